@@ -0,0 +1,226 @@
+// The MIT License (MIT)
+//
+// STLite benchmark harness
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_RDTSC
+#endif
+
+// Every benchmark prints a line per measurement:
+//
+//   name   median time   throughput   99th percentile time   cycles per op
+//
+// The results can also be appended to files for tracking regressions, one
+// row per measurement. The files are given in the environment:
+//
+//   BENCH_CSV=results.csv    CSV with a header line when the file is new
+//   BENCH_JSON=results.json  JSON Lines, one object per line
+//   BENCH_REPS=n             Repetitions of every measurement
+//
+// The cycles are counted with the time stamp counter, which runs at a fixed
+// rate on current CPUs, so they are reference cycles, not core cycles. On
+// other architectures they are not reported.
+
+namespace bench
+{
+
+// Keep the compiler from optimizing away a computed value
+template <class T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline unsigned long long cycles()
+{
+#ifdef BENCH_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Statistics of the repetitions of a measurement, in milliseconds
+struct Result
+{
+    unsigned reps = 0;
+    double median = 0;
+    double p99 = 0;
+    double min = 0;
+    double max = 0;
+    double cycles = 0; // Median cycles of a repetition, 0 if not counted
+};
+
+// Value below which the fraction p of the sorted samples lies (nearest rank)
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t rank = (size_t) (p * sorted.size() + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Run f() once as a warmup and then reps times
+template <class F>
+Result measure(F& f, unsigned reps)
+{
+    if (const char* env = getenv("BENCH_REPS"))
+        reps = atoi(env) > 0 ? atoi(env) : reps;
+
+    std::vector<double> times;
+    std::vector<double> counts;
+
+    f();
+
+    for (unsigned i = 0; i < reps; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long c0 = cycles();
+        f();
+        unsigned long long c1 = cycles();
+        auto stop = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+        counts.push_back(double(c1 - c0));
+    }
+
+    std::sort(times.begin(), times.end());
+    std::sort(counts.begin(), counts.end());
+
+    Result r;
+    r.reps = reps;
+    r.median = times[times.size() / 2];
+    r.p99 = percentile(times, 0.99);
+    r.min = times.front();
+    r.max = times.back();
+    r.cycles = counts[counts.size() / 2];
+    return r;
+}
+
+// Name of the benchmark program, the first column of the files
+inline const char* program()
+{
+#ifdef __GLIBC__
+    return program_invocation_short_name;
+#else
+    return "bench";
+#endif
+}
+
+// Append the result to the files given in the environment. ops and bytes
+// are the work done by one repetition, bytes is 0 if not measured.
+inline void record(const char* name, const Result& r, double ops, double bytes)
+{
+    double seconds = r.median / 1000.0;
+    double ops_per_sec = ops / seconds;
+    double cycles_per_op = r.cycles / ops;
+    double gb_per_sec = bytes / seconds / 1e9;
+
+    if (const char* path = getenv("BENCH_CSV"))
+    {
+        if (FILE* f = fopen(path, "a"))
+        {
+            if (ftell(f) == 0)
+                fprintf(f, "bench,name,reps,ops,median_ms,p99_ms,min_ms,max_ms,"
+                           "ops_per_sec,cycles_per_op,gb_per_sec\n");
+
+            // Quotes in the name are doubled
+            fprintf(f, "%s,\"", program());
+            for (const char* c = name; *c; c++)
+            {
+                if (*c == '"')
+                    fputc('"', f);
+                fputc(*c, f);
+            }
+            fprintf(f, "\",%u,%.0f,%.6f,%.6f,%.6f,%.6f,%.1f,%.3f,%.4f\n", r.reps, ops, r.median,
+                    r.p99, r.min, r.max, ops_per_sec, cycles_per_op, gb_per_sec);
+            fclose(f);
+        }
+    }
+
+    if (const char* path = getenv("BENCH_JSON"))
+    {
+        if (FILE* f = fopen(path, "a"))
+        {
+            fprintf(f, "{\"bench\": \"%s\", \"name\": \"", program());
+            for (const char* c = name; *c; c++)
+            {
+                if (*c == '"' || *c == '\\')
+                    fputc('\\', f);
+                fputc(*c, f);
+            }
+            fprintf(f, "\", \"reps\": %u, \"ops\": %.0f, \"median_ms\": %.6f, \"p99_ms\": %.6f, "
+                       "\"min_ms\": %.6f, \"max_ms\": %.6f, \"ops_per_sec\": %.1f, "
+                       "\"cycles_per_op\": %.3f, \"gb_per_sec\": %.4f}\n",
+                    r.reps, ops, r.median, r.p99, r.min, r.max, ops_per_sec, cycles_per_op,
+                    gb_per_sec);
+            fclose(f);
+        }
+    }
+}
+
+// Run f() once as a warmup and then reps times, print and return the median
+// time of a single run in milliseconds. ops is the number of operations done
+// by one run of f() and is used to report the throughput.
+template <class F>
+double run(const char* name, unsigned long ops, F f, unsigned reps = 5)
+{
+    Result r = measure(f, reps);
+
+    printf("%-48s %10.3f ms %14.0f ops/s  p99 %10.3f ms", name, r.median,
+           ops / (r.median / 1000.0), r.p99);
+    if (r.cycles > 0)
+        printf(" %10.2f cycles/op", r.cycles / ops);
+    printf("\n");
+
+    record(name, r, ops, 0);
+    return r.median;
+}
+
+// Like run(), but report the throughput in GB/s of the bytes processed by
+// one run of f()
+template <class F>
+double bandwidth(const char* name, double bytes, F f, unsigned reps = 5)
+{
+    Result r = measure(f, reps);
+
+    printf("%-48s %10.3f ms %10.2f GB/s  p99 %10.3f ms", name, r.median,
+           bytes / (r.median / 1000.0) / 1e9, r.p99);
+    if (r.cycles > 0)
+        printf(" %10.2f cycles/byte", r.cycles / bytes);
+    printf("\n");
+
+    record(name, r, 1, bytes);
+    return r.median;
+}
+
+} // namespace bench
+
+#endif
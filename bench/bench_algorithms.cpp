@@ -0,0 +1,98 @@
+#include "bench.h"
+
+#include "../include/algorithms.h"
+#include "../include/vector.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdlib.h>
+#include <string.h>
+
+constexpr unsigned elements = 1000000;
+
+// Every algorithm runs on a fresh copy of the same input for both libraries.
+// The copy is part of the measured time, it is the same for both sides.
+
+static stlite::Vector<int> input(elements);
+static stlite::Vector<int> work(elements);
+static stlite::Vector<int> out(2 * elements);
+
+static void reset() { memcpy(work.data(), input.data(), elements * sizeof(int)); }
+
+template <class F>
+static void run(const char* name, F f)
+{
+    bench::run(name, elements, [&] {
+        reset();
+        f();
+        bench::do_not_optimize(work.data()[elements / 2]);
+    });
+}
+
+int main()
+{
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+        input[i] = rand() % elements;
+
+    stlite::Vector<char> bytes(elements, 'a');
+    bytes[elements - 1] = 'b';
+
+    printf("%u ints\n", elements);
+
+    run("std::fill", [] { std::fill(work.begin(), work.end(), 7); });
+    run("stlite::fill", [] { stlite::fill(work.begin(), work.end(), 7); });
+
+    run("std::fill (char)", [&] { std::fill(bytes.begin(), bytes.end(), 'a'); });
+    run("stlite::fill (char)", [&] { stlite::fill(bytes.begin(), bytes.end(), 'a'); });
+
+    bytes[elements - 1] = 'b';
+    run("std::find (char)", [&] {
+        bench::do_not_optimize(std::find(bytes.begin(), bytes.end(), 'b'));
+    });
+    run("stlite::find (char)", [&] {
+        bench::do_not_optimize(stlite::find(bytes.begin(), bytes.end(), 'b'));
+    });
+
+    run("std::find", [] { bench::do_not_optimize(std::find(work.begin(), work.end(), -1)); });
+    run("stlite::find", [] { bench::do_not_optimize(stlite::find(work.begin(), work.end(), -1)); });
+
+    auto odd = [](int x) { return x & 1; };
+    run("std::count_if", [&] { bench::do_not_optimize(std::count_if(work.begin(), work.end(), odd)); });
+    run("stlite::count_if", [&] { bench::do_not_optimize(stlite::count_if(work.begin(), work.end(), odd)); });
+
+    auto twice = [](int x) { return 2 * x; };
+    run("std::transform", [&] { std::transform(work.begin(), work.end(), work.begin(), twice); });
+    run("stlite::transform", [&] { stlite::transform(work.begin(), work.end(), work.begin(), twice); });
+
+    run("std::accumulate", [] { bench::do_not_optimize(std::accumulate(work.begin(), work.end(), 0)); });
+    run("stlite::accumulate", [] { bench::do_not_optimize(stlite::accumulate(work.begin(), work.end(), 0)); });
+
+    auto small = [](int x) { return x < (int) elements / 2; };
+    run("std::partition", [&] { std::partition(work.begin(), work.end(), small); });
+    run("stlite::partition", [&] { stlite::partition(work.begin(), work.end(), small); });
+
+    run("std::nth_element", [] { std::nth_element(work.begin(), work.begin() + elements / 2, work.end()); });
+    run("stlite::nth_element", [] { stlite::nth_element(work.begin(), work.begin() + elements / 2, work.end()); });
+
+    run("std::partial_sort (1%)", [] { std::partial_sort(work.begin(), work.begin() + elements / 100, work.end()); });
+    run("stlite::partial_sort (1%)", [] { stlite::partial_sort(work.begin(), work.begin() + elements / 100, work.end()); });
+
+    run("std::stable_sort", [] { std::stable_sort(work.begin(), work.end()); });
+    run("stlite::stable_sort", [] { stlite::stable_sort(work.begin(), work.end()); });
+
+    // Sorted halves for merge and sorted input with duplicates for unique
+    reset();
+    std::sort(work.begin(), work.begin() + elements / 2);
+    std::sort(work.begin() + elements / 2, work.end());
+    memcpy(input.data(), work.data(), elements * sizeof(int));
+
+    stlite::Vector<int>::Iterator half = work.begin() + elements / 2;
+    run("std::merge", [&] { std::merge(work.begin(), half, half, work.end(), out.begin()); });
+    run("stlite::merge", [&] { stlite::merge(work.begin(), half, half, work.end(), out.begin()); });
+
+    run("std::unique", [] { bench::do_not_optimize(std::unique(work.begin(), work.end())); });
+    run("stlite::unique", [] { bench::do_not_optimize(stlite::unique(work.begin(), work.end())); });
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include "../include/bit_vector.h"
+#include "../include/vector.h"
+
+#include <stdlib.h>
+#include <vector>
+
+// BitVector against Vector<bool>, which stores a byte per element, and
+// std::vector<bool>, which packs the bits too. All hold the same random bits,
+// about a quarter of them set.
+
+constexpr unsigned elements = 1 << 24;
+
+int main()
+{
+    stlite::Vector<bool> bytes(elements);
+    stlite::Vector<bool> bytes2(elements);
+    stlite::BitVector bv(elements);
+    stlite::BitVector bv2(elements);
+    std::vector<bool> sbv(elements);
+
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+    {
+        bool a = rand() % 4 == 0;
+        bool b = rand() % 2 == 0;
+        bytes[i] = a;
+        bytes2[i] = b;
+        bv.set(i, a);
+        sbv[i] = a;
+        bv2.set(i, b);
+    }
+
+    printf("%u bits: Vector<bool> %u KB, BitVector %u KB\n", elements,
+           elements / 1024, bv.word_count() * 8 / 1024);
+
+    bench::run("Vector<bool> count", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += bytes[i];
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("std::vector<bool> count", elements, [&] {
+        bench::do_not_optimize(std::count(sbv.begin(), sbv.end(), true));
+    });
+
+    bench::run("BitVector count", elements, [&] { bench::do_not_optimize(bv.count()); });
+
+    bench::run("Vector<bool> iterate set bits", elements, [&] {
+        unsigned long sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            if (bytes[i])
+                sum += i;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("BitVector iterate set bits", elements, [&] {
+        unsigned long sum = 0;
+        for (size_t i = bv.find_first(); i != bv.size(); i = bv.find_next(i))
+            sum += i;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("Vector<bool> and", elements, [&] {
+        bool* a = bytes.data();
+        const bool* b = bytes2.data();
+        for (unsigned i = 0; i < elements; i++)
+            a[i] = a[i] & b[i];
+        bench::do_not_optimize(a[0]);
+    });
+
+    bench::run("BitVector and", elements, [&] {
+        bv &= bv2;
+        bench::do_not_optimize(bv.data()[0]);
+    });
+
+    // Random membership tests, the bits fit in the cache, the bytes don't
+    unsigned* probes = new unsigned[1 << 20];
+    for (unsigned i = 0; i < 1 << 20; i++)
+        probes[i] = rand() % elements;
+
+    bench::run("Vector<bool> random test", 1 << 20, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < 1 << 20; i++)
+            n += bytes2[probes[i]];
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("BitVector random test", 1 << 20, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < 1 << 20; i++)
+            n += bv2.test(probes[i]);
+        bench::do_not_optimize(n);
+    });
+
+    delete[] probes;
+
+    stlite::RankSelect rs(bv2);
+    bench::run("RankSelect rank", 1 << 20, [&] {
+        size_t sum = 0;
+        for (unsigned i = 0; i < 1 << 20; i++)
+            sum += rs.rank(i * 16);
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("RankSelect select", 1 << 20, [&] {
+        size_t sum = 0;
+        for (unsigned i = 0; i < 1 << 20; i++)
+            sum += rs.select(i * 4);
+        bench::do_not_optimize(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "bench.h"
+
+#include "../include/chunked_reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Reading a large file of fixed-size records and a large text file with
+// ChunkedReader against stdio and small read() calls. BENCH_FILE_MB sets
+// the size of each file, 1024 MB by default. Unless the files are larger
+// than the free memory they stay in the page cache, and the buffered reads
+// measure the copying; the O_DIRECT reads go to the disk every time.
+
+struct Record
+{
+    unsigned long id;
+    unsigned value;
+    unsigned flags;
+};
+
+static char records_path[] = "/tmp/bench_chunked_records.XXXXXX";
+static char lines_path[] = "/tmp/bench_chunked_lines.XXXXXX";
+
+static unsigned long file_size()
+{
+    const char* mb = getenv("BENCH_FILE_MB");
+    return (mb ? strtoul(mb, nullptr, 10) : 1024) << 20;
+}
+
+static void create_files(unsigned long size)
+{
+    static Record records[1 << 16];
+    static char text[1 << 20];
+
+    int fd = mkstemp(records_path);
+    for (unsigned long written = 0, id = 0; written < size; written += sizeof(records))
+    {
+        for (unsigned i = 0; i < 1 << 16; i++, id++)
+            records[i] = Record{ id, (unsigned) id * 7, 0 };
+        if (write(fd, records, sizeof(records)) != sizeof(records))
+            abort();
+    }
+    close(fd);
+
+    // Lines of 20 to 140 characters
+    size_t n = 0;
+    for (unsigned len = 20; n + 141 < sizeof(text); len = 20 + (len * 7 + 13) % 121)
+    {
+        memset(text + n, 'a' + len % 26, len);
+        n += len;
+        text[n++] = '\n';
+    }
+
+    fd = mkstemp(lines_path);
+    for (unsigned long written = 0; written < size; written += n)
+        if (write(fd, text, n) != (ssize_t) n)
+            abort();
+    close(fd);
+}
+
+int main()
+{
+    unsigned long size = file_size();
+    create_files(size);
+    printf("%lu MB files\n", size >> 20);
+
+    bench::bandwidth("read() 4 KB records", size, [] {
+        static Record buffer[4096 / sizeof(Record)];
+        unsigned long sum = 0;
+        int fd = open(records_path, O_RDONLY);
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+            for (unsigned i = 0; i < n / sizeof(Record); i++)
+                sum += buffer[i].value;
+        close(fd);
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("fread records", size, [] {
+        Record r;
+        unsigned long sum = 0;
+        FILE* f = fopen(records_path, "r");
+        while (fread(&r, sizeof(r), 1, f) == 1)
+            sum += r.value;
+        fclose(f);
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader next_batch", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(records_path);
+        stlite::Vector<Record> batch;
+        unsigned long sum = 0;
+        while (reader.next_batch(batch, 4096))
+            for (const Record& r : batch)
+                sum += r.value;
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader next_batch, 8 MB chunks", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(records_path, 0, 8 << 20);
+        stlite::Vector<Record> batch;
+        unsigned long sum = 0;
+        while (reader.next_batch(batch, 4096))
+            for (const Record& r : batch)
+                sum += r.value;
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader next_batch, O_DIRECT", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(records_path, stlite::chunked_read_direct);
+        stlite::Vector<Record> batch;
+        unsigned long sum = 0;
+        while (reader.next_batch(batch, 4096))
+            for (const Record& r : batch)
+                sum += r.value;
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader fill Queue", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(records_path);
+        stlite::Queue<Record> queue;
+        unsigned long sum = 0;
+        while (reader.fill(queue, 1024))
+            while (!queue.empty())
+            {
+                sum += queue.front().value;
+                queue.pop();
+            }
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("fgets lines", size, [] {
+        static char line[256];
+        unsigned long sum = 0;
+        FILE* f = fopen(lines_path, "r");
+        while (fgets(line, sizeof(line), f))
+            sum += strlen(line);
+        fclose(f);
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader next_line", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(lines_path);
+        stlite::Span<const char> line;
+        unsigned long sum = 0;
+        while (reader.next_line(line))
+            sum += line.size();
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::bandwidth("ChunkedReader next_lines", size, [] {
+        stlite::ChunkedReader reader;
+        reader.open(lines_path);
+        stlite::Vector<stlite::Span<const char>> batch;
+        unsigned long sum = 0;
+        while (reader.next_lines(batch, 1024))
+            for (unsigned i = 0; i < batch.size(); i++)
+                sum += batch[i].size();
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    unlink(records_path);
+    unlink(lines_path);
+    return 0;
+}
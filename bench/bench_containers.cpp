@@ -0,0 +1,279 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/circular_list.h"
+#include "../include/forward_list.h"
+#include "../include/queue.h"
+#include "../include/set.h"
+#include "../include/stack.h"
+#include "../include/vector.h"
+
+#include <forward_list>
+#include <list>
+#include <queue>
+#include <set>
+#include <stack>
+#include <stdlib.h>
+#include <vector>
+
+// Core operations of the basic containers against their libstdc++
+// counterparts: Vector and Array against std::vector, the lists against
+// std::list and std::forward_list, Set against std::set, Stack and Queue
+// against the std adaptors on their default containers.
+
+constexpr unsigned elements = 1 << 20;
+constexpr unsigned set_elements = 1 << 17;
+
+static void vectors()
+{
+    bench::run("Vector push_back", elements, [] {
+        stlite::Vector<int> vec;
+        for (unsigned i = 0; i < elements; i++)
+            vec.push_back(i);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("std::vector push_back", elements, [] {
+        std::vector<int> vec;
+        for (unsigned i = 0; i < elements; i++)
+            vec.push_back(i);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    stlite::Vector<int> vec(elements);
+    std::vector<int> svec(elements);
+    stlite::Array<int> arr(elements);
+    for (unsigned i = 0; i < elements; i++)
+        vec[i] = svec[i] = arr[i] = i;
+
+    bench::run("Vector iterate", elements, [&] {
+        int sum = 0;
+        for (int x : vec)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::vector iterate", elements, [&] {
+        int sum = 0;
+        for (int x : svec)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("Array iterate", elements, [&] {
+        int sum = 0;
+        for (int x : arr)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    // Random reads, dominated by the cache misses
+    unsigned* index = new unsigned[elements];
+    for (unsigned i = 0; i < elements; i++)
+        index[i] = rand() % elements;
+
+    bench::run("Vector random access", elements, [&] {
+        int sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += vec[index[i]];
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::vector random access", elements, [&] {
+        int sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += svec[index[i]];
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("Array random access", elements, [&] {
+        int sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += arr[index[i]];
+        bench::do_not_optimize(sum);
+    });
+
+    delete[] index;
+}
+
+static void lists()
+{
+    bench::run("CircularList push_back and pop_front", elements, [] {
+        stlite::CircularList<int> lst;
+        for (unsigned i = 0; i < elements; i++)
+            lst.push_back(i);
+        while (lst.pop_front())
+        {
+        }
+    });
+
+    bench::run("std::list push_back and pop_front", elements, [] {
+        std::list<int> lst;
+        for (unsigned i = 0; i < elements; i++)
+            lst.push_back(i);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    bench::run("ForwardList push_front and pop_front", elements, [] {
+        stlite::ForwardList<int> lst;
+        for (unsigned i = 0; i < elements; i++)
+            lst.push_front(i);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    bench::run("std::forward_list push_front and pop_front", elements, [] {
+        std::forward_list<int> lst;
+        for (unsigned i = 0; i < elements; i++)
+            lst.push_front(i);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    stlite::CircularList<int> clst;
+    std::list<int> slst;
+    stlite::ForwardList<int> flst;
+    std::forward_list<int> sflst;
+    for (unsigned i = 0; i < elements; i++)
+    {
+        clst.push_back(i);
+        slst.push_back(i);
+        flst.push_front(i);
+        sflst.push_front(i);
+    }
+
+    bench::run("CircularList iterate", elements, [&] {
+        int sum = 0;
+        for (int x : clst)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::list iterate", elements, [&] {
+        int sum = 0;
+        for (int x : slst)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("ForwardList iterate", elements, [&] {
+        int sum = 0;
+        for (int x : flst)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::forward_list iterate", elements, [&] {
+        int sum = 0;
+        for (int x : sflst)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+}
+
+static void sets()
+{
+    int* keys = new int[set_elements];
+    for (unsigned i = 0; i < set_elements; i++)
+        keys[i] = rand();
+
+    stlite::Set<int> set;
+    std::set<int> sset;
+
+    bench::run("Set insert", set_elements, [&] {
+        set.clear();
+        for (unsigned i = 0; i < set_elements; i++)
+            set.insert(keys[i]);
+    });
+
+    bench::run("std::set insert", set_elements, [&] {
+        sset.clear();
+        for (unsigned i = 0; i < set_elements; i++)
+            sset.insert(keys[i]);
+    });
+
+    // Half of the lookups miss
+    bench::run("Set count", set_elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < set_elements; i++)
+            n += set.count(keys[i] + (i & 1));
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("std::set count", set_elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < set_elements; i++)
+            n += sset.count(keys[i] + (i & 1));
+        bench::do_not_optimize(n);
+    });
+
+    delete[] keys;
+}
+
+static void adaptors()
+{
+    bench::run("Stack push and pop", elements, [] {
+        stlite::Stack<int> st;
+        for (unsigned i = 0; i < elements; i++)
+            st.push(i);
+        int sum = 0;
+        while (!st.empty())
+        {
+            sum += st.top();
+            st.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::stack push and pop", elements, [] {
+        std::stack<int> st;
+        for (unsigned i = 0; i < elements; i++)
+            st.push(i);
+        int sum = 0;
+        while (!st.empty())
+        {
+            sum += st.top();
+            st.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("Queue push and pop", elements, [] {
+        stlite::Queue<int> q;
+        for (unsigned i = 0; i < elements; i++)
+            q.push(i);
+        int sum = 0;
+        while (!q.empty())
+        {
+            sum += q.front();
+            q.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("std::queue push and pop", elements, [] {
+        std::queue<int> q;
+        for (unsigned i = 0; i < elements; i++)
+            q.push(i);
+        int sum = 0;
+        while (!q.empty())
+        {
+            sum += q.front();
+            q.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+int main()
+{
+    srand(1);
+
+    vectors();
+    lists();
+    sets();
+    adaptors();
+
+    return 0;
+}
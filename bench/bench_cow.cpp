@@ -0,0 +1,111 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/cow_array.h"
+#include "../include/cow_vector.h"
+#include "../include/vector.h"
+
+// Pipeline stages take the container by value, as our read-only consumers
+// do, and look up a few entries
+
+constexpr unsigned lookups = 1000;
+
+template <class V>
+static long stage_sum(V v)
+{
+    const V& c = v;
+    long s = 0;
+    for (unsigned i = 0; i < lookups; i++)
+        s += c[(i * 7919) % c.size()];
+    return s;
+}
+
+template <class V>
+static long stage_max(V v)
+{
+    const V& c = v;
+    long m = c[0];
+    for (unsigned i = 0; i < lookups; i++)
+        if (c[(i * 104729) % c.size()] > m)
+            m = c[(i * 104729) % c.size()];
+    return m;
+}
+
+// The last stage modifies its copy
+template <class V>
+static long stage_modify(V v)
+{
+    v[0] = -1;
+    return v[0];
+}
+
+template <class V>
+static void pipeline(const V& input, unsigned stages)
+{
+    long r = 0;
+    for (unsigned i = 0; i < stages; i++)
+        r += (i % 2) ? stage_sum(input) : stage_max(input);
+    r += stage_modify(input);
+    bench::do_not_optimize(r);
+}
+
+int main()
+{
+    constexpr unsigned size = 100000;
+    constexpr unsigned stages = 8;
+    constexpr unsigned runs = 100;
+
+    stlite::Vector<int> vec;
+    stlite::CowVector<int> cow_vec;
+    for (unsigned i = 0; i < size; i++)
+    {
+        vec.push_back(i);
+        cow_vec.push_back(i);
+    }
+
+    stlite::Array<int> arr(vec.data(), size);
+    stlite::CowArray<int> cow_arr(vec.data(), size);
+
+    printf("Pipeline of %u read-only stages + 1 writing stage, %u elements\n",
+           stages, size);
+
+    bench::run("stlite::Vector", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+            pipeline(vec, stages);
+    });
+
+    bench::run("stlite::CowVector", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+            pipeline(cow_vec, stages);
+    });
+
+    bench::run("stlite::Array", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+            pipeline(arr, stages);
+    });
+
+    bench::run("stlite::CowArray", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+            pipeline(cow_arr, stages);
+    });
+
+    printf("Copy only, %u elements\n", size);
+
+    bench::run("stlite::Vector copy", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+        {
+            stlite::Vector<int> copy(vec);
+            bench::do_not_optimize(copy.size());
+        }
+    });
+
+    bench::run("stlite::CowVector copy", runs, [&] {
+        for (unsigned i = 0; i < runs; i++)
+        {
+            stlite::CowVector<int> copy(cow_vec);
+            bench::do_not_optimize(copy.size());
+        }
+    });
+
+    return 0;
+}
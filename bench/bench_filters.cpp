@@ -0,0 +1,98 @@
+#include "bench.h"
+
+#include "../include/bloom_filter.h"
+#include "../include/cuckoo_filter.h"
+
+#include <stdio.h>
+
+// Query throughput and measured false positive rates of the filters. The
+// filters are built for the number of keys inserted; the negative queries
+// are keys which have not been inserted.
+
+constexpr unsigned keys = 1 << 22;
+constexpr unsigned queries = 1 << 22;
+
+template <class Filter>
+static void run_queries(const char* name, const Filter& filter, unsigned first)
+{
+    bench::run(name, queries, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < queries; i++)
+            n += filter.contains(first + i * 2654435761u);
+        bench::do_not_optimize(n);
+    });
+}
+
+// Keys are i * 2654435761, queries of the negative keys start at 1 so they
+// never hit an inserted key
+template <class Filter>
+static double measured_fpr(const Filter& filter)
+{
+    unsigned n = 0;
+    for (unsigned i = 0; i < queries; i++)
+        n += filter.contains(1 + i * 2654435761u);
+    return double(n) / queries;
+}
+
+static void bloom(double fpr)
+{
+    stlite::BloomFilter<unsigned> filter(keys, fpr);
+    for (unsigned i = 0; i < keys; i++)
+        filter.insert(i * 2654435761u);
+
+    printf("Bloom, requested FPR %.4f: %.2f bits/key, expected %.4f, measured %.4f\n", fpr,
+           8.0 * filter.size_in_bytes() / keys, filter.false_positive_rate(),
+           measured_fpr(filter));
+
+    for (int l = stlite::simd::detected_level(); l >= stlite::simd::scalar; l--)
+    {
+        if (l == stlite::simd::sse2)
+            continue;
+        stlite::simd::set_level(static_cast<stlite::simd::Level>(l));
+
+        const char* level = l == stlite::simd::avx2 ? "avx2" : "scalar";
+        char name[64];
+
+        snprintf(name, sizeof(name), "  Bloom positive queries (%s)", level);
+        run_queries(name, filter, 0);
+        snprintf(name, sizeof(name), "  Bloom negative queries (%s)", level);
+        run_queries(name, filter, 1);
+    }
+    stlite::simd::set_level(stlite::simd::detected_level());
+}
+
+static void cuckoo(double fpr)
+{
+    stlite::CuckooFilter<unsigned> filter(keys, fpr);
+    for (unsigned i = 0; i < keys; i++)
+        filter.insert(i * 2654435761u);
+
+    printf("Cuckoo, requested FPR %.4f: %u-bit fingerprints, %.2f bits/key, load %.2f, "
+           "expected %.4f, measured %.4f\n",
+           fpr, filter.fingerprint_bits(), 8.0 * filter.size_in_bytes() / keys,
+           filter.load_factor(), filter.false_positive_rate(), measured_fpr(filter));
+
+    run_queries("  Cuckoo positive queries", filter, 0);
+    run_queries("  Cuckoo negative queries", filter, 1);
+}
+
+int main()
+{
+    printf("%u keys, %u queries\n", keys, queries);
+
+    for (double fpr : { 0.05, 0.01, 0.001 })
+    {
+        bloom(fpr);
+        cuckoo(fpr);
+    }
+
+    stlite::CuckooFilter<unsigned> filter(keys, 0.01);
+    bench::run("Cuckoo insert and erase", 2 * keys, [&] {
+        for (unsigned i = 0; i < keys; i++)
+            filter.insert(i * 2654435761u);
+        for (unsigned i = 0; i < keys; i++)
+            filter.erase(i * 2654435761u);
+    }, 3);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "bench.h"
+
+#include "../include/huge_page_allocator.h"
+#include "../include/vector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Random reads over a large Vector with the default allocator and with
+// HugePageAllocator. With 4 KB pages nearly every read of a multi-GB vector
+// misses the TLB as well as the cache, and the page walk adds to the
+// latency. BENCH_VECTOR_MB sets the size of the vector, 4096 MB by default,
+// limited to three quarters of the available memory and rounded down to a
+// power of two.
+
+constexpr unsigned reads = 1 << 22;
+constexpr unsigned chained_reads = 1 << 20;
+
+// Value of a field of /proc/meminfo or /proc/self/smaps_rollup in kB
+static unsigned long meminfo(const char* file, const char* field)
+{
+    FILE* f = fopen(file, "r");
+    if (!f)
+        return 0;
+
+    char line[256];
+    unsigned long kb = 0;
+    size_t len = strlen(field);
+    while (fgets(line, sizeof(line), f))
+        if (strncmp(line, field, len) == 0 && line[len] == ':')
+            kb = strtoul(line + len + 1, nullptr, 10);
+    fclose(f);
+    return kb;
+}
+
+static unsigned long vector_elements()
+{
+    const char* env = getenv("BENCH_VECTOR_MB");
+    unsigned long mb = env ? strtoul(env, nullptr, 10) : 4096;
+    unsigned long available = meminfo("/proc/meminfo", "MemAvailable") / 1024;
+    if (available && mb > available * 3 / 4)
+        mb = available * 3 / 4;
+
+    unsigned long n = (mb << 20) / sizeof(unsigned long);
+    unsigned long p = 1;
+    while (p * 2 <= n)
+        p *= 2;
+    return p;
+}
+
+template <class Alloc>
+static void random_reads(const char* name, unsigned long n)
+{
+    stlite::Vector<unsigned long, Alloc> vec(n);
+    for (unsigned long i = 0; i < n; i++)
+        vec[i] = i;
+
+    printf("%s: %lu MB, %lu MB in transparent huge pages\n", name, n * sizeof(unsigned long) >> 20,
+           meminfo("/proc/self/smaps_rollup", "AnonHugePages") / 1024);
+
+    char label[128];
+    unsigned long mask = n - 1;
+
+    // Independent reads, the CPU overlaps the misses
+    snprintf(label, sizeof(label), "%s random reads", name);
+    bench::run(label, reads, [&] {
+        unsigned long x = 88172645463325252UL;
+        unsigned long sum = 0;
+        for (unsigned i = 0; i < reads; i++)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            sum += vec[x & mask];
+        }
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    // Each read depends on the one before, so the full latency of the
+    // miss and of the page walk is exposed
+    snprintf(label, sizeof(label), "%s dependent reads", name);
+    bench::run(label, chained_reads, [&] {
+        unsigned long i = 1;
+        for (unsigned k = 0; k < chained_reads; k++)
+            i = ((i + vec[i]) * 0x9e3779b97f4a7c15UL >> 20) & mask;
+        bench::do_not_optimize(i);
+    }, 3);
+}
+
+int main()
+{
+    unsigned long n = vector_elements();
+
+    random_reads<stlite::Allocator<unsigned long>>("Vector", n);
+    random_reads<stlite::HugePageAllocator<unsigned long>>("Vector with huge pages", n);
+
+    return 0;
+}
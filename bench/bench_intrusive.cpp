@@ -0,0 +1,106 @@
+#include "bench.h"
+
+#include "../include/circular_list.h"
+#include "../include/forward_list.h"
+#include "../include/intrusive_list.h"
+#include "../include/intrusive_set.h"
+#include "../include/set.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Objects living in a pool, as they would in the application
+struct PoolItem
+{
+    int value = 0;
+    stlite::ForwardListHook fwd_hook;
+    stlite::ListHook hook;
+    stlite::SetHook set_hook;
+
+    bool operator<(const PoolItem& other) const { return value < other.value; }
+};
+
+int main()
+{
+    constexpr unsigned num = 1000000;
+
+    std::vector<int> keys(num);
+    for (unsigned i = 0; i < num; i++)
+        keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+    std::vector<PoolItem> pool(num);
+    for (unsigned i = 0; i < num; i++)
+        pool[i].value = keys[i];
+
+    printf("Forward list: push_front + pop_front of %u elements\n", num);
+
+    bench::run("stlite::ForwardList<PoolItem>", num, [&] {
+        stlite::ForwardList<PoolItem> lst;
+        for (unsigned i = 0; i < num; i++)
+            lst.push_front(pool[i]);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    bench::run("stlite::IntrusiveForwardList<PoolItem>", num, [&] {
+        stlite::IntrusiveForwardList<PoolItem, &PoolItem::fwd_hook> lst;
+        for (unsigned i = 0; i < num; i++)
+            lst.push_front(pool[i]);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    printf("Circular list: push_back + pop_front of %u elements\n", num);
+
+    bench::run("stlite::CircularList<PoolItem>", num, [&] {
+        stlite::CircularList<PoolItem> lst;
+        for (unsigned i = 0; i < num; i++)
+            lst.push_back(pool[i]);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    bench::run("stlite::IntrusiveCircularList<PoolItem>", num, [&] {
+        stlite::IntrusiveCircularList<PoolItem, &PoolItem::hook> lst;
+        for (unsigned i = 0; i < num; i++)
+            lst.push_back(pool[i]);
+        while (!lst.empty())
+            lst.pop_front();
+    });
+
+    printf("Circular list: unlink every other element by reference\n");
+
+    bench::run("stlite::CircularList<int>::remove", num / 100, [&] {
+        stlite::CircularList<int> lst;
+        for (unsigned i = 0; i < num / 100; i++)
+            lst.push_back(i);
+        for (unsigned i = 0; i < num / 100; i += 2)
+            lst.remove(i);
+    });
+
+    bench::run("stlite::IntrusiveCircularList::erase", num, [&] {
+        stlite::IntrusiveCircularList<PoolItem, &PoolItem::hook> lst;
+        for (unsigned i = 0; i < num; i++)
+            lst.push_back(pool[i]);
+        for (unsigned i = 0; i < num; i += 2)
+            lst.erase(pool[i]);
+    });
+
+    printf("Set: insert of %u elements + clear\n", num);
+
+    bench::run("stlite::Set<int>", num, [&] {
+        stlite::Set<int> set;
+        for (unsigned i = 0; i < num; i++)
+            set.insert(pool[i].value);
+    });
+
+    bench::run("stlite::IntrusiveSet<PoolItem>", num, [&] {
+        stlite::IntrusiveSet<PoolItem, &PoolItem::set_hook> set;
+        for (unsigned i = 0; i < num; i++)
+            set.insert(pool[i]);
+    });
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/vector.h"
+
+#include <numeric>
+
+// Summing loops over a Vector<int>. Every loop is kept in its own noinline
+// function, so the generated code can be compared directly with
+//
+//   g++ -O3 -std=c++14 -DUSE_STL -S bench/bench_iterators.cpp -o - | c++filt
+//
+// The iterators are plain pointers underneath, so the loops over Iterator,
+// ReverseIterator, range-for and std::accumulate compile to the same
+// vectorized loop as the one over data(). The bench is built with -O3 because
+// the -O2 cost model of GCC leaves these reductions scalar.
+
+constexpr unsigned elements = 1 << 20;
+constexpr unsigned rounds = 64;
+
+// The iterator Vector used to have: a pointer plus an index, compared by the
+// index only
+template <class T>
+class IndexIterator
+{
+    T* _data = nullptr;
+    unsigned _current = -1;
+public:
+    IndexIterator(T* data, unsigned n) : _data(data), _current(n) {}
+
+    IndexIterator& operator++()
+    {
+        _current++;
+        return *this;
+    }
+
+    T& operator*() { return _data[_current]; }
+
+    bool operator!=(const IndexIterator& other) { return other._current != _current; }
+};
+
+__attribute__((noinline)) static int sum_data(const stlite::Vector<int>& vec)
+{
+    const int* p = vec.data();
+    int sum = 0;
+    for (unsigned i = 0; i < vec.size(); i++)
+        sum += p[i];
+    return sum;
+}
+
+__attribute__((noinline)) static int sum_iterator(const stlite::Vector<int>& vec)
+{
+    int sum = 0;
+    for (stlite::Vector<int>::ConstIterator it = vec.begin(); it != vec.end(); ++it)
+        sum += *it;
+    return sum;
+}
+
+__attribute__((noinline)) static int sum_range_for(const stlite::Vector<int>& vec)
+{
+    int sum = 0;
+    for (int x : vec)
+        sum += x;
+    return sum;
+}
+
+__attribute__((noinline)) static int sum_reverse(const stlite::Vector<int>& vec)
+{
+    int sum = 0;
+    for (stlite::Vector<int>::ConstReverseIterator it = vec.rbegin(); it != vec.rend(); ++it)
+        sum += *it;
+    return sum;
+}
+
+__attribute__((noinline)) static int sum_accumulate(const stlite::Vector<int>& vec)
+{
+    return std::accumulate(vec.begin(), vec.end(), 0);
+}
+
+__attribute__((noinline)) static int sum_index_iterator(stlite::Vector<int>& vec)
+{
+    int sum = 0;
+    IndexIterator<int> end(nullptr, vec.size());
+    for (IndexIterator<int> it(vec.data(), 0); it != end; ++it)
+        sum += *it;
+    return sum;
+}
+
+template <class F>
+static void run(const char* name, F f)
+{
+    bench::run(name, (unsigned long)elements * rounds, [&] {
+        int total = 0;
+        for (unsigned r = 0; r < rounds; r++)
+        {
+            total += f();
+            // Clobbers memory, so the sum can't be hoisted out of the loop
+            bench::do_not_optimize(total);
+        }
+        bench::do_not_optimize(total);
+    });
+}
+
+int main()
+{
+    stlite::Vector<int> vec(elements);
+    for (unsigned i = 0; i < elements; i++)
+        vec[i] = i & 0xff;
+
+    printf("Sum of %u ints, %u rounds\n", elements, rounds);
+
+    run("data() and index", [&] { return sum_data(vec); });
+    run("Vector::ConstIterator", [&] { return sum_iterator(vec); });
+    run("range-for", [&] { return sum_range_for(vec); });
+    run("Vector::ConstReverseIterator", [&] { return sum_reverse(vec); });
+    run("std::accumulate over Vector iterators", [&] { return sum_accumulate(vec); });
+    run("old index based iterator", [&] { return sum_index_iterator(vec); });
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "bench.h"
+
+#include "../include/circular_list.h"
+#include "../include/forward_list.h"
+
+#include <forward_list>
+#include <list>
+#include <random>
+#include <vector>
+
+int main()
+{
+    constexpr unsigned num = 1000000;
+
+    std::vector<int> values(num);
+    std::mt19937 rng(42);
+    for (unsigned i = 0; i < num; i++)
+        values[i] = rng();
+
+    // The lists are filled outside of the timed region, every timed run
+    // reverses or sorts the same nodes again.
+    stlite::ForwardList<int> fl;
+    std::forward_list<int> std_fl;
+    stlite::CircularList<int> cl;
+    std::list<int> std_l;
+
+    for (unsigned i = 0; i < num; i++)
+    {
+        fl.push_front(values[i]);
+        std_fl.push_front(values[i]);
+        cl.push_back(values[i]);
+        std_l.push_back(values[i]);
+    }
+
+    printf("Reverse of %u nodes\n", num);
+
+    bench::run("stlite::ForwardList::reverse", num, [&] { fl.reverse(); });
+    bench::run("std::forward_list::reverse", num, [&] { std_fl.reverse(); });
+    bench::run("stlite::CircularList::reverse", num, [&] { cl.reverse(); });
+    bench::run("std::list::reverse", num, [&] { std_l.reverse(); });
+
+    printf("Sort of %u nodes\n", num);
+
+    // Sorting sorted input is not interesting, write the original random
+    // values back into the nodes before every run. The refill is timed too,
+    // it costs the same for every list.
+    auto refill = [&](auto& lst) {
+        unsigned i = 0;
+        for (auto it = lst.begin(); it != lst.end(); ++it)
+            *it = values[i++];
+    };
+
+    bench::run("stlite::ForwardList::sort", num, [&] { refill(fl); fl.sort(); });
+    bench::run("std::forward_list::sort", num, [&] { refill(std_fl); std_fl.sort(); });
+    bench::run("stlite::CircularList::sort", num, [&] { refill(cl); cl.sort(); });
+    bench::run("std::list::sort", num, [&] { refill(std_l); std_l.sort(); });
+
+    printf("Concatenation of two %u node lists\n", num / 2);
+
+    bench::run("stlite::CircularList::append (copy)", num / 2, [&] {
+        stlite::CircularList<int> a(values.data(), num / 2);
+        stlite::CircularList<int> b(values.data(), num / 2);
+        a.append(b);
+    });
+
+    bench::run("stlite::CircularList::splice", num / 2, [&] {
+        stlite::CircularList<int> a(values.data(), num / 2);
+        stlite::CircularList<int> b(values.data(), num / 2);
+        a.splice(b);
+    });
+
+    printf("Merge of two sorted %u node lists\n", num / 2);
+
+    bench::run("stlite::CircularList::merge", num, [&] {
+        stlite::CircularList<int> a(values.data(), num / 2);
+        stlite::CircularList<int> b(values.data() + num / 2, num / 2);
+        a.sort();
+        b.sort();
+        a.merge(b);
+    });
+
+    bench::run("std::list::merge", num, [&] {
+        std::list<int> a(values.begin(), values.begin() + num / 2);
+        std::list<int> b(values.begin() + num / 2, values.end());
+        a.sort();
+        b.sort();
+        a.merge(b);
+    });
+
+    return 0;
+}
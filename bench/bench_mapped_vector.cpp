@@ -0,0 +1,125 @@
+#include "bench.h"
+
+#include "../include/mapped_vector.h"
+#include "../include/vector.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+// Loading a file of fixed-size records: reading it and appending the records
+// to a Vector or a std::vector against mapping it with MappedVector. The
+// file is in the page cache after it has been written, so the reads measure
+// the copying and not the disk. Mapping costs only the page table setup of
+// the pages which are touched; the resident memory of the process is
+// printed after each load.
+
+constexpr unsigned records = 1 << 21;
+constexpr unsigned chunk = 4096;
+
+struct Record
+{
+    unsigned long id;
+    double values[3];
+};
+
+static char path[] = "/tmp/bench_mapped_vector.XXXXXX";
+
+// Resident set size in MB
+static double rss()
+{
+    FILE* f = fopen("/proc/self/statm", "r");
+    unsigned long pages = 0, resident = 0;
+    if (f)
+    {
+        if (fscanf(f, "%lu %lu", &pages, &resident) != 2)
+            resident = 0;
+        fclose(f);
+    }
+    return resident * (double) sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+// Read the file in chunks and pass each record to f
+template <class F>
+static void read_records(F f)
+{
+    static Record buffer[chunk];
+    int fd = open(path, O_RDONLY);
+    long n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+        for (long i = 0; i < n / (long) sizeof(Record); i++)
+            f(buffer[i]);
+    close(fd);
+}
+
+template <class V>
+static double sum(const V& vec)
+{
+    double s = 0;
+    for (unsigned i = 0; i < vec.size(); i++)
+        s += vec[i].values[0];
+    return s;
+}
+
+int main()
+{
+    int fd = mkstemp(path);
+    close(fd);
+
+    {
+        stlite::MappedVector<Record> out;
+        out.create(path);
+        out.reserve(records);
+        for (unsigned i = 0; i < records; i++)
+            out.push_back(Record{ i, { i * 1.0, i * 2.0, i * 3.0 } });
+    }
+
+    double bytes = (double) records * sizeof(Record);
+    printf("%u records, %.0f MB, rss %.1f MB\n", records, bytes / (1 << 20), rss());
+
+    bench::bandwidth("Vector read + push_back (reserved)", bytes, [] {
+        stlite::Vector<Record> vec;
+        vec.reserve(records);
+        read_records([&](const Record& r) { vec.push_back(r); });
+        bench::do_not_optimize(vec.data());
+    });
+
+    bench::bandwidth("std::vector read + push_back", bytes, [] {
+        std::vector<Record> vec;
+        read_records([&](const Record& r) { vec.push_back(r); });
+        bench::do_not_optimize(vec.data());
+    });
+
+    bench::bandwidth("MappedVector open", bytes, [] {
+        stlite::MappedVector<Record> vec;
+        vec.open(path);
+        bench::do_not_optimize(vec.data());
+    });
+
+    bench::bandwidth("MappedVector open + scan", bytes, [] {
+        stlite::MappedVector<Record> vec;
+        vec.open(path);
+        bench::do_not_optimize(sum(vec));
+    });
+
+    double before = rss();
+    stlite::Vector<Record> loaded;
+    loaded.reserve(records);
+    read_records([&](const Record& r) { loaded.push_back(r); });
+    printf("Vector loaded: rss +%.1f MB\n", rss() - before);
+
+    before = rss();
+    stlite::MappedVector<Record> mapped;
+    mapped.open(path);
+    printf("MappedVector opened: rss +%.1f MB\n", rss() - before);
+    bench::do_not_optimize(sum(mapped));
+    printf("MappedVector scanned: rss +%.1f MB, shared with the page cache\n", rss() - before);
+
+    bench::bandwidth("Vector scan", bytes, [&] { bench::do_not_optimize(sum(loaded)); });
+    bench::bandwidth("MappedVector scan", bytes, [&] { bench::do_not_optimize(sum(mapped)); });
+
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+
+#include "../include/execution.h"
+#include "../include/vector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Scaling of the parallel algorithms from one thread up to the number of CPUs,
+// or to the number given as the first argument. Every thread count uses a
+// pool of its own, so the default pool plays no part.
+
+constexpr unsigned elements = 1 << 24;
+
+static stlite::Vector<int> input(elements);
+static stlite::Vector<int> work(elements);
+static stlite::Vector<int> out(elements);
+
+static void run_threads(unsigned threads)
+{
+    stlite::ThreadPool pool(threads - 1);
+    stlite::ParallelPolicy par(pool);
+
+    printf("%u thread(s)\n", threads);
+
+    bench::bandwidth("fill", elements * sizeof(int),
+                     [&] { stlite::fill(par, work.begin(), work.end(), 7); });
+
+    bench::bandwidth("copy", 2.0 * elements * sizeof(int),
+                     [&] { stlite::copy(par, input.begin(), input.end(), out.begin()); });
+
+    bench::bandwidth("transform", 2.0 * elements * sizeof(int), [&] {
+        stlite::transform(par, input.begin(), input.end(), out.begin(),
+                          [](int x) { return 3 * x + 1; });
+    });
+
+    bench::bandwidth("reduce", elements * sizeof(int), [&] {
+        bench::do_not_optimize(stlite::reduce(par, input.begin(), input.end(), 0LL));
+    });
+
+    // Heavier work per element, so the threads aren't limited by the memory
+    bench::run("for_each (compute)", elements, [&] {
+        stlite::for_each(par, work.begin(), work.end(), [](int& x) {
+            unsigned h = x;
+            for (unsigned i = 0; i < 16; i++)
+                h = h * 2654435761u + 1;
+            x = h;
+        });
+    });
+
+    // The copy of the input is part of the measured time
+    bench::run("sort", elements, [&] {
+        memcpy(work.data(), input.data(), elements * sizeof(int));
+        stlite::sort(par, work.begin(), work.end());
+    }, 3);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned max_threads = stlite::hardware_concurrency();
+    if (argc > 1)
+        max_threads = atoi(argv[1]);
+    if (max_threads < 1)
+        max_threads = 1;
+
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+        input[i] = rand();
+
+    printf("%u ints, up to %u thread(s)\n", elements, max_threads);
+
+    for (unsigned threads = 1; threads <= max_threads; threads++)
+        run_threads(threads);
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "bench.h"
+
+#include "../include/persistent_vector.h"
+#include "../include/vector.h"
+
+int main()
+{
+    constexpr unsigned table_size = 100000;
+    constexpr unsigned requests = 1000;
+
+    stlite::Vector<unsigned> vec;
+    stlite::TransientVector<unsigned> builder;
+    for (unsigned i = 0; i < table_size; i++)
+    {
+        vec.push_back(i);
+        builder.push_back(i);
+    }
+    stlite::PersistentVector<unsigned> pvec = builder.persistent();
+
+    printf("Snapshot + modify one entry of a %u entry table, %u requests\n",
+           table_size, requests);
+
+    bench::run("stlite::Vector copy + operator[]", requests, [&] {
+        for (unsigned r = 0; r < requests; r++)
+        {
+            stlite::Vector<unsigned> snapshot(vec);
+            snapshot[(r * 7919) % table_size] = r;
+            bench::do_not_optimize(snapshot.data());
+        }
+    });
+
+    bench::run("stlite::PersistentVector copy + set", requests, [&] {
+        for (unsigned r = 0; r < requests; r++)
+        {
+            stlite::PersistentVector<unsigned> snapshot(pvec);
+            stlite::PersistentVector<unsigned> modified =
+                snapshot.set((r * 7919) % table_size, r);
+            bench::do_not_optimize(modified[0]);
+        }
+    });
+
+    printf("Build a %u entry table\n", table_size);
+
+    bench::run("stlite::Vector::push_back", table_size, [&] {
+        stlite::Vector<unsigned> v;
+        for (unsigned i = 0; i < table_size; i++)
+            v.push_back(i);
+        bench::do_not_optimize(v.data());
+    });
+
+    bench::run("stlite::PersistentVector::push_back", table_size, [&] {
+        stlite::PersistentVector<unsigned> v;
+        for (unsigned i = 0; i < table_size; i++)
+            v = v.push_back(i);
+        bench::do_not_optimize(v[0]);
+    });
+
+    bench::run("stlite::TransientVector::push_back", table_size, [&] {
+        stlite::TransientVector<unsigned> t;
+        for (unsigned i = 0; i < table_size; i++)
+            t.push_back(i);
+        stlite::PersistentVector<unsigned> v = t.persistent();
+        bench::do_not_optimize(v[0]);
+    });
+
+    printf("Read all %u entries\n", table_size);
+
+    bench::run("stlite::Vector::operator[]", table_size, [&] {
+        unsigned long sum = 0;
+        for (unsigned i = 0; i < table_size; i++)
+            sum += vec[i];
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("stlite::PersistentVector::operator[]", table_size, [&] {
+        unsigned long sum = 0;
+        for (unsigned i = 0; i < table_size; i++)
+            sum += pvec[i];
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("stlite::PersistentVector::Iterator", table_size, [&] {
+        unsigned long sum = 0;
+        for (auto it = pvec.begin(); it != pvec.end(); ++it)
+            sum += *it;
+        bench::do_not_optimize(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "bench.h"
+
+#include "../include/circular_list.h"
+#include "../include/priority_queue.h"
+
+#include <queue>
+#include <stdlib.h>
+#include <vector>
+
+// Push n random values and pop them all, smallest first, as a scheduler
+// does with its timers. The sorted list needs O(n) per push, so it runs on
+// fewer elements.
+
+constexpr unsigned elements = 1000000;
+constexpr unsigned list_elements = 20000;
+
+static std::vector<int> values;
+
+template <unsigned Arity>
+static void run_heap(const char* name, unsigned n)
+{
+    bench::run(name, 2 * n, [n] {
+        stlite::PriorityQueue<int, stlite::Greater<int>, Arity> queue;
+        for (unsigned i = 0; i < n; i++)
+            queue.push(values[i]);
+
+        long long sum = 0;
+        while (!queue.empty())
+        {
+            sum += queue.top();
+            queue.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+int main()
+{
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+        values.push_back(rand());
+
+    printf("%u pushes and pops\n", elements);
+
+    run_heap<2>("PriorityQueue, arity 2", elements);
+    run_heap<4>("PriorityQueue, arity 4", elements);
+    run_heap<8>("PriorityQueue, arity 8", elements);
+
+    bench::run("std::priority_queue", 2 * elements, [] {
+        std::priority_queue<int, std::vector<int>, std::greater<int>> queue;
+        for (unsigned i = 0; i < elements; i++)
+            queue.push(values[i]);
+
+        long long sum = 0;
+        while (!queue.empty())
+        {
+            sum += queue.top();
+            queue.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("PriorityQueue, heapify", 2 * elements, [] {
+        stlite::PriorityQueue<int, stlite::Greater<int>> queue(values.begin(), values.end());
+
+        long long sum = 0;
+        while (!queue.empty())
+        {
+            sum += queue.top();
+            queue.pop();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("IndexedPriorityQueue, push and update", 2 * elements, [] {
+        stlite::IndexedPriorityQueue<int, stlite::Greater<int>> queue(elements);
+        for (unsigned i = 0; i < elements; i++)
+            queue.push(i, values[i]);
+        for (unsigned i = 0; i < elements; i++)
+            queue.update(i, values[i] / 2);
+        bench::do_not_optimize(queue.top_key());
+    });
+
+    printf("%u pushes and pops\n", list_elements);
+
+    run_heap<4>("PriorityQueue, arity 4", list_elements);
+
+    bench::run("Sorted CircularList", 2 * list_elements, [] {
+        stlite::CircularList<int> lst;
+        for (unsigned i = 0; i < list_elements; i++)
+        {
+            int x = values[i];
+            if (lst.empty() || x >= lst.back())
+            {
+                lst.push_back(x);
+            }
+            else
+            {
+                // Insert before the first larger element
+                stlite::CircularList<int>::Iterator it = lst.begin();
+                while (*it <= x)
+                    ++it;
+                lst.insert(it, x);
+            }
+        }
+
+        long long sum = 0;
+        while (!lst.empty())
+        {
+            sum += lst.front();
+            lst.pop_front();
+        }
+        bench::do_not_optimize(sum);
+    }, 1);
+
+    return 0;
+}
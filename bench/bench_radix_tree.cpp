@@ -0,0 +1,155 @@
+#include "bench.h"
+
+#include "../include/radix_tree.h"
+#include "../include/set.h"
+
+#include <set>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// String lookups in a RadixTree against a Set<std::string> and a
+// std::set<std::string>. The keys look like request paths, so they share
+// long prefixes which the sets compare again at every level of the tree.
+
+constexpr unsigned elements = 200000;
+
+static const char* segments[] = { "api", "v1", "v2", "users", "orders", "items",
+                                  "static", "img", "css", "admin", "search", "cart" };
+
+std::string random_path()
+{
+    std::string path;
+    unsigned depth = 2 + rand() % 4;
+    for (unsigned i = 0; i < depth; i++)
+    {
+        path += '/';
+        path += segments[rand() % 12];
+    }
+    path += '/';
+    path += std::to_string(rand() % 100000);
+    return path;
+}
+
+int main()
+{
+    srand(1);
+
+    std::vector<std::string> keys;
+    for (unsigned i = 0; i < elements; i++)
+        keys.push_back(random_path());
+
+    std::vector<std::string> misses;
+    for (unsigned i = 0; i < elements; i++)
+        misses.push_back(random_path() + "x");
+
+    // Queries in random order
+    std::vector<std::string> queries(keys);
+    for (unsigned i = elements - 1; i > 0; i--)
+        std::swap(queries[i], queries[rand() % (i + 1)]);
+
+    stlite::Set<std::string> set;
+    stlite::RadixTree<unsigned> tree;
+
+    bench::run("Set<std::string> insert", elements, [&] {
+        set.clear();
+        for (unsigned i = 0; i < elements; i++)
+            set.insert(keys[i]);
+    }, 1);
+
+    std::set<std::string> sset;
+    bench::run("std::set<std::string> insert", elements, [&] {
+        sset.clear();
+        for (unsigned i = 0; i < elements; i++)
+            sset.insert(keys[i]);
+    }, 1);
+
+    bench::run("RadixTree insert", elements, [&] {
+        tree.clear();
+        for (unsigned i = 0; i < elements; i++)
+            tree.insert(keys[i], i);
+    }, 1);
+
+    printf("%u distinct keys\n", tree.size());
+
+    bench::run("Set<std::string> find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += set.count(queries[i]);
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("std::set<std::string> find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += sset.count(queries[i]);
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("RadixTree find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += tree.contains(queries[i]);
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("Set<std::string> find missing", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += set.count(misses[i]);
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("RadixTree find missing", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += tree.contains(misses[i]);
+        bench::do_not_optimize(n);
+    });
+
+    // Routing: the longest stored route which is a prefix of the request.
+    // With the Set every prefix of the request is looked up, longest first.
+    stlite::Set<std::string> route_set;
+    stlite::RadixTree<unsigned> routes;
+    for (unsigned i = 0; i < elements / 10; i++)
+    {
+        std::string route = keys[i].substr(0, keys[i].rfind('/') + 1);
+        route_set.insert(route);
+        routes.insert(route, i);
+    }
+
+    bench::run("Set<std::string> longest prefix", elements, [&] {
+        size_t sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+        {
+            const std::string& q = queries[i];
+            for (size_t len = q.size() + 1; len-- > 0;)
+                if (route_set.count(q.substr(0, len)))
+                {
+                    sum += len;
+                    break;
+                }
+        }
+        bench::do_not_optimize(sum);
+    }, 3);
+
+    bench::run("RadixTree longest prefix", elements, [&] {
+        size_t sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+        {
+            stlite::size_t len = 0;
+            if (routes.longest_prefix(queries[i], &len))
+                sum += len;
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("RadixTree prefix scan", 1000, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < 1000; i++)
+            routes.for_each_prefix(queries[i].substr(0, 10), [&](const char*, size_t, const unsigned&) { n++; });
+        bench::do_not_optimize(n);
+    });
+
+    return 0;
+}
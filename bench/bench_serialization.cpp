@@ -0,0 +1,97 @@
+#include "bench.h"
+
+#include "../include/serialization.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+// Saving and loading containers in the binary format. The file stays in the
+// page cache, so the numbers measure the copying and the checksum and not
+// the disk. The raw write() and read() of the same bytes without a header or
+// a checksum are the baseline.
+
+constexpr unsigned elements = 1 << 24;
+constexpr unsigned list_elements = 1 << 20;
+
+static char path[] = "/tmp/bench_serialization.XXXXXX";
+
+int main()
+{
+    int fd = mkstemp(path);
+    close(fd);
+
+    stlite::Vector<int> vec(elements);
+    for (unsigned i = 0; i < elements; i++)
+        vec[i] = rand();
+
+    double bytes = (double) elements * sizeof(int);
+
+    bench::bandwidth("checksum", bytes, [&] {
+        bench::do_not_optimize(stlite::serial_checksum(vec.data(), bytes));
+    });
+
+    bench::bandwidth("raw write", bytes, [&] {
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        stlite::serial_write(fd, vec.data(), bytes);
+        close(fd);
+    });
+
+    bench::bandwidth("raw read", bytes, [&] {
+        stlite::Vector<int> loaded(elements);
+        int fd = open(path, O_RDONLY);
+        stlite::serial_read(fd, loaded.data(), bytes);
+        close(fd);
+        bench::do_not_optimize(loaded.data());
+    });
+
+    bench::bandwidth("Vector save", bytes, [&] { stlite::save(path, vec); });
+
+    bench::bandwidth("Vector load", bytes, [&] {
+        stlite::Vector<int> loaded;
+        stlite::load(path, loaded);
+        bench::do_not_optimize(loaded.data());
+    });
+
+    bench::bandwidth("SerialView open", bytes, [&] {
+        stlite::SerialView<int> view;
+        view.open(path);
+        bench::do_not_optimize(view.data());
+    });
+
+    bench::bandwidth("SerialView open and verify", bytes, [&] {
+        stlite::SerialView<int> view;
+        view.open(path, true);
+        bench::do_not_optimize(view.data());
+    });
+
+    stlite::CircularList<int> lst;
+    stlite::Set<int> set;
+    for (unsigned i = 0; i < list_elements; i++)
+    {
+        lst.push_back(vec[i]);
+        set.insert(vec[i]);
+    }
+
+    double list_bytes = (double) list_elements * sizeof(int);
+
+    bench::bandwidth("CircularList save", list_bytes, [&] { stlite::save(path, lst); });
+
+    bench::bandwidth("CircularList load", list_bytes, [&] {
+        stlite::CircularList<int> loaded;
+        stlite::load(path, loaded);
+        bench::do_not_optimize(loaded.size());
+    });
+
+    double set_bytes = (double) set.size() * sizeof(int);
+
+    bench::bandwidth("Set save", set_bytes, [&] { stlite::save(path, set); });
+
+    bench::bandwidth("Set load", set_bytes, [&] {
+        stlite::Set<int> loaded;
+        stlite::load(path, loaded);
+        bench::do_not_optimize(loaded.size());
+    });
+
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/simd_algorithms.h"
+#include "../include/vector.h"
+
+#include <stdlib.h>
+
+namespace simd = stlite::simd;
+
+static const char* level_names[] = { "scalar", "sse2", "avx2" };
+
+// Scan the same range rounds times. The small range stays in L2 cache and
+// shows the speed of the kernels, the large one the memory bandwidth.
+template <class Container>
+static void run_kernels(const char* type, const Container& c, unsigned rounds)
+{
+    typedef typename Container::ConstIterator It;
+    It first = c.begin();
+    It last = c.end();
+    double bytes = (double) c.size() * sizeof(*first) * rounds;
+    char name[64];
+
+    for (int l = simd::scalar; l <= simd::detected_level(); l++)
+    {
+        simd::set_level(static_cast<simd::Level>(l));
+        const char* level = level_names[l];
+
+        // The value is not in the range, so find scans all of it
+        snprintf(name, sizeof(name), "%s find (%s)", type, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::find(first, last, -1));
+        });
+
+        snprintf(name, sizeof(name), "%s count (%s)", type, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::count(first, last, 7));
+        });
+
+        snprintf(name, sizeof(name), "%s min_element (%s)", type, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::min_element(first, last));
+        });
+
+        snprintf(name, sizeof(name), "%s max_element (%s)", type, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::max_element(first, last));
+        });
+
+        snprintf(name, sizeof(name), "%s sum (%s)", type, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::sum(first, last));
+        });
+    }
+
+    simd::set_level(simd::detected_level());
+}
+
+template <class Container>
+static void fill(Container& c)
+{
+    for (unsigned i = 0; i < c.size(); i++)
+        c[i] = rand() % 1000;
+}
+
+// The same kernels over a cache line aligned range and over the same range
+// shifted by one element, so that a quarter of the 16-byte loads and half of
+// the 32-byte loads span two cache lines. The range fits in L1 or L2 cache,
+// from memory the difference disappears in the bandwidth.
+static void run_alignment(unsigned n, unsigned rounds)
+{
+    stlite::Vector<float, stlite::Allocator<float, stlite::cache_line_size>> vec(n + 16);
+    fill(vec);
+
+    const float* aligned = vec.data();
+    const float* misaligned = vec.data() + 1;
+    double bytes = (double) n * sizeof(float) * rounds;
+    const char* level = level_names[simd::level()];
+    char name[64];
+
+    for (int a = 0; a < 2; a++)
+    {
+        const float* first = a == 0 ? aligned : misaligned;
+        const char* kind = a == 0 ? "aligned" : "misaligned";
+
+        snprintf(name, sizeof(name), "float count, %u %s (%s)", n, kind, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::count(first, first + n, 7.0f));
+        });
+
+        snprintf(name, sizeof(name), "float sum, %u %s (%s)", n, kind, level);
+        bench::bandwidth(name, bytes, [&] {
+            for (unsigned r = 0; r < rounds; r++)
+                bench::do_not_optimize(simd::sum(first, first + n));
+        });
+    }
+}
+
+int main()
+{
+    printf("Detected level: %s\n", level_names[simd::detected_level()]);
+
+    const unsigned small = 32 * 1024;
+    const unsigned large = 32 * 1024 * 1024;
+
+    stlite::Vector<int> ints(small);
+    stlite::Array<float> floats(small);
+    fill(ints);
+    fill(floats);
+
+    printf("\n%u elements (in cache), 1000 rounds\n", small);
+    run_kernels("Vector<int>", ints, 1000);
+    run_kernels("Array<float>", floats, 1000);
+
+    stlite::Vector<int> big_ints(large);
+    stlite::Array<float> big_floats(large);
+    fill(big_ints);
+    fill(big_floats);
+
+    printf("\n%u elements (in memory), 1 round\n", large);
+    run_kernels("Vector<int>", big_ints, 1);
+    run_kernels("Array<float>", big_floats, 1);
+
+    printf("\nAligned and misaligned ranges\n");
+    run_alignment(4 * 1024, 10000);
+    run_alignment(32 * 1024, 1000);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "bench.h"
+
+#include "../include/concurrent_skip_list.h"
+#include "../include/set.h"
+#include "../include/skip_list.h"
+#include "../include/thread_pool.h"
+
+#include <pthread.h>
+#include <set>
+#include <stdlib.h>
+
+// SkipList against Set and std::set in one thread, then ConcurrentSkipList against a Set
+// behind a mutex from one thread up to the number of CPUs, or to the number
+// given as the first argument. The threads run a mix of 80% lookups, 10%
+// insertions and 10% erasures of random keys.
+
+constexpr unsigned elements = 1 << 18;
+constexpr unsigned ops_per_thread = 1 << 17;
+
+static unsigned* keys;
+
+struct LockedSet
+{
+    stlite::Set<unsigned> set;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    bool insert(unsigned x)
+    {
+        pthread_mutex_lock(&mutex);
+        bool inserted = set.count(x) == 0;
+        if (inserted)
+            set.insert(x);
+        pthread_mutex_unlock(&mutex);
+        return inserted;
+    }
+
+    // Set::erase does nothing yet, the erasures only cost a lookup
+    bool erase(unsigned x)
+    {
+        pthread_mutex_lock(&mutex);
+        bool found = set.count(x) != 0;
+        set.erase(x);
+        pthread_mutex_unlock(&mutex);
+        return found;
+    }
+
+    bool contains(unsigned x)
+    {
+        pthread_mutex_lock(&mutex);
+        bool found = set.count(x) != 0;
+        pthread_mutex_unlock(&mutex);
+        return found;
+    }
+};
+
+template <class S>
+struct Worker
+{
+    S* set;
+    unsigned seed;
+    unsigned found;
+    pthread_t thread;
+
+    static void* main(void* p)
+    {
+        Worker* w = static_cast<Worker*>(p);
+        unsigned long long state = w->seed;
+        unsigned found = 0;
+
+        for (unsigned i = 0; i < ops_per_thread; i++)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned r = state >> 33;
+            unsigned x = keys[r % elements] + (r & 1);
+            unsigned op = (state >> 20) % 10;
+            if (op == 0)
+                w->set->insert(x);
+            else if (op == 1)
+                w->set->erase(x);
+            else
+                found += w->set->contains(x);
+        }
+
+        w->found = found;
+        return nullptr;
+    }
+};
+
+template <class S>
+void run_threads(const char* name, S& set, unsigned threads)
+{
+    char label[64];
+    snprintf(label, sizeof(label), "%s, %u thread(s)", name, threads);
+
+    Worker<S> workers[64];
+    bench::run(label, (unsigned long) threads * ops_per_thread, [&] {
+        for (unsigned i = 0; i < threads; i++)
+        {
+            workers[i].set = &set;
+            workers[i].seed = i + 1;
+            pthread_create(&workers[i].thread, nullptr, Worker<S>::main, &workers[i]);
+        }
+        for (unsigned i = 0; i < threads; i++)
+            pthread_join(workers[i].thread, nullptr);
+    }, 3);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned max_threads = stlite::hardware_concurrency();
+    if (argc > 1)
+        max_threads = atoi(argv[1]);
+    if (max_threads < 1)
+        max_threads = 1;
+    if (max_threads > 64)
+        max_threads = 64;
+
+    // Even keys are inserted first, the odd ones are the misses
+    keys = new unsigned[elements];
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+        keys[i] = (unsigned) rand() * 2;
+
+    stlite::Set<unsigned> set;
+    stlite::SkipList<unsigned> list;
+
+    bench::run("Set insert", elements, [&] {
+        set.clear();
+        for (unsigned i = 0; i < elements; i++)
+            set.insert(keys[i]);
+    }, 1);
+
+    std::set<unsigned> sset;
+    bench::run("std::set insert", elements, [&] {
+        sset.clear();
+        for (unsigned i = 0; i < elements; i++)
+            sset.insert(keys[i]);
+    }, 1);
+
+    bench::run("SkipList insert", elements, [&] {
+        list.clear();
+        for (unsigned i = 0; i < elements; i++)
+            list.insert(keys[i]);
+    }, 1);
+
+    bench::run("Set find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += set.count(keys[i] + (i & 1));
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("std::set find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += sset.count(keys[i] + (i & 1));
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("SkipList find", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += list.count(keys[i] + (i & 1));
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("SkipList in-order scan", list.size(), [&] {
+        unsigned long sum = 0;
+        for (unsigned x : list)
+            sum += x;
+        bench::do_not_optimize(sum);
+    });
+
+    printf("%u keys, up to %u thread(s)\n", elements, max_threads);
+
+    LockedSet locked;
+    stlite::ConcurrentSkipList<unsigned> concurrent;
+    for (unsigned i = 0; i < elements; i++)
+    {
+        locked.set.insert(keys[i]);
+        concurrent.insert(keys[i]);
+    }
+
+    for (unsigned threads = 1; threads <= max_threads; threads++)
+    {
+        run_threads("Set with a mutex", locked, threads);
+        run_threads("ConcurrentSkipList", concurrent, threads);
+    }
+
+    delete[] keys;
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "bench.h"
+
+#include "../include/soa_vector.h"
+#include "../include/vector.h"
+
+#include <stdlib.h>
+
+// Scanning one field of records stored as an array of structures (Vector of
+// records) and as a structure of arrays (SoAVector). The record is 32 bytes,
+// so a scan of its 4-byte price reads 8 times more memory in the array of
+// structures.
+
+constexpr unsigned elements = 4000000;
+
+struct Record
+{
+    int id;
+    float price;
+    int quantity;
+    int flags;
+    double timestamp;
+    long long account;
+};
+
+typedef stlite::SoAVector<int, float, int, int, double, long long> Records;
+
+int main()
+{
+    stlite::Vector<Record> aos(elements);
+    Records soa;
+    soa.reserve(elements);
+
+    srand(1);
+    for (unsigned i = 0; i < elements; i++)
+    {
+        Record r = { (int) i, (float) (rand() % 1000), rand() % 100, 0, i * 1.0, i };
+        aos[i] = r;
+        soa.push_back(r.id, r.price, r.quantity, r.flags, r.timestamp, r.account);
+    }
+
+    printf("%u records of %u bytes\n", elements, (unsigned) sizeof(Record));
+
+    bench::run("AoS sum of one field", elements, [&] {
+        float sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += aos[i].price;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("SoA sum of one field", elements, [&] {
+        stlite::Span<const float> prices = soa.column<1>();
+        float sum = 0;
+        for (unsigned i = 0; i < prices.size(); i++)
+            sum += prices[i];
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("AoS count of a predicate", elements, [&] {
+        unsigned n = 0;
+        for (unsigned i = 0; i < elements; i++)
+            n += aos[i].quantity > 50;
+        bench::do_not_optimize(n);
+    });
+
+    bench::run("SoA count of a predicate", elements, [&] {
+        stlite::Span<const int> quantities = soa.column<2>();
+        unsigned n = 0;
+        for (unsigned i = 0; i < quantities.size(); i++)
+            n += quantities[i] > 50;
+        bench::do_not_optimize(n);
+    });
+
+    // Reading two fields, the structure of arrays reads two streams
+    bench::run("AoS sum of two fields", elements, [&] {
+        double sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += aos[i].price * aos[i].quantity;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("SoA sum of two fields", elements, [&] {
+        const float* prices = soa.data<1>();
+        const int* quantities = soa.data<2>();
+        double sum = 0;
+        for (unsigned i = 0; i < elements; i++)
+            sum += prices[i] * quantities[i];
+        bench::do_not_optimize(sum);
+    });
+
+    // Whole rows, where the array of structures has the advantage
+    bench::run("AoS read whole rows", elements, [&] {
+        long long sum = 0;
+        for (unsigned i = 0; i < elements; i += 7)
+            sum += aos[i].id + aos[i].quantity + aos[i].flags + aos[i].account;
+        bench::do_not_optimize(sum);
+    });
+
+    bench::run("SoA read whole rows", elements, [&] {
+        long long sum = 0;
+        for (unsigned i = 0; i < elements; i += 7)
+        {
+            Records::ConstReference row = soa[i];
+            sum += row.get<0>() + row.get<2>() + row.get<3>() + row.get<5>();
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/static_array.h"
+#include "../include/static_vector.h"
+#include "../include/vector.h"
+
+constexpr unsigned packets = 1000000;
+constexpr unsigned packet_size = 64;  // In 32-bit words
+
+// Per-packet work: fill a scratch buffer and checksum it
+
+template <class Buffer>
+static unsigned checksum(const Buffer& buf)
+{
+    unsigned sum = 0;
+    for (unsigned i = 0; i < packet_size; i++)
+        sum = sum * 31 + buf[i];
+    return sum;
+}
+
+int main()
+{
+    printf("Per-packet %u word scratch buffer, %u packets\n", packet_size, packets);
+
+    bench::run("stlite::Array<unsigned>", packets, [&] {
+        unsigned total = 0;
+        for (unsigned p = 0; p < packets; p++)
+        {
+            stlite::Array<unsigned> buf(packet_size);
+            for (unsigned i = 0; i < packet_size; i++)
+                buf[i] = p + i;
+            total += checksum(buf);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    bench::run("stlite::StaticArray<unsigned, N>", packets, [&] {
+        unsigned total = 0;
+        for (unsigned p = 0; p < packets; p++)
+        {
+            stlite::StaticArray<unsigned, packet_size> buf;
+            for (unsigned i = 0; i < packet_size; i++)
+                buf[i] = p + i;
+            total += checksum(buf);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    bench::run("stlite::Vector<unsigned>::push_back", packets, [&] {
+        unsigned total = 0;
+        for (unsigned p = 0; p < packets; p++)
+        {
+            stlite::Vector<unsigned> buf;
+            for (unsigned i = 0; i < packet_size; i++)
+                buf.push_back(p + i);
+            total += checksum(buf);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    bench::run("stlite::StaticVector<unsigned, N>::push_back", packets, [&] {
+        unsigned total = 0;
+        for (unsigned p = 0; p < packets; p++)
+        {
+            stlite::StaticVector<unsigned, packet_size> buf;
+            for (unsigned i = 0; i < packet_size; i++)
+                buf.push_back(p + i);
+            total += checksum(buf);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    // The size lives next to the inline elements, so every push_back() has
+    // to store it back to memory before the next element is written. Filling
+    // the buffer through resize() and operator[] avoids that.
+    bench::run("stlite::StaticVector<unsigned, N>::resize", packets, [&] {
+        unsigned total = 0;
+        for (unsigned p = 0; p < packets; p++)
+        {
+            stlite::StaticVector<unsigned, packet_size> buf;
+            buf.resize(packet_size);
+            for (unsigned i = 0; i < packet_size; i++)
+                buf[i] = p + i;
+            total += checksum(buf);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    return 0;
+}
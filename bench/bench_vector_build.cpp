@@ -0,0 +1,113 @@
+#include "bench.h"
+
+#include "../include/array.h"
+#include "../include/forward_list.h"
+#include "../include/span.h"
+#include "../include/vector.h"
+
+#include <vector>
+
+// Building 10^7 element vectors from ranges: element by element with
+// push_back() into a reserved vector, against the bulk operations, which
+// compute the final size, allocate once and copy the range with memmove
+// when it is contiguous. push_back() without reserve() grows the vector by
+// vector_block_size elements, which is quadratic at this size and left out.
+
+constexpr unsigned elements = 10000000;
+constexpr unsigned chunk = 1000;
+
+int main()
+{
+    int* source = new int[elements];
+    for (unsigned i = 0; i < elements; i++)
+        source[i] = i;
+    std::vector<int> ssource(source, source + elements);
+
+    stlite::ForwardList<int> lst;
+    for (unsigned i = elements; i-- > 0;)
+        lst.push_front(i);
+
+    bench::run("Vector reserve and push_back from array", elements, [&] {
+        stlite::Vector<int> vec;
+        vec.reserve(elements);
+        for (unsigned i = 0; i < elements; i++)
+            vec.push_back(source[i]);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("Vector range constructor from array", elements, [&] {
+        stlite::Vector<int> vec(source, source + elements);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("Vector range constructor from std::vector", elements, [&] {
+        stlite::Vector<int> vec(ssource.begin(), ssource.end());
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("std::vector range constructor from array", elements, [&] {
+        std::vector<int> vec(source, source + elements);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("Array range constructor from array", elements, [&] {
+        stlite::Array<int> arr(source, source + elements);
+        bench::do_not_optimize(arr.data()[0]);
+    });
+
+    bench::run("Vector reserve and push_back from ForwardList", elements, [&] {
+        stlite::Vector<int> vec;
+        vec.reserve(elements);
+        for (int x : lst)
+            vec.push_back(x);
+        bench::do_not_optimize(vec.data()[0]);
+    }, 3);
+
+    bench::run("Vector range constructor from ForwardList", elements, [&] {
+        stlite::Vector<int> vec(lst.begin(), lst.end());
+        bench::do_not_optimize(vec.data()[0]);
+    }, 3);
+
+    bench::run("Vector fill constructor", elements, [&] {
+        stlite::Vector<int> vec(elements, 7);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("Vector resize", elements, [&] {
+        stlite::Vector<int> vec;
+        vec.resize(elements, 7);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("std::vector resize", elements, [&] {
+        std::vector<int> vec;
+        vec.resize(elements, 7);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    stlite::Vector<int> target;
+    bench::run("Vector assign from array", elements, [&] {
+        target.assign(source, source + elements);
+        bench::do_not_optimize(target.data()[0]);
+    });
+
+    // Chunks appended one after another, as when collecting batches
+    bench::run("Vector append_range of chunks", elements, [&] {
+        stlite::Vector<int> vec;
+        vec.reserve(elements);
+        for (unsigned i = 0; i < elements; i += chunk)
+            vec.append_range(stlite::Span<const int>(source + i, chunk));
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    bench::run("std::vector insert of chunks", elements, [&] {
+        std::vector<int> vec;
+        vec.reserve(elements);
+        for (unsigned i = 0; i < elements; i += chunk)
+            vec.insert(vec.end(), source + i, source + i + chunk);
+        bench::do_not_optimize(vec.data()[0]);
+    });
+
+    delete[] source;
+    return 0;
+}
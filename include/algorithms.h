@@ -21,20 +21,46 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#ifndef ALGORITHMS_H
+#define ALGORITHMS_H
+
+#include "allocator.h"
+#include "iterator.h"
+
 namespace stlite
 {
 
+// Function objects, the default comparators of the algorithms
+
 template <class T>
-void min(T a, T b);
+struct Less
+{
+    constexpr bool operator()(const T& a, const T& b) const { return a < b; }
+};
 
 template <class T>
-void max(T a, T b);
+struct Greater
+{
+    constexpr bool operator()(const T& a, const T& b) const { return b < a; }
+};
+
+template <class T>
+struct EqualTo
+{
+    constexpr bool operator()(const T& a, const T& b) const { return a == b; }
+};
+
+template <class T>
+const T& min(const T& a, const T& b);
+
+template <class T>
+const T& max(const T& a, const T& b);
 
 template <class T>
 void swap(T& a, T& b);
 
 template <class T>
-void copy(T* start, T* end, T* dst);
+void copy(const T* start, const T* end, T* dst);
 
 template <class T>
 void quick_sort(T* arr, unsigned len);
@@ -42,20 +68,122 @@ void quick_sort(T* arr, unsigned len);
 template <class T>
 int binary_search(T x, T* arr, unsigned len);
 
+// Linked list algorithms. Node is any element type with "value" and "next"
+// members and the lists are terminated with nullptr. Nodes are only relinked,
+// they are never allocated or copied.
+
+template <class Node>
+Node* list_reverse(Node* head);
+
+template <class Node>
+Node* list_merge(Node* a, Node* b);
+
+template <class Node>
+Node* list_sort(Node* head);
+
+// Iterator range algorithms. They work on ranges of any container iterators
+// and take the fast path when the range is contiguous (raw pointers, Vector,
+// Array, ...) and the elements are trivially copyable: copies become memmove,
+// fills of byte elements memset and finds of byte elements memchr.
+
+template <class InputIt>
+ptrdiff_t distance(InputIt first, InputIt last);
+
+template <class InputIt, class OutputIt>
+OutputIt copy(InputIt first, InputIt last, OutputIt dst);
+
+template <class ForwardIt, class T>
+void fill(ForwardIt first, ForwardIt last, const T& value);
+
+template <class InputIt, class T>
+InputIt find(InputIt first, InputIt last, const T& value);
+
+template <class InputIt, class Predicate>
+InputIt find_if(InputIt first, InputIt last, Predicate pred);
+
+template <class InputIt, class T>
+ptrdiff_t count(InputIt first, InputIt last, const T& value);
+
+template <class InputIt, class Predicate>
+ptrdiff_t count_if(InputIt first, InputIt last, Predicate pred);
+
+template <class InputIt, class OutputIt, class UnaryOperation>
+OutputIt transform(InputIt first, InputIt last, OutputIt dst, UnaryOperation op);
+
+template <class InputIt1, class InputIt2, class OutputIt, class BinaryOperation>
+OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt dst,
+                   BinaryOperation op);
+
+template <class InputIt, class T>
+T accumulate(InputIt first, InputIt last, T init);
+
+template <class InputIt, class T, class BinaryOperation>
+T accumulate(InputIt first, InputIt last, T init, BinaryOperation op);
+
+template <class InputIt, class T>
+T reduce(InputIt first, InputIt last, T init);
+
+template <class InputIt, class T, class BinaryOperation>
+T reduce(InputIt first, InputIt last, T init, BinaryOperation op);
+
+template <class InputIt, class Function>
+Function for_each(InputIt first, InputIt last, Function f);
+
+template <class BidirIt, class Predicate>
+BidirIt partition(BidirIt first, BidirIt last, Predicate pred);
+
+template <class ForwardIt>
+ForwardIt unique(ForwardIt first, ForwardIt last);
+
+template <class ForwardIt, class BinaryPredicate>
+ForwardIt unique(ForwardIt first, ForwardIt last, BinaryPredicate pred);
+
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+               OutputIt dst);
+
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+               OutputIt dst, Compare comp);
+
+template <class RandomIt>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last);
+
+template <class RandomIt, class Compare>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp);
+
+template <class RandomIt>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last);
+
+template <class RandomIt, class Compare>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp);
+
+template <class RandomIt>
+void sort(RandomIt first, RandomIt last);
+
+template <class RandomIt, class Compare>
+void sort(RandomIt first, RandomIt last, Compare comp);
+
+template <class RandomIt>
+void stable_sort(RandomIt first, RandomIt last);
+
+template <class RandomIt, class Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp);
+
 //====----------------------------------------------------------------------====
 // Implementations of methods
 //====----------------------------------------------------------------------====
 
 template <class T>
-void min(T a, T b)
+const T& min(const T& a, const T& b)
 {
-    return (a < b) ? a : b;
+    return (b < a) ? b : a;
 }
 
 template <class T>
-void max(T a, T b)
+const T& max(const T& a, const T& b)
 {
-    return (a > b) ? a : b;
+    return (a < b) ? b : a;
 }
 
 template <class T>
@@ -67,14 +195,25 @@ void swap(T& a, T& b)
 }
 
 template <class T>
-void copy(T* start, T* end, T* dst)
+static void copy_block(const T* start, const T* end, T* dst, BoolConstant<true>)
 {
-    unsigned char* p = (unsigned char *) start;
-    unsigned char* e = (unsigned char *) end;
-    unsigned char* d = (unsigned char *) dst;
+    if (start != end)
+        __builtin_memmove(dst, start, (end - start) * sizeof(T));
+}
 
-    while (p != e)
-        *d++ = *p++;
+template <class T>
+static void copy_block(const T* start, const T* end, T* dst, BoolConstant<false>)
+{
+    while (start != end)
+        *dst++ = *start++;
+}
+
+// Trivially copyable elements are copied as a block of bytes, the others are
+// copied one by one with their assignment operator.
+template <class T>
+void copy(const T* start, const T* end, T* dst)
+{
+    copy_block(start, end, dst, BoolConstant<__is_trivially_copyable(T)>());
 }
 
 template <class T>
@@ -134,4 +273,757 @@ int binary_search(T x, T* arr, unsigned len)
     return binary_search_helper(x, arr, 0, len-1);
 }
 
+// Reverse the list in place and return the new head
+template <class Node>
+Node* list_reverse(Node* head)
+{
+    Node* prev = nullptr;
+
+    while (head)
+    {
+        Node* next = head->next;
+        head->next = prev;
+        prev = head;
+        head = next;
+    }
+
+    return prev;
+}
+
+// Merge two sorted lists into one sorted list and return its head. The merge
+// is stable, on equal values nodes from "a" come first.
+template <class Node>
+Node* list_merge(Node* a, Node* b)
+{
+    Node* head = nullptr;
+    Node** tail = &head;
+
+    while (a && b)
+    {
+        if (b->value < a->value)
+        {
+            *tail = b;
+            b = b->next;
+        }
+        else
+        {
+            *tail = a;
+            a = a->next;
+        }
+        tail = &(*tail)->next;
+    }
+
+    *tail = a ? a : b;
+
+    return head;
+}
+
+// Stable bottom-up merge sort, return the new head of the list.
+//
+// bins[i] holds a sorted run of 2^i nodes (or nothing). Every node taken from
+// the input is merged into the bins the same way a binary counter is
+// incremented, so each node takes part in O(log n) merges and no recursion or
+// extra memory is needed. 64 bins are enough for any list that fits in memory.
+template <class Node>
+Node* list_sort(Node* head)
+{
+    constexpr unsigned max_bins = 64;
+    Node* bins[max_bins] = {};
+    unsigned used = 0;
+
+    while (head)
+    {
+        Node* carry = head;
+        head = head->next;
+        carry->next = nullptr;
+
+        unsigned i = 0;
+        while (i < used && bins[i])
+        {
+            // bins[i] holds older nodes, keep them first for stability
+            carry = list_merge(bins[i], carry);
+            bins[i] = nullptr;
+            i++;
+        }
+
+        bins[i] = carry;
+        if (i == used)
+            used++;
+    }
+
+    Node* result = nullptr;
+    for (unsigned i = 0; i < used; i++)
+        if (bins[i])
+            result = list_merge(bins[i], result);
+
+    return result;
+}
+
+// Iterator range algorithms. Calls between the algorithms are qualified with
+// stlite::, otherwise argument dependent lookup would also find the std
+// algorithms of the same name for std iterators.
+
+// True if the range [first, last) can be copied to dst with memmove
+template <class InputIt, class OutputIt>
+struct BitwiseCopyable
+    : BoolConstant<IteratorTraits<InputIt>::contiguous &&
+                   IteratorTraits<OutputIt>::contiguous &&
+                   IsSame<typename IteratorTraits<InputIt>::value_type,
+                          typename IteratorTraits<OutputIt>::value_type>::value &&
+                   __is_trivially_copyable(typename IteratorTraits<InputIt>::value_type)>
+{
+};
+
+// True for contiguous ranges of byte sized elements, which memset and memchr
+// can handle
+template <class It>
+struct ByteRange
+    : BoolConstant<IteratorTraits<It>::contiguous &&
+                   (IsSame<typename IteratorTraits<It>::value_type, char>::value ||
+                    IsSame<typename IteratorTraits<It>::value_type, signed char>::value ||
+                    IsSame<typename IteratorTraits<It>::value_type, unsigned char>::value)>
+{
+};
+
+template <class InputIt, class OutputIt>
+static OutputIt copy_helper(InputIt first, InputIt last, OutputIt dst, BoolConstant<true>)
+{
+    typedef typename IteratorTraits<InputIt>::value_type V;
+    ptrdiff_t n = last - first;
+    if (n == 0)
+        return dst;
+    __builtin_memmove(IteratorTraits<OutputIt>::pointer(dst),
+                      IteratorTraits<InputIt>::pointer(first), n * sizeof(V));
+    return dst + n;
+}
+
+template <class InputIt, class OutputIt>
+static OutputIt copy_helper(InputIt first, InputIt last, OutputIt dst, BoolConstant<false>)
+{
+    for (; first != last; ++first, ++dst)
+        *dst = *first;
+    return dst;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt copy(InputIt first, InputIt last, OutputIt dst)
+{
+    return copy_helper(first, last, dst, BitwiseCopyable<InputIt, OutputIt>());
+}
+
+// Iterators which can be subtracted are random access, the others are
+// counted
+template <class It>
+static auto distance_helper(It first, It last, int) -> decltype(ptrdiff_t(last - first))
+{
+    return last - first;
+}
+
+template <class It>
+static ptrdiff_t distance_helper(It first, It last, long)
+{
+    ptrdiff_t n = 0;
+    for (; first != last; ++first)
+        n++;
+    return n;
+}
+
+template <class InputIt>
+ptrdiff_t distance(InputIt first, InputIt last)
+{
+    return distance_helper(first, last, 0);
+}
+
+// Like copy(), but the elements are moved
+template <class InputIt, class OutputIt>
+static OutputIt move_helper(InputIt first, InputIt last, OutputIt dst, BoolConstant<false>)
+{
+    typedef typename IteratorTraits<InputIt>::value_type V;
+
+    for (; first != last; ++first, ++dst)
+        *dst = static_cast<V&&>(*first);
+    return dst;
+}
+
+template <class InputIt, class OutputIt>
+static OutputIt move_helper(InputIt first, InputIt last, OutputIt dst, BoolConstant<true>)
+{
+    return copy_helper(first, last, dst, BoolConstant<true>());
+}
+
+template <class InputIt, class OutputIt>
+static OutputIt move_range(InputIt first, InputIt last, OutputIt dst)
+{
+    return move_helper(first, last, dst, BitwiseCopyable<InputIt, OutputIt>());
+}
+
+template <class ForwardIt, class T>
+static void fill_helper(ForwardIt first, ForwardIt last, const T& value, BoolConstant<true>)
+{
+    typedef typename IteratorTraits<ForwardIt>::value_type V;
+    V v = value;
+    __builtin_memset(IteratorTraits<ForwardIt>::pointer(first), (unsigned char) v,
+                     last - first);
+}
+
+template <class ForwardIt, class T>
+static void fill_helper(ForwardIt first, ForwardIt last, const T& value, BoolConstant<false>)
+{
+    typedef typename IteratorTraits<ForwardIt>::value_type V;
+
+    // A local copy, the stores through first could otherwise alias value and
+    // force it to be reloaded on every iteration
+    const V v = value;
+    for (; first != last; ++first)
+        *first = v;
+}
+
+template <class ForwardIt, class T>
+void fill(ForwardIt first, ForwardIt last, const T& value)
+{
+    fill_helper(first, last, value, ByteRange<ForwardIt>());
+}
+
+template <class InputIt, class T>
+static InputIt find_helper(InputIt first, InputIt last, const T& value, BoolConstant<true>)
+{
+    typedef typename IteratorTraits<InputIt>::value_type V;
+
+    // The value doesn't fit into a byte element, so no element is equal to it
+    V v = value;
+    if (v != value)
+        return last;
+
+    const V* p = IteratorTraits<InputIt>::pointer(first);
+    const void* found = __builtin_memchr(p, (unsigned char) v, last - first);
+    return found ? first + (static_cast<const V*>(found) - p) : last;
+}
+
+template <class InputIt, class T>
+static InputIt find_helper(InputIt first, InputIt last, const T& value, BoolConstant<false>)
+{
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+template <class InputIt, class T>
+InputIt find(InputIt first, InputIt last, const T& value)
+{
+    return find_helper(first, last, value, ByteRange<InputIt>());
+}
+
+template <class InputIt, class Predicate>
+InputIt find_if(InputIt first, InputIt last, Predicate pred)
+{
+    for (; first != last; ++first)
+        if (pred(*first))
+            return first;
+    return last;
+}
+
+template <class InputIt, class T>
+ptrdiff_t count(InputIt first, InputIt last, const T& value)
+{
+    ptrdiff_t n = 0;
+    for (; first != last; ++first)
+        if (*first == value)
+            n++;
+    return n;
+}
+
+template <class InputIt, class Predicate>
+ptrdiff_t count_if(InputIt first, InputIt last, Predicate pred)
+{
+    ptrdiff_t n = 0;
+    for (; first != last; ++first)
+        if (pred(*first))
+            n++;
+    return n;
+}
+
+template <class InputIt, class OutputIt, class UnaryOperation>
+OutputIt transform(InputIt first, InputIt last, OutputIt dst, UnaryOperation op)
+{
+    for (; first != last; ++first, ++dst)
+        *dst = op(*first);
+    return dst;
+}
+
+template <class InputIt1, class InputIt2, class OutputIt, class BinaryOperation>
+OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt dst,
+                   BinaryOperation op)
+{
+    for (; first1 != last1; ++first1, ++first2, ++dst)
+        *dst = op(*first1, *first2);
+    return dst;
+}
+
+template <class InputIt, class T>
+T accumulate(InputIt first, InputIt last, T init)
+{
+    for (; first != last; ++first)
+        init = init + *first;
+    return init;
+}
+
+template <class InputIt, class T, class BinaryOperation>
+T accumulate(InputIt first, InputIt last, T init, BinaryOperation op)
+{
+    for (; first != last; ++first)
+        init = op(init, *first);
+    return init;
+}
+
+// Like accumulate(), but op must be associative, which lets the parallel
+// version (execution.h) add up parts of the range independently
+template <class InputIt, class T>
+T reduce(InputIt first, InputIt last, T init)
+{
+    return stlite::accumulate(first, last, init);
+}
+
+template <class InputIt, class T, class BinaryOperation>
+T reduce(InputIt first, InputIt last, T init, BinaryOperation op)
+{
+    return stlite::accumulate(first, last, init, op);
+}
+
+template <class InputIt, class Function>
+Function for_each(InputIt first, InputIt last, Function f)
+{
+    for (; first != last; ++first)
+        f(*first);
+    return f;
+}
+
+// Move the elements satisfying pred in front of the others and return the
+// start of the second group. The relative order is not preserved.
+template <class BidirIt, class Predicate>
+BidirIt partition(BidirIt first, BidirIt last, Predicate pred)
+{
+    while (true)
+    {
+        while (first != last && pred(*first))
+            ++first;
+        if (first == last)
+            return first;
+
+        do
+        {
+            --last;
+            if (first == last)
+                return first;
+        } while (!pred(*last));
+
+        stlite::swap(*first, *last);
+        ++first;
+    }
+}
+
+template <class ForwardIt>
+ForwardIt unique(ForwardIt first, ForwardIt last)
+{
+    typedef typename IteratorTraits<ForwardIt>::value_type V;
+    return stlite::unique(first, last, EqualTo<V>());
+}
+
+// Remove consecutive duplicates, return the end of the resulting range
+template <class ForwardIt, class BinaryPredicate>
+ForwardIt unique(ForwardIt first, ForwardIt last, BinaryPredicate pred)
+{
+    typedef typename IteratorTraits<ForwardIt>::value_type V;
+
+    if (first == last)
+        return last;
+
+    ForwardIt result = first;
+    while (++first != last)
+    {
+        if (!pred(*result, *first) && ++result != first)
+            *result = static_cast<V&&>(*first);
+    }
+
+    return ++result;
+}
+
+template <class InputIt1, class InputIt2, class OutputIt>
+OutputIt merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+               OutputIt dst)
+{
+    typedef typename IteratorTraits<InputIt1>::value_type V;
+    return stlite::merge(first1, last1, first2, last2, dst, Less<V>());
+}
+
+// Merge two sorted ranges into dst. The merge is stable, on equal elements
+// the ones from the first range come first. Once one of the ranges runs out
+// the rest of the other one is copied as a block.
+template <class InputIt1, class InputIt2, class OutputIt, class Compare>
+OutputIt merge(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+               OutputIt dst, Compare comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first2, *first1))
+        {
+            *dst = *first2;
+            ++first2;
+        }
+        else
+        {
+            *dst = *first1;
+            ++first1;
+        }
+        ++dst;
+    }
+
+    dst = stlite::copy(first1, last1, dst);
+    return stlite::copy(first2, last2, dst);
+}
+
+// Helpers of the sorting and selection algorithms
+
+template <class RandomIt, class Compare>
+static void insertion_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+
+    if (first == last)
+        return;
+
+    for (RandomIt i = first + 1; i != last; ++i)
+    {
+        V tmp = static_cast<V&&>(*i);
+        RandomIt j = i;
+
+        while (j != first && comp(tmp, *(j - 1)))
+        {
+            *j = static_cast<V&&>(*(j - 1));
+            --j;
+        }
+
+        *j = static_cast<V&&>(tmp);
+    }
+}
+
+// Move the median of *a, *b and *c to *result
+template <class RandomIt, class Compare>
+static void move_median_to_first(RandomIt result, RandomIt a, RandomIt b, RandomIt c,
+                                 Compare comp)
+{
+    if (comp(*a, *b))
+    {
+        if (comp(*b, *c))
+            stlite::swap(*result, *b);
+        else if (comp(*a, *c))
+            stlite::swap(*result, *c);
+        else
+            stlite::swap(*result, *a);
+    }
+    else if (comp(*a, *c))
+        stlite::swap(*result, *a);
+    else if (comp(*b, *c))
+        stlite::swap(*result, *c);
+    else
+        stlite::swap(*result, *b);
+}
+
+// Partition [first, last) around *pivot. The median of three selection
+// guarantees there is an element on both sides which stops the scans, so
+// they don't need bound checks.
+template <class RandomIt, class Compare>
+static RandomIt unguarded_partition(RandomIt first, RandomIt last, RandomIt pivot,
+                                    Compare comp)
+{
+    while (true)
+    {
+        while (comp(*first, *pivot))
+            ++first;
+        --last;
+        while (comp(*pivot, *last))
+            --last;
+        if (!(first < last))
+            return first;
+        stlite::swap(*first, *last);
+        ++first;
+    }
+}
+
+template <class RandomIt, class Compare>
+static RandomIt partition_pivot(RandomIt first, RandomIt last, Compare comp)
+{
+    RandomIt mid = first + (last - first) / 2;
+    move_median_to_first(first, first + 1, mid, last - 1, comp);
+    return unguarded_partition(first + 1, last, first, comp);
+}
+
+// Restore the max heap property of first[0, len) below the hole i
+template <class RandomIt, class Compare>
+static void sift_down(RandomIt first, ptrdiff_t len, ptrdiff_t i, Compare comp)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    V value = static_cast<V&&>(first[i]);
+
+    while (true)
+    {
+        ptrdiff_t child = 2 * i + 1;
+        if (child >= len)
+            break;
+        if (child + 1 < len && comp(first[child], first[child + 1]))
+            child++;
+        if (!comp(value, first[child]))
+            break;
+        first[i] = static_cast<V&&>(first[child]);
+        i = child;
+    }
+
+    first[i] = static_cast<V&&>(value);
+}
+
+// Leave the middle - first smallest elements of [first, last) in
+// [first, middle) arranged as a max heap
+template <class RandomIt, class Compare>
+static void heap_select(RandomIt first, RandomIt middle, RandomIt last, Compare comp)
+{
+    ptrdiff_t len = middle - first;
+
+    for (ptrdiff_t i = len / 2; i > 0; i--)
+        sift_down(first, len, i - 1, comp);
+
+    for (RandomIt it = middle; it < last; ++it)
+    {
+        if (comp(*it, *first))
+        {
+            stlite::swap(*it, *first);
+            sift_down(first, len, 0, comp);
+        }
+    }
+}
+
+template <class RandomIt, class Compare>
+static void sort_heap(RandomIt first, RandomIt last, Compare comp)
+{
+    for (ptrdiff_t len = last - first; len > 1; len--)
+    {
+        stlite::swap(first[0], first[len - 1]);
+        sift_down(first, len - 1, 0, comp);
+    }
+}
+
+template <class RandomIt>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    stlite::nth_element(first, nth, last, Less<V>());
+}
+
+// Quickselect with median of three pivots. When the partitions keep coming
+// out unbalanced it falls back to heap selection, so the worst case stays
+// O(n log n).
+template <class RandomIt, class Compare>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp)
+{
+    if (first == last || nth == last)
+        return;
+
+    unsigned depth = 0;
+    for (ptrdiff_t n = last - first; n > 1; n >>= 1)
+        depth += 2;
+
+    while (last - first > 3)
+    {
+        if (depth == 0)
+        {
+            heap_select(first, nth + 1, last, comp);
+            stlite::swap(*first, *nth);
+            return;
+        }
+        depth--;
+
+        RandomIt cut = partition_pivot(first, last, comp);
+        if (cut <= nth)
+            first = cut;
+        else
+            last = cut;
+    }
+
+    insertion_sort(first, last, comp);
+}
+
+template <class RandomIt>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    stlite::partial_sort(first, middle, last, Less<V>());
+}
+
+// Sort the middle - first smallest elements into [first, middle), the order
+// of the rest is unspecified
+template <class RandomIt, class Compare>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp)
+{
+    if (first == middle)
+        return;
+
+    heap_select(first, middle, last, comp);
+    stlite::sort_heap(first, middle, comp);
+}
+
+template <class RandomIt, class Compare>
+static void introsort_loop(RandomIt first, RandomIt last, unsigned depth, Compare comp)
+{
+    // Short partitions are left for the final insertion sort
+    while (last - first > 16)
+    {
+        if (depth == 0)
+        {
+            // Too many unbalanced partitions, heap sort the rest
+            heap_select(first, last, last, comp);
+            stlite::sort_heap(first, last, comp);
+            return;
+        }
+        depth--;
+
+        RandomIt cut = partition_pivot(first, last, comp);
+        introsort_loop(cut, last, depth, comp);
+        last = cut;
+    }
+}
+
+template <class RandomIt>
+void sort(RandomIt first, RandomIt last)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    stlite::sort(first, last, Less<V>());
+}
+
+// Introsort: quicksort with median of three pivots, heap sort once the
+// recursion gets too deep and insertion sort for the short partitions. The
+// sort is not stable.
+template <class RandomIt, class Compare>
+void sort(RandomIt first, RandomIt last, Compare comp)
+{
+    if (last - first < 2)
+        return;
+
+    unsigned depth = 0;
+    for (ptrdiff_t n = last - first; n > 1; n >>= 1)
+        depth += 2;
+
+    introsort_loop(first, last, depth, comp);
+    insertion_sort(first, last, comp);
+}
+
+// Stable merge of two sorted ranges which moves the elements
+template <class InputIt, class OutputIt, class Compare>
+static OutputIt merge_move(InputIt first1, InputIt last1, InputIt first2, InputIt last2,
+                           OutputIt dst, Compare comp)
+{
+    typedef typename IteratorTraits<InputIt>::value_type V;
+
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first2, *first1))
+        {
+            *dst = static_cast<V&&>(*first2);
+            ++first2;
+        }
+        else
+        {
+            *dst = static_cast<V&&>(*first1);
+            ++first1;
+        }
+        ++dst;
+    }
+
+    dst = move_range(first1, last1, dst);
+    return move_range(first2, last2, dst);
+}
+
+// Merge neighbouring sorted runs of width elements from src into dst
+template <class InputIt, class OutputIt, class Compare>
+static void merge_pass(InputIt src, ptrdiff_t n, ptrdiff_t width, OutputIt dst,
+                       Compare comp)
+{
+    for (ptrdiff_t lo = 0; lo < n; lo += 2 * width)
+    {
+        ptrdiff_t mid = stlite::min(lo + width, n);
+        ptrdiff_t hi = stlite::min(lo + 2 * width, n);
+
+        // Runs which are already in order are moved as a block
+        if (mid == hi || !comp(src[mid], src[mid - 1]))
+            move_range(src + lo, src + hi, dst + lo);
+        else
+            merge_move(src + lo, src + mid, src + mid, src + hi, dst + lo, comp);
+    }
+}
+
+// Bottom-up merge sort. Runs of stable_sort_run elements are sorted by
+// insertion and then merged back and forth between the range and a buffer of
+// the same size.
+template <class RandomIt, class Compare>
+static void stable_sort_impl(RandomIt first, RandomIt last, Compare comp)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    constexpr ptrdiff_t stable_sort_run = 32;
+
+    ptrdiff_t n = last - first;
+
+    for (ptrdiff_t lo = 0; lo < n; lo += stable_sort_run)
+        insertion_sort(first + lo, first + stlite::min(lo + stable_sort_run, n), comp);
+
+    if (n <= stable_sort_run)
+        return;
+
+    Allocator<V> allocator;
+    V* buf = allocator.allocate(n);
+    bool in_buf = false;
+
+    for (ptrdiff_t width = stable_sort_run; width < n; width *= 2)
+    {
+        if (in_buf)
+            merge_pass(buf, n, width, first, comp);
+        else
+            merge_pass(first, n, width, buf, comp);
+        in_buf = !in_buf;
+    }
+
+    if (in_buf)
+        move_range(buf, buf + n, first);
+
+    allocator.deallocate(buf, n);
+}
+
+template <class RandomIt, class Compare>
+static void stable_sort_helper(RandomIt first, RandomIt last, Compare comp, BoolConstant<true>)
+{
+    // Sort the underlying pointers, so the merges use memmove for trivially
+    // copyable elements
+    stable_sort_impl(IteratorTraits<RandomIt>::pointer(first),
+                     IteratorTraits<RandomIt>::pointer(last), comp);
+}
+
+template <class RandomIt, class Compare>
+static void stable_sort_helper(RandomIt first, RandomIt last, Compare comp, BoolConstant<false>)
+{
+    stable_sort_impl(first, last, comp);
+}
+
+template <class RandomIt>
+void stable_sort(RandomIt first, RandomIt last)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    stlite::stable_sort(first, last, Less<V>());
+}
+
+template <class RandomIt, class Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    typedef IteratorTraits<RandomIt> Traits;
+    stable_sort_helper(first, last, comp, BoolConstant<Traits::contiguous>());
+}
+
 } // namespace stlite
+
+#endif
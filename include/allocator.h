@@ -24,35 +24,297 @@
 #ifndef ALLOCATOR_H
 #define ALLOCATOR_H
 
+#include <new>
+#include <stdlib.h>
+
 namespace stlite
 {
 
 typedef unsigned int size_t;
 
-template <class T>
+constexpr unsigned cache_line_size = 64;
+
+template <bool B>
+struct BoolConstant
+{
+    static constexpr bool value = B;
+};
+
+// Alignment of the memory returned by new, larger alignments need an
+// aligned allocation before C++17
+#ifdef __STDCPP_DEFAULT_NEW_ALIGNMENT__
+constexpr size_t default_new_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+#else
+constexpr size_t default_new_alignment = 2 * sizeof(void*);
+#endif
+
+// The blocks are aligned to Align bytes, or to alignof(T) if it is larger,
+// e.g. to a cache line or to the width of the SIMD registers:
+//
+//   stlite::Vector<float, stlite::Allocator<float, 64>> samples;
+//
+// Over-aligned blocks are allocated with posix_memalign() and their
+// elements constructed in place, the others with new T[n]. Both throw
+// std::bad_alloc when the memory runs out.
+template <class T, size_t Align = 0>
 class Allocator
 {
+    static_assert((Align & (Align - 1)) == 0, "The alignment must be a power of two");
+
 public:
+    static constexpr size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+private:
+    static constexpr bool over_aligned = alignment > default_new_alignment;
+
+    static T* allocate_aligned(size_t n)
+    {
+        void* p;
+        unsigned long bytes = (unsigned long) n * sizeof(T);
+        if (posix_memalign(&p, alignment, bytes ? bytes : 1) != 0)
+            throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    // The plain new and delete are only compiled for the types they align
+    static T* allocate_block(size_t n, BoolConstant<false>) { return new T[n]; }
+
+    static T* allocate_block(size_t n, BoolConstant<true>)
+    {
+        T* p = allocate_aligned(n);
+        size_t i = 0;
+        try
+        {
+            for (; i < n; i++)
+                new (&p[i]) T;
+        }
+        catch (...)
+        {
+            // Undo the elements built so far, like new T[n] does
+            while (i > 0)
+                p[--i].~T();
+            free(p);
+            throw;
+        }
+        return p;
+    }
+
+    static void deallocate_block(T* p, size_t, BoolConstant<false>) { delete [] p; }
+
+    static void deallocate_block(T* p, size_t n, BoolConstant<true>)
+    {
+        for (size_t i = 0; i < n; i++)
+            p[i].~T();
+        free(p);
+    }
+
+    template <class... Args>
+    static T* construct_object(BoolConstant<false>, Args&&... args)
+    {
+        return new T(static_cast<Args&&>(args)...);
+    }
+
+    template <class... Args>
+    static T* construct_object(BoolConstant<true>, Args&&... args)
+    {
+        T* p = allocate_aligned(1);
+        try
+        {
+            new (p) T(static_cast<Args&&>(args)...);
+        }
+        catch (...)
+        {
+            free(p);
+            throw;
+        }
+        return p;
+    }
+
+    static void destroy_object(T* p, BoolConstant<false>) { delete p; }
+
+    static void destroy_object(T* p, BoolConstant<true>)
+    {
+        p->~T();
+        free(p);
+    }
+
+public:
+    // The same allocator for another type, the node containers allocate
+    // their nodes through Alloc::rebind<Node>::other
+    template <class U>
+    struct rebind
+    {
+        typedef Allocator<U, Align> other;
+    };
+
     Allocator() = default;
     ~Allocator() = default;
 
+    // Converting constructor, for the allocator of the elements of a node
+    // container
+    template <class U>
+    Allocator(const Allocator<U, Align>&) {}
+
     // Return address
     //address
 
     // Allocate block of storage
-    T* allocate(size_t n) { return new T[n]; }
+    T* allocate(size_t n) { return allocate_block(n, BoolConstant<over_aligned>()); }
 
     // Release block of storage
-    void deallocate(T* p, size_t n) { if (p) delete [] p; }
+    void deallocate(T* p, size_t n)
+    {
+        if (p)
+            deallocate_block(p, n, BoolConstant<over_aligned>());
+    }
 
     // Maximum size possible to allocate
     // max_size
 
-    // Construct an object
-    // construct
+    // Allocate and construct a single object
+    template <class... Args>
+    T* construct(Args&&... args)
+    {
+        return construct_object(BoolConstant<over_aligned>(), static_cast<Args&&>(args)...);
+    }
+
+    // Destroy and release an object created with construct()
+    void destroy(T* p)
+    {
+        if (p)
+            destroy_object(p, BoolConstant<over_aligned>());
+    }
+};
+
+template <class... T>
+struct VoidType
+{
+    typedef void type;
+};
+
+// Only used in unevaluated expressions
+template <class T>
+T& declared_value();
+
+template <class Alloc, class = void>
+struct AllocatorPropagateOnCopy
+{
+    static constexpr bool value = false;
+};
+
+template <class Alloc>
+struct AllocatorPropagateOnCopy<Alloc, typename VoidType<decltype(Alloc::propagate_on_copy_assignment)>::type>
+{
+    static constexpr bool value = Alloc::propagate_on_copy_assignment;
+};
+
+template <class Alloc, class = void>
+struct AllocatorPropagateOnMove
+{
+    static constexpr bool value = false;
+};
+
+template <class Alloc>
+struct AllocatorPropagateOnMove<Alloc, typename VoidType<decltype(Alloc::propagate_on_move_assignment)>::type>
+{
+    static constexpr bool value = Alloc::propagate_on_move_assignment;
+};
+
+template <class Alloc, class = void>
+struct AllocatorPropagateOnSwap
+{
+    static constexpr bool value = false;
+};
+
+template <class Alloc>
+struct AllocatorPropagateOnSwap<Alloc, typename VoidType<decltype(Alloc::propagate_on_swap)>::type>
+{
+    static constexpr bool value = Alloc::propagate_on_swap;
+};
+
+template <class Alloc, class = void>
+struct AllocatorSelectOnCopy
+{
+    static Alloc select(const Alloc& alloc) { return alloc; }
+};
+
+template <class Alloc>
+struct AllocatorSelectOnCopy<Alloc, typename VoidType<decltype(
+    declared_value<const Alloc>().select_on_copy_construction())>::type>
+{
+    static Alloc select(const Alloc& alloc) { return alloc.select_on_copy_construction(); }
+};
+
+template <class Alloc, class = void>
+struct AllocatorEqual
+{
+    static bool equal(const Alloc&, const Alloc&) { return true; }
+};
+
+template <class Alloc>
+struct AllocatorEqual<Alloc, typename VoidType<decltype(
+    declared_value<const Alloc>() == declared_value<const Alloc>())>::type>
+{
+    static bool equal(const Alloc& a, const Alloc& b) { return a == b; }
+};
+
+// How the containers pass their allocators on, after std::allocator_traits.
+// An allocator with state (an arena, a pool) declares the operations which
+// take the allocator along with the elements:
+//
+//   static constexpr bool propagate_on_copy_assignment = true;
+//   static constexpr bool propagate_on_move_assignment = true;
+//   static constexpr bool propagate_on_swap = true;
+//
+// each of them false when it is not declared, and it may define
+// select_on_copy_construction() for the allocator of a copy, which is
+// otherwise a copy of the allocator. Two allocators are equal when either
+// can release the memory of the other; an allocator without operator== has
+// no state and is always equal to the others.
+//
+// A container assigned from one with an unequal allocator which doesn't
+// propagate copies or moves the elements into its own memory. Swapping two
+// containers whose allocators are unequal and don't propagate is undefined.
+template <class Alloc>
+struct AllocatorTraits
+{
+    static constexpr bool propagate_on_copy_assignment = AllocatorPropagateOnCopy<Alloc>::value;
+    static constexpr bool propagate_on_move_assignment = AllocatorPropagateOnMove<Alloc>::value;
+    static constexpr bool propagate_on_swap = AllocatorPropagateOnSwap<Alloc>::value;
+
+    static Alloc select_on_copy_construction(const Alloc& alloc)
+    {
+        return AllocatorSelectOnCopy<Alloc>::select(alloc);
+    }
+
+    static bool equal(const Alloc& a, const Alloc& b) { return AllocatorEqual<Alloc>::equal(a, b); }
+};
+
+// Allocator of the blocks of the contiguous container C. An allocator which
+// names its allocations after the container (InstrumentedAllocator)
+// declares container_rebind<C>::other, the others are used as they are.
+template <class Alloc, class C, class = void>
+struct ContainerAllocator
+{
+    typedef Alloc type;
+};
+
+template <class Alloc, class C>
+struct ContainerAllocator<Alloc, C, typename VoidType<typename Alloc::template container_rebind<C>::other>::type>
+{
+    typedef typename Alloc::template container_rebind<C>::other type;
+};
+
+// Unit of storage of the variable-sized nodes, e.g. a skip list node with
+// its level pointers. The containers rebind their allocator to
+// NodeBytes<Node> and allocate units(bytes) of them, so the allocators
+// align the nodes as they do any type.
+template <class Node>
+struct NodeBytes
+{
+    alignas(Node) unsigned char bytes[alignof(Node)];
 
-    // Destroy an object
-    // destroy
+    static size_t units(size_t bytes) { return (bytes + sizeof(NodeBytes) - 1) / sizeof(NodeBytes); }
 };
 
 } // namespace stlite
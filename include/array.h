@@ -26,6 +26,7 @@
 
 #include "algorithms.h"
 #include "allocator.h"
+#include "iterator.h"
 
 #ifdef USE_STL
 #include <algorithm>
@@ -41,7 +42,10 @@ class Array
     size_t _max_size = -1;
     size_t _size = 0;
 
-    Alloc allocator;
+    // The allocator of the blocks, Alloc itself unless it counts them under
+    // the name of the container
+    typedef typename ContainerAllocator<Alloc, Array>::type BlockAlloc;
+    BlockAlloc allocator;
 
     void allocate_data(size_t n)
     {
@@ -49,72 +53,104 @@ class Array
         _data = allocator.allocate(n);
     }
 
+    // Take the memory of other, which must be releasable by our allocator
+    void steal(Array& other)
+    {
+        _data = other._data;
+        _size = other._size;
+
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    // Move the elements of other into our own memory
+    void move_elements(Array& other)
+    {
+        allocate_data(other._size);
+        for (size_t i = 0; i < _size; i++)
+            _data[i] = static_cast<T&&>(other._data[i]);
+    }
+
 public:
     Array() {}
 
+    explicit Array(const Alloc& alloc) : allocator(alloc) {}
+
     // Fill constructors
-    explicit Array(size_t n)
+    explicit Array(size_t n, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         allocate_data(n);
     }
 
-    explicit Array(size_t n, const T& val)
+    explicit Array(size_t n, const T& val, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         allocate_data(n);
-        for (unsigned i = 0; i < n; i++)
-            _data[i] = val;
+        stlite::fill(_data, _data + n, val);
     }
 
     // This constructor creates array from the given array
-    Array(const T* arr, size_t len)
+    Array(const T* arr, size_t len, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         _size = len;
         allocate_data(len);
         copy<T>(arr, arr + _size, _data);
     }
 
-#ifdef USE_STL
-    Array(std::initializer_list<T> initlst)
+    // Range constructor, the size is computed up front and the array
+    // allocated once
+    template <class InputIt, class = typename EnableIfIterator<InputIt>::type>
+    Array(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
-        _size = initlst.size();
-        allocate_data(_size);
-
-        unsigned idx = 0;
+        allocate_data(stlite::distance(first, last));
+        stlite::copy(first, last, _data);
+    }
 
-        for (auto x : initlst)
-            _data[idx++] = x;
+#ifdef USE_STL
+    Array(std::initializer_list<T> initlst, const Alloc& alloc = Alloc()) : allocator(alloc)
+    {
+        allocate_data(initlst.size());
+        stlite::copy(initlst.begin(), initlst.end(), _data);
     }
 #endif
 
     // Copy constructor
     Array(const Array& other)
+        : allocator(AllocatorTraits<BlockAlloc>::select_on_copy_construction(other.allocator))
     {
         _size = other._size;
         allocate_data(other._size);
         copy<T>(other._data, other._data + _size, _data);
     }
 
-    // Move constructor
-    Array(Array&& other)
+    Array(const Array& other, const Alloc& alloc) : allocator(alloc)
     {
-        if (&other != this)
-        {
-            _data = other._data;
-            _size = other._size;
+        _size = other._size;
+        allocate_data(other._size);
+        copy<T>(other._data, other._data + _size, _data);
+    }
 
-            other._data = nullptr;
-            other._size = 0;
-        }
+    // Move constructor
+    Array(Array&& other) : allocator(other.allocator) { steal(other); }
+
+    // The elements are moved one by one when the allocators are not equal
+    Array(Array&& other, const Alloc& alloc) : allocator(alloc)
+    {
+        if (AllocatorTraits<BlockAlloc>::equal(allocator, other.allocator))
+            steal(other);
+        else
+            move_elements(other);
     }
 
     ~Array() { allocator.deallocate(_data, _size); } // Destructor
 
     // Copy assignment operator
-    Array<T>& operator=(const Array& other)
+    Array& operator=(const Array& other)
     {
         if (&other != this)
         {
             allocator.deallocate(_data, _size);
+            if (AllocatorTraits<BlockAlloc>::propagate_on_copy_assignment)
+                allocator = other.allocator;
 
             _size = other._size;
             allocate_data(other._size);
@@ -124,81 +160,48 @@ public:
     }
 
     // Move assignment operator
-    Array<T>& operator=(Array&& other)
+    Array& operator=(Array&& other)
     {
         if (&other != this)
         {
             allocator.deallocate(_data, _size);
 
-            _data = other._data;
-            _size = other._size;
-
-            other._data = nullptr;
-            other._size = 0;
+            if (AllocatorTraits<BlockAlloc>::propagate_on_move_assignment)
+            {
+                allocator = other.allocator;
+                steal(other);
+            }
+            else if (AllocatorTraits<BlockAlloc>::equal(allocator, other.allocator))
+                steal(other);
+            else
+                move_elements(other);
         }
         return *this;
     }
 
     // Iterators
-    class Iterator
-    {
-        T* _data = nullptr;
-        unsigned _current = -1;
-    public:
-        Iterator() {}
-        Iterator(T* data, unsigned n) : _data(data), _current(n) {}
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
 
-        // Prefix increment operator
-        Iterator& operator++()
-        {
-            ++_current;
-            return *this;
-        }
+    Iterator begin() { return Iterator(_data); }
+    Iterator end() { return Iterator(_data + _size); }
 
-        // Postfix increment operator
-        Iterator operator++(int)
-        {
-            Iterator tmp = *this;
-            ++_current;
-            return tmp;
-        }
-
-        // Prefix decrement operator
-        Iterator& operator--()
-        {
-            --_current;
-            return *this;
-        }
-
-        // Postfix decrement operator
-        Iterator operator--(int)
-        {
-            Iterator tmp = *this;
-            --_current;
-            return tmp;
-        }
-
-        T& operator*()
-        {
-            return _data[_current];
-        }
+    ConstIterator begin() const { return ConstIterator(_data); }
+    ConstIterator end() const { return ConstIterator(_data + _size); }
 
-        bool operator==(Iterator other)
-        {
-            return other._current == _current;
-        }
+    ConstIterator cbegin() const { return ConstIterator(_data); }
+    ConstIterator cend() const { return ConstIterator(_data + _size); }
 
-        bool operator!=(Iterator other)
-        {
-            return other._current != _current;
-        }
-    };
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
 
-    Iterator begin() { return Iterator(_data, 0); }
-    Iterator end() { return Iterator(nullptr, _size); }
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
 
-    const Iterator cbegin() const { return Iterator(_data, 0); }
-    const Iterator cend() const { return Iterator(nullptr, _size); }
+    ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
 
     // Capacity
     size_t size() const { return _size; }
@@ -236,14 +239,65 @@ public:
     const T& back() const { return _data[_size - 1]; }
 
     T* data() { return _data; }
+    const T* data() const { return _data; }
 
     // Modifiers
-    void fill(const T& value)
+    void fill(const T& value) { stlite::fill(_data, _data + _size, value); }
+
+    // Replace the contents with n copies of val, the array is reallocated
+    // when its size changes
+    void assign(size_t n, const T& val)
+    {
+        const T v = val; // val may be an element
+        if (n != _size)
+        {
+            allocator.deallocate(_data, _size);
+            allocate_data(n);
+        }
+        stlite::fill(_data, _data + n, v);
+    }
+
+    // Replace the contents with the range, which must not be in this array
+    template <class InputIt>
+    typename EnableIfIterator<InputIt>::type assign(InputIt first, InputIt last)
+    {
+        size_t n = stlite::distance(first, last);
+        if (n != _size)
+        {
+            allocator.deallocate(_data, _size);
+            allocate_data(n);
+        }
+        stlite::copy(first, last, _data);
+    }
+
+    // Resize to n elements keeping the first ones, the new elements are
+    // value-initialized
+    void resize(size_t n)
+    {
+        if (n == _size)
+            return;
+
+        T* tmp = allocator.allocate(n);
+        size_t kept = n < _size ? n : _size;
+        copy<T>(_data, _data + kept, tmp);
+        stlite::fill(tmp + kept, tmp + n, T());
+        allocator.deallocate(_data, _size);
+        _data = tmp;
+        _size = n;
+    }
+
+    // The allocators are exchanged only if they propagate on swap,
+    // otherwise they must be equal
+    void swap(Array& other)
     {
-        for (unsigned i = 0; i < _size; ++i)
-            _data[i] = value;
+        if (AllocatorTraits<BlockAlloc>::propagate_on_swap)
+            stlite::swap(allocator, other.allocator);
+        stlite::swap(_data, other._data);
+        stlite::swap(_size, other._size);
     }
-    // swap()
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(allocator); }
 };
 
 } // namespace stlite
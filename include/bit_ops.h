@@ -0,0 +1,268 @@
+// The MIT License (MIT)
+//
+// STLite bit operations
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include "allocator.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STLITE_POPCNT_X86
+#endif
+
+namespace stlite
+{
+
+// Storage unit of BitVector and Bitset. Bit i is bit i % 64 of word i / 64.
+typedef unsigned long long BitWord;
+
+constexpr size_t bits_per_word = 64;
+
+// Word operations shared by BitVector and Bitset. They work on arrays of
+// words holding n bits; the bits past n in the last word are always zero, so
+// the whole words can be counted and compared.
+namespace bits
+{
+
+constexpr size_t words(size_t n) { return (n + bits_per_word - 1) / bits_per_word; }
+
+constexpr BitWord mask(size_t i) { return BitWord(1) << (i % bits_per_word); }
+
+// Valid bits of the last word of n bits
+constexpr BitWord tail_mask(size_t n)
+{
+    return n % bits_per_word ? mask(n) - 1 : ~BitWord(0);
+}
+
+// Without the popcnt instruction __builtin_popcountll is a library call, the
+// bit-parallel sum is faster
+inline unsigned popcount(BitWord w)
+{
+#ifdef __POPCNT__
+    return __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (w * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+// Index of the lowest set bit, w must not be zero
+inline unsigned lowest(BitWord w) { return __builtin_ctzll(w); }
+
+// Index of the k-th (from 0) set bit of w, w must have more than k bits set
+inline unsigned select(BitWord w, unsigned k)
+{
+    while (k--)
+        w &= w - 1;
+    return lowest(w);
+}
+
+// Four independent sums, so the popcounts aren't chained on one register.
+// The builtin is expanded for the target of the function this is inlined
+// into, which is the popcnt instruction in count_popcnt().
+__attribute__((always_inline)) inline size_t count_loop(const BitWord* w, size_t n)
+{
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        c0 += __builtin_popcountll(w[i]);
+        c1 += __builtin_popcountll(w[i + 1]);
+        c2 += __builtin_popcountll(w[i + 2]);
+        c3 += __builtin_popcountll(w[i + 3]);
+    }
+    for (; i < n; i++)
+        c0 += __builtin_popcountll(w[i]);
+
+    return c0 + c1 + c2 + c3;
+}
+
+#ifdef STLITE_POPCNT_X86
+// Compiled for the popcnt instruction regardless of the compiler flags, only
+// called after the CPU has been checked to support it
+__attribute__((target("popcnt"))) inline size_t count_popcnt(const BitWord* w, size_t n)
+{
+    return count_loop(w, n);
+}
+#endif
+
+// Number of set bits of n words
+inline size_t count(const BitWord* w, size_t n)
+{
+#ifdef STLITE_POPCNT_X86
+    static const bool popcnt = __builtin_cpu_supports("popcnt");
+    if (popcnt)
+        return count_popcnt(w, n);
+#endif
+    return count_loop(w, n);
+}
+
+// Index of the first set bit at or after pos, or nbits if there is none
+inline size_t find_from(const BitWord* w, size_t nbits, size_t pos)
+{
+    if (pos >= nbits)
+        return nbits;
+
+    size_t i = pos / bits_per_word;
+    BitWord word = w[i] & ~(mask(pos) - 1);
+    size_t n = words(nbits);
+
+    while (!word)
+    {
+        if (++i == n)
+            return nbits;
+        word = w[i];
+    }
+
+    return i * bits_per_word + lowest(word);
+}
+
+// Number of set bits before pos, pos may be equal to nbits
+inline size_t rank(const BitWord* w, size_t nbits, size_t pos)
+{
+    if (pos >= nbits)
+        return count(w, words(nbits));
+
+    size_t i = pos / bits_per_word;
+    return count(w, i) + popcount(w[i] & (mask(pos) - 1));
+}
+
+// Index of the k-th (from 0) set bit, or nbits if there are not more than k
+inline size_t select(const BitWord* w, size_t nbits, size_t k)
+{
+    size_t n = words(nbits);
+    for (size_t i = 0; i < n; i++)
+    {
+        unsigned c = popcount(w[i]);
+        if (k < c)
+            return i * bits_per_word + select(w[i], k);
+        k -= c;
+    }
+    return nbits;
+}
+
+inline bool equal(const BitWord* a, const BitWord* b, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        if (a[i] != b[i])
+            return false;
+    return true;
+}
+
+// The bulk operations go through 16-byte GCC vectors, which compile to SSE2
+// on x86 and NEON on ARM even at -O2, where the plain loops stay scalar
+
+typedef BitWord WordPair __attribute__((vector_size(16)));
+
+struct AndOp
+{
+    template <class W>
+    W operator()(W a, W b) const { return a & b; }
+};
+
+struct OrOp
+{
+    template <class W>
+    W operator()(W a, W b) const { return a | b; }
+};
+
+struct XorOp
+{
+    template <class W>
+    W operator()(W a, W b) const { return a ^ b; }
+};
+
+struct AndNotOp
+{
+    template <class W>
+    W operator()(W a, W b) const { return a & ~b; }
+};
+
+// dst[i] = op(dst[i], src[i]) for n words
+template <class Op>
+inline void apply(BitWord* dst, const BitWord* src, size_t n, Op op)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        WordPair a0, a1, b0, b1;
+        __builtin_memcpy(&a0, dst + i, sizeof(a0));
+        __builtin_memcpy(&a1, dst + i + 2, sizeof(a1));
+        __builtin_memcpy(&b0, src + i, sizeof(b0));
+        __builtin_memcpy(&b1, src + i + 2, sizeof(b1));
+        a0 = op(a0, b0);
+        a1 = op(a1, b1);
+        __builtin_memcpy(dst + i, &a0, sizeof(a0));
+        __builtin_memcpy(dst + i + 2, &a1, sizeof(a1));
+    }
+    for (; i < n; i++)
+        dst[i] = op(dst[i], src[i]);
+}
+
+// Invert nbits bits
+inline void flip(BitWord* w, size_t nbits)
+{
+    size_t n = words(nbits);
+    for (size_t i = 0; i < n; i++)
+        w[i] = ~w[i];
+    if (n)
+        w[n - 1] &= tail_mask(nbits);
+}
+
+} // namespace bits
+
+// Proxy returned by the non-const operator[] of BitVector and Bitset, so
+// that bits can be assigned like elements:
+//   bv[3] = true;
+class BitReference
+{
+    BitWord* _word;
+    BitWord _mask;
+
+public:
+    BitReference(BitWord* word, BitWord mask) : _word(word), _mask(mask) {}
+    BitReference(const BitReference& other) = default;
+
+    operator bool() const { return (*_word & _mask) != 0; }
+
+    BitReference& operator=(bool value)
+    {
+        if (value)
+            *_word |= _mask;
+        else
+            *_word &= ~_mask;
+        return *this;
+    }
+
+    BitReference& operator=(const BitReference& other) { return *this = bool(other); }
+
+    void flip() { *_word ^= _mask; }
+};
+
+} // namespace stlite
+
+#endif
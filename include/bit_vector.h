@@ -0,0 +1,378 @@
+// The MIT License (MIT)
+//
+// STLite bit vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include "allocator.h"
+#include "bit_ops.h"
+
+namespace stlite
+{
+
+// Dynamic array of bits packed 64 to a word, an eighth of the memory of a
+// Vector<bool>. Counting and searching go through whole words with popcount
+// and count-trailing-zeros, the bulk operations (&=, |=, ^=) work on several
+// words at a time. All the bits of the storage past size() are kept zero.
+class BitVector
+{
+    BitWord* _words = nullptr;
+    size_t _capacity = 0; // In words
+    size_t _size = 0;     // In bits
+    Allocator<BitWord> allocator;
+
+    void reallocate(size_t capacity)
+    {
+        BitWord* tmp = allocator.allocate(capacity);
+        size_t n = bits::words(_size);
+
+        for (size_t i = 0; i < n; i++)
+            tmp[i] = _words[i];
+        for (size_t i = n; i < capacity; i++)
+            tmp[i] = 0;
+
+        allocator.deallocate(_words, _capacity);
+        _words = tmp;
+        _capacity = capacity;
+    }
+
+    // Clear the bits past the size in the last word
+    void trim()
+    {
+        if (_size % bits_per_word)
+            _words[_size / bits_per_word] &= bits::tail_mask(_size);
+    }
+
+    void steal(BitVector& other)
+    {
+        _words = other._words;
+        _capacity = other._capacity;
+        _size = other._size;
+
+        other._words = nullptr;
+        other._capacity = 0;
+        other._size = 0;
+    }
+
+public:
+    BitVector() {}
+
+    // Fill constructor
+    explicit BitVector(size_t n, bool value = false)
+    {
+        resize(n, value);
+    }
+
+    // Copy constructor
+    BitVector(const BitVector& other)
+    {
+        reallocate(bits::words(other._size));
+        for (size_t i = 0; i < _capacity; i++)
+            _words[i] = other._words[i];
+        _size = other._size;
+    }
+
+    // Move constructor
+    BitVector(BitVector&& other) { steal(other); }
+
+    ~BitVector() { allocator.deallocate(_words, _capacity); }
+
+    // Copy assignment operator
+    BitVector& operator=(const BitVector& other)
+    {
+        if (&other != this)
+        {
+            size_t n = bits::words(other._size);
+
+            _size = 0;
+            if (_capacity < n)
+                reallocate(n);
+            for (size_t i = 0; i < n; i++)
+                _words[i] = other._words[i];
+            for (size_t i = n; i < _capacity; i++)
+                _words[i] = 0;
+            _size = other._size;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    BitVector& operator=(BitVector&& other)
+    {
+        if (&other != this)
+        {
+            allocator.deallocate(_words, _capacity);
+            steal(other);
+        }
+        return *this;
+    }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity * bits_per_word; }
+    bool empty() const { return _size == 0; }
+
+    // Make room for at least n bits without reallocating
+    void reserve(size_t n)
+    {
+        if (bits::words(n) > _capacity)
+            reallocate(bits::words(n));
+    }
+
+    // Element access
+    bool operator[](size_t i) const { return test(i); }
+
+    BitReference operator[](size_t i)
+    {
+        return BitReference(_words + i / bits_per_word, bits::mask(i));
+    }
+
+    bool test(size_t i) const { return (_words[i / bits_per_word] & bits::mask(i)) != 0; }
+
+    // Underlying words, the bits past size() are zero
+    const BitWord* data() const { return _words; }
+    size_t word_count() const { return bits::words(_size); }
+
+    // Modifiers
+
+    void set(size_t i) { _words[i / bits_per_word] |= bits::mask(i); }
+    void reset(size_t i) { _words[i / bits_per_word] &= ~bits::mask(i); }
+    void flip(size_t i) { _words[i / bits_per_word] ^= bits::mask(i); }
+
+    void set(size_t i, bool value)
+    {
+        if (value)
+            set(i);
+        else
+            reset(i);
+    }
+
+    // Set, clear or invert all the bits
+    void set()
+    {
+        for (size_t i = 0; i < word_count(); i++)
+            _words[i] = ~BitWord(0);
+        trim();
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < word_count(); i++)
+            _words[i] = 0;
+    }
+
+    void flip() { bits::flip(_words, _size); }
+
+    void push_back(bool value)
+    {
+        // Grow geometrically, so n push_back() calls copy O(n) words
+        if (_size == _capacity * bits_per_word)
+            reallocate(_capacity ? 2 * _capacity : 1);
+        set(_size++, value);
+    }
+
+    bool pop_back()
+    {
+        if (_size == 0)
+            return false;
+        reset(--_size);
+        return true;
+    }
+
+    // Change the number of bits, the added bits are set to value
+    void resize(size_t n, bool value = false)
+    {
+        if (bits::words(n) > _capacity)
+            reallocate(bits::words(n));
+
+        if (n > _size && value)
+        {
+            size_t i = _size;
+            for (; i < n && i % bits_per_word; i++)
+                set(i);
+            for (; i + bits_per_word <= n; i += bits_per_word)
+                _words[i / bits_per_word] = ~BitWord(0);
+            for (; i < n; i++)
+                set(i);
+        }
+
+        // Bits removed by shrinking are cleared, so growing again adds zeros
+        size_t old = _size;
+        _size = n;
+        if (n < old)
+        {
+            trim();
+            for (size_t i = bits::words(n); i < bits::words(old); i++)
+                _words[i] = 0;
+        }
+    }
+
+    void clear() { resize(0); }
+
+    // Operations
+
+    // Number of set bits
+    size_t count() const { return bits::count(_words, word_count()); }
+
+    bool any() const { return find_first() != _size; }
+    bool none() const { return !any(); }
+    bool all() const { return count() == _size; }
+
+    // Index of the first set bit, or size() if no bit is set
+    size_t find_first() const { return bits::find_from(_words, _size, 0); }
+
+    // Index of the first set bit after pos, or size() if there is none
+    size_t find_next(size_t pos) const { return bits::find_from(_words, _size, pos + 1); }
+
+    // The bulk operations combine this vector with the first size() bits of
+    // other, which must not be shorter
+
+    BitVector& operator&=(const BitVector& other)
+    {
+        bits::apply(_words, other._words, word_count(), bits::AndOp());
+        trim();
+        return *this;
+    }
+
+    BitVector& operator|=(const BitVector& other)
+    {
+        bits::apply(_words, other._words, word_count(), bits::OrOp());
+        trim();
+        return *this;
+    }
+
+    BitVector& operator^=(const BitVector& other)
+    {
+        bits::apply(_words, other._words, word_count(), bits::XorOp());
+        trim();
+        return *this;
+    }
+
+    // Clear the bits which are set in other
+    BitVector& subtract(const BitVector& other)
+    {
+        bits::apply(_words, other._words, word_count(), bits::AndNotOp());
+        return *this;
+    }
+
+    bool operator==(const BitVector& other) const
+    {
+        return _size == other._size && bits::equal(_words, other._words, word_count());
+    }
+
+    bool operator!=(const BitVector& other) const { return !(*this == other); }
+};
+
+// Rank and select queries over a BitVector, a Bitset or any array of words in
+// constant and logarithmic time. The index keeps the number of set bits
+// before every 512-bit block, about 12% of the size of the bits. It refers to
+// the words, which must not be modified or destroyed while the index is in
+// use.
+class RankSelect
+{
+    static constexpr size_t block_words = 8;
+
+    const BitWord* _words = nullptr;
+    size_t _size = 0;
+    size_t _blocks = 0;
+    size_t* _ranks = nullptr; // Set bits before each block, and the total
+    Allocator<size_t> allocator;
+
+public:
+    explicit RankSelect(const BitVector& bv) : RankSelect(bv.data(), bv.size()) {}
+
+    // Index of size bits in words, the bits past size must be zero
+    RankSelect(const BitWord* words, size_t size) : _words(words), _size(size)
+    {
+        size_t n = bits::words(size);
+        _blocks = (n + block_words - 1) / block_words;
+        _ranks = allocator.allocate(_blocks + 1);
+
+        size_t total = 0;
+        for (size_t b = 0; b < _blocks; b++)
+        {
+            _ranks[b] = total;
+            size_t end = (b + 1) * block_words < n ? (b + 1) * block_words : n;
+            total += bits::count(_words + b * block_words, end - b * block_words);
+        }
+        _ranks[_blocks] = total;
+    }
+
+    RankSelect(const RankSelect& other) = delete;
+    RankSelect& operator=(const RankSelect& other) = delete;
+
+    ~RankSelect() { allocator.deallocate(_ranks, _blocks + 1); }
+
+    // Number of set bits
+    size_t count() const { return _ranks[_blocks]; }
+
+    // Number of set bits before pos, pos may be equal to the size
+    size_t rank(size_t pos) const
+    {
+        if (pos >= _size)
+            return count();
+
+        size_t word = pos / bits_per_word;
+        size_t r = _ranks[word / block_words];
+
+        for (size_t i = word / block_words * block_words; i < word; i++)
+            r += bits::popcount(_words[i]);
+
+        return r + bits::popcount(_words[word] & (bits::mask(pos) - 1));
+    }
+
+    // Index of the k-th (from 0) set bit, or the size if there are not more
+    // than k set bits
+    size_t select(size_t k) const
+    {
+        if (k >= count())
+            return _size;
+
+        // Last block with less than k + 1 bits before it
+        size_t lo = 0;
+        size_t hi = _blocks;
+        while (hi - lo > 1)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (_ranks[mid] <= k)
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        k -= _ranks[lo];
+        size_t i = lo * block_words;
+        while (true)
+        {
+            unsigned c = bits::popcount(_words[i]);
+            if (k < c)
+                return i * bits_per_word + bits::select(_words[i], k);
+            k -= c;
+            i++;
+        }
+    }
+};
+
+} // namespace stlite
+
+#endif
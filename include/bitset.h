@@ -0,0 +1,187 @@
+// The MIT License (MIT)
+//
+// STLite bitset
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include "allocator.h"
+#include "bit_ops.h"
+
+namespace stlite
+{
+
+// Fixed number of bits stored inline, packed 64 to a word. Operations are the
+// same as those of BitVector.
+template <size_t N>
+class Bitset
+{
+    static constexpr size_t words = bits::words(N);
+
+    // At least one word, so that Bitset<0> is valid
+    BitWord _words[words ? words : 1] = {};
+
+    void trim()
+    {
+        if (N % bits_per_word)
+            _words[N / bits_per_word] &= bits::tail_mask(N);
+    }
+
+public:
+    constexpr Bitset() {}
+
+    // Set the bits of the given value, the bits past N are dropped
+    explicit Bitset(unsigned long long value)
+    {
+        _words[0] = N ? value : 0;
+        trim();
+    }
+
+    static constexpr size_t size() { return N; }
+
+    // Element access
+    bool operator[](size_t i) const { return test(i); }
+
+    BitReference operator[](size_t i)
+    {
+        return BitReference(_words + i / bits_per_word, bits::mask(i));
+    }
+
+    bool test(size_t i) const { return (_words[i / bits_per_word] & bits::mask(i)) != 0; }
+
+    const BitWord* data() const { return _words; }
+    static constexpr size_t word_count() { return words; }
+
+    // Modifiers
+
+    Bitset& set(size_t i)
+    {
+        _words[i / bits_per_word] |= bits::mask(i);
+        return *this;
+    }
+
+    Bitset& reset(size_t i)
+    {
+        _words[i / bits_per_word] &= ~bits::mask(i);
+        return *this;
+    }
+
+    Bitset& flip(size_t i)
+    {
+        _words[i / bits_per_word] ^= bits::mask(i);
+        return *this;
+    }
+
+    Bitset& set(size_t i, bool value) { return value ? set(i) : reset(i); }
+
+    // Set, clear or invert all the bits
+    Bitset& set()
+    {
+        for (size_t i = 0; i < words; i++)
+            _words[i] = ~BitWord(0);
+        trim();
+        return *this;
+    }
+
+    Bitset& reset()
+    {
+        for (size_t i = 0; i < words; i++)
+            _words[i] = 0;
+        return *this;
+    }
+
+    Bitset& flip()
+    {
+        bits::flip(_words, N);
+        return *this;
+    }
+
+    // Operations
+
+    size_t count() const { return bits::count(_words, words); }
+
+    bool any() const { return find_first() != N; }
+    bool none() const { return !any(); }
+    bool all() const { return count() == N; }
+
+    // Index of the first set bit, or N if no bit is set
+    size_t find_first() const { return bits::find_from(_words, N, 0); }
+
+    // Index of the first set bit after pos, or N if there is none
+    size_t find_next(size_t pos) const { return bits::find_from(_words, N, pos + 1); }
+
+    // Number of set bits before pos, pos may be equal to N. The words are
+    // counted on every call, a RankSelect index answers in constant time.
+    size_t rank(size_t pos) const { return bits::rank(_words, N, pos); }
+
+    // Index of the k-th (from 0) set bit, or N if there are not more than k
+    size_t select(size_t k) const { return bits::select(_words, N, k); }
+
+    Bitset& operator&=(const Bitset& other)
+    {
+        bits::apply(_words, other._words, words, bits::AndOp());
+        return *this;
+    }
+
+    Bitset& operator|=(const Bitset& other)
+    {
+        bits::apply(_words, other._words, words, bits::OrOp());
+        return *this;
+    }
+
+    Bitset& operator^=(const Bitset& other)
+    {
+        bits::apply(_words, other._words, words, bits::XorOp());
+        return *this;
+    }
+
+    Bitset operator~() const { return Bitset(*this).flip(); }
+
+    bool operator==(const Bitset& other) const
+    {
+        return bits::equal(_words, other._words, words);
+    }
+
+    bool operator!=(const Bitset& other) const { return !(*this == other); }
+};
+
+template <size_t N>
+Bitset<N> operator&(const Bitset<N>& a, const Bitset<N>& b)
+{
+    return Bitset<N>(a) &= b;
+}
+
+template <size_t N>
+Bitset<N> operator|(const Bitset<N>& a, const Bitset<N>& b)
+{
+    return Bitset<N>(a) |= b;
+}
+
+template <size_t N>
+Bitset<N> operator^(const Bitset<N>& a, const Bitset<N>& b)
+{
+    return Bitset<N>(a) ^= b;
+}
+
+} // namespace stlite
+
+#endif
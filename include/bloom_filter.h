@@ -0,0 +1,352 @@
+// The MIT License (MIT)
+//
+// STLite blocked Bloom filter
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include "algorithms.h"
+#include "allocator.h"
+#include "bit_ops.h"
+#include "hash.h"
+#include "simd_algorithms.h"
+
+#include <math.h>
+
+namespace stlite
+{
+
+// Multipliers picking the bit of every lane from the key hash, from the split
+// block Bloom filter of Apache Parquet
+constexpr unsigned bloom_salts[8] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+// Blocked Bloom filter: every key maps to one 64-byte block (a cache line)
+// and sets one bit in each of its eight 64-bit words, so a query touches a
+// single cache line. With AVX2 the eight bits are computed and tested with a
+// few vector instructions.
+//
+//   BloomFilter<int> filter(1000000, 0.01); // Keys, false positive rate
+//   filter.insert(42);
+//   if (filter.contains(key))               // false: key is not in the set
+//       ...
+//
+// There are no false negatives. The false positive rate is the requested one
+// once the expected number of keys has been inserted; the size is chosen
+// from an exact model of the block loads.
+template <class Key, class H = Hash<Key>>
+class BloomFilter
+{
+    static constexpr size_t block_words = 8;
+    static constexpr size_t block_bits = block_words * bits_per_word;
+    static constexpr unsigned magic = 0x31464253; // "SBF1"
+
+    BitWord* _storage = nullptr; // Allocated block, not aligned
+    BitWord* _words = nullptr;   // First block, aligned to 64 bytes
+    size_t _blocks = 0;
+    size_t _inserted = 0;
+    H _hash;
+    Allocator<BitWord> allocator;
+
+    void allocate_blocks(size_t blocks)
+    {
+        _blocks = blocks;
+        _storage = allocator.allocate(blocks * block_words + block_words);
+
+        unsigned long addr = reinterpret_cast<unsigned long>(_storage);
+        _words = _storage + ((64 - addr % 64) % 64) / sizeof(BitWord);
+        clear();
+    }
+
+    void deallocate_blocks()
+    {
+        allocator.deallocate(_storage, _blocks * block_words + block_words);
+        _storage = nullptr;
+        _words = nullptr;
+        _blocks = 0;
+    }
+
+    void steal(BloomFilter& other)
+    {
+        _storage = other._storage;
+        _words = other._words;
+        _blocks = other._blocks;
+        _inserted = other._inserted;
+
+        other._storage = nullptr;
+        other._words = nullptr;
+        other._blocks = 0;
+        other._inserted = 0;
+    }
+
+    // First word of the block of the hash, picked from the high 32 bits
+    BitWord* block(unsigned long long h) const
+    {
+        return _words + ((h >> 32) * _blocks >> 32) * block_words;
+    }
+
+    static BitWord lane_mask(unsigned h, size_t lane)
+    {
+        return BitWord(1) << ((h * bloom_salts[lane]) >> 26);
+    }
+
+    static void insert_scalar(BitWord* b, unsigned h)
+    {
+        for (size_t i = 0; i < block_words; i++)
+            b[i] |= lane_mask(h, i);
+    }
+
+    static bool contains_scalar(const BitWord* b, unsigned h)
+    {
+        BitWord missing = 0;
+        for (size_t i = 0; i < block_words; i++)
+            missing |= lane_mask(h, i) & ~b[i];
+        return !missing;
+    }
+
+#ifdef STLITE_SIMD_X86
+    // The masks of the lanes 0-3 and 4-7
+    STLITE_AVX2 static void masks_avx2(unsigned h, __m256i& lo, __m256i& hi)
+    {
+        const __m256i salts = _mm256_setr_epi32(0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+                                                0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31);
+        __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(h), salts), 26);
+        __m256i one = _mm256_set1_epi64x(1);
+
+        lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bit)));
+        hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bit, 1)));
+    }
+
+    STLITE_AVX2 static void insert_avx2(BitWord* b, unsigned h)
+    {
+        __m256i lo, hi;
+        masks_avx2(h, lo, hi);
+
+        __m256i* p = reinterpret_cast<__m256i*>(b);
+        _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), lo));
+        _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), hi));
+    }
+
+    STLITE_AVX2 static bool contains_avx2(const BitWord* b, unsigned h)
+    {
+        __m256i lo, hi;
+        masks_avx2(h, lo, hi);
+
+        const __m256i* p = reinterpret_cast<const __m256i*>(b);
+        return _mm256_testc_si256(_mm256_load_si256(p), lo) &
+               _mm256_testc_si256(_mm256_load_si256(p + 1), hi);
+    }
+#endif
+
+    void insert_hash(unsigned long long h)
+    {
+        BitWord* b = block(h);
+#ifdef STLITE_SIMD_X86
+        if (simd::level() == simd::avx2)
+        {
+            insert_avx2(b, h);
+            return;
+        }
+#endif
+        insert_scalar(b, h);
+    }
+
+    bool contains_hash(unsigned long long h) const
+    {
+        const BitWord* b = block(h);
+#ifdef STLITE_SIMD_X86
+        if (simd::level() == simd::avx2)
+            return contains_avx2(b, h);
+#endif
+        return contains_scalar(b, h);
+    }
+
+public:
+    // Expected false positive rate of a filter of the given number of blocks
+    // holding the given number of keys. The number of keys of a block follows
+    // the Poisson distribution; a block with j keys gives a false positive
+    // when all eight bits of the query are among the set ones.
+    static double estimate_fpr(size_t keys, size_t blocks)
+    {
+        if (keys == 0)
+            return 0;
+
+        double load = double(keys) / blocks;
+        double spread = 12 * sqrt(load) + 30;
+        size_t first = load > spread ? load - spread : 0;
+        double fpr = 0;
+
+        // The Poisson probabilities are computed as logarithms, exp(-load)
+        // alone underflows for large loads
+        for (size_t j = first; j <= load + spread; j++)
+        {
+            double p = exp(j * log(load) - load - lgamma(j + 1.0));
+            fpr += p * pow(1 - pow(1 - 1.0 / bits_per_word, double(j)), double(block_words));
+        }
+
+        return fpr;
+    }
+
+    // Smallest filter which keeps the false positive rate at fpr for the
+    // given number of keys
+    explicit BloomFilter(size_t keys = 0, double fpr = 0.01)
+    {
+        // The block count times block_words, plus the block_words kept for
+        // the alignment, must fit in a size_t
+        const size_t max_blocks = ((size_t) -1) / block_words - 1;
+
+        size_t lo = 1;
+        size_t hi = 1;
+        while (estimate_fpr(keys, hi) > fpr && hi < max_blocks)
+            hi = hi < max_blocks / 2 ? hi * 2 : max_blocks;
+
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (estimate_fpr(keys, mid) > fpr)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        allocate_blocks(lo);
+    }
+
+    // Copy constructor
+    BloomFilter(const BloomFilter& other)
+    {
+        allocate_blocks(other._blocks);
+        stlite::copy(other._words, other._words + _blocks * block_words, _words);
+        _inserted = other._inserted;
+    }
+
+    // Move constructor
+    BloomFilter(BloomFilter&& other) { steal(other); }
+
+    ~BloomFilter() { deallocate_blocks(); }
+
+    // Copy assignment operator
+    BloomFilter& operator=(const BloomFilter& other)
+    {
+        if (&other != this)
+        {
+            deallocate_blocks();
+            allocate_blocks(other._blocks);
+            stlite::copy(other._words, other._words + _blocks * block_words, _words);
+            _inserted = other._inserted;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    BloomFilter& operator=(BloomFilter&& other)
+    {
+        if (&other != this)
+        {
+            deallocate_blocks();
+            steal(other);
+        }
+        return *this;
+    }
+
+    void insert(const Key& key)
+    {
+        insert_hash(_hash(key));
+        _inserted++;
+    }
+
+    // False if the key has certainly not been inserted
+    bool contains(const Key& key) const { return contains_hash(_hash(key)); }
+
+    void clear()
+    {
+        stlite::fill(_words, _words + _blocks * block_words, BitWord(0));
+        _inserted = 0;
+    }
+
+    // Add the keys of another filter of the same size. Return false and do
+    // nothing if the sizes differ.
+    bool merge(const BloomFilter& other)
+    {
+        if (other._blocks != _blocks)
+            return false;
+
+        bits::apply(_words, other._words, _blocks * block_words, bits::OrOp());
+        _inserted += other._inserted;
+        return true;
+    }
+
+    // Number of insertions, counting duplicates
+    size_t inserted() const { return _inserted; }
+
+    size_t block_count() const { return _blocks; }
+    unsigned long size_in_bytes() const
+    {
+        return (unsigned long) _blocks * block_words * sizeof(BitWord);
+    }
+
+    // False positive rate expected with the current number of insertions
+    double false_positive_rate() const { return estimate_fpr(_inserted, _blocks); }
+
+    // Serialization. The words are written in the byte order of the host, the
+    // hash function must be the same when reading.
+
+    unsigned long serialized_size() const { return 12 + size_in_bytes(); }
+
+    // Write serialized_size() bytes to out
+    void serialize(void* out) const
+    {
+        unsigned char* p = static_cast<unsigned char*>(out);
+        unsigned header[3] = { magic, _blocks, _inserted };
+
+        __builtin_memcpy(p, header, sizeof(header));
+        __builtin_memcpy(p + sizeof(header), _words, size_in_bytes());
+    }
+
+    // Replace the filter by a serialized one. Return false and leave the
+    // filter unchanged if the data is not a serialized filter.
+    bool deserialize(const void* in, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(in);
+        unsigned header[3];
+
+        if (size < sizeof(header))
+            return false;
+
+        __builtin_memcpy(header, p, sizeof(header));
+        size_t bytes = size - sizeof(header);
+        if (header[0] != magic || header[1] == 0 ||
+            bytes % (block_words * sizeof(BitWord)) != 0 ||
+            bytes / (block_words * sizeof(BitWord)) != header[1])
+            return false;
+
+        deallocate_blocks();
+        allocate_blocks(header[1]);
+        __builtin_memcpy(_words, p + sizeof(header), size_in_bytes());
+        _inserted = header[2];
+        return true;
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,347 @@
+// The MIT License (MIT)
+//
+// STLite chunked file reader
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CHUNKED_READER_H
+#define CHUNKED_READER_H
+
+#include "allocator.h"
+#include "queue.h"
+#include "span.h"
+#include "vector.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace stlite
+{
+
+constexpr size_t chunked_reader_chunk_size = 1 << 20;
+
+// Alignment of the chunks in memory and in the file, which O_DIRECT needs
+constexpr size_t chunked_reader_alignment = 4096;
+
+// Options of ChunkedReader::open(), may be combined with |
+enum ChunkedReadFlags
+{
+    chunked_read_direct = 1,     // O_DIRECT, bypass the page cache
+    chunked_read_drop_cache = 2, // Drop the chunks from the page cache once read
+};
+
+// Sequential reader of large files which keeps only one chunk in memory.
+// The file is read in large aligned chunks, hinted as sequential with
+// posix_fadvise(), and handed out as fixed-size records or as lines:
+//
+//   stlite::ChunkedReader reader;
+//   if (!reader.open("events.bin"))
+//       ...
+//   stlite::Vector<Event> batch;
+//   while (reader.next_batch(batch, 4096))
+//       process(batch);
+//
+// A record or a line may straddle two chunks, the part at the end of one
+// chunk is carried over in front of the next, so a record or a line can be
+// at most one chunk long. The functions return false at the end of the
+// file and on errors, error() tells them apart.
+class ChunkedReader
+{
+    int _fd = -1;
+    bool _owns_fd = false;
+    unsigned _flags = 0;
+    size_t _chunk_size = 0;
+
+    // Carry area of _chunk_size bytes followed by the chunk, both aligned
+    char* _memory = nullptr;
+    char* _chunk = nullptr;
+
+    // Bytes not consumed yet, at the end of the carry area and in the chunk
+    const char* _pos = nullptr;
+    const char* _end = nullptr;
+
+    unsigned long _offset = 0;  // File offset of the end of the chunk
+    unsigned long _dropped = 0; // Bytes dropped from the page cache
+    bool _eof = false;
+    bool _error = false;
+
+    size_t available() const { return _end - _pos; }
+
+    // Read the next chunk, keeping the bytes which haven't been consumed.
+    // Returns false if nothing could be read.
+    bool refill()
+    {
+        if (_eof || _error)
+            return false;
+
+        size_t carry = available();
+        if (carry > _chunk_size)
+        {
+            _error = true;
+            return false;
+        }
+        memmove(_chunk - carry, _pos, carry);
+
+        if ((_flags & chunked_read_drop_cache) && _offset > _dropped)
+        {
+            posix_fadvise(_fd, _dropped, _offset - _dropped, POSIX_FADV_DONTNEED);
+            _dropped = _offset;
+        }
+
+        // A regular file returns whole chunks, a pipe may return less
+        ssize_t n = read(_fd, _chunk, _chunk_size);
+        if (n < 0 && errno == EINVAL && (_flags & chunked_read_direct))
+        {
+            // The file system doesn't support O_DIRECT
+            _flags &= ~chunked_read_direct;
+            fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+            n = read(_fd, _chunk, _chunk_size);
+        }
+
+        _pos = _chunk - carry;
+        _end = _chunk + (n > 0 ? n : 0);
+
+        if (n < 0)
+            _error = true;
+        else if (n == 0)
+            _eof = true;
+        else
+            _offset += n;
+
+        return n > 0;
+    }
+
+    // Make at least n bytes available, false at the end of the file
+    bool ensure(size_t n)
+    {
+        while (available() < n)
+            if (!refill())
+                return false;
+        return true;
+    }
+
+    bool attach(int fd, bool owns_fd, size_t chunk_size, unsigned flags)
+    {
+        chunk_size = (chunk_size + chunked_reader_alignment - 1) & ~(chunked_reader_alignment - 1);
+        if (chunk_size == 0)
+            chunk_size = chunked_reader_alignment;
+
+        void* memory;
+        if (posix_memalign(&memory, chunked_reader_alignment, 2 * (unsigned long) chunk_size) != 0)
+        {
+            if (owns_fd)
+                ::close(fd);
+            return false;
+        }
+
+        _fd = fd;
+        _owns_fd = owns_fd;
+        _flags = flags;
+        _chunk_size = chunk_size;
+        _memory = static_cast<char*>(memory);
+        _chunk = _memory + chunk_size;
+        _pos = _end = _chunk;
+
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return true;
+    }
+
+public:
+    ChunkedReader() {}
+
+    ChunkedReader(const ChunkedReader& other) = delete;
+    ChunkedReader& operator=(const ChunkedReader& other) = delete;
+
+    ~ChunkedReader() { close(); }
+
+    // Open the file at path, chunk_size is rounded up to the alignment
+    bool open(const char* path, unsigned flags = 0, size_t chunk_size = chunked_reader_chunk_size)
+    {
+        close();
+
+        int fd = -1;
+        if (flags & chunked_read_direct)
+            fd = ::open(path, O_RDONLY | O_DIRECT);
+        if (fd < 0)
+            fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        return attach(fd, true, chunk_size, flags);
+    }
+
+    // Read from an open file descriptor, like a pipe or a socket, which is
+    // not closed by the reader
+    bool open(int fd, unsigned flags = 0, size_t chunk_size = chunked_reader_chunk_size)
+    {
+        close();
+        return attach(fd, false, chunk_size, flags & ~chunked_read_direct);
+    }
+
+    void close()
+    {
+        if (_owns_fd && _fd >= 0)
+            ::close(_fd);
+        free(_memory);
+
+        _fd = -1;
+        _owns_fd = false;
+        _memory = _chunk = nullptr;
+        _pos = _end = nullptr;
+        _offset = _dropped = 0;
+        _eof = _error = false;
+    }
+
+    bool is_open() const { return _fd >= 0; }
+
+    // Whether reading failed, or a record or a line was longer than a chunk
+    bool error() const { return _error; }
+
+    // Whether the whole file has been consumed
+    bool done() const { return _eof && available() == 0; }
+
+    // Records
+
+    // Read the next record, false at the end of the file. A partial record
+    // at the end of the file is an error.
+    template <class T>
+    bool next(T& record)
+    {
+        static_assert(__is_trivially_copyable(T), "Records must be trivially copyable");
+
+        if (!ensure(sizeof(T)))
+        {
+            if (available() > 0)
+                _error = true;
+            return false;
+        }
+        memcpy(static_cast<void*>(&record), _pos, sizeof(T));
+        _pos += sizeof(T);
+        return true;
+    }
+
+    // Replace the contents of batch with the next at most max records,
+    // false if there are none left
+    template <class T, class Alloc>
+    bool next_batch(Vector<T, Alloc>& batch, size_t max)
+    {
+        static_assert(__is_trivially_copyable(T), "Records must be trivially copyable");
+
+        batch.clear();
+        batch.reserve(max);
+
+        T record;
+        while (batch.size() < max && next(record))
+        {
+            batch.push_back(record);
+
+            // The rest of the whole records in the chunk without the checks
+            // of next()
+            size_t n = available() / sizeof(T);
+            if (n > max - batch.size())
+                n = max - batch.size();
+            for (size_t i = 0; i < n; i++, _pos += sizeof(T))
+            {
+                memcpy(static_cast<void*>(&record), _pos, sizeof(T));
+                batch.push_back(record);
+            }
+        }
+        return !batch.empty();
+    }
+
+    // Push records to the queue until it holds max elements, so the memory
+    // of the queue stays bounded while a consumer pops them. Returns the
+    // number of records pushed, 0 at the end of the file.
+    template <class T, class Alloc>
+    size_t fill(Queue<T, Alloc>& queue, size_t max)
+    {
+        size_t pushed = 0;
+        T record;
+        while (queue.size() < max && next(record))
+        {
+            queue.push(record);
+            pushed++;
+        }
+        return pushed;
+    }
+
+    // Lines
+
+    // Read the next line without its '\n'. The line points into the chunk
+    // and is valid until the next call. The last line may lack the '\n'.
+    bool next_line(Span<const char>& line)
+    {
+        size_t scanned = 0;
+        while (true)
+        {
+            const char* nl = static_cast<const char*>(memchr(_pos + scanned, '\n', available() - scanned));
+            if (nl)
+            {
+                line = Span<const char>(_pos, nl - _pos);
+                _pos = nl + 1;
+                return true;
+            }
+
+            scanned = available();
+            if (!refill())
+                break;
+        }
+
+        if (_error || available() == 0)
+            return false;
+
+        line = Span<const char>(_pos, available());
+        _pos = _end;
+        return true;
+    }
+
+    // Replace the contents of batch with the next at most max lines which
+    // are in the current chunk, false if there are none left. The lines
+    // are valid until the next call.
+    template <class Alloc>
+    bool next_lines(Vector<Span<const char>, Alloc>& batch, size_t max)
+    {
+        batch.clear();
+
+        Span<const char> line;
+        if (!next_line(line))
+            return false;
+        batch.push_back(line);
+
+        // Only the complete lines of the chunk, reading more could move it
+        while (batch.size() < max)
+        {
+            const char* nl = static_cast<const char*>(memchr(_pos, '\n', available()));
+            if (!nl)
+                break;
+            batch.push_back(Span<const char>(_pos, nl - _pos));
+            _pos = nl + 1;
+        }
+        return true;
+    }
+};
+
+} // namespace stlite
+
+#endif
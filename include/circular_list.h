@@ -24,12 +24,14 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include "algorithms.h"
 #include "allocator.h"
+#include "trace.h"
 
 namespace stlite
 {
 
-template <class T>
+template <class T, class Alloc = Allocator<T>>
 class CircularList
 {
     struct Element
@@ -52,79 +54,112 @@ class CircularList
     Element* _lst = nullptr;
     size_t _size = 0;
 
+    typedef typename Alloc::template rebind<Element>::other ElementAlloc;
+    ElementAlloc _alloc;
+
+    // Append copies of the elements of other
+    void copy_elements(const CircularList& other)
+    {
+        other.for_each([this](const T& value) { push_back(value); });
+    }
+
+    // Take the elements of other, which must be releasable by our allocator
+    void steal(CircularList& other)
+    {
+        _lst = other._lst;
+        _size = other._size;
+
+        other._lst = nullptr;
+        other._size = 0;
+    }
+
+    // Break the circle and return the first element of the now nullptr
+    // terminated list. The list must not be empty.
+    Element* open()
+    {
+        Element* first = _lst->next;
+        _lst->next = nullptr;
+        return first;
+    }
+
+    // Close the nullptr terminated list starting with first back into a
+    // circle. tail must be the last element of that list.
+    void close(Element* first, Element* tail)
+    {
+        tail->next = first;
+        _lst = tail;
+    }
+
 public:
     CircularList() {}
 
+    explicit CircularList(const Alloc& alloc) : _alloc(alloc) {}
+
     // This constructor creates list from the given array
-    CircularList(const T* arr, size_t len)
+    CircularList(const T* arr, size_t len, const Alloc& alloc = Alloc()) : _alloc(alloc)
     {
         for (size_t i = 0; i < len; i++)
             push_back(arr[i]);
     }
 
     // Copy constructor
-    CircularList(const CircularList<T>& other)
+    CircularList(const CircularList& other)
+        : _alloc(AllocatorTraits<ElementAlloc>::select_on_copy_construction(other._alloc))
     {
-        if (&other != this && other._lst)
-        {
-            // Pointer to the first element
-            Element* p = other._lst->next;
-            while (p != other._lst)
-            {
-                push_back(p->value);
-                p = p->next;
-            }
-
-            push_back(p->value);
-        }
+        copy_elements(other);
     }
 
+    CircularList(const CircularList& other, const Alloc& alloc) : _alloc(alloc) { copy_elements(other); }
+
     // Move constructor
-    CircularList(CircularList<T>&& other)
+    CircularList(CircularList&& other) : _alloc(other._alloc) { steal(other); }
+
+    // The elements are copied when the allocators are not equal
+    CircularList(CircularList&& other, const Alloc& alloc) : _alloc(alloc)
     {
-        if (&other != this)
+        if (AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+            steal(other);
+        else
         {
-            _lst = other._lst;
-            _size = other._size;
-
-            other._lst = nullptr;
-            other._size = 0;
+            copy_elements(other);
+            other.clear();
         }
     }
 
     ~CircularList() { clear(); }                      // Destructor
 
     // Copy assignment operator
-    CircularList<T>& operator=(const CircularList<T>& other)
+    CircularList& operator=(const CircularList& other)
     {
-        if (&other != this && other._lst)
+        if (&other != this)
         {
             clear();
-
-            // Pointer to the first element
-            Element* p = other._lst->next;
-            while (p != other._lst)
-            {
-                push_back(p->value);
-                p = p->next;
-            }
-
-            push_back(p->value);
+            if (AllocatorTraits<ElementAlloc>::propagate_on_copy_assignment)
+                _alloc = other._alloc;
+            copy_elements(other);
         }
         return *this;
     }
 
     // Move assignment operator
-    CircularList<T>& operator=(CircularList<T>&& other)
+    CircularList& operator=(CircularList&& other)
     {
         if (&other != this)
         {
             clear();
-            _lst = other._lst;
-            _size = other._size;
 
-            other._lst = nullptr;
-            other._size = 0;
+            if (AllocatorTraits<ElementAlloc>::propagate_on_move_assignment)
+            {
+                _alloc = other._alloc;
+                steal(other);
+            }
+            else if (AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+                steal(other);
+            else
+            {
+                copy_elements(other);
+                other.clear();
+            }
         }
         return *this;
     }
@@ -233,6 +268,7 @@ public:
                 p = p->next;
                 n++;
             }
+            STLITE_TRACE_EVENT("CircularList::at", "steps", n, "size", _size);
 
             if ((n == pos) || (p == _lst && n+1 == pos))
                 return p->value;
@@ -244,7 +280,7 @@ public:
     // Append element to end of the list
     void push_back(const T& value)
     {
-        Element* e = new Element(value);
+        Element* e = _alloc.construct(value);
 
         if (!_lst)
         {
@@ -263,7 +299,7 @@ public:
     // Insert element at beginning of the list
     void push_front(const T& value)
     {
-        Element* e = new Element(value);
+        Element* e = _alloc.construct(value);
 
         if (!_lst)
         {
@@ -292,7 +328,7 @@ public:
 
         if (_lst->next == _lst)
         {
-            delete _lst;
+            _alloc.destroy(_lst);
             _lst = nullptr;
             _size = 0;
         }
@@ -300,7 +336,7 @@ public:
         {
             Element* old = _lst->next;
             _lst->next = _lst->next->next;
-            delete old;
+            _alloc.destroy(old);
             _size--;
         }
 
@@ -316,7 +352,7 @@ public:
         {
             // The list contains a single element
 
-            delete _lst;
+            _alloc.destroy(_lst);
             _lst = nullptr;
             _size = 0;
         }
@@ -328,8 +364,9 @@ public:
             Element *p = _lst->next;
             while (p->next != _lst)
                 p = p->next;
+            STLITE_TRACE_EVENT("CircularList::pop_back", "size", _size);
             p->next = _lst->next;
-            delete _lst;
+            _alloc.destroy(_lst);
             _lst = p;
             _size--;
         }
@@ -341,7 +378,7 @@ public:
     {
         if (pos._prev)
         {
-            Element* e = new Element(value);
+            Element* e = _alloc.construct(value);
             e->next = pos._prev->next;
             pos._prev->next = e;
             pos._prev = pos._prev->next;
@@ -359,7 +396,7 @@ public:
         {
             Element* old = pos._prev->next;
             pos._prev = pos._prev->next;
-            delete old;
+            _alloc.destroy(old);
         }
     }
 
@@ -379,6 +416,63 @@ public:
         }
     }
 
+    // Move all elements of other to the end of this list in O(1). Nodes are
+    // relinked, not copied, and other becomes empty. When the allocators are
+    // not equal the elements are copied into our memory first.
+    void splice(CircularList& other)
+    {
+        if (&other == this || !other._lst)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            CircularList own(static_cast<CircularList&&>(other), get_allocator());
+            splice(own);
+            return;
+        }
+
+        if (_lst)
+        {
+            Element* first = _lst->next;
+            _lst->next = other._lst->next;
+            other._lst->next = first;
+        }
+
+        _lst = other._lst;
+        _size += other._size;
+
+        other._lst = nullptr;
+        other._size = 0;
+    }
+
+    // Move all elements of other in front of the position pos in O(1)
+    void splice(const Iterator& pos, CircularList& other)
+    {
+        if (&other == this || !other._lst)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            CircularList own(static_cast<CircularList&&>(other), get_allocator());
+            splice(pos, own);
+            return;
+        }
+
+        if (!_lst || !pos._prev || pos._is_end)
+        {
+            splice(other);
+            return;
+        }
+
+        Element* first = other._lst->next;
+        other._lst->next = pos._prev->next;
+        pos._prev->next = first;
+        _size += other._size;
+
+        other._lst = nullptr;
+        other._size = 0;
+    }
+
     void clear()
     {
         if (!_lst)
@@ -390,14 +484,27 @@ public:
         {
             Element* old = _lst->next;
             _lst->next = _lst->next->next;
-            delete old;
+            _alloc.destroy(old);
         }
 
-        delete _lst;
+        _alloc.destroy(_lst);
         _lst = nullptr;
         _size = 0;
     }
 
+    // The allocators are exchanged only if they propagate on swap,
+    // otherwise they must be equal
+    void swap(CircularList& other)
+    {
+        if (AllocatorTraits<ElementAlloc>::propagate_on_swap)
+            stlite::swap(_alloc, other._alloc);
+        stlite::swap(_lst, other._lst);
+        stlite::swap(_size, other._size);
+    }
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
     // Operations
 
     // Remove element with the value from the list.
@@ -411,7 +518,7 @@ public:
         {
             if (_lst->value == value)
             {
-                delete _lst;
+                _alloc.destroy(_lst);
                 _size--;
                 return true;
             }
@@ -432,7 +539,7 @@ public:
 
             Element* old = p->next;
             p->next = p->next->next;
-            delete old;
+            _alloc.destroy(old);
             _size--;
 
             return true;
@@ -453,7 +560,77 @@ public:
         return false;
     }
 
-    void reverse() {}
+    // Call f(value) for the elements from the front
+    template <class F>
+    void for_each(F f) const
+    {
+        if (!_lst)
+            return;
+
+        const Element* p = _lst;
+        do
+        {
+            p = p->next;
+            f(p->value);
+        } while (p != _lst);
+    }
+
+    void reverse()
+    {
+        if (!_lst)
+            return;
+
+        // The first element becomes the last one
+        Element* first = open();
+        close(list_reverse(first), first);
+    }
+
+    // Merge sorted other into this sorted list, other becomes empty
+    void merge(CircularList& other)
+    {
+        if (&other == this || !other._lst)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            CircularList own(static_cast<CircularList&&>(other), get_allocator());
+            merge(own);
+            return;
+        }
+
+        if (!_lst)
+        {
+            splice(other);
+            return;
+        }
+
+        // list_merge() takes equal values from this list first, therefore
+        // the last element of other ends last unless our last one is greater.
+        Element* tail = (other._lst->value < _lst->value) ? _lst : other._lst;
+
+        Element* a = open();
+        Element* b = other.open();
+        close(list_merge(a, b), tail);
+        _size += other._size;
+
+        other._lst = nullptr;
+        other._size = 0;
+    }
+
+    // Stable O(n log n) sort, nodes are relinked without allocation
+    void sort()
+    {
+        if (!_lst)
+            return;
+
+        Element* first = list_sort(open());
+
+        Element* tail = first;
+        while (tail->next)
+            tail = tail->next;
+
+        close(first, tail);
+    }
 };
 
 } // namespace stlite
@@ -0,0 +1,347 @@
+// The MIT License (MIT)
+//
+// STLite concurrent skip list
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CONCURRENT_SKIP_LIST_H
+#define CONCURRENT_SKIP_LIST_H
+
+#include "epoch.h"
+#include "skip_list.h"
+
+#include <new>
+
+namespace stlite
+{
+
+// Lock-free ordered set on a skip list (Herlihy and Shavit, "The Art of
+// Multiprocessor Programming", with Fraser's handling of the upper levels).
+// Any number of threads may insert, erase and search at the same time.
+//
+// A node is erased by marking the low bit of its next pointers, the top
+// level first and the bottom level last, which is the point where it leaves
+// the set. Searches unlink the marked nodes they pass by. An unlinked node
+// is handed to the epoch domain of the list and deleted once no thread can
+// be reading it. Its inserter may still be linking its upper levels while it
+// is being erased, so it is retired only when both the inserter and the
+// eraser are done with it.
+//
+// size() and for_each() are exact only when no other thread modifies the
+// list; for_each() visits the elements in order and never visits an element
+// erased before it started.
+//
+// The nodes are allocated in NodeBytes units of Alloc, which must be safe to
+// call from several threads, and released by whichever thread collects them.
+template <class T, class Compare = Less<T>, class Alloc = Allocator<T>>
+class ConcurrentSkipList
+{
+    typedef unsigned long Link; // Node pointer, low bit set when marked
+
+    struct Node
+    {
+        unsigned level;
+        unsigned owners; // Inserter and eraser not yet done with the node
+        T value;
+        Link next[1];
+
+        static size_t bytes(unsigned level) { return sizeof(Node) + (level - 1) * sizeof(Link); }
+    };
+
+    typedef typename Alloc::template rebind<NodeBytes<Node>>::other NodeAlloc;
+
+    static Node* ptr(Link l) { return reinterpret_cast<Node*>(l & ~Link(1)); }
+    static Link link(Node* n) { return reinterpret_cast<Link>(n); }
+    static bool marked(Link l) { return l & 1; }
+
+    static Link load(const Link& l) { return __atomic_load_n(&l, __ATOMIC_ACQUIRE); }
+
+    static bool cas(Link& l, Link expected, Link desired)
+    {
+        return __atomic_compare_exchange_n(&l, &expected, desired, false, __ATOMIC_ACQ_REL,
+                                           __ATOMIC_ACQUIRE);
+    }
+
+    Node* _head; // Value not constructed
+    long _size = 0;
+    Compare _comp;
+    NodeAlloc _alloc;
+    mutable EpochDomain _epoch;
+
+    Node* allocate(unsigned level)
+    {
+        Node* node = reinterpret_cast<Node*>(_alloc.allocate(NodeBytes<Node>::units(Node::bytes(level))));
+        node->level = level;
+        return node;
+    }
+
+    void deallocate(Node* node)
+    {
+        _alloc.deallocate(reinterpret_cast<NodeBytes<Node>*>(node), NodeBytes<Node>::units(Node::bytes(node->level)));
+    }
+
+    Node* create(const T& value, unsigned level)
+    {
+        Node* node = allocate(level);
+        new (&node->value) T(value);
+        node->owners = 2;
+        return node;
+    }
+
+    void destroy(Node* node)
+    {
+        node->value.~T();
+        deallocate(node);
+    }
+
+    static void destroy_retired(void* p, void* list)
+    {
+        static_cast<ConcurrentSkipList*>(list)->destroy(static_cast<Node*>(p));
+    }
+
+    static unsigned random_level()
+    {
+        static thread_local unsigned long long state =
+            0x9e3779b97f4a7c15ULL * (EpochThreadIndex::current() + 1);
+        return skip_list_level(state);
+    }
+
+    // Called by the inserter and by the eraser when they are done
+    void release(Node* node)
+    {
+        if (__atomic_sub_fetch(&node->owners, 1, __ATOMIC_ACQ_REL) == 0)
+            _epoch.retire(node, &destroy_retired, this);
+    }
+
+    // Predecessors and successors of value at all the levels, unlinking the
+    // marked nodes on the way. Returns whether succs[0] is equal to value.
+    bool search(const T& value, Node** preds, Node** succs)
+    {
+    retry:
+        Node* pred = _head;
+        for (unsigned i = skip_list_max_level; i-- > 0;)
+        {
+            Node* curr = ptr(load(pred->next[i]));
+            while (curr)
+            {
+                Link succ = load(curr->next[i]);
+                while (marked(succ))
+                {
+                    if (!cas(pred->next[i], link(curr), succ & ~Link(1)))
+                        goto retry;
+                    curr = ptr(succ);
+                    if (!curr)
+                        break;
+                    succ = load(curr->next[i]);
+                }
+
+                if (!curr || !_comp(curr->value, value))
+                    break;
+
+                pred = curr;
+                curr = ptr(succ);
+            }
+            preds[i] = pred;
+            succs[i] = curr;
+        }
+        return succs[0] && !_comp(value, succs[0]->value);
+    }
+
+    // First unmarked node not less than value, without unlinking anything,
+    // so readers don't write to the shared nodes
+    const Node* lower_bound_node(const T& value) const
+    {
+        const Node* pred = _head;
+        const Node* curr = nullptr;
+
+        for (unsigned i = skip_list_max_level; i-- > 0;)
+        {
+            curr = ptr(load(pred->next[i]));
+            while (curr)
+            {
+                Link succ = load(curr->next[i]);
+                if (!marked(succ) && !_comp(curr->value, value))
+                    break;
+                if (!marked(succ))
+                    pred = curr;
+                curr = ptr(succ);
+            }
+        }
+        return curr;
+    }
+
+public:
+    explicit ConcurrentSkipList(const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+        : _comp(comp), _alloc(alloc)
+    {
+        _head = allocate(skip_list_max_level);
+        for (unsigned i = 0; i < skip_list_max_level; i++)
+            _head->next[i] = 0;
+    }
+
+    explicit ConcurrentSkipList(const Alloc& alloc) : ConcurrentSkipList(Compare(), alloc) {}
+
+    ConcurrentSkipList(const ConcurrentSkipList& other) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList& other) = delete;
+
+    // No other thread may use the list any more
+    ~ConcurrentSkipList()
+    {
+        Node* node = ptr(_head->next[0]);
+        while (node)
+        {
+            Node* next = ptr(node->next[0]);
+            destroy(node);
+            node = next;
+        }
+        deallocate(_head);
+    }
+
+    // Capacity
+    bool empty() const { return size() == 0; }
+    unsigned size() const { return __atomic_load_n(&_size, __ATOMIC_RELAXED); }
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
+    // Modifiers
+
+    // Insert the value unless an equal one is present, returns whether it
+    // has been inserted
+    bool insert(const T& value)
+    {
+        EpochDomain::Guard guard(_epoch);
+        Node* preds[skip_list_max_level];
+        Node* succs[skip_list_max_level];
+        unsigned level = random_level();
+        Node* node = nullptr;
+
+        while (true)
+        {
+            if (search(value, preds, succs))
+            {
+                if (node)
+                    destroy(node);
+                return false;
+            }
+
+            if (!node)
+                node = create(value, level);
+            for (unsigned i = 0; i < level; i++)
+                node->next[i] = link(succs[i]);
+
+            // The node is in the set once it is linked at the bottom level
+            if (cas(preds[0]->next[0], link(succs[0]), link(node)))
+                break;
+        }
+        __atomic_add_fetch(&_size, 1, __ATOMIC_RELAXED);
+
+        for (unsigned i = 1; i < level; i++)
+        {
+            while (true)
+            {
+                // Point the node to the successor, unless it is being erased
+                Link next = load(node->next[i]);
+                if (marked(next))
+                    goto linked;
+                if (next != link(succs[i]) && !cas(node->next[i], next, link(succs[i])))
+                    goto linked;
+
+                if (cas(preds[i]->next[i], link(succs[i]), link(node)))
+                    break;
+
+                search(value, preds, succs);
+                if (succs[0] != node)
+                    goto linked;
+            }
+        }
+
+    linked:
+        // An eraser may have missed the levels linked after it marked them
+        if (marked(load(node->next[0])))
+            search(value, preds, succs);
+        release(node);
+        return true;
+    }
+
+    bool erase(const T& value)
+    {
+        EpochDomain::Guard guard(_epoch);
+        Node* preds[skip_list_max_level];
+        Node* succs[skip_list_max_level];
+
+        if (!search(value, preds, succs))
+            return false;
+
+        Node* node = succs[0];
+        for (unsigned i = node->level; i-- > 1;)
+        {
+            Link next = load(node->next[i]);
+            while (!marked(next) && !cas(node->next[i], next, next | 1))
+                next = load(node->next[i]);
+        }
+
+        // Marking the bottom level erases the node, only one thread succeeds
+        Link next = load(node->next[0]);
+        while (true)
+        {
+            if (marked(next))
+                return false;
+            if (cas(node->next[0], next, next | 1))
+                break;
+            next = load(node->next[0]);
+        }
+        __atomic_sub_fetch(&_size, 1, __ATOMIC_RELAXED);
+
+        // Unlink the node from all the levels
+        search(value, preds, succs);
+        release(node);
+        return true;
+    }
+
+    // Operations
+
+    bool contains(const T& value) const
+    {
+        EpochDomain::Guard guard(_epoch);
+        const Node* node = lower_bound_node(value);
+        return node && !_comp(value, node->value);
+    }
+
+    unsigned count(const T& value) const { return contains(value); }
+
+    // Call f(value) for the elements in order
+    template <class F>
+    void for_each(F f) const
+    {
+        EpochDomain::Guard guard(_epoch);
+        for (const Node* node = ptr(load(_head->next[0])); node;)
+        {
+            Link next = load(node->next[0]);
+            if (!marked(next))
+                f(node->value);
+            node = ptr(next);
+        }
+    }
+};
+
+} // namespace stlite
+
+#endif
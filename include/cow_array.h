@@ -0,0 +1,191 @@
+// The MIT License (MIT)
+//
+// STLite copy-on-write array
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef COW_ARRAY_H
+#define COW_ARRAY_H
+
+#include "cow_buffer.h"
+#include "iterator.h"
+
+#include <assert.h>
+
+#ifdef USE_STL
+#include <initializer_list>
+#endif
+
+namespace stlite
+{
+
+// Array with copy-on-write semantics, see CowVector. The buffer is detached
+// the first time a shared array is modified through operator[], at(),
+// front(), back(), data(), begin() or fill().
+template <class T, class Alloc = Allocator<T>>
+class CowArray
+{
+    CowBuffer<T, Alloc> _buffer;
+    size_t _max_size = -1;
+    size_t _size = 0;
+
+public:
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
+
+    CowArray() {}
+
+    explicit CowArray(const Alloc& alloc) : _buffer(alloc) {}
+
+    // Fill constructors
+    explicit CowArray(size_t n, const Alloc& alloc = Alloc()) : _buffer(n, alloc), _size(n) {}
+
+    explicit CowArray(size_t n, const T& val, const Alloc& alloc = Alloc())
+        : _buffer(n, alloc), _size(n)
+    {
+        fill(val);
+    }
+
+    // This constructor creates array from the given array
+    CowArray(const T* arr, size_t len, const Alloc& alloc = Alloc())
+        : _buffer(len, alloc), _size(len)
+    {
+        T* data = _buffer.data();
+        for (unsigned i = 0; i < len; i++)
+            data[i] = arr[i];
+    }
+
+#ifdef USE_STL
+    CowArray(std::initializer_list<T> initlst, const Alloc& alloc = Alloc())
+        : _buffer(initlst.size(), alloc), _size(initlst.size())
+    {
+        T* data = _buffer.data();
+        unsigned idx = 0;
+
+        for (auto x : initlst)
+            data[idx++] = x;
+    }
+#endif
+
+    // Copy constructor, O(1)
+    CowArray(const CowArray& other) = default;
+
+    // Move constructor
+    CowArray(CowArray&& other) : _buffer(static_cast<CowBuffer<T, Alloc>&&>(other._buffer))
+    {
+        _size = other._size;
+        other._size = 0;
+    }
+
+    ~CowArray() {}
+
+    // Copy assignment operator, O(1)
+    CowArray& operator=(const CowArray& other) = default;
+
+    // Move assignment operator
+    CowArray& operator=(CowArray&& other)
+    {
+        if (&other != this)
+        {
+            _buffer = static_cast<CowBuffer<T, Alloc>&&>(other._buffer);
+            _size = other._size;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    // Iterators
+    Iterator begin() { return Iterator(data()); }
+    Iterator end() { return Iterator(data() + _size); }
+
+    ConstIterator begin() const { return ConstIterator(_buffer.data()); }
+    ConstIterator end() const { return ConstIterator(_buffer.data() + _size); }
+
+    ConstIterator cbegin() const { return ConstIterator(_buffer.data()); }
+    ConstIterator cend() const { return ConstIterator(_buffer.data() + _size); }
+
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
+
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t max_size() const { return _max_size; }
+    bool empty() const { return _size == 0; }
+
+    // Number of arrays sharing the buffer
+    unsigned use_count() const { return _buffer.use_count(); }
+
+    // Allocator
+    Alloc get_allocator() const { return _buffer.get_allocator(); }
+
+    // Element access
+    T& operator[](int n) { return data()[n]; }
+    const T& operator[](int n) const { return _buffer.data()[n]; }
+
+    T& at(unsigned n)
+    {
+        assert(n < _size);
+        return data()[n];
+    }
+
+    const T& at(unsigned n) const
+    {
+        assert(n < _size);
+        return _buffer.data()[n];
+    }
+
+    T& front() { return data()[0]; }
+    T& back() { return data()[_size - 1]; }
+
+    const T& front() const { return _buffer.data()[0]; }
+    const T& back() const { return _buffer.data()[_size - 1]; }
+
+    T* data()
+    {
+        _buffer.detach(_size);
+        return _buffer.data();
+    }
+
+    const T* data() const { return _buffer.data(); }
+
+    // Modifiers
+    void fill(const T& value)
+    {
+        // Old contents are overwritten, there is no need to copy them
+        if (!_buffer.unique())
+            _buffer.reallocate(_size, 0);
+
+        T* d = _buffer.data();
+        for (unsigned i = 0; i < _size; ++i)
+            d[i] = value;
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,182 @@
+// The MIT License (MIT)
+//
+// STLite copy-on-write buffer
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef COW_BUFFER_H
+#define COW_BUFFER_H
+
+#include "algorithms.h"
+#include "allocator.h"
+
+namespace stlite
+{
+
+// Reference counted storage shared by copy-on-write containers. Copying a
+// CowBuffer only increments the reference count. The count is updated
+// atomically, so different buffers sharing the storage can be used from
+// different threads. A single buffer must not be modified concurrently.
+template <class T, class Alloc = Allocator<T>>
+class CowBuffer
+{
+    struct Block
+    {
+        unsigned refs = 1;
+        size_t capacity = 0;
+        T* data = nullptr;
+        Alloc allocator; // Allocated the block, which may outlive the buffer
+
+        explicit Block(const Alloc& alloc) : allocator(alloc) {}
+    };
+
+    typedef typename Alloc::template rebind<Block>::other BlockAlloc;
+
+    Block* _block = nullptr;
+    Alloc allocator;
+
+    Block* create(size_t capacity)
+    {
+        Block* b = BlockAlloc(allocator).construct(allocator);
+        b->capacity = capacity;
+        b->data = allocator.allocate(capacity);
+        return b;
+    }
+
+    void retain()
+    {
+        if (_block)
+            __atomic_add_fetch(&_block->refs, 1, __ATOMIC_RELAXED);
+    }
+
+    void release()
+    {
+        if (_block && __atomic_sub_fetch(&_block->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            _block->allocator.deallocate(_block->data, _block->capacity);
+            BlockAlloc(_block->allocator).destroy(_block);
+        }
+        _block = nullptr;
+    }
+
+public:
+    CowBuffer() {}
+
+    explicit CowBuffer(const Alloc& alloc) : allocator(alloc) {}
+
+    explicit CowBuffer(size_t capacity, const Alloc& alloc = Alloc()) : allocator(alloc)
+    {
+        if (capacity)
+            _block = create(capacity);
+    }
+
+    // Copy constructor, shares the storage
+    CowBuffer(const CowBuffer& other)
+        : _block(other._block),
+          allocator(AllocatorTraits<Alloc>::select_on_copy_construction(other.allocator))
+    {
+        retain();
+    }
+
+    // Move constructor
+    CowBuffer(CowBuffer&& other) : _block(other._block), allocator(other.allocator)
+    {
+        other._block = nullptr;
+    }
+
+    ~CowBuffer() { release(); }
+
+    // Copy assignment operator. The storage is released by the allocator
+    // which allocated it, so it is shared whatever the allocators are; the
+    // allocator only decides where the storage of the next detach() comes
+    // from.
+    CowBuffer& operator=(const CowBuffer& other)
+    {
+        if (AllocatorTraits<Alloc>::propagate_on_copy_assignment)
+            allocator = other.allocator;
+        if (other._block != _block)
+        {
+            release();
+            _block = other._block;
+            retain();
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    CowBuffer& operator=(CowBuffer&& other)
+    {
+        if (&other != this)
+        {
+            if (AllocatorTraits<Alloc>::propagate_on_move_assignment)
+                allocator = other.allocator;
+            release();
+            _block = other._block;
+            other._block = nullptr;
+        }
+        return *this;
+    }
+
+    // The allocators are exchanged only if they propagate on swap
+    void swap(CowBuffer& other)
+    {
+        if (AllocatorTraits<Alloc>::propagate_on_swap)
+            stlite::swap(allocator, other.allocator);
+        stlite::swap(_block, other._block);
+    }
+
+    Alloc get_allocator() const { return allocator; }
+
+    T* data() { return _block ? _block->data : nullptr; }
+    const T* data() const { return _block ? _block->data : nullptr; }
+
+    size_t capacity() const { return _block ? _block->capacity : 0; }
+
+    // Number of buffers sharing the storage
+    unsigned use_count() const
+    {
+        return _block ? __atomic_load_n(&_block->refs, __ATOMIC_ACQUIRE) : 0;
+    }
+
+    bool unique() const { return use_count() <= 1; }
+
+    // Make sure the storage is not shared before it is written to. Only the
+    // first "used" elements are copied.
+    void detach(size_t used)
+    {
+        if (!unique())
+            reallocate(_block->capacity, used);
+    }
+
+    // Move to a new private storage of the given capacity keeping the first
+    // "used" elements
+    void reallocate(size_t capacity, size_t used)
+    {
+        Block* b = create(capacity);
+        if (_block)
+            copy<T>(_block->data, _block->data + used, b->data);
+        release();
+        _block = b;
+    }
+};
+
+} // namespace stlite
+
+#endif
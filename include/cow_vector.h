@@ -0,0 +1,240 @@
+// The MIT License (MIT)
+//
+// STLite copy-on-write vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef COW_VECTOR_H
+#define COW_VECTOR_H
+
+#include "cow_buffer.h"
+#include "iterator.h"
+#include "vector.h"
+
+#include <assert.h>
+
+#ifdef USE_STL
+#include <initializer_list>
+#endif
+
+namespace stlite
+{
+
+// Vector with copy-on-write semantics. Copies share the buffer and cost O(1),
+// the buffer is copied (detached) the first time a shared vector is modified
+// through a non-const member: operator[], at(), front(), back(), data(),
+// begin(), push_back() and reverse(). Read-only code should use const
+// references or the const members so that it never detaches.
+//
+// As with any copy-on-write container, references and pointers obtained
+// through non-const members must not be used to modify the vector after it
+// has been copied.
+template <class T, class Alloc = Allocator<T>>
+class CowVector
+{
+    CowBuffer<T, Alloc> _buffer;
+    size_t _max_size = -1;
+    size_t _size = 0;
+
+    void check_and_alloc_data()
+    {
+        if (_size >= _buffer.capacity())
+        {
+            size_t new_capacity = _buffer.capacity() + vector_block_size;
+
+            if (new_capacity > _max_size)
+                return;
+
+            _buffer.reallocate(new_capacity, _size);
+        }
+        else
+        {
+            _buffer.detach(_size);
+        }
+    }
+
+public:
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
+
+    CowVector() {}
+
+    explicit CowVector(const Alloc& alloc) : _buffer(alloc) {}
+
+    // Fill constructors
+    explicit CowVector(size_t n, const Alloc& alloc = Alloc()) : _buffer(n, alloc), _size(n) {}
+
+    explicit CowVector(size_t n, const T& val, const Alloc& alloc = Alloc())
+        : _buffer(n, alloc), _size(n)
+    {
+        T* data = _buffer.data();
+        for (unsigned i = 0; i < n; i++)
+            data[i] = val;
+    }
+
+    // This constructor creates vector from the given array
+    CowVector(const T* arr, size_t len, const Alloc& alloc = Alloc())
+        : _buffer(len, alloc), _size(len)
+    {
+        T* data = _buffer.data();
+        for (unsigned i = 0; i < len; i++)
+            data[i] = arr[i];
+    }
+
+#ifdef USE_STL
+    CowVector(std::initializer_list<T> initlst, const Alloc& alloc = Alloc())
+        : _buffer(initlst.size(), alloc), _size(initlst.size())
+    {
+        T* data = _buffer.data();
+        unsigned idx = 0;
+
+        for (auto x : initlst)
+            data[idx++] = x;
+    }
+#endif
+
+    // Copy constructor, O(1)
+    CowVector(const CowVector& other) = default;
+
+    // Move constructor
+    CowVector(CowVector&& other) : _buffer(static_cast<CowBuffer<T, Alloc>&&>(other._buffer))
+    {
+        _size = other._size;
+        other._size = 0;
+    }
+
+    ~CowVector() {}
+
+    // Copy assignment operator, O(1)
+    CowVector& operator=(const CowVector& other) = default;
+
+    // Move assignment operator
+    CowVector& operator=(CowVector&& other)
+    {
+        if (&other != this)
+        {
+            _buffer = static_cast<CowBuffer<T, Alloc>&&>(other._buffer);
+            _size = other._size;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    // Iterators
+    Iterator begin() { return Iterator(data()); }
+    Iterator end() { return Iterator(data() + _size); }
+
+    ConstIterator begin() const { return ConstIterator(_buffer.data()); }
+    ConstIterator end() const { return ConstIterator(_buffer.data() + _size); }
+
+    ConstIterator cbegin() const { return ConstIterator(_buffer.data()); }
+    ConstIterator cend() const { return ConstIterator(_buffer.data() + _size); }
+
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
+
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t max_size() const { return _max_size; }
+    size_t capacity() const { return _buffer.capacity(); }
+    bool empty() const { return _size == 0; }
+
+    // Number of vectors sharing the buffer
+    unsigned use_count() const { return _buffer.use_count(); }
+
+    // Allocator
+    Alloc get_allocator() const { return _buffer.get_allocator(); }
+
+    // Element access
+    T& operator[](int n) { return data()[n]; }
+    const T& operator[](int n) const { return _buffer.data()[n]; }
+
+    T& at(unsigned n)
+    {
+        assert(n < _size);
+        return data()[n];
+    }
+
+    const T& at(unsigned n) const
+    {
+        assert(n < _size);
+        return _buffer.data()[n];
+    }
+
+    T& front() { return data()[0]; }
+    T& back() { return data()[_size - 1]; }
+
+    const T& front() const { return _buffer.data()[0]; }
+    const T& back() const { return _buffer.data()[_size - 1]; }
+
+    T* data()
+    {
+        _buffer.detach(_size);
+        return _buffer.data();
+    }
+
+    const T* data() const { return _buffer.data(); }
+
+    // Modifiers
+
+    void push_back(const T& value)
+    {
+        check_and_alloc_data();
+        _buffer.data()[_size++] = value;
+    }
+
+    void push_back(T&& value)
+    {
+        check_and_alloc_data();
+        _buffer.data()[_size++] = static_cast<T &&>(value);
+    }
+
+    // Elements past the size are never read, so neither of these needs to
+    // detach the buffer
+    void pop_back() { if (_size > 0) _size--; }
+
+    void clear() { _size = 0; }
+
+    // Operations
+    void reverse()
+    {
+        if (_size == 0)
+            return;
+
+        T* d = data();
+        unsigned i = 0;
+        unsigned j = _size - 1;
+
+        while (i < j)
+            swap(d[i++], d[j--]);
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,412 @@
+// The MIT License (MIT)
+//
+// STLite cuckoo filter
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include "algorithms.h"
+#include "allocator.h"
+#include "hash.h"
+
+#include <math.h>
+
+namespace stlite
+{
+
+// Cuckoo filter (Fan et al., "Cuckoo Filter: Practically Better Than Bloom").
+// A key is stored as a short fingerprint in one of two buckets of four slots,
+// the second bucket is computed from the first one and the fingerprint, so
+// fingerprints can be moved and erased without the key:
+//
+//   CuckooFilter<int> filter(1000000, 0.001); // Keys, false positive rate
+//   filter.insert(42);
+//   filter.erase(42);
+//
+// Unlike a Bloom filter it supports erase(), which must only be called for
+// keys which have been inserted. A key inserted twice must be erased twice.
+// A bucket is a 64-bit word of four 16-bit slots, a query compares the
+// fingerprint with all of them at once. Fingerprints have as many bits as the
+// false positive rate needs, up to 16.
+template <class Key, class H = Hash<Key>>
+class CuckooFilter
+{
+    static constexpr unsigned slots = 4;
+    static constexpr unsigned max_kicks = 500;
+    static constexpr unsigned magic = 0x31464643; // "CFF1"
+
+    static constexpr unsigned long long lanes_low = 0x0001000100010001ULL;
+    static constexpr unsigned long long lanes_high = 0x8000800080008000ULL;
+
+    unsigned long long* _buckets = nullptr;
+    size_t _bucket_count = 0;
+    size_t _size = 0;
+    unsigned _bits = 16;
+
+    // Fingerprint which didn't fit when the filter got full
+    bool _has_victim = false;
+    size_t _victim_bucket = 0;
+    unsigned _victim = 0;
+
+    unsigned long long _random = 0x2545f4914f6cdd1dULL;
+    H _hash;
+    Allocator<unsigned long long> allocator;
+
+    void allocate_buckets(size_t count)
+    {
+        _bucket_count = count;
+        _buckets = allocator.allocate(count);
+        stlite::fill(_buckets, _buckets + count, 0ULL);
+    }
+
+    void deallocate_buckets()
+    {
+        allocator.deallocate(_buckets, _bucket_count);
+        _buckets = nullptr;
+        _bucket_count = 0;
+    }
+
+    void steal(CuckooFilter& other)
+    {
+        _buckets = other._buckets;
+        _bucket_count = other._bucket_count;
+        _size = other._size;
+        _bits = other._bits;
+        _has_victim = other._has_victim;
+        _victim_bucket = other._victim_bucket;
+        _victim = other._victim;
+
+        other._buckets = nullptr;
+        other._bucket_count = 0;
+        other._size = 0;
+        other._has_victim = false;
+    }
+
+    // Fingerprints are never 0, 0 marks an empty slot
+    unsigned fingerprint(unsigned long long h) const
+    {
+        unsigned fp = (h >> 32) & ((1U << _bits) - 1);
+        return fp ? fp : 1;
+    }
+
+    // Scale a 32-bit hash to [0, bucket count) without a division
+    size_t reduce(unsigned h) const { return (unsigned long long) h * _bucket_count >> 32; }
+
+    size_t index(unsigned long long h) const { return reduce(h); }
+
+    // The alternate bucket is (f - i) mod the bucket count, where f depends
+    // on the fingerprint only. Applying it twice gives i back, and unlike the
+    // usual i ^ f it works for any number of buckets, not just powers of two.
+    size_t alternate(size_t i, unsigned fp) const
+    {
+        size_t f = reduce(fp * 0x5bd1e995U);
+        return f >= i ? f - i : f + _bucket_count - i;
+    }
+
+    // Nonzero if a 16-bit lane of x is zero
+    static unsigned long long zero_lane(unsigned long long x)
+    {
+        return (x - lanes_low) & ~x & lanes_high;
+    }
+
+    bool bucket_contains(size_t i, unsigned fp) const
+    {
+        return zero_lane(_buckets[i] ^ (fp * lanes_low)) != 0;
+    }
+
+    bool put(size_t i, unsigned fp)
+    {
+        unsigned long long free = zero_lane(_buckets[i]);
+        if (!free)
+            return false;
+
+        // The lowest empty slot
+        unsigned shift = __builtin_ctzll(free) - 15;
+        _buckets[i] |= (unsigned long long) fp << shift;
+        return true;
+    }
+
+    bool remove(size_t i, unsigned fp)
+    {
+        unsigned long long found = zero_lane(_buckets[i] ^ (fp * lanes_low));
+        if (!found)
+            return false;
+
+        unsigned shift = __builtin_ctzll(found) - 15;
+        _buckets[i] &= ~(0xFFFFULL << shift);
+        return true;
+    }
+
+    unsigned long long next_random()
+    {
+        _random ^= _random << 13;
+        _random ^= _random >> 7;
+        _random ^= _random << 17;
+        return _random;
+    }
+
+    // Store the fingerprint in bucket i or its alternate, moving other
+    // fingerprints if both are full. If no place is found, the last moved
+    // fingerprint becomes the victim.
+    void insert_fingerprint(size_t i, unsigned fp)
+    {
+        size_t j = alternate(i, fp);
+        if (put(i, fp) || put(j, fp))
+            return;
+
+        i = next_random() & 1 ? i : j;
+        for (unsigned kick = 0; kick < max_kicks; kick++)
+        {
+            unsigned shift = 16 * (next_random() % slots);
+            unsigned evicted = (_buckets[i] >> shift) & 0xFFFF;
+
+            _buckets[i] = (_buckets[i] & ~(0xFFFFULL << shift)) | ((unsigned long long) fp << shift);
+            fp = evicted;
+            i = alternate(i, fp);
+
+            if (put(i, fp))
+                return;
+        }
+
+        _has_victim = true;
+        _victim_bucket = i;
+        _victim = fp;
+    }
+
+    bool victim_matches(size_t i, unsigned fp) const
+    {
+        return _has_victim && _victim == fp &&
+               (_victim_bucket == i || _victim_bucket == alternate(i, fp));
+    }
+
+public:
+    // Filter for the given number of keys with the given false positive rate.
+    // The rate is about 2 * 4 / 2^bits at full load.
+    explicit CuckooFilter(size_t keys = 0, double fpr = 0.01)
+    {
+        double bits = ceil(log2(2.0 * slots / fpr));
+        _bits = bits < 4 ? 4 : bits > 16 ? 16 : bits;
+
+        // Fill the buckets up to 95% at the expected number of keys
+        allocate_buckets(keys / (slots * 0.95) + 1);
+    }
+
+    // Copy constructor
+    CuckooFilter(const CuckooFilter& other)
+    {
+        allocate_buckets(other._bucket_count);
+        stlite::copy(other._buckets, other._buckets + _bucket_count, _buckets);
+        _size = other._size;
+        _bits = other._bits;
+        _has_victim = other._has_victim;
+        _victim_bucket = other._victim_bucket;
+        _victim = other._victim;
+    }
+
+    // Move constructor
+    CuckooFilter(CuckooFilter&& other) { steal(other); }
+
+    ~CuckooFilter() { deallocate_buckets(); }
+
+    // Copy assignment operator
+    CuckooFilter& operator=(const CuckooFilter& other)
+    {
+        if (&other != this)
+        {
+            CuckooFilter tmp(other);
+            deallocate_buckets();
+            steal(tmp);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    CuckooFilter& operator=(CuckooFilter&& other)
+    {
+        if (&other != this)
+        {
+            deallocate_buckets();
+            steal(other);
+        }
+        return *this;
+    }
+
+    // Return false if the filter is full, the key is not added then
+    bool insert(const Key& key)
+    {
+        if (_has_victim)
+            return false;
+
+        unsigned long long h = _hash(key);
+        insert_fingerprint(index(h), fingerprint(h));
+        _size++;
+        return true;
+    }
+
+    // False if the key has certainly not been inserted
+    bool contains(const Key& key) const
+    {
+        unsigned long long h = _hash(key);
+        unsigned fp = fingerprint(h);
+        size_t i = index(h);
+
+        return bucket_contains(i, fp) | bucket_contains(alternate(i, fp), fp) |
+               victim_matches(i, fp);
+    }
+
+    // Erase one copy of an inserted key. Return false if it was not found.
+    bool erase(const Key& key)
+    {
+        unsigned long long h = _hash(key);
+        unsigned fp = fingerprint(h);
+        size_t i = index(h);
+
+        if (remove(i, fp) || remove(alternate(i, fp), fp))
+        {
+            _size--;
+
+            // There is a free slot now, try to place the victim
+            if (_has_victim)
+            {
+                _has_victim = false;
+                insert_fingerprint(_victim_bucket, _victim);
+            }
+            return true;
+        }
+
+        if (victim_matches(i, fp))
+        {
+            _has_victim = false;
+            _size--;
+            return true;
+        }
+
+        return false;
+    }
+
+    void clear()
+    {
+        stlite::fill(_buckets, _buckets + _bucket_count, 0ULL);
+        _size = 0;
+        _has_victim = false;
+    }
+
+    // Add the fingerprints of another filter with the same number of buckets
+    // and fingerprint bits. Return false if the filters don't match or this
+    // one gets full; in that case some fingerprints may have been added.
+    bool merge(const CuckooFilter& other)
+    {
+        if (other._bucket_count != _bucket_count || other._bits != _bits)
+            return false;
+
+        for (size_t i = 0; i < _bucket_count; i++)
+        {
+            for (unsigned s = 0; s < slots; s++)
+            {
+                unsigned fp = (other._buckets[i] >> (16 * s)) & 0xFFFF;
+                if (!fp)
+                    continue;
+                if (_has_victim)
+                    return false;
+                insert_fingerprint(i, fp);
+                _size++;
+            }
+        }
+
+        if (other._has_victim)
+        {
+            if (_has_victim)
+                return false;
+            insert_fingerprint(other._victim_bucket, other._victim);
+            _size++;
+        }
+
+        return true;
+    }
+
+    // Number of stored keys
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    size_t bucket_count() const { return _bucket_count; }
+    size_t capacity() const { return _bucket_count * slots; }
+    unsigned fingerprint_bits() const { return _bits; }
+    size_t size_in_bytes() const { return _bucket_count * sizeof(unsigned long long); }
+
+    double load_factor() const { return double(_size) / capacity(); }
+
+    // False positive rate expected at the current load
+    double false_positive_rate() const
+    {
+        return 1 - pow(1 - 1.0 / (1U << _bits), 2.0 * slots * load_factor());
+    }
+
+    // Serialization. The buckets are written in the byte order of the host,
+    // the hash function must be the same when reading.
+
+    size_t serialized_size() const { return 24 + size_in_bytes(); }
+
+    // Write serialized_size() bytes to out
+    void serialize(void* out) const
+    {
+        unsigned char* p = static_cast<unsigned char*>(out);
+        unsigned header[6] = { magic, _bucket_count, _size, _bits,
+                               _has_victim ? _victim : 0, _victim_bucket };
+
+        __builtin_memcpy(p, header, sizeof(header));
+        __builtin_memcpy(p + sizeof(header), _buckets, size_in_bytes());
+    }
+
+    // Replace the filter by a serialized one. Return false and leave the
+    // filter unchanged if the data is not a serialized filter.
+    bool deserialize(const void* in, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(in);
+        unsigned header[6];
+
+        if (size < sizeof(header))
+            return false;
+
+        __builtin_memcpy(header, p, sizeof(header));
+        size_t count = header[1];
+        if (header[0] != magic || count == 0 ||
+            header[3] < 4 || header[3] > 16 ||
+            (size - sizeof(header)) / sizeof(unsigned long long) != count ||
+            (size - sizeof(header)) % sizeof(unsigned long long) != 0 ||
+            header[5] >= count)
+            return false;
+
+        deallocate_buckets();
+        allocate_buckets(count);
+        __builtin_memcpy(_buckets, p + sizeof(header), size_in_bytes());
+        _size = header[2];
+        _bits = header[3];
+        _has_victim = header[4] != 0;
+        _victim = header[4];
+        _victim_bucket = header[5];
+        return true;
+    }
+};
+
+} // namespace stlite
+
+#endif
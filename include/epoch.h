@@ -0,0 +1,280 @@
+// The MIT License (MIT)
+//
+// STLite epoch-based memory reclamation
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include "allocator.h"
+
+#include <new>
+#include <sched.h>
+
+namespace stlite
+{
+
+// Most threads which may use epoch-protected structures at the same time,
+// more threads wait for one of them to exit
+constexpr unsigned epoch_max_threads = 256;
+
+// Small index identifying the calling thread, unique among the running
+// threads and reused after a thread exits
+class EpochThreadIndex
+{
+    unsigned _index;
+
+    static unsigned char* used()
+    {
+        static unsigned char slots[epoch_max_threads];
+        return slots;
+    }
+
+public:
+    // One more than the largest index ever handed out
+    static unsigned& high_water()
+    {
+        static unsigned n = 0;
+        return n;
+    }
+
+    EpochThreadIndex()
+    {
+        unsigned char* slots = used();
+        while (true)
+        {
+            for (unsigned i = 0; i < epoch_max_threads; i++)
+            {
+                unsigned char expected = 0;
+                if (__atomic_compare_exchange_n(&slots[i], &expected, 1, false,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                {
+                    _index = i;
+                    unsigned n = __atomic_load_n(&high_water(), __ATOMIC_RELAXED);
+                    while (n < i + 1 &&
+                           !__atomic_compare_exchange_n(&high_water(), &n, i + 1, false,
+                                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                    {
+                    }
+                    return;
+                }
+            }
+            sched_yield();
+        }
+    }
+
+    ~EpochThreadIndex() { __atomic_store_n(&used()[_index], 0, __ATOMIC_RELEASE); }
+
+    static unsigned current()
+    {
+        static thread_local EpochThreadIndex index;
+        return index._index;
+    }
+};
+
+// Epoch-based reclamation (Fraser, "Practical lock-freedom") for lock-free
+// structures. Readers enter a critical section for the time they hold
+// pointers to shared nodes; a node which has been unlinked is retired
+// instead of deleted, and it is deleted once every thread which could have
+// seen it has left its critical section:
+//
+//   {
+//       EpochDomain::Guard guard(domain);
+//       ... unlink node ...
+//       domain.retire(node);
+//   }
+//
+// The global epoch advances when all the threads in a critical section have
+// observed it. A node retired in epoch e can't be reached by a thread which
+// entered in epoch e + 1 or later, so it is deleted when the global epoch
+// reaches e + 2. Each thread keeps the retired nodes in three lists, one per
+// epoch modulo 3.
+class EpochDomain
+{
+    struct Retired
+    {
+        void* p;
+        void (*destroy)(void* p, void* context);
+        void* context;
+        Retired* next;
+    };
+
+    struct alignas(64) Slot
+    {
+        // Epoch << 1 | 1 while in a critical section, 0 outside of it
+        unsigned long state = 0;
+        unsigned depth = 0; // Nested guards of the owning thread
+
+        Retired* limbo[3] = { nullptr, nullptr, nullptr };
+        unsigned long limbo_epoch[3] = { 0, 0, 0 };
+        unsigned retired = 0; // Since the last attempt to advance
+    };
+
+    static constexpr unsigned advance_interval = 64;
+
+    unsigned long _epoch = 0;
+    char* _memory;
+    Slot* _slots; // In _memory, aligned to a cache line
+
+    template <class T>
+    static void destroy_object(void* p, void*)
+    {
+        delete static_cast<T*>(p);
+    }
+
+    static void free_list(Retired* r)
+    {
+        while (r)
+        {
+            Retired* next = r->next;
+            r->destroy(r->p, r->context);
+            delete r;
+            r = next;
+        }
+    }
+
+    // Advance the global epoch if every thread in a critical section has
+    // observed the current one
+    bool try_advance()
+    {
+        unsigned long e = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+        unsigned n = __atomic_load_n(&EpochThreadIndex::high_water(), __ATOMIC_ACQUIRE);
+
+        for (unsigned i = 0; i < n; i++)
+        {
+            unsigned long s = __atomic_load_n(&_slots[i].state, __ATOMIC_SEQ_CST);
+            if ((s & 1) && (s >> 1) != e)
+                return false;
+        }
+
+        return __atomic_compare_exchange_n(&_epoch, &e, e + 1, false, __ATOMIC_SEQ_CST,
+                                           __ATOMIC_RELAXED);
+    }
+
+    // Delete the retired nodes of the slot which are at least two epochs old
+    void collect(Slot& slot)
+    {
+        unsigned long e = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+        for (unsigned i = 0; i < 3; i++)
+            if (slot.limbo[i] && slot.limbo_epoch[i] + 2 <= e)
+            {
+                free_list(slot.limbo[i]);
+                slot.limbo[i] = nullptr;
+            }
+    }
+
+public:
+    EpochDomain()
+    {
+        // The default new doesn't align to more than 16 bytes before C++17
+        _memory = new char[epoch_max_threads * sizeof(Slot) + alignof(Slot)];
+        unsigned long p = reinterpret_cast<unsigned long>(_memory);
+        p = (p + alignof(Slot) - 1) & ~(unsigned long) (alignof(Slot) - 1);
+        _slots = reinterpret_cast<Slot*>(p);
+        for (unsigned i = 0; i < epoch_max_threads; i++)
+            new (&_slots[i]) Slot;
+    }
+
+    EpochDomain(const EpochDomain& other) = delete;
+    EpochDomain& operator=(const EpochDomain& other) = delete;
+
+    // No thread may be in a critical section any more
+    ~EpochDomain()
+    {
+        for (unsigned i = 0; i < epoch_max_threads; i++)
+            for (unsigned j = 0; j < 3; j++)
+                free_list(_slots[i].limbo[j]);
+        delete[] _memory;
+    }
+
+    void enter()
+    {
+        Slot& slot = _slots[EpochThreadIndex::current()];
+        if (slot.depth++ > 0)
+            return;
+
+        // The store must be visible before the shared pointers are read
+        unsigned long e = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&slot.state, e << 1 | 1, __ATOMIC_SEQ_CST);
+    }
+
+    void exit()
+    {
+        Slot& slot = _slots[EpochThreadIndex::current()];
+        if (--slot.depth == 0)
+            __atomic_store_n(&slot.state, 0, __ATOMIC_RELEASE);
+    }
+
+    // Delete p with delete once no thread can reach it any more. p must be
+    // unlinked already, and the caller must be in a critical section.
+    template <class T>
+    void retire(T* p)
+    {
+        retire(p, &destroy_object<T>, nullptr);
+    }
+
+    // Call destroy(p, context) instead, e.g. to release p with the allocator
+    // of its container
+    void retire(void* p, void (*destroy)(void* p, void* context), void* context)
+    {
+        Slot& slot = _slots[EpochThreadIndex::current()];
+
+        // The epoch is read after the node has been unlinked
+        unsigned long e = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+        unsigned i = e % 3;
+
+        // The list of this index is three epochs old, so its nodes are free
+        if (slot.limbo_epoch[i] != e)
+        {
+            free_list(slot.limbo[i]);
+            slot.limbo[i] = nullptr;
+            slot.limbo_epoch[i] = e;
+        }
+        slot.limbo[i] = new Retired{ p, destroy, context, slot.limbo[i] };
+
+        if (++slot.retired >= advance_interval)
+        {
+            slot.retired = 0;
+            try_advance();
+            collect(slot);
+        }
+    }
+
+    // Current global epoch
+    unsigned long epoch() const { return __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST); }
+
+    // Critical section for the lifetime of the guard
+    class Guard
+    {
+        EpochDomain& _domain;
+
+    public:
+        explicit Guard(EpochDomain& domain) : _domain(domain) { _domain.enter(); }
+        ~Guard() { _domain.exit(); }
+
+        Guard(const Guard& other) = delete;
+        Guard& operator=(const Guard& other) = delete;
+    };
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,382 @@
+// The MIT License (MIT)
+//
+// STLite execution policies
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef EXECUTION_H
+#define EXECUTION_H
+
+#include "algorithms.h"
+#include "allocator.h"
+#include "iterator.h"
+#include "thread_pool.h"
+
+namespace stlite
+{
+
+// Execution policies of the bulk algorithms. The first argument selects how
+// the algorithm runs:
+//
+//   stlite::fill(stlite::seq, vec.begin(), vec.end(), 0); // Calling thread
+//   stlite::fill(stlite::par, vec.begin(), vec.end(), 0); // Thread pool
+//
+// The parallel algorithms take random access iterators. The range is split
+// into chunks which are processed concurrently, so the functions passed in
+// must be safe to call from several threads at once.
+
+struct SequencedPolicy
+{
+};
+
+struct ParallelPolicy
+{
+    ThreadPool* pool = nullptr;
+
+    // Use the default pool
+    constexpr ParallelPolicy() {}
+
+    // Use the given pool, e.g. to limit the number of threads
+    constexpr explicit ParallelPolicy(ThreadPool& p) : pool(&p) {}
+
+    ThreadPool& get_pool() const { return pool ? *pool : ThreadPool::default_pool(); }
+};
+
+constexpr SequencedPolicy seq{};
+constexpr ParallelPolicy par{};
+
+// Ranges shorter than this run serially, waking up the pool would cost more
+// than it saves
+constexpr ptrdiff_t parallel_cutoff = 1 << 16;
+
+// Minimal number of elements of one task
+constexpr ptrdiff_t parallel_min_chunk = 1 << 14;
+
+// Tasks per thread, more tasks than threads balance the load when some
+// threads are slower
+constexpr unsigned parallel_tasks_per_thread = 4;
+
+constexpr unsigned parallel_max_tasks = 256;
+
+// Splits [0, n) into tasks of about the same size. For contiguous ranges the
+// boundaries are moved to cache line boundaries of the written range, so no
+// two threads write to the same cache line.
+class ParallelChunks
+{
+    ptrdiff_t _n;
+    ptrdiff_t _tasks;
+    ptrdiff_t _head = 0; // Elements before the first line boundary
+    ptrdiff_t _line = 1; // Elements per cache line
+
+    template <class It>
+    void align(It written, BoolConstant<true>)
+    {
+        typedef typename IteratorTraits<It>::value_type V;
+        unsigned long addr = reinterpret_cast<unsigned long>(IteratorTraits<It>::pointer(written));
+
+        if (cache_line_size % sizeof(V) != 0 || addr % sizeof(V) != 0)
+            return;
+
+        _line = cache_line_size / sizeof(V);
+        _head = ((cache_line_size - addr % cache_line_size) % cache_line_size) / sizeof(V);
+    }
+
+    template <class It>
+    void align(It written, BoolConstant<false>)
+    {
+    }
+
+public:
+    template <class It>
+    ParallelChunks(It written, ptrdiff_t n, ptrdiff_t tasks) : _n(n), _tasks(tasks)
+    {
+        align(written, BoolConstant<IteratorTraits<It>::contiguous>());
+    }
+
+    // Start of the task k, boundary(tasks) is n
+    ptrdiff_t boundary(ptrdiff_t k) const
+    {
+        if (k >= _tasks)
+            return _n;
+
+        ptrdiff_t b = k * _n / _tasks;
+        if (b > _head)
+            b = _head + (b - _head) / _line * _line;
+        return b;
+    }
+};
+
+// Number of tasks worth running in parallel for n elements, 0 if the range
+// should be processed serially
+inline unsigned parallel_tasks(ThreadPool& pool, ptrdiff_t n)
+{
+    if (n < parallel_cutoff || pool.size() < 2)
+        return 0;
+
+    ptrdiff_t tasks = pool.size() * parallel_tasks_per_thread;
+    if (tasks > n / parallel_min_chunk)
+        tasks = n / parallel_min_chunk;
+    if (tasks > parallel_max_tasks)
+        tasks = parallel_max_tasks;
+
+    return tasks < 2 ? 0 : tasks;
+}
+
+// Call f(task, begin, end) for non-empty chunks of [0, n) on the pool of the
+// policy. Return false without calling f if the range should be processed
+// serially.
+template <class It, class F>
+bool parallel_for(const ParallelPolicy& policy, It written, ptrdiff_t n, F f)
+{
+    ThreadPool& pool = policy.get_pool();
+    unsigned tasks = parallel_tasks(pool, n);
+    if (!tasks)
+        return false;
+
+    ParallelChunks chunks(written, n, tasks);
+    auto task = [&](unsigned i) {
+        ptrdiff_t begin = chunks.boundary(i);
+        ptrdiff_t end = chunks.boundary(i + 1);
+        if (begin < end)
+            f(i, begin, end);
+    };
+
+    pool.run(tasks, task);
+    return true;
+}
+
+//====----------------------------------------------------------------------====
+// Sequenced algorithms
+//====----------------------------------------------------------------------====
+
+template <class ForwardIt, class T>
+void fill(SequencedPolicy, ForwardIt first, ForwardIt last, const T& value)
+{
+    stlite::fill(first, last, value);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt copy(SequencedPolicy, InputIt first, InputIt last, OutputIt dst)
+{
+    return stlite::copy(first, last, dst);
+}
+
+template <class InputIt, class OutputIt, class UnaryOperation>
+OutputIt transform(SequencedPolicy, InputIt first, InputIt last, OutputIt dst,
+                   UnaryOperation op)
+{
+    return stlite::transform(first, last, dst, op);
+}
+
+template <class InputIt, class T>
+T reduce(SequencedPolicy, InputIt first, InputIt last, T init)
+{
+    return stlite::reduce(first, last, init);
+}
+
+template <class InputIt, class T, class BinaryOperation>
+T reduce(SequencedPolicy, InputIt first, InputIt last, T init, BinaryOperation op)
+{
+    return stlite::reduce(first, last, init, op);
+}
+
+template <class RandomIt>
+void sort(SequencedPolicy, RandomIt first, RandomIt last)
+{
+    stlite::sort(first, last);
+}
+
+template <class RandomIt, class Compare>
+void sort(SequencedPolicy, RandomIt first, RandomIt last, Compare comp)
+{
+    stlite::sort(first, last, comp);
+}
+
+template <class InputIt, class Function>
+void for_each(SequencedPolicy, InputIt first, InputIt last, Function f)
+{
+    stlite::for_each(first, last, f);
+}
+
+//====----------------------------------------------------------------------====
+// Parallel algorithms
+//====----------------------------------------------------------------------====
+
+template <class RandomIt, class T>
+void fill(const ParallelPolicy& policy, RandomIt first, RandomIt last, const T& value)
+{
+    bool done = parallel_for(policy, first, last - first,
+                             [&](unsigned, ptrdiff_t begin, ptrdiff_t end) {
+                                 stlite::fill(first + begin, first + end, value);
+                             });
+    if (!done)
+        stlite::fill(first, last, value);
+}
+
+template <class RandomIt1, class RandomIt2>
+RandomIt2 copy(const ParallelPolicy& policy, RandomIt1 first, RandomIt1 last, RandomIt2 dst)
+{
+    bool done = parallel_for(policy, dst, last - first,
+                             [&](unsigned, ptrdiff_t begin, ptrdiff_t end) {
+                                 stlite::copy(first + begin, first + end, dst + begin);
+                             });
+    if (!done)
+        return stlite::copy(first, last, dst);
+    return dst + (last - first);
+}
+
+template <class RandomIt1, class RandomIt2, class UnaryOperation>
+RandomIt2 transform(const ParallelPolicy& policy, RandomIt1 first, RandomIt1 last,
+                    RandomIt2 dst, UnaryOperation op)
+{
+    bool done = parallel_for(policy, dst, last - first,
+                             [&](unsigned, ptrdiff_t begin, ptrdiff_t end) {
+                                 stlite::transform(first + begin, first + end, dst + begin, op);
+                             });
+    if (!done)
+        return stlite::transform(first, last, dst, op);
+    return dst + (last - first);
+}
+
+// Every task reduces its chunk into its own slot, the slots are then combined
+// in order. op must be associative, it doesn't need to be commutative. T must
+// be default constructible.
+template <class RandomIt, class T, class BinaryOperation>
+T reduce(const ParallelPolicy& policy, RandomIt first, RandomIt last, T init,
+         BinaryOperation op)
+{
+    // Each slot has cache lines of its own, so the threads don't slow each
+    // other down by writing to the same line
+    struct alignas(cache_line_size) Slot
+    {
+        T value;
+        bool used = false;
+    };
+
+    Slot slots[parallel_max_tasks];
+
+    bool done = parallel_for(policy, first, last - first,
+                             [&](unsigned task, ptrdiff_t begin, ptrdiff_t end) {
+                                 slots[task].value = stlite::accumulate(
+                                     first + begin + 1, first + end, T(first[begin]), op);
+                                 slots[task].used = true;
+                             });
+    if (!done)
+        return stlite::reduce(first, last, init, op);
+
+    for (unsigned i = 0; i < parallel_max_tasks; i++)
+        if (slots[i].used)
+            init = op(init, slots[i].value);
+
+    return init;
+}
+
+template <class RandomIt, class T>
+T reduce(const ParallelPolicy& policy, RandomIt first, RandomIt last, T init)
+{
+    return stlite::reduce(policy, first, last, init, [](const T& a, const T& b) { return a + b; });
+}
+
+template <class RandomIt, class Function>
+void for_each(const ParallelPolicy& policy, RandomIt first, RandomIt last, Function f)
+{
+    bool done = parallel_for(policy, first, last - first,
+                             [&](unsigned, ptrdiff_t begin, ptrdiff_t end) {
+                                 stlite::for_each(first + begin, first + end, f);
+                             });
+    if (!done)
+        stlite::for_each(first, last, f);
+}
+
+// The range is split into a power of two runs which are sorted concurrently
+// and then merged pairwise, run against run, between the range and a buffer.
+// Every merge round has half the merges of the previous one, so the last
+// rounds use fewer threads. The sort is not stable.
+template <class RandomIt, class Compare>
+void sort(const ParallelPolicy& policy, RandomIt first, RandomIt last, Compare comp)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+
+    ptrdiff_t n = last - first;
+    ThreadPool& pool = policy.get_pool();
+    unsigned tasks = parallel_tasks(pool, n);
+
+    if (!tasks)
+    {
+        stlite::sort(first, last, comp);
+        return;
+    }
+
+    unsigned runs = 1;
+    while (runs < pool.size() && 2 * runs <= tasks)
+        runs *= 2;
+    if (runs < 2)
+        runs = 2;
+
+    ParallelChunks chunks(first, n, runs);
+
+    auto sort_run = [&](unsigned i) {
+        stlite::sort(first + chunks.boundary(i), first + chunks.boundary(i + 1), comp);
+    };
+    pool.run(runs, sort_run);
+
+    Allocator<V> allocator;
+    V* buf = allocator.allocate(n);
+    bool in_buf = false;
+
+    for (unsigned width = 1; width < runs; width *= 2)
+    {
+        auto merge_runs = [&](unsigned m) {
+            ptrdiff_t lo = chunks.boundary(2 * m * width);
+            ptrdiff_t mid = chunks.boundary((2 * m + 1) * width);
+            ptrdiff_t hi = chunks.boundary((2 * m + 2) * width);
+
+            if (in_buf)
+                merge_move(buf + lo, buf + mid, buf + mid, buf + hi, first + lo, comp);
+            else
+                merge_move(first + lo, first + mid, first + mid, first + hi, buf + lo, comp);
+        };
+        pool.run(runs / (2 * width), merge_runs);
+        in_buf = !in_buf;
+    }
+
+    if (in_buf)
+    {
+        bool done = parallel_for(policy, first, n, [&](unsigned, ptrdiff_t begin, ptrdiff_t end) {
+            move_range(buf + begin, buf + end, first + begin);
+        });
+        if (!done)
+            move_range(buf, buf + n, first);
+    }
+
+    allocator.deallocate(buf, n);
+}
+
+
+template <class RandomIt>
+void sort(const ParallelPolicy& policy, RandomIt first, RandomIt last)
+{
+    typedef typename IteratorTraits<RandomIt>::value_type V;
+    stlite::sort(policy, first, last, Less<V>());
+}
+
+} // namespace stlite
+
+#endif
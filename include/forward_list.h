@@ -24,6 +24,7 @@
 #ifndef FORWARD_LIST_H
 #define FORWARD_LIST_H
 
+#include "algorithms.h"
 #include "allocator.h"
 
 #ifdef USE_STL
@@ -33,10 +34,6 @@
 namespace stlite
 {
 
-// TODO: Support custom allocators:
-//   http://www.cplusplus.com/reference/memory/allocator/
-//   http://www.cplusplus.com/reference/memory/allocator_traits/
-
 template <class T, class Alloc = Allocator<T>>
 class ForwardList
 {
@@ -52,63 +49,102 @@ class ForwardList
     Element* _lst = nullptr; // First element of the list
     size_t _max_size = 0;
 
-    Allocator<T> allocator;
+    typedef typename Alloc::template rebind<Element>::other ElementAlloc;
+    ElementAlloc _alloc;
+
+    // Append copies of the elements of other to the empty list
+    void copy_elements(const ForwardList& other)
+    {
+        Element** tail = &_lst;
+        for (const Element* p = other._lst; p; p = p->next)
+        {
+            *tail = _alloc.construct(p->value);
+            tail = &(*tail)->next;
+        }
+    }
+
+    // Move the elements of other into our own elements, other becomes empty
+    void move_elements(ForwardList& other)
+    {
+        Element** tail = &_lst;
+        for (Element* p = other._lst; p; p = p->next)
+        {
+            *tail = _alloc.construct(static_cast<T&&>(p->value));
+            tail = &(*tail)->next;
+        }
+        other.clear();
+    }
+
+    // Take the elements of other, which must be releasable by our allocator
+    void steal(ForwardList& other)
+    {
+        _lst = other._lst;
+        _max_size = other._max_size;
+
+        other._lst = nullptr;
+        other._max_size = 0;
+    }
 
 public:
     ForwardList() {}
 
+    explicit ForwardList(const Alloc& alloc) : _alloc(alloc) {}
+
     // This constructor creates list from the given array
     // ForwardList(T* arr, unsigned len);
 
     // Copy constructor
-    // ForwardList(const ForwardList<T>& other);
+    ForwardList(const ForwardList& other)
+        : _alloc(AllocatorTraits<ElementAlloc>::select_on_copy_construction(other._alloc))
+    {
+        copy_elements(other);
+    }
+
+    ForwardList(const ForwardList& other, const Alloc& alloc) : _alloc(alloc) { copy_elements(other); }
 
     // Move constructor
-    ForwardList(ForwardList<T, Alloc>&& other)
-    {
-        if (&other != this)
-        {
-            _lst = other._lst;
-            _max_size = other._max_size;
+    ForwardList(ForwardList&& other) : _alloc(other._alloc) { steal(other); }
 
-            other._lst = nullptr;
-            other._max_size = 0;
-        }
+    // The elements are moved one by one when the allocators are not equal
+    ForwardList(ForwardList&& other, const Alloc& alloc) : _alloc(alloc)
+    {
+        if (AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+            steal(other);
+        else
+            move_elements(other);
     }
 
     ~ForwardList() { clear(); }
 
     // Copy assignment operator
-    ForwardList<T, Alloc>& operator=(const ForwardList<T, Alloc>& other)
+    ForwardList& operator=(const ForwardList& other)
     {
-        if (&other != this && other._lst)
+        if (&other != this)
         {
             clear();
-
-            // Pointer to the first element
-            Element* p = other._lst->next;
-            while (p != other._lst)
-            {
-                push_back(p->value);
-                p = p->next;
-            }
-
-            push_back(p->value);
+            if (AllocatorTraits<ElementAlloc>::propagate_on_copy_assignment)
+                _alloc = other._alloc;
+            copy_elements(other);
         }
         return *this;
     }
 
     // Move assignment operator
-    ForwardList<T, Alloc>& operator=(ForwardList<T, Alloc>&& other)
+    ForwardList& operator=(ForwardList&& other)
     {
         if (&other != this)
         {
             clear();
-            _lst = other._lst;
-            _max_size = other._max_size;
 
-            other._lst = nullptr;
-            other._max_size = 0;
+            if (AllocatorTraits<ElementAlloc>::propagate_on_move_assignment)
+            {
+                _alloc = other._alloc;
+                steal(other);
+            }
+            else if (AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+                steal(other);
+            else
+                move_elements(other);
         }
         return *this;
     }
@@ -117,7 +153,7 @@ public:
     class Iterator
     {
         Element* _p = nullptr;
-        friend class List;
+        friend class ForwardList;
 
     public:
         Iterator() = default;
@@ -170,6 +206,9 @@ public:
     bool empty() const { return _lst == nullptr; }
     size_t max_size() const { return _max_size; }
 
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
     // Element access
     // If the list is empty, the return value of these functions is undefined
     T& front() { return _lst->value; }
@@ -184,7 +223,7 @@ public:
     // http://www.cplusplus.com/reference/forward_list/forward_list/emplace_front/
     template <class... Args> void emplace_front(Args&&... args)
     {
-        Element* e = new Element();
+        Element* e = _alloc.construct();
         // TODO: This is WRONG. How to make it generic?
         e->value = std::make_tuple(std::forward<Args>(args)...);
 
@@ -198,7 +237,7 @@ public:
     // Insert element at beginning of the list
     void push_front(const T& value)
     {
-        Element* e = new Element(value);
+        Element* e = _alloc.construct(value);
 
         if (_lst)
             e->next = _lst;
@@ -209,8 +248,7 @@ public:
     // Insert element at beginning of the list
     void push_front(T&& value)
     {
-        Element* e = new Element();
-        e->value = static_cast<T &&>(value);
+        Element* e = _alloc.construct(static_cast<T &&>(value));
 
         if (_lst)
             e->next = _lst;
@@ -226,14 +264,14 @@ public:
         if (!_lst->next)
         {
             // There is single element in the list
-            delete _lst;
+            _alloc.destroy(_lst);
             _lst = nullptr;
         }
         else
         {
             Element* old = _lst;
             _lst = _lst->next;
-            delete old;
+            _alloc.destroy(old);
         }
     }
 
@@ -243,7 +281,65 @@ public:
 
     //void erase_after(Iterator& pos) {}
 
-    //void swap() {}
+    // The allocators are exchanged only if they propagate on swap,
+    // otherwise they must be equal
+    void swap(ForwardList& other)
+    {
+        if (AllocatorTraits<ElementAlloc>::propagate_on_swap)
+            stlite::swap(_alloc, other._alloc);
+        stlite::swap(_lst, other._lst);
+        stlite::swap(_max_size, other._max_size);
+    }
+
+    // Move all elements of other to the beginning of this list. Nodes are
+    // relinked, not copied, unless the allocators are not equal; then the
+    // elements are moved into our memory first. Without a tail pointer we
+    // have to walk other to find its last element, so this is linear in the
+    // length of other.
+    void splice_front(ForwardList<T, Alloc>& other)
+    {
+        if (&other == this || !other._lst)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            ForwardList own(static_cast<ForwardList&&>(other), get_allocator());
+            splice_front(own);
+            return;
+        }
+
+        Element* last = other._lst;
+        while (last->next)
+            last = last->next;
+
+        last->next = _lst;
+        _lst = other._lst;
+        other._lst = nullptr;
+    }
+
+    // Move all elements of other after the position pos, which must point to
+    // an element of this list. Linear in the length of other, see
+    // splice_front().
+    void splice_after(Iterator pos, ForwardList<T, Alloc>& other)
+    {
+        if (&other == this || !other._lst || !pos._p)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            ForwardList own(static_cast<ForwardList&&>(other), get_allocator());
+            splice_after(pos, own);
+            return;
+        }
+
+        Element* last = other._lst;
+        while (last->next)
+            last = last->next;
+
+        last->next = pos._p->next;
+        pos._p->next = other._lst;
+        other._lst = nullptr;
+    }
 
     //void resize() {}
 
@@ -258,7 +354,7 @@ public:
         {
             Element* old = p;
             p = p->next;
-            delete old;
+            _alloc.destroy(old);
         }
 
         _lst = nullptr;
@@ -288,10 +384,38 @@ public:
         else
             prev->next = p->next;
 
-        delete p;
+        _alloc.destroy(p);
+    }
+
+    // Call f(value) for the elements from the front
+    template <class F>
+    void for_each(F f) const
+    {
+        for (const Element* p = _lst; p; p = p->next)
+            f(p->value);
+    }
+
+    void reverse() { _lst = list_reverse(_lst); }
+
+    // Merge sorted other into this sorted list, other becomes empty
+    void merge(ForwardList<T, Alloc>& other)
+    {
+        if (&other == this)
+            return;
+
+        if (!AllocatorTraits<ElementAlloc>::equal(_alloc, other._alloc))
+        {
+            ForwardList own(static_cast<ForwardList&&>(other), get_allocator());
+            merge(own);
+            return;
+        }
+
+        _lst = list_merge(_lst, other._lst);
+        other._lst = nullptr;
     }
 
-    void reverse() {}
+    // Stable O(n log n) sort, nodes are relinked without allocation
+    void sort() { _lst = list_sort(_lst); }
 };
 
 } // namespace stlite
@@ -0,0 +1,100 @@
+// The MIT License (MIT)
+//
+// STLite hash functions
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef HASH_H
+#define HASH_H
+
+#include "allocator.h"
+
+#ifdef USE_STL
+#include <string>
+#endif
+
+namespace stlite
+{
+
+// Finalizer of splitmix64, every input bit affects every output bit
+constexpr unsigned long long hash_mix(unsigned long long x)
+{
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// 64-bit hash of n bytes, the bytes are read eight at a time
+inline unsigned long long hash_bytes(const void* data, size_t n, unsigned long long seed = 0)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    unsigned long long h = seed ^ (n * 0x9e3779b97f4a7c15ULL);
+
+    for (; n >= 8; n -= 8, p += 8)
+    {
+        unsigned long long w;
+        __builtin_memcpy(&w, p, 8);
+        h = hash_mix(h ^ w);
+    }
+
+    if (n)
+    {
+        unsigned long long w = 0;
+        __builtin_memcpy(&w, p, n);
+        h = hash_mix(h ^ w ^ 0xff);
+    }
+
+    return hash_mix(h);
+}
+
+// Hash functor used by the filters. Integers and pointers are mixed, other
+// types must specialize Hash. The constant keeps 0 from hashing to 0.
+template <class T>
+struct Hash
+{
+    unsigned long long operator()(const T& value) const
+    {
+        return hash_mix(static_cast<unsigned long long>(value) + 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+template <class T>
+struct Hash<T*>
+{
+    unsigned long long operator()(const T* p) const
+    {
+        return hash_mix(reinterpret_cast<unsigned long>(p) + 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+#ifdef USE_STL
+template <>
+struct Hash<std::string>
+{
+    unsigned long long operator()(const std::string& s) const
+    {
+        return hash_bytes(s.data(), s.size());
+    }
+};
+#endif
+
+} // namespace stlite
+
+#endif
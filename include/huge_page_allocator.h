@@ -0,0 +1,221 @@
+// The MIT License (MIT)
+//
+// STLite huge page allocator
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include "allocator.h"
+
+#include <new>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace stlite
+{
+
+// Size of the huge pages the blocks are aligned to, 2 MB on x86-64 and on
+// arm64 with 4 KB pages
+constexpr unsigned long huge_page_size = 2UL << 20;
+
+// Smaller blocks come from Allocator, a huge page would be mostly unused
+constexpr unsigned long huge_page_threshold = 1UL << 20;
+
+// Options of HugePageAllocator, may be combined with |
+enum HugePageFlags
+{
+    // Map the blocks from the reserved huge pages (MAP_HUGETLB) and fall
+    // back to transparent huge pages if there are not enough of them
+    huge_page_hugetlb = 1,
+    // Spread the pages of a block round robin over all the NUMA nodes
+    huge_page_interleave = 2,
+};
+
+// Allocator for large buffers which are accessed at random. Every page of
+// a block which doesn't fit in the TLB costs a page walk on a miss; backing
+// the block with 2 MB pages instead of 4 KB ones cuts the number of TLB
+// entries it needs by 512. The blocks of at least huge_page_threshold bytes
+// are mapped with mmap(), aligned to huge_page_size and advised with
+// MADV_HUGEPAGE, smaller ones come from Allocator:
+//
+//   stlite::Vector<Entry, stlite::HugePageAllocator<Entry>> table(n);
+//
+// With Node >= 0 the pages are bound to that NUMA node, with
+// huge_page_interleave they are interleaved over all the nodes. The NUMA
+// policy is set with the mbind() system call directly, so libnuma isn't
+// needed. Each step which isn't supported, like MAP_HUGETLB without
+// reserved pages, transparent huge pages being disabled or a kernel
+// without NUMA, falls back silently to the next one; allocate() fails only
+// if no memory can be mapped at all.
+template <class T, unsigned Flags = 0, int Node = -1>
+class HugePageAllocator
+{
+    Allocator<T> _small;
+
+    static unsigned long mapped_bytes(size_t n)
+    {
+        unsigned long bytes = (unsigned long) n * sizeof(T);
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+    static bool is_small(size_t n) { return (unsigned long) n * sizeof(T) < huge_page_threshold; }
+
+    // Map bytes aligned to a huge page: map more and unmap the ends
+    static void* map_aligned(unsigned long bytes)
+    {
+        unsigned long size = bytes + huge_page_size;
+        char* p = static_cast<char*>(
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (p == MAP_FAILED)
+            return nullptr;
+
+        unsigned long addr = reinterpret_cast<unsigned long>(p);
+        unsigned long head = ((addr + huge_page_size - 1) & ~(huge_page_size - 1)) - addr;
+        if (head)
+            munmap(p, head);
+        if (size - head - bytes)
+            munmap(p + head + bytes, size - head - bytes);
+        return p + head;
+    }
+
+    static void set_numa_policy(void* p, unsigned long bytes)
+    {
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+        // Values from <linux/mempolicy.h>. The kernel takes the number of
+        // bits of the mask plus one.
+        const int mpol_bind = 2;
+        const int mpol_interleave = 3;
+        const int mpol_f_mems_allowed = 4;
+        const unsigned long max_node = 8 * sizeof(unsigned long) + 1;
+
+        unsigned long mask = 0;
+        int mode;
+        if (Node >= 0 && Node < 64)
+        {
+            mask = 1UL << Node;
+            mode = mpol_bind;
+        }
+        else if (Flags & huge_page_interleave)
+        {
+            // All the nodes the process may allocate from
+            if (syscall(SYS_get_mempolicy, nullptr, &mask, max_node, nullptr, mpol_f_mems_allowed) != 0)
+                return;
+            mode = mpol_interleave;
+        }
+        else
+            return;
+
+        syscall(SYS_mbind, p, bytes, mode, &mask, max_node, 0);
+#else
+        (void) p;
+        (void) bytes;
+#endif
+    }
+
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef HugePageAllocator<U, Flags, Node> other;
+    };
+
+    HugePageAllocator() = default;
+
+    // Converting constructor, for the allocator of the elements of a node
+    // container
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U, Flags, Node>&) {}
+
+    // Allocate block of storage, nullptr if it can't be mapped
+    T* allocate(size_t n)
+    {
+        if (is_small(n))
+            return _small.allocate(n);
+
+        unsigned long bytes = mapped_bytes(n);
+        void* p = nullptr;
+
+#ifdef MAP_HUGETLB
+        if (Flags & huge_page_hugetlb)
+        {
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED)
+                p = nullptr;
+        }
+#endif
+
+        if (!p)
+        {
+            p = map_aligned(bytes);
+            if (!p)
+                return nullptr;
+#ifdef MADV_HUGEPAGE
+            madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        }
+
+        // Before the pages are touched, they are placed on the first access
+        set_numa_policy(p, bytes);
+
+        // The pages are zeroed, only the other types need constructing
+        T* data = static_cast<T*>(p);
+        if (!__has_trivial_constructor(T))
+            for (size_t i = 0; i < n; i++)
+                new (&data[i]) T();
+        return data;
+    }
+
+    // Release block of storage, n must be the size it was allocated with
+    void deallocate(T* p, size_t n)
+    {
+        if (!p)
+            return;
+
+        if (is_small(n))
+        {
+            _small.deallocate(p, n);
+            return;
+        }
+
+        if (!__has_trivial_destructor(T))
+            for (size_t i = 0; i < n; i++)
+                p[i].~T();
+        munmap(p, mapped_bytes(n));
+    }
+
+    // Allocate and construct a single object
+    template <class... Args>
+    T* construct(Args&&... args)
+    {
+        return _small.construct(static_cast<Args&&>(args)...);
+    }
+
+    // Destroy and release an object created with construct()
+    void destroy(T* p) { _small.destroy(p); }
+};
+
+} // namespace stlite
+
+#endif
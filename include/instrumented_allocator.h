@@ -0,0 +1,377 @@
+// The MIT License (MIT)
+//
+// STLite instrumented allocator
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef INSTRUMENTED_ALLOCATOR_H
+#define INSTRUMENTED_ALLOCATOR_H
+
+#include "allocator.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace stlite
+{
+
+// Most categories the registry keeps apart, allocations of further ones are
+// counted under "other"
+constexpr unsigned allocation_stats_max_categories = 64;
+
+// Histogram bucket i counts the allocations of more than 2^(i-1) and at most
+// 2^i bytes
+constexpr unsigned allocation_stats_buckets = 48;
+
+constexpr unsigned allocation_stats_name_size = 256;
+
+// Counters of a single category, the bytes are n * sizeof(T) as requested
+// from the allocator
+struct AllocationCounters
+{
+    char name[allocation_stats_name_size];
+    unsigned long allocations;
+    unsigned long deallocations;
+    unsigned long bytes_live;
+    unsigned long peak_bytes;
+    unsigned long bytes_total;
+    unsigned long histogram[allocation_stats_buckets];
+};
+
+// Global registry of the allocation counters of the instrumented allocators.
+// The counters are updated with relaxed atomics, so the allocators may be
+// used from any thread; a snapshot taken while other threads allocate is
+// consistent per counter but not across the counters.
+class AllocationStats
+{
+    static AllocationCounters* table()
+    {
+        static AllocationCounters counters[allocation_stats_max_categories + 1];
+        return counters;
+    }
+
+    static unsigned& categories()
+    {
+        static unsigned n = 0;
+        return n;
+    }
+
+    static int& lock()
+    {
+        static int l = 0;
+        return l;
+    }
+
+    static unsigned bucket(unsigned long bytes)
+    {
+        if (bytes <= 1)
+            return 0;
+        unsigned b = 64 - __builtin_clzl(bytes - 1);
+        return b < allocation_stats_buckets ? b : allocation_stats_buckets - 1;
+    }
+
+    static unsigned long load(const unsigned long& c) { return __atomic_load_n(&c, __ATOMIC_RELAXED); }
+
+    static void snapshot_one(unsigned i, AllocationCounters& out)
+    {
+        AllocationCounters* t = table();
+        memcpy(out.name, t[i].name, allocation_stats_name_size);
+        out.allocations = load(t[i].allocations);
+        out.deallocations = load(t[i].deallocations);
+        out.bytes_live = load(t[i].bytes_live);
+        out.peak_bytes = load(t[i].peak_bytes);
+        out.bytes_total = load(t[i].bytes_total);
+        for (unsigned j = 0; j < allocation_stats_buckets; j++)
+            out.histogram[j] = load(t[i].histogram[j]);
+    }
+
+public:
+    // Counters of the category with the given name, created on the first use
+    static AllocationCounters* counters(const char* name)
+    {
+        while (__atomic_exchange_n(&lock(), 1, __ATOMIC_ACQUIRE))
+            sched_yield();
+
+        AllocationCounters* t = table();
+        unsigned n = categories();
+        AllocationCounters* c = nullptr;
+
+        for (unsigned i = 0; i < n && !c; i++)
+            if (strcmp(t[i].name, name) == 0)
+                c = &t[i];
+
+        if (!c)
+        {
+            if (n < allocation_stats_max_categories)
+            {
+                c = &t[n];
+                strncpy(c->name, name, allocation_stats_name_size - 1);
+                __atomic_store_n(&categories(), n + 1, __ATOMIC_RELEASE);
+            }
+            else
+            {
+                // The overflow entry after the table
+                c = &t[allocation_stats_max_categories];
+                strcpy(c->name, "other");
+            }
+        }
+
+        __atomic_store_n(&lock(), 0, __ATOMIC_RELEASE);
+        return c;
+    }
+
+    static void record_allocate(AllocationCounters* c, unsigned long bytes)
+    {
+        __atomic_add_fetch(&c->allocations, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&c->bytes_total, bytes, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&c->histogram[bucket(bytes)], 1, __ATOMIC_RELAXED);
+
+        unsigned long live = __atomic_add_fetch(&c->bytes_live, bytes, __ATOMIC_RELAXED);
+        unsigned long peak = load(c->peak_bytes);
+        while (peak < live &&
+               !__atomic_compare_exchange_n(&c->peak_bytes, &peak, live, false, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+        {
+        }
+    }
+
+    static void record_deallocate(AllocationCounters* c, unsigned long bytes)
+    {
+        __atomic_add_fetch(&c->deallocations, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&c->bytes_live, bytes, __ATOMIC_RELAXED);
+    }
+
+    // Number of categories, including the overflow one once it is used
+    static unsigned size()
+    {
+        unsigned n = __atomic_load_n(&categories(), __ATOMIC_ACQUIRE);
+        if (n == allocation_stats_max_categories && load(table()[n].allocations))
+            n++;
+        return n;
+    }
+
+    // Copy the counters of at most max categories to out, returns how many
+    // have been copied
+    static unsigned snapshot(AllocationCounters* out, unsigned max)
+    {
+        unsigned n = size();
+        if (n > max)
+            n = max;
+
+        for (unsigned i = 0; i < n; i++)
+            snapshot_one(i, out[i]);
+        return n;
+    }
+
+    // Counters of the category with the given name, false if there is none
+    static bool snapshot(const char* name, AllocationCounters& out)
+    {
+        AllocationCounters* t = table();
+        unsigned n = size();
+        for (unsigned i = 0; i < n; i++)
+            if (strcmp(t[i].name, name) == 0)
+            {
+                snapshot_one(i, out);
+                return true;
+            }
+        return false;
+    }
+
+    // Start counting anew. The live bytes belong to memory which is still
+    // allocated, so they are kept and become the new peak.
+    static void reset()
+    {
+        AllocationCounters* t = table();
+        for (unsigned i = 0; i <= allocation_stats_max_categories; i++)
+        {
+            __atomic_store_n(&t[i].allocations, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&t[i].deallocations, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&t[i].bytes_total, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&t[i].peak_bytes, load(t[i].bytes_live), __ATOMIC_RELAXED);
+            for (unsigned j = 0; j < allocation_stats_buckets; j++)
+                __atomic_store_n(&t[i].histogram[j], 0, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Write the counters of all the categories as a JSON object:
+    //
+    //   {"categories": [{"name": "...", "allocations": 3, "deallocations": 1,
+    //     "bytes_live": 32, "peak_bytes": 48, "bytes_total": 48,
+    //     "histogram": {"16": 3}}]}
+    //
+    // The histogram keys are the bucket upper bounds in bytes, empty buckets
+    // are left out.
+    static void dump_json(FILE* out)
+    {
+        AllocationCounters c;
+
+        fprintf(out, "{\"categories\": [");
+        unsigned n = size();
+        for (unsigned i = 0; i < n; i++)
+        {
+            snapshot_one(i, c);
+            fprintf(out, "%s{\"name\": \"", i ? ", " : "");
+            for (const char* p = c.name; *p; p++)
+            {
+                if (*p == '"' || *p == '\\')
+                    fputc('\\', out);
+                fputc(*p, out);
+            }
+            fprintf(out,
+                    "\", \"allocations\": %lu, \"deallocations\": %lu, \"bytes_live\": %lu, "
+                    "\"peak_bytes\": %lu, \"bytes_total\": %lu, \"histogram\": {",
+                    c.allocations, c.deallocations, c.bytes_live, c.peak_bytes, c.bytes_total);
+
+            bool first = true;
+            for (unsigned j = 0; j < allocation_stats_buckets; j++)
+                if (c.histogram[j])
+                {
+                    fprintf(out, "%s\"%lu\": %lu", first ? "" : ", ", 1UL << j, c.histogram[j]);
+                    first = false;
+                }
+            fprintf(out, "}}");
+        }
+        fprintf(out, "]}\n");
+    }
+};
+
+// Copy the type name out of the signature of allocation_type_name(), e.g.
+// "const char* stlite::allocation_type_name() [with T = stlite::Node<int>]"
+inline const char* allocation_name_from_signature(char* name, const char* sig)
+{
+    const char* begin = strstr(sig, "T = ");
+    begin = begin ? begin + 4 : sig;
+    const char* end = strrchr(begin, ']');
+    unsigned len = end ? end - begin : strlen(begin);
+    if (len >= allocation_stats_name_size)
+        len = allocation_stats_name_size - 1;
+
+    memcpy(name, begin, len);
+    name[len] = 0;
+    return name;
+}
+
+// Name of the type T as the compiler spells it, e.g. "stlite::Node<int>"
+template <class T>
+const char* allocation_type_name()
+{
+    static char buffer[allocation_stats_name_size];
+    static const char* name = allocation_name_from_signature(buffer, __PRETTY_FUNCTION__);
+    return name;
+}
+
+template <class T, class Tag>
+struct AllocationCategory
+{
+    typedef Tag type;
+};
+
+template <class T>
+struct AllocationCategory<T, void>
+{
+    typedef T type;
+};
+
+// Allocator which counts its allocations in AllocationStats, for the Alloc
+// parameter of the containers:
+//
+//   stlite::Vector<int, stlite::InstrumentedAllocator<int>> vec;
+//   stlite::Set<int, stlite::InstrumentedAllocator<int, OrderBook>> set;
+//
+// The allocations are counted under the name of Tag, or of the allocated
+// type when Tag is void. The node containers allocate their nodes through a
+// rebound allocator, and the contiguous containers (Vector, Array) their
+// blocks through container_rebind, so by default each of them has its own
+// category named after its node type or its own type, e.g.
+// "stlite::ForwardList<int, ...>::Element" or "stlite::Vector<int, ...>". A
+// tag groups the allocations of several containers under one name instead.
+template <class T, class Tag = void>
+class InstrumentedAllocator
+{
+    Allocator<T> _alloc;
+
+    static AllocationCounters* counters()
+    {
+        static AllocationCounters* c =
+            AllocationStats::counters(allocation_type_name<typename AllocationCategory<T, Tag>::type>());
+        return c;
+    }
+
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef InstrumentedAllocator<U, Tag> other;
+    };
+
+    // The same allocator for the blocks of the contiguous container C, they
+    // are counted under the name of C unless a tag is given
+    template <class C>
+    struct container_rebind
+    {
+        typedef InstrumentedAllocator<T, typename AllocationCategory<C, Tag>::type> other;
+    };
+
+    InstrumentedAllocator() = default;
+
+    // Converting constructor, for the allocator of the elements of a node
+    // container or of the blocks of a contiguous one
+    template <class U, class V>
+    InstrumentedAllocator(const InstrumentedAllocator<U, V>&) {}
+
+    // Allocate block of storage
+    T* allocate(size_t n)
+    {
+        AllocationStats::record_allocate(counters(), (unsigned long) n * sizeof(T));
+        return _alloc.allocate(n);
+    }
+
+    // Release block of storage
+    void deallocate(T* p, size_t n)
+    {
+        if (!p)
+            return;
+        AllocationStats::record_deallocate(counters(), (unsigned long) n * sizeof(T));
+        _alloc.deallocate(p, n);
+    }
+
+    // Allocate and construct a single object
+    template <class... Args>
+    T* construct(Args&&... args)
+    {
+        AllocationStats::record_allocate(counters(), sizeof(T));
+        return _alloc.construct(static_cast<Args&&>(args)...);
+    }
+
+    // Destroy and release an object created with construct()
+    void destroy(T* p)
+    {
+        if (!p)
+            return;
+        AllocationStats::record_deallocate(counters(), sizeof(T));
+        _alloc.destroy(p);
+    }
+};
+
+} // namespace stlite
+
+#endif
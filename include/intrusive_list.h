@@ -0,0 +1,434 @@
+// The MIT License (MIT)
+//
+// STLite intrusive lists
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include "allocator.h"
+
+namespace stlite
+{
+
+// Intrusive containers do not own their elements. The user type embeds a hook
+// member and the container only links hooks together, so inserting and
+// erasing never allocates or copies. The user is responsible for keeping the
+// objects alive while they are linked.
+//
+//   struct Packet
+//   {
+//       int id;
+//       stlite::ListHook hook;
+//   };
+//
+//   stlite::IntrusiveCircularList<Packet, &Packet::hook> lst;
+
+// Return the object which contains the given hook member
+template <class T, class H>
+T* hook_owner(H* hook, H T::*member)
+{
+    // Offset of the member inside T, computed on a fake (never dereferenced)
+    // object address, the same way offsetof does it.
+    T* fake = reinterpret_cast<T*>(0x1000);
+    unsigned long offset = reinterpret_cast<char*>(&(fake->*member)) -
+                           reinterpret_cast<char*>(fake);
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset);
+}
+
+//====----------------------------------------------------------------------====
+// Intrusive forward list
+//====----------------------------------------------------------------------====
+
+struct ForwardListHook
+{
+    ForwardListHook* next = nullptr;
+};
+
+template <class T, ForwardListHook T::*Hook>
+class IntrusiveForwardList
+{
+    // _head.next points to the first element of the list
+    ForwardListHook _head;
+    size_t _size = 0;
+
+    static T* owner(ForwardListHook* h) { return hook_owner<T>(h, Hook); }
+
+public:
+    IntrusiveForwardList() {}
+
+    // Elements are not owned, therefore the list can't be copied
+    IntrusiveForwardList(const IntrusiveForwardList& other) = delete;
+    IntrusiveForwardList& operator=(const IntrusiveForwardList& other) = delete;
+
+    // Move constructor
+    IntrusiveForwardList(IntrusiveForwardList&& other)
+    {
+        _head.next = other._head.next;
+        _size = other._size;
+
+        other._head.next = nullptr;
+        other._size = 0;
+    }
+
+    ~IntrusiveForwardList() { clear(); }
+
+    // Iterators
+    class Iterator
+    {
+        ForwardListHook* _p = nullptr;
+        friend class IntrusiveForwardList;
+
+    public:
+        Iterator() = default;
+
+        Iterator(ForwardListHook* h) : _p(h) {}
+
+        // Only forward iteration is supported
+
+        // Prefix increment operator
+        Iterator& operator++()
+        {
+            _p = _p->next;
+            return *this;
+        }
+
+        // Postfix increment operator
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            _p = _p->next;
+            return tmp;
+        }
+
+        T& operator*() { return *owner(_p); }
+        T* operator->() { return owner(_p); }
+
+        bool operator==(const Iterator& other) const { return other._p == _p; }
+        bool operator!=(const Iterator& other) const { return other._p != _p; }
+    };
+
+    // The iterator before the first element, usable with insert_after() and
+    // erase_after(). It must not be dereferenced.
+    Iterator before_begin() { return Iterator(&_head); }
+    Iterator begin() { return Iterator(_head.next); }
+    Iterator end() { return Iterator(); }
+
+    // Capacity
+    bool empty() const { return _head.next == nullptr; }
+    size_t size() const { return _size; }
+
+    // Element access
+    // If the list is empty, the return value of these functions is undefined
+    T& front() { return *owner(_head.next); }
+
+    // Modifiers
+
+    void push_front(T& value)
+    {
+        ForwardListHook* h = &(value.*Hook);
+        h->next = _head.next;
+        _head.next = h;
+        _size++;
+    }
+
+    void pop_front()
+    {
+        if (!_head.next)
+            return;
+
+        ForwardListHook* old = _head.next;
+        _head.next = old->next;
+        old->next = nullptr;
+        _size--;
+    }
+
+    // Link value right after the position pos
+    void insert_after(Iterator pos, T& value)
+    {
+        ForwardListHook* h = &(value.*Hook);
+        h->next = pos._p->next;
+        pos._p->next = h;
+        _size++;
+    }
+
+    // Unlink the element following the position pos
+    void erase_after(Iterator pos)
+    {
+        ForwardListHook* old = pos._p->next;
+        if (!old)
+            return;
+
+        pos._p->next = old->next;
+        old->next = nullptr;
+        _size--;
+    }
+
+    // Unlink all elements. Objects themselves are left untouched.
+    void clear()
+    {
+        ForwardListHook* p = _head.next;
+
+        while (p)
+        {
+            ForwardListHook* old = p;
+            p = p->next;
+            old->next = nullptr;
+        }
+
+        _head.next = nullptr;
+        _size = 0;
+    }
+
+    // Operations
+
+    // Unlink the given object. A singly linked hook has no back pointer,
+    // therefore this walks the list to find the predecessor.
+    // Return true if element has been removed, false otherwise.
+    bool remove(T& value)
+    {
+        ForwardListHook* h = &(value.*Hook);
+        ForwardListHook* prev = &_head;
+
+        while (prev->next && prev->next != h)
+            prev = prev->next;
+
+        if (!prev->next)
+            return false;
+
+        prev->next = h->next;
+        h->next = nullptr;
+        _size--;
+
+        return true;
+    }
+};
+
+//====----------------------------------------------------------------------====
+// Intrusive circular list
+//====----------------------------------------------------------------------====
+
+// Doubly linked hook, an object can be unlinked in O(1) by reference
+struct ListHook
+{
+    ListHook* prev = nullptr;
+    ListHook* next = nullptr;
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+template <class T, ListHook T::*Hook>
+class IntrusiveCircularList
+{
+    //
+    //         _root
+    //           |
+    //           v
+    //  +---+  +---+  +---+  +---+
+    //  | 4 |<>| R |<>| 1 |<>| 2 | ...
+    //  +---+  +---+  +---+  +---+
+    //
+    // _root is a sentinel hook which closes the circle. _root.next is the
+    // first element and _root.prev is the last one.
+
+    ListHook _root;
+    size_t _size = 0;
+
+    static T* owner(ListHook* h) { return hook_owner<T>(h, Hook); }
+
+    void init()
+    {
+        _root.prev = &_root;
+        _root.next = &_root;
+    }
+
+    // Link h before the hook pos
+    void link_before(ListHook* pos, ListHook* h)
+    {
+        h->next = pos;
+        h->prev = pos->prev;
+        pos->prev->next = h;
+        pos->prev = h;
+        _size++;
+    }
+
+    void unlink(ListHook* h)
+    {
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = nullptr;
+        h->next = nullptr;
+        _size--;
+    }
+
+public:
+    IntrusiveCircularList() { init(); }
+
+    // Elements are not owned, therefore the list can't be copied
+    IntrusiveCircularList(const IntrusiveCircularList& other) = delete;
+    IntrusiveCircularList& operator=(const IntrusiveCircularList& other) = delete;
+
+    // Move constructor
+    IntrusiveCircularList(IntrusiveCircularList&& other)
+    {
+        init();
+
+        if (!other.empty())
+        {
+            // Only the first and the last element point to the sentinel
+            _root.next = other._root.next;
+            _root.prev = other._root.prev;
+            _root.next->prev = &_root;
+            _root.prev->next = &_root;
+            _size = other._size;
+
+            other.init();
+            other._size = 0;
+        }
+    }
+
+    ~IntrusiveCircularList() { clear(); }
+
+    // Iterators
+    class Iterator
+    {
+        ListHook* _p = nullptr;
+        friend class IntrusiveCircularList;
+
+    public:
+        Iterator() = default;
+
+        Iterator(ListHook* h) : _p(h) {}
+
+        // Prefix increment operator
+        Iterator& operator++()
+        {
+            _p = _p->next;
+            return *this;
+        }
+
+        // Postfix increment operator
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            _p = _p->next;
+            return tmp;
+        }
+
+        // Prefix decrement operator
+        Iterator& operator--()
+        {
+            _p = _p->prev;
+            return *this;
+        }
+
+        // Postfix decrement operator
+        Iterator operator--(int)
+        {
+            Iterator tmp = *this;
+            _p = _p->prev;
+            return tmp;
+        }
+
+        T& operator*() { return *owner(_p); }
+        T* operator->() { return owner(_p); }
+
+        bool operator==(const Iterator& other) const { return other._p == _p; }
+        bool operator!=(const Iterator& other) const { return other._p != _p; }
+    };
+
+    Iterator begin() { return Iterator(_root.next); }
+    Iterator end() { return Iterator(&_root); }
+
+    // Return iterator pointing to the given linked object
+    Iterator iterator_to(T& value) { return Iterator(&(value.*Hook)); }
+
+    // Capacity
+    bool empty() const { return _root.next == &_root; }
+    size_t size() const { return _size; }
+
+    // Element access
+    // If the list is empty, the return value of these functions is undefined
+    T& front() { return *owner(_root.next); }
+    T& back() { return *owner(_root.prev); }
+
+    // Modifiers
+
+    // Link element to end of the list
+    void push_back(T& value) { link_before(&_root, &(value.*Hook)); }
+
+    // Link element at beginning of the list
+    void push_front(T& value) { link_before(_root.next, &(value.*Hook)); }
+
+    bool pop_front()
+    {
+        if (empty())
+            return false;
+
+        unlink(_root.next);
+        return true;
+    }
+
+    bool pop_back()
+    {
+        if (empty())
+            return false;
+
+        unlink(_root.prev);
+        return true;
+    }
+
+    // Link value before the position pos
+    void insert(Iterator pos, T& value) { link_before(pos._p, &(value.*Hook)); }
+
+    // Unlink element at the position pos and return iterator to the next one
+    Iterator erase(Iterator pos)
+    {
+        ListHook* next = pos._p->next;
+        unlink(pos._p);
+        return Iterator(next);
+    }
+
+    // Unlink the given object in O(1). The object must be linked into this
+    // list.
+    void erase(T& value) { unlink(&(value.*Hook)); }
+
+    // Unlink all elements. Objects themselves are left untouched.
+    void clear()
+    {
+        ListHook* p = _root.next;
+
+        while (p != &_root)
+        {
+            ListHook* old = p;
+            p = p->next;
+            old->prev = nullptr;
+            old->next = nullptr;
+        }
+
+        init();
+        _size = 0;
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,344 @@
+// The MIT License (MIT)
+//
+// STLite intrusive set
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INTRUSIVE_SET_H
+#define INTRUSIVE_SET_H
+
+#include "intrusive_list.h"
+
+namespace stlite
+{
+
+// Hook for IntrusiveSet. The parent pointer lets us erase an object by
+// reference without searching for it first.
+struct SetHook
+{
+    SetHook* parent = nullptr;
+    SetHook* left = nullptr;
+    SetHook* right = nullptr;
+    int height = 0; // 0 means the hook is not linked
+
+    bool is_linked() const { return height != 0; }
+};
+
+// AVL tree of objects embedding a SetHook. Elements are ordered by operator<
+// of T and are unique. Insert and erase never allocate.
+template <class T, SetHook T::*Hook>
+class IntrusiveSet
+{
+    SetHook* _root = nullptr;
+    size_t _size = 0;
+
+    static T* owner(SetHook* h) { return hook_owner<T>(h, Hook); }
+
+    static int height(SetHook* n) { return n ? n->height : 0; }
+
+    static void update_height(SetHook* n)
+    {
+        int hl = height(n->left);
+        int hr = height(n->right);
+        n->height = 1 + (hl > hr ? hl : hr);
+    }
+
+    static SetHook* leftmost(SetHook* n)
+    {
+        while (n->left)
+            n = n->left;
+        return n;
+    }
+
+    void replace_child(SetHook* parent, SetHook* old, SetHook* n)
+    {
+        if (!parent)
+            _root = n;
+        else if (parent->left == old)
+            parent->left = n;
+        else
+            parent->right = n;
+    }
+
+    //
+    //      x                y
+    //     / \              / \      y takes the place of x,
+    //    a   y     =>     x   c     x becomes y's left child
+    //       / \          / \        and gets y's old left
+    //      b   c        a   b       subtree b
+    //
+    SetHook* rotate_left(SetHook* x)
+    {
+        SetHook* y = x->right;
+        x->right = y->left;
+        if (y->left)
+            y->left->parent = x;
+        y->parent = x->parent;
+        replace_child(x->parent, x, y);
+        y->left = x;
+        x->parent = y;
+        update_height(x);
+        update_height(y);
+        return y;
+    }
+
+    SetHook* rotate_right(SetHook* x)
+    {
+        SetHook* y = x->left;
+        x->left = y->right;
+        if (y->right)
+            y->right->parent = x;
+        y->parent = x->parent;
+        replace_child(x->parent, x, y);
+        y->right = x;
+        x->parent = y;
+        update_height(x);
+        update_height(y);
+        return y;
+    }
+
+    // Restore the AVL property on the path from n up to the root
+    void rebalance(SetHook* n)
+    {
+        while (n)
+        {
+            update_height(n);
+            int balance = height(n->left) - height(n->right);
+
+            if (balance > 1)
+            {
+                if (height(n->left->left) < height(n->left->right))
+                    rotate_left(n->left);
+                n = rotate_right(n);
+            }
+            else if (balance < -1)
+            {
+                if (height(n->right->right) < height(n->right->left))
+                    rotate_right(n->right);
+                n = rotate_left(n);
+            }
+
+            n = n->parent;
+        }
+    }
+
+    static void reset(SetHook* h)
+    {
+        h->parent = nullptr;
+        h->left = nullptr;
+        h->right = nullptr;
+        h->height = 0;
+    }
+
+    void unlink_elements(SetHook* n)
+    {
+        if (!n)
+            return;
+
+        unlink_elements(n->left);
+        unlink_elements(n->right);
+        reset(n);
+    }
+
+public:
+    IntrusiveSet() {}
+
+    // Elements are not owned, therefore the set can't be copied
+    IntrusiveSet(const IntrusiveSet& other) = delete;
+    IntrusiveSet& operator=(const IntrusiveSet& other) = delete;
+
+    // Move constructor
+    IntrusiveSet(IntrusiveSet&& other)
+    {
+        _root = other._root;
+        _size = other._size;
+
+        other._root = nullptr;
+        other._size = 0;
+    }
+
+    ~IntrusiveSet() { clear(); }
+
+    // Iterators (in-order traversal)
+    class Iterator
+    {
+        SetHook* _p = nullptr;
+        friend class IntrusiveSet;
+
+    public:
+        Iterator() = default;
+
+        Iterator(SetHook* h) : _p(h) {}
+
+        // Prefix increment operator
+        Iterator& operator++()
+        {
+            if (_p->right)
+            {
+                _p = leftmost(_p->right);
+            }
+            else
+            {
+                SetHook* parent = _p->parent;
+                while (parent && parent->right == _p)
+                {
+                    _p = parent;
+                    parent = parent->parent;
+                }
+                _p = parent;
+            }
+            return *this;
+        }
+
+        // Postfix increment operator
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        T& operator*() { return *owner(_p); }
+        T* operator->() { return owner(_p); }
+
+        bool operator==(const Iterator& other) const { return other._p == _p; }
+        bool operator!=(const Iterator& other) const { return other._p != _p; }
+    };
+
+    Iterator begin() { return Iterator(_root ? leftmost(_root) : nullptr); }
+    Iterator end() { return Iterator(); }
+
+    // Capacity
+    bool empty() const { return _root == nullptr; }
+    size_t size() const { return _size; }
+
+    // Modifiers
+
+    // Link the object into the set.
+    // Return false if an equal element is already in the set.
+    bool insert(T& value)
+    {
+        SetHook* h = &(value.*Hook);
+        SetHook* parent = nullptr;
+        SetHook** link = &_root;
+
+        while (*link)
+        {
+            parent = *link;
+            if (value < *owner(parent))
+                link = &parent->left;
+            else if (*owner(parent) < value)
+                link = &parent->right;
+            else
+                return false;
+        }
+
+        h->parent = parent;
+        h->left = nullptr;
+        h->right = nullptr;
+        h->height = 1;
+        *link = h;
+        _size++;
+
+        rebalance(parent);
+        return true;
+    }
+
+    // Unlink the given object. The object must be linked into this set.
+    void erase(T& value)
+    {
+        SetHook* z = &(value.*Hook);
+        SetHook* start;
+
+        if (z->left && z->right)
+        {
+            // Put the in-order successor y into the place of z
+            SetHook* y = leftmost(z->right);
+
+            if (y->parent == z)
+            {
+                start = y;
+            }
+            else
+            {
+                start = y->parent;
+                start->left = y->right;
+                if (y->right)
+                    y->right->parent = start;
+                y->right = z->right;
+                z->right->parent = y;
+            }
+
+            y->left = z->left;
+            z->left->parent = y;
+            y->parent = z->parent;
+            replace_child(z->parent, z, y);
+        }
+        else
+        {
+            SetHook* child = z->left ? z->left : z->right;
+            if (child)
+                child->parent = z->parent;
+            replace_child(z->parent, z, child);
+            start = z->parent;
+        }
+
+        reset(z);
+        _size--;
+
+        rebalance(start);
+    }
+
+    // Unlink all elements. Objects themselves are left untouched.
+    void clear()
+    {
+        unlink_elements(_root);
+        _root = nullptr;
+        _size = 0;
+    }
+
+    // Operations
+
+    // Return pointer to the element equal to the key or nullptr
+    T* find(const T& key)
+    {
+        SetHook* n = _root;
+
+        while (n)
+        {
+            if (key < *owner(n))
+                n = n->left;
+            else if (*owner(n) < key)
+                n = n->right;
+            else
+                return owner(n);
+        }
+
+        return nullptr;
+    }
+
+    size_t count(const T& key) { return find(key) ? 1 : 0; }
+
+    Iterator iterator_to(T& value) { return Iterator(&(value.*Hook)); }
+};
+
+} // namespace stlite
+
+#endif
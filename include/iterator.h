@@ -0,0 +1,415 @@
+// The MIT License (MIT)
+//
+// STLite iterators
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef ITERATOR_H
+#define ITERATOR_H
+
+#include "allocator.h"
+
+#ifdef USE_STL
+#include <iterator>
+#endif
+
+namespace stlite
+{
+
+typedef long ptrdiff_t;
+
+template <class T>
+struct RemoveConst
+{
+    typedef T type;
+};
+
+template <class T>
+struct RemoveConst<const T>
+{
+    typedef T type;
+};
+
+template <class T>
+struct RemoveReference
+{
+    typedef T type;
+};
+
+template <class T>
+struct RemoveReference<T&>
+{
+    typedef T type;
+};
+
+template <class T>
+struct RemoveReference<T&&>
+{
+    typedef T type;
+};
+
+template <class T, class U>
+struct IsSame : BoolConstant<false> {};
+
+template <class T>
+struct IsSame<T, T> : BoolConstant<true> {};
+
+// I-th type of the list Ts
+template <size_t I, class T, class... Ts>
+struct TypeAt
+{
+    typedef typename TypeAt<I - 1, Ts...>::type type;
+};
+
+template <class T, class... Ts>
+struct TypeAt<0, T, Ts...>
+{
+    typedef T type;
+};
+
+// Compile-time list of indices, MakeIndexSequence<N>::type is
+// IndexSequence<0, 1, ..., N - 1>
+template <size_t... I>
+struct IndexSequence
+{
+};
+
+template <size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...>
+{
+};
+
+template <size_t... I>
+struct MakeIndexSequence<0, I...>
+{
+    typedef IndexSequence<I...> type;
+};
+
+// Iterator over elements stored contiguously in memory (Vector, Array, ...).
+// It is a thin wrapper of a pointer, so loops over it compile to the same code
+// as loops over raw pointers. ContiguousIterator<const T> is the constant
+// variant, a non-constant iterator converts to it implicitly.
+template <class T>
+class ContiguousIterator
+{
+    T* _p = nullptr;
+
+public:
+    typedef typename RemoveConst<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+#ifdef USE_STL
+    typedef std::random_access_iterator_tag iterator_category;
+#endif
+
+    constexpr ContiguousIterator() {}
+    constexpr explicit ContiguousIterator(T* p) : _p(p) {}
+
+    // Conversion from iterator to const iterator
+    template <class U>
+    constexpr ContiguousIterator(const ContiguousIterator<U>& other) : _p(other.base()) {}
+
+    // Underlying pointer
+    constexpr T* base() const { return _p; }
+
+    // Prefix increment operator
+    constexpr ContiguousIterator& operator++()
+    {
+        ++_p;
+        return *this;
+    }
+
+    // Postfix increment operator
+    constexpr ContiguousIterator operator++(int)
+    {
+        ContiguousIterator tmp = *this;
+        ++_p;
+        return tmp;
+    }
+
+    // Prefix decrement operator
+    constexpr ContiguousIterator& operator--()
+    {
+        --_p;
+        return *this;
+    }
+
+    // Postfix decrement operator
+    constexpr ContiguousIterator operator--(int)
+    {
+        ContiguousIterator tmp = *this;
+        --_p;
+        return tmp;
+    }
+
+    constexpr ContiguousIterator& operator+=(difference_type n)
+    {
+        _p += n;
+        return *this;
+    }
+
+    constexpr ContiguousIterator& operator-=(difference_type n)
+    {
+        _p -= n;
+        return *this;
+    }
+
+    constexpr ContiguousIterator operator+(difference_type n) const
+    {
+        return ContiguousIterator(_p + n);
+    }
+
+    constexpr ContiguousIterator operator-(difference_type n) const
+    {
+        return ContiguousIterator(_p - n);
+    }
+
+    constexpr T& operator*() const { return *_p; }
+    constexpr T* operator->() const { return _p; }
+    constexpr T& operator[](difference_type n) const { return _p[n]; }
+};
+
+template <class T>
+constexpr ContiguousIterator<T> operator+(ptrdiff_t n, const ContiguousIterator<T>& it)
+{
+    return it + n;
+}
+
+// Comparisons and the distance work between iterators and const iterators
+
+template <class T, class U>
+constexpr ptrdiff_t operator-(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() - b.base();
+}
+
+template <class T, class U>
+constexpr bool operator==(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() == b.base();
+}
+
+template <class T, class U>
+constexpr bool operator!=(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() != b.base();
+}
+
+template <class T, class U>
+constexpr bool operator<(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() < b.base();
+}
+
+template <class T, class U>
+constexpr bool operator>(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() > b.base();
+}
+
+template <class T, class U>
+constexpr bool operator<=(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() <= b.base();
+}
+
+template <class T, class U>
+constexpr bool operator>=(const ContiguousIterator<T>& a, const ContiguousIterator<U>& b)
+{
+    return a.base() >= b.base();
+}
+
+// Traits of iterator types used by the algorithms. Contiguous iterators (raw
+// pointers and ContiguousIterator) can be unwrapped with pointer(), which lets
+// the algorithms hand whole ranges to memmove, memset or memchr.
+template <class It>
+struct IteratorTraits
+{
+    typedef typename RemoveConst<
+        typename RemoveReference<decltype(*declared_value<It>())>::type>::type
+        value_type;
+    typedef ptrdiff_t difference_type;
+    static constexpr bool contiguous = false;
+};
+
+template <class T>
+struct IteratorTraits<T*>
+{
+    typedef typename RemoveConst<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    static constexpr bool contiguous = true;
+
+    static T* pointer(T* p) { return p; }
+};
+
+template <class T>
+struct IteratorTraits<ContiguousIterator<T>>
+{
+    typedef typename RemoveConst<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    static constexpr bool contiguous = true;
+
+    static T* pointer(ContiguousIterator<T> it) { return it.base(); }
+};
+
+// EnableIfIterator<It, R>::type is R when It can be dereferenced and
+// incremented. The constructors taking an iterator range use it, so that
+// they don't take a count and a value of the same type instead.
+template <class It, class R = void, class = void>
+struct EnableIfIterator
+{
+};
+
+template <class It, class R>
+struct EnableIfIterator<It, R, typename VoidType<decltype(*declared_value<It>()),
+                                                 decltype(++declared_value<It>())>::type>
+{
+    typedef R type;
+};
+
+// Iterates a random access range backwards. Like std::reverse_iterator it
+// holds the iterator one past the element it refers to, so rbegin() is built
+// from end() and rend() from begin().
+template <class It>
+class ReverseIterator
+{
+    It _it;
+
+public:
+    typedef typename It::value_type value_type;
+    typedef typename It::difference_type difference_type;
+    typedef typename It::pointer pointer;
+    typedef typename It::reference reference;
+#ifdef USE_STL
+    typedef std::random_access_iterator_tag iterator_category;
+#endif
+
+    constexpr ReverseIterator() {}
+    constexpr explicit ReverseIterator(It it) : _it(it) {}
+
+    // Conversion from reverse iterator to const reverse iterator
+    template <class U>
+    constexpr ReverseIterator(const ReverseIterator<U>& other) : _it(other.base()) {}
+
+    constexpr It base() const { return _it; }
+
+    // Prefix increment operator
+    constexpr ReverseIterator& operator++()
+    {
+        --_it;
+        return *this;
+    }
+
+    // Postfix increment operator
+    constexpr ReverseIterator operator++(int)
+    {
+        ReverseIterator tmp = *this;
+        --_it;
+        return tmp;
+    }
+
+    // Prefix decrement operator
+    constexpr ReverseIterator& operator--()
+    {
+        ++_it;
+        return *this;
+    }
+
+    // Postfix decrement operator
+    constexpr ReverseIterator operator--(int)
+    {
+        ReverseIterator tmp = *this;
+        ++_it;
+        return tmp;
+    }
+
+    constexpr ReverseIterator& operator+=(difference_type n)
+    {
+        _it -= n;
+        return *this;
+    }
+
+    constexpr ReverseIterator& operator-=(difference_type n)
+    {
+        _it += n;
+        return *this;
+    }
+
+    constexpr ReverseIterator operator+(difference_type n) const
+    {
+        return ReverseIterator(_it - n);
+    }
+
+    constexpr ReverseIterator operator-(difference_type n) const
+    {
+        return ReverseIterator(_it + n);
+    }
+
+    constexpr reference operator*() const { return *(_it - 1); }
+    constexpr pointer operator->() const { return (_it - 1).operator->(); }
+    constexpr reference operator[](difference_type n) const { return *(_it - n - 1); }
+};
+
+template <class It, class U>
+constexpr ptrdiff_t operator-(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return b.base() - a.base();
+}
+
+template <class It, class U>
+constexpr bool operator==(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() == b.base();
+}
+
+template <class It, class U>
+constexpr bool operator!=(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() != b.base();
+}
+
+template <class It, class U>
+constexpr bool operator<(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() > b.base();
+}
+
+template <class It, class U>
+constexpr bool operator>(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() < b.base();
+}
+
+template <class It, class U>
+constexpr bool operator<=(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() >= b.base();
+}
+
+template <class It, class U>
+constexpr bool operator>=(const ReverseIterator<It>& a, const ReverseIterator<U>& b)
+{
+    return a.base() <= b.base();
+}
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,337 @@
+// The MIT License (MIT)
+//
+// STLite memory-mapped vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MAPPED_VECTOR_H
+#define MAPPED_VECTOR_H
+
+#include "allocator.h"
+#include "iterator.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stlite
+{
+
+// Vector of trivially copyable elements stored in a memory-mapped file. The
+// file holds the elements and nothing else, so an existing file of records
+// is used in place without reading or copying it:
+//
+//   stlite::MappedVector<Record> records;
+//   if (!records.open("records.bin"))
+//       ...
+//   for (const Record& r : records)
+//       ...
+//
+// The pages are loaded on the first access and are shared with the page
+// cache, a read-only mapping costs no private memory at all. A writable
+// vector grows the file geometrically with ftruncate() and mremap(); the
+// file is truncated back to the elements when the vector is closed, so it
+// may have zeroed elements at its end if the process dies before that.
+//
+// The operations which may fail return false and leave the vector as it
+// was. Growing moves the mapping, so it invalidates pointers and iterators
+// like Vector does.
+template <class T>
+class MappedVector
+{
+    static_assert(__is_trivially_copyable(T), "MappedVector needs a trivially copyable T");
+
+    T* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    int _fd = -1;
+    bool _writable = false;
+
+    static unsigned long page_size() { return sysconf(_SC_PAGESIZE); }
+
+    // Bytes of the file for the given number of elements, rounded up to
+    // whole pages so that the capacity isn't wasted
+    static unsigned long bytes_for(unsigned long n)
+    {
+        unsigned long page = page_size();
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    bool map(unsigned long bytes)
+    {
+        if (bytes == 0)
+            return true;
+
+        int prot = _writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* p = mmap(nullptr, bytes, prot, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED)
+            return false;
+
+        _data = static_cast<T*>(p);
+        return true;
+    }
+
+    // Grow the file and the mapping to at least n elements
+    bool grow(size_t n)
+    {
+        if (!_writable)
+            return false;
+
+        unsigned long old_bytes = (unsigned long) _capacity * sizeof(T);
+        unsigned long new_bytes = bytes_for(n);
+        if (new_bytes / sizeof(T) > (size_t) -1)
+            return false;
+
+        if (ftruncate(_fd, new_bytes) != 0)
+            return false;
+
+        void* p;
+        if (_data)
+            p = mremap(_data, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        else
+            p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+        // Give the file back its old length. If even that fails, close()
+        // still truncates it to the elements.
+        if (p == MAP_FAILED)
+        {
+            int r = ftruncate(_fd, old_bytes);
+            (void) r;
+            return false;
+        }
+
+        _data = static_cast<T*>(p);
+        _capacity = new_bytes / sizeof(T);
+        return true;
+    }
+
+public:
+    MappedVector() {}
+
+    MappedVector(const MappedVector& other) = delete;
+    MappedVector& operator=(const MappedVector& other) = delete;
+
+    // Move constructor
+    MappedVector(MappedVector&& other)
+        : _data(other._data), _size(other._size), _capacity(other._capacity), _fd(other._fd),
+          _writable(other._writable)
+    {
+        other._data = nullptr;
+        other._size = 0;
+        other._capacity = 0;
+        other._fd = -1;
+    }
+
+    // Move assignment operator
+    MappedVector& operator=(MappedVector&& other)
+    {
+        if (&other != this)
+        {
+            close();
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            _fd = other._fd;
+            _writable = other._writable;
+
+            other._data = nullptr;
+            other._size = 0;
+            other._capacity = 0;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    ~MappedVector() { close(); }
+
+    // Map an existing file, read-only unless writable is set. Fails if the
+    // file can't be opened or its size isn't a multiple of sizeof(T).
+    bool open(const char* path, bool writable = false)
+    {
+        close();
+
+        int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size % sizeof(T) != 0 ||
+            (unsigned long) st.st_size / sizeof(T) > (size_t) -1)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        _fd = fd;
+        _writable = writable;
+        if (!map(st.st_size))
+        {
+            ::close(fd);
+            _fd = -1;
+            return false;
+        }
+
+        _size = _capacity = st.st_size / sizeof(T);
+        return true;
+    }
+
+    // Create an empty writable vector in the file, which is truncated if it
+    // exists
+    bool create(const char* path)
+    {
+        close();
+
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+
+        _fd = fd;
+        _writable = true;
+        return true;
+    }
+
+    // Unmap the vector and truncate its file to the elements. Returns false
+    // if the file couldn't be truncated, it keeps zeroed elements at its end
+    // then.
+    bool close()
+    {
+        if (_fd < 0)
+            return true;
+
+        if (_data)
+            munmap(_data, (unsigned long) _capacity * sizeof(T));
+
+        bool ok = true;
+        if (_writable)
+            ok = ftruncate(_fd, (unsigned long) _size * sizeof(T)) == 0;
+        ::close(_fd);
+
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+        _fd = -1;
+        _writable = false;
+        return ok;
+    }
+
+    // Write the modified pages back to the file, and wait for the writes to
+    // complete unless async is set
+    bool sync(bool async = false)
+    {
+        if (!_data)
+            return _fd >= 0;
+        return msync(_data, (unsigned long) _capacity * sizeof(T), async ? MS_ASYNC : MS_SYNC) == 0;
+    }
+
+    bool is_open() const { return _fd >= 0; }
+    bool writable() const { return _writable; }
+
+    // Iterators
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+
+    Iterator begin() { return Iterator(_data); }
+    Iterator end() { return Iterator(_data + _size); }
+
+    ConstIterator begin() const { return ConstIterator(_data); }
+    ConstIterator end() const { return ConstIterator(_data + _size); }
+
+    ConstIterator cbegin() const { return ConstIterator(_data); }
+    ConstIterator cend() const { return ConstIterator(_data + _size); }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    // Make room for at least n elements without remapping
+    bool reserve(size_t n)
+    {
+        if (n <= _capacity)
+            return true;
+        return grow(n);
+    }
+
+    // Change the number of elements, the new ones are zeroed
+    bool resize(size_t n)
+    {
+        if (!_writable || (n > _capacity && !grow(n)))
+            return false;
+
+        // The pages past the end of a truncated file read as zeros, but the
+        // elements removed earlier are still in the mapping
+        if (n > _size)
+            memset(static_cast<void*>(_data + _size), 0, (unsigned long) (n - _size) * sizeof(T));
+        _size = n;
+        return true;
+    }
+
+    // Element access. Writing the elements of a read-only vector crashes
+    // the process with SIGSEGV.
+    T& operator[](size_t n) { return _data[n]; }
+    const T& operator[](size_t n) const { return _data[n]; }
+
+    T& front() { return _data[0]; }
+    T& back() { return _data[_size - 1]; }
+
+    const T& front() const { return _data[0]; }
+    const T& back() const { return _data[_size - 1]; }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    // Modifiers
+
+    bool push_back(const T& value)
+    {
+        if (!_writable)
+            return false;
+
+        // value may be an element, which moves if the mapping grows
+        T copy = value;
+        if (_size == _capacity && !grow(_capacity ? _capacity * 2 : 1))
+            return false;
+        _data[_size++] = copy;
+        return true;
+    }
+
+    bool pop_back()
+    {
+        if (_size == 0 || !_writable)
+            return false;
+        _size--;
+        return true;
+    }
+
+    bool clear()
+    {
+        if (!_writable)
+            return false;
+        _size = 0;
+        return true;
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,452 @@
+// The MIT License (MIT)
+//
+// STLite memory resources
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+#include "allocator.h"
+
+#include <new>
+#include <stdlib.h>
+
+namespace stlite
+{
+
+// Source of untyped memory, after std::pmr::memory_resource. Containers use
+// one through PolymorphicAllocator, so the memory strategy is picked at run
+// time per container without changing its type. allocate() returns nullptr
+// when the memory can't be obtained. bytes and align passed to deallocate()
+// must be the ones the block was allocated with.
+class MemoryResource
+{
+public:
+    virtual ~MemoryResource() {}
+
+    void* allocate(unsigned long bytes, size_t align = default_new_alignment)
+    {
+        return do_allocate(bytes, align);
+    }
+
+    void deallocate(void* p, unsigned long bytes, size_t align = default_new_alignment)
+    {
+        if (p)
+            do_deallocate(p, bytes, align);
+    }
+
+    // Whether the memory allocated from either can be released by the other
+    bool is_equal(const MemoryResource& other) const
+    {
+        return this == &other || do_is_equal(other);
+    }
+
+protected:
+    virtual void* do_allocate(unsigned long bytes, size_t align) = 0;
+    virtual void do_deallocate(void* p, unsigned long bytes, size_t align) = 0;
+    virtual bool do_is_equal(const MemoryResource& other) const { return this == &other; }
+};
+
+// Memory from malloc(), or from posix_memalign() for the larger alignments
+class NewDeleteResource : public MemoryResource
+{
+protected:
+    void* do_allocate(unsigned long bytes, size_t align) override
+    {
+        if (align <= default_new_alignment)
+            return malloc(bytes ? bytes : 1);
+
+        void* p;
+        if (posix_memalign(&p, align, bytes ? bytes : 1) != 0)
+            return nullptr;
+        return p;
+    }
+
+    void do_deallocate(void* p, unsigned long, size_t) override { free(p); }
+};
+
+inline MemoryResource* new_delete_resource()
+{
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+inline MemoryResource*& default_resource_pointer()
+{
+    static MemoryResource* resource = new_delete_resource();
+    return resource;
+}
+
+// Resource of the default constructed PolymorphicAllocators, and the
+// upstream of the other resources by default
+inline MemoryResource* get_default_resource()
+{
+    return __atomic_load_n(&default_resource_pointer(), __ATOMIC_ACQUIRE);
+}
+
+// Returns the previous default resource, nullptr restores new_delete_resource()
+inline MemoryResource* set_default_resource(MemoryResource* resource)
+{
+    if (!resource)
+        resource = new_delete_resource();
+    return __atomic_exchange_n(&default_resource_pointer(), resource, __ATOMIC_ACQ_REL);
+}
+
+// Arena: blocks are carved one after another from a buffer, deallocate()
+// does nothing, and all the memory is released at once by release() or by
+// the destructor. When the buffer is exhausted a chunk is allocated from the
+// upstream resource, each one twice as large as the previous. Suited to the
+// data of a single request, which is thrown away together. Not thread safe.
+class MonotonicBufferResource : public MemoryResource
+{
+    struct Chunk
+    {
+        Chunk* next;
+        unsigned long bytes;
+    };
+
+    static constexpr unsigned long default_chunk_size = 4096;
+
+    MemoryResource* _upstream;
+    Chunk* _chunks = nullptr;
+
+    char* _initial_buffer = nullptr;
+    unsigned long _initial_size = 0;
+
+    char* _current = nullptr; // Free space of the current buffer
+    unsigned long _left = 0;
+    unsigned long _next_size;
+
+    bool add_chunk(unsigned long bytes, size_t align)
+    {
+        unsigned long size = _next_size;
+        while (size < sizeof(Chunk) + bytes + align)
+            size *= 2;
+
+        Chunk* chunk = static_cast<Chunk*>(_upstream->allocate(size, alignof(Chunk)));
+        if (!chunk)
+            return false;
+        chunk->next = _chunks;
+        chunk->bytes = size;
+        _chunks = chunk;
+
+        _current = reinterpret_cast<char*>(chunk + 1);
+        _left = size - sizeof(Chunk);
+        _next_size = size * 2;
+        return true;
+    }
+
+public:
+    explicit MonotonicBufferResource(MemoryResource* upstream = get_default_resource())
+        : _upstream(upstream), _next_size(default_chunk_size)
+    {
+    }
+
+    // The first chunk allocated from upstream has initial_size bytes
+    explicit MonotonicBufferResource(unsigned long initial_size,
+                                     MemoryResource* upstream = get_default_resource())
+        : _upstream(upstream), _next_size(initial_size > sizeof(Chunk) ? initial_size : default_chunk_size)
+    {
+    }
+
+    // Blocks are carved from buffer, e.g. an array on the stack, before any
+    // chunk is allocated from upstream
+    MonotonicBufferResource(void* buffer, unsigned long size,
+                            MemoryResource* upstream = get_default_resource())
+        : _upstream(upstream), _initial_buffer(static_cast<char*>(buffer)), _initial_size(size),
+          _current(static_cast<char*>(buffer)), _left(size),
+          _next_size(size > default_chunk_size ? size : default_chunk_size)
+    {
+    }
+
+    MonotonicBufferResource(const MonotonicBufferResource& other) = delete;
+    MonotonicBufferResource& operator=(const MonotonicBufferResource& other) = delete;
+
+    ~MonotonicBufferResource() { release(); }
+
+    // Return the chunks to upstream and start over from the initial buffer.
+    // The blocks allocated so far become invalid.
+    void release()
+    {
+        while (_chunks)
+        {
+            Chunk* next = _chunks->next;
+            _upstream->deallocate(_chunks, _chunks->bytes, alignof(Chunk));
+            _chunks = next;
+        }
+        _current = _initial_buffer;
+        _left = _initial_size;
+    }
+
+    MemoryResource* upstream_resource() const { return _upstream; }
+
+protected:
+    void* do_allocate(unsigned long bytes, size_t align) override
+    {
+        unsigned long pad = -reinterpret_cast<unsigned long>(_current) & (align - 1);
+        if (!_current || pad + bytes > _left)
+        {
+            if (!add_chunk(bytes, align))
+                return nullptr;
+            pad = -reinterpret_cast<unsigned long>(_current) & (align - 1);
+        }
+
+        char* p = _current + pad;
+        _current = p + bytes;
+        _left -= pad + bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, unsigned long, size_t) override {}
+};
+
+// Pools of fixed size blocks, one per power of two from 8 bytes up to
+// largest_block. A block is taken from the free list of its pool and put
+// back on it when deallocated, without touching upstream; an empty pool
+// allocates a chunk of blocks from upstream, twice as many as its previous
+// one up to max_blocks_per_chunk. Larger blocks are allocated from upstream
+// directly. Suited to node containers whose nodes come and go. The chunks
+// are returned to upstream by release() or by the destructor. Not thread
+// safe.
+class PoolResource : public MemoryResource
+{
+    struct Chunk
+    {
+        Chunk* next;
+        unsigned long bytes;
+    };
+
+    struct Pool
+    {
+        void* free = nullptr; // Each free block points to the next one
+        Chunk* chunks = nullptr;
+        unsigned long blocks_per_chunk = 16;
+    };
+
+    static constexpr size_t smallest_block = 8;
+    static constexpr unsigned max_pools = 32;
+
+    MemoryResource* _upstream;
+    size_t _largest_block;
+    unsigned long _max_blocks_per_chunk;
+    unsigned _pools_count;
+    Pool _pools[max_pools];
+
+    static unsigned pool_index(unsigned long bytes)
+    {
+        if (bytes <= smallest_block)
+            return 0;
+        return 64 - __builtin_clzl(bytes - 1) - 3;
+    }
+
+    static unsigned long block_size(unsigned index) { return (unsigned long) smallest_block << index; }
+
+    // The blocks of a chunk follow its header, each aligned to the block size
+    bool refill(unsigned index)
+    {
+        Pool& pool = _pools[index];
+        unsigned long size = block_size(index);
+        unsigned long header = (sizeof(Chunk) + size - 1) / size * size;
+        unsigned long bytes = header + pool.blocks_per_chunk * size;
+
+        char* p = static_cast<char*>(_upstream->allocate(bytes, size < cache_line_size ? size : cache_line_size));
+        if (!p)
+            return false;
+
+        Chunk* chunk = reinterpret_cast<Chunk*>(p);
+        chunk->next = pool.chunks;
+        chunk->bytes = bytes;
+        pool.chunks = chunk;
+
+        for (unsigned long i = pool.blocks_per_chunk; i-- > 0;)
+        {
+            void** block = reinterpret_cast<void**>(p + header + i * size);
+            *block = pool.free;
+            pool.free = block;
+        }
+
+        if (pool.blocks_per_chunk * 2 <= _max_blocks_per_chunk)
+            pool.blocks_per_chunk *= 2;
+        return true;
+    }
+
+public:
+    explicit PoolResource(MemoryResource* upstream = get_default_resource(), size_t largest_block = 4096,
+                          unsigned long max_blocks_per_chunk = 1024)
+        : _upstream(upstream), _max_blocks_per_chunk(max_blocks_per_chunk)
+    {
+        if (largest_block < smallest_block)
+            largest_block = smallest_block;
+        _pools_count = pool_index(largest_block) + 1;
+        if (_pools_count > max_pools)
+            _pools_count = max_pools;
+        _largest_block = block_size(_pools_count - 1);
+    }
+
+    PoolResource(const PoolResource& other) = delete;
+    PoolResource& operator=(const PoolResource& other) = delete;
+
+    ~PoolResource() { release(); }
+
+    // Return the chunks of the pools to upstream. The pooled blocks
+    // allocated so far become invalid, the larger ones are not affected.
+    void release()
+    {
+        for (unsigned i = 0; i < _pools_count; i++)
+        {
+            Pool& pool = _pools[i];
+            unsigned long size = block_size(i);
+            while (pool.chunks)
+            {
+                Chunk* next = pool.chunks->next;
+                _upstream->deallocate(pool.chunks, pool.chunks->bytes,
+                                      size < cache_line_size ? size : cache_line_size);
+                pool.chunks = next;
+            }
+            pool = Pool();
+        }
+    }
+
+    // Largest block served from the pools
+    size_t largest_block() const { return _largest_block; }
+
+    MemoryResource* upstream_resource() const { return _upstream; }
+
+protected:
+    void* do_allocate(unsigned long bytes, size_t align) override
+    {
+        // A block is aligned to its size, up to a cache line
+        if (bytes < align)
+            bytes = align;
+        if (bytes > _largest_block || align > cache_line_size)
+            return _upstream->allocate(bytes, align);
+
+        unsigned index = pool_index(bytes);
+        Pool& pool = _pools[index];
+        if (!pool.free && !refill(index))
+            return nullptr;
+
+        void** block = static_cast<void**>(pool.free);
+        pool.free = *block;
+        return block;
+    }
+
+    void do_deallocate(void* p, unsigned long bytes, size_t align) override
+    {
+        if (bytes < align)
+            bytes = align;
+        if (bytes > _largest_block || align > cache_line_size)
+        {
+            _upstream->deallocate(p, bytes, align);
+            return;
+        }
+
+        Pool& pool = _pools[pool_index(bytes)];
+        void** block = static_cast<void**>(p);
+        *block = pool.free;
+        pool.free = block;
+    }
+};
+
+// Allocator on a MemoryResource, after std::pmr::polymorphic_allocator.
+// Containers of the same type may use different resources:
+//
+//   stlite::MonotonicBufferResource arena;
+//   stlite::Vector<int, stlite::PolymorphicAllocator<int>> vec(&arena);
+//
+// Like the std one it never propagates on assignment or swap, and a copy of
+// a container uses the default resource, so the memory of a container
+// never outlives its resource by accident. The allocator of a container
+// must not be destroyed before the container.
+template <class T>
+class PolymorphicAllocator
+{
+    MemoryResource* _resource;
+
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef PolymorphicAllocator<U> other;
+    };
+
+    PolymorphicAllocator() : _resource(get_default_resource()) {}
+
+    PolymorphicAllocator(MemoryResource* resource) : _resource(resource) {}
+
+    // Converting constructor, for the allocator of the elements of a node
+    // container
+    template <class U>
+    PolymorphicAllocator(const PolymorphicAllocator<U>& other) : _resource(other.resource())
+    {
+    }
+
+    MemoryResource* resource() const { return _resource; }
+
+    // Allocate block of storage, nullptr if the resource is exhausted
+    T* allocate(size_t n)
+    {
+        T* p = static_cast<T*>(_resource->allocate((unsigned long) n * sizeof(T), alignof(T)));
+        if (p)
+            for (size_t i = 0; i < n; i++)
+                new (&p[i]) T;
+        return p;
+    }
+
+    // Release block of storage
+    void deallocate(T* p, size_t n)
+    {
+        if (!p)
+            return;
+        for (size_t i = 0; i < n; i++)
+            p[i].~T();
+        _resource->deallocate(p, (unsigned long) n * sizeof(T), alignof(T));
+    }
+
+    // Allocate and construct a single object
+    template <class... Args>
+    T* construct(Args&&... args)
+    {
+        T* p = static_cast<T*>(_resource->allocate(sizeof(T), alignof(T)));
+        if (p)
+            new (p) T(static_cast<Args&&>(args)...);
+        return p;
+    }
+
+    // Destroy and release an object created with construct()
+    void destroy(T* p)
+    {
+        if (!p)
+            return;
+        p->~T();
+        _resource->deallocate(p, sizeof(T), alignof(T));
+    }
+
+    PolymorphicAllocator select_on_copy_construction() const { return PolymorphicAllocator(); }
+
+    bool operator==(const PolymorphicAllocator& other) const { return _resource->is_equal(*other._resource); }
+    bool operator!=(const PolymorphicAllocator& other) const { return !(*this == other); }
+};
+
+} // namespace stlite
+
+#endif
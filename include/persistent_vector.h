@@ -0,0 +1,568 @@
+// The MIT License (MIT)
+//
+// STLite persistent vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PERSISTENT_VECTOR_H
+#define PERSISTENT_VECTOR_H
+
+#include "allocator.h"
+
+#include <assert.h>
+
+#ifdef USE_STL
+#include <initializer_list>
+#endif
+
+namespace stlite
+{
+
+template <class T, class Alloc>
+class TransientVector;
+
+// Immutable vector with structural sharing.
+//
+// Elements are stored in a 32-way trie of fixed-size leaves. The last, not yet
+// full leaf (the tail) is kept outside of the trie so that push_back() touches
+// the trie only once every 32 elements:
+//
+//                   _root (branch)
+//              +----------+----------+
+//              |          |          |
+//            leaf 0    leaf 1 ... leaf k         _tail
+//           [0..31]   [32..63]                [k*32+32 ..]
+//
+// Nodes are reference counted. Modifying operations return a new vector which
+// copies only the nodes on the path to the modified element and shares the
+// rest with the original, so they cost O(log32 n). Copying a vector (taking a
+// snapshot) is O(1). Reference counts are updated atomically, therefore
+// versions sharing nodes can be used from different threads.
+//
+// A node whose reference count is 1 is owned by a single vector and can be
+// modified in place. TransientVector uses this to build a vector with batched
+// updates without copying nodes over and over again.
+//
+// The nodes are allocated through Alloc rebound to their type. The versions
+// sharing nodes must release them with the same allocator, so a copy or an
+// assignment takes the allocator along with the nodes.
+template <class T, class Alloc = Allocator<T>>
+class PersistentVector
+{
+    static constexpr unsigned bits = 5;
+    static constexpr unsigned width = 1 << bits;
+    static constexpr unsigned mask = width - 1;
+
+    struct Node
+    {
+        unsigned refs = 1;
+    };
+
+    struct Branch : Node
+    {
+        Node* children[width] = {};
+    };
+
+    struct Leaf : Node
+    {
+        T values[width];
+    };
+
+    Branch* _root = nullptr;
+    Leaf* _tail = nullptr;
+    size_t _size = 0;
+    unsigned _shift = bits; // Level of the root, leaves are on level 0
+    Alloc _alloc;
+
+    friend class TransientVector<T, Alloc>;
+
+    template <class N>
+    N* create()
+    {
+        typename Alloc::template rebind<N>::other alloc(_alloc);
+        return alloc.construct();
+    }
+
+    template <class N>
+    void destroy(N* n)
+    {
+        typename Alloc::template rebind<N>::other alloc(_alloc);
+        alloc.destroy(n);
+    }
+
+    static void retain(Node* n)
+    {
+        if (n)
+            __atomic_add_fetch(&n->refs, 1, __ATOMIC_RELAXED);
+    }
+
+    void release(Node* n, unsigned level)
+    {
+        if (!n || __atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) != 0)
+            return;
+
+        if (level == 0)
+        {
+            destroy(static_cast<Leaf*>(n));
+        }
+        else
+        {
+            Branch* b = static_cast<Branch*>(n);
+            for (unsigned i = 0; i < width; i++)
+                release(b->children[i], level - bits);
+            destroy(b);
+        }
+    }
+
+    static bool is_unique(Node* n)
+    {
+        return __atomic_load_n(&n->refs, __ATOMIC_ACQUIRE) == 1;
+    }
+
+    // Make sure we are the only owner of the leaf, copy it otherwise
+    Leaf* unique_leaf(Leaf* leaf)
+    {
+        if (is_unique(leaf))
+            return leaf;
+
+        Leaf* copy = create<Leaf>();
+        for (unsigned i = 0; i < width; i++)
+            copy->values[i] = leaf->values[i];
+        release(leaf, 0);
+        return copy;
+    }
+
+    Branch* unique_branch(Branch* branch, unsigned level)
+    {
+        if (is_unique(branch))
+            return branch;
+
+        Branch* copy = create<Branch>();
+        for (unsigned i = 0; i < width; i++)
+        {
+            copy->children[i] = branch->children[i];
+            retain(copy->children[i]);
+        }
+        release(branch, level);
+        return copy;
+    }
+
+    size_t tail_offset() const
+    {
+        return _size < width ? 0 : ((_size - 1) >> bits) << bits;
+    }
+
+    const Leaf* leaf_for(size_t i) const
+    {
+        if (i >= tail_offset())
+            return _tail;
+
+        const Node* n = _root;
+        for (unsigned level = _shift; level > 0; level -= bits)
+            n = static_cast<const Branch*>(n)->children[(i >> level) & mask];
+
+        return static_cast<const Leaf*>(n);
+    }
+
+    // Chain of branches from the given level down to the leaf
+    Node* new_path(unsigned level, Node* leaf)
+    {
+        if (level == 0)
+            return leaf;
+
+        Branch* b = create<Branch>();
+        b->children[0] = new_path(level - bits, leaf);
+        return b;
+    }
+
+    // Insert full tail as the last leaf of the subtree rooted in the unique
+    // branch on the given level
+    void push_tail(unsigned level, Branch* parent, Leaf* tail)
+    {
+        unsigned subidx = ((_size - 1) >> level) & mask;
+
+        if (level == bits)
+        {
+            parent->children[subidx] = tail;
+            return;
+        }
+
+        Node*& child = parent->children[subidx];
+        if (child)
+        {
+            child = unique_branch(static_cast<Branch*>(child), level - bits);
+            push_tail(level - bits, static_cast<Branch*>(child), tail);
+        }
+        else
+        {
+            child = new_path(level - bits, tail);
+        }
+    }
+
+    // Remove the last leaf from the subtree rooted in the unique branch on the
+    // given level. Return nullptr if the branch became empty, it is released
+    // in that case.
+    Branch* pop_tail(unsigned level, Branch* node)
+    {
+        unsigned subidx = ((_size - 2) >> level) & mask;
+
+        if (level > bits)
+        {
+            Branch* child = unique_branch(static_cast<Branch*>(node->children[subidx]),
+                                          level - bits);
+            node->children[subidx] = pop_tail(level - bits, child);
+        }
+        else
+        {
+            release(node->children[subidx], 0);
+            node->children[subidx] = nullptr;
+        }
+
+        if (subidx == 0 && !node->children[0])
+        {
+            release(node, level);
+            return nullptr;
+        }
+
+        return node;
+    }
+
+    // In place modifiers, they copy only the nodes which are shared with
+    // other vectors
+
+    void push_back_mut(const T& value)
+    {
+        size_t tail_count = _size - tail_offset();
+
+        if (_tail && tail_count < width)
+        {
+            _tail = unique_leaf(_tail);
+            _tail->values[tail_count] = value;
+            _size++;
+            return;
+        }
+
+        if (_tail)
+        {
+            // Tail is full, move it into the trie
+            if (!_root)
+            {
+                _root = create<Branch>();
+                _root->children[0] = _tail;
+            }
+            else if ((_size >> bits) > (1u << _shift))
+            {
+                // Root is full, add a new level
+                Branch* root = create<Branch>();
+                root->children[0] = _root;
+                root->children[1] = new_path(_shift, _tail);
+                _root = root;
+                _shift += bits;
+            }
+            else
+            {
+                _root = unique_branch(_root, _shift);
+                push_tail(_shift, _root, _tail);
+            }
+        }
+
+        _tail = create<Leaf>();
+        _tail->values[0] = value;
+        _size++;
+    }
+
+    void set_mut(size_t i, const T& value)
+    {
+        if (i >= tail_offset())
+        {
+            _tail = unique_leaf(_tail);
+            _tail->values[i & mask] = value;
+            return;
+        }
+
+        _root = unique_branch(_root, _shift);
+        Branch* b = _root;
+
+        for (unsigned level = _shift; level > bits; level -= bits)
+        {
+            Node*& child = b->children[(i >> level) & mask];
+            child = unique_branch(static_cast<Branch*>(child), level - bits);
+            b = static_cast<Branch*>(child);
+        }
+
+        Node*& leaf = b->children[(i >> bits) & mask];
+        leaf = unique_leaf(static_cast<Leaf*>(leaf));
+        static_cast<Leaf*>(leaf)->values[i & mask] = value;
+    }
+
+    void pop_back_mut()
+    {
+        if (_size == 0)
+            return;
+
+        if (_size == 1)
+        {
+            release(_tail, 0);
+            _tail = nullptr;
+            _size = 0;
+            return;
+        }
+
+        if (_size - tail_offset() > 1)
+        {
+            _size--;
+            return;
+        }
+
+        // The tail becomes empty, the last leaf of the trie is the new tail
+        Leaf* leaf = const_cast<Leaf*>(leaf_for(_size - 2));
+        retain(leaf);
+        release(_tail, 0);
+        _tail = leaf;
+
+        _root = unique_branch(_root, _shift);
+        _root = pop_tail(_shift, _root);
+
+        if (_root && _shift > bits && !_root->children[1])
+        {
+            // Only one child left, remove a level
+            Branch* root = static_cast<Branch*>(_root->children[0]);
+            retain(root);
+            release(_root, _shift);
+            _root = root;
+            _shift -= bits;
+        }
+
+        _size--;
+    }
+
+public:
+    PersistentVector() {}
+
+    explicit PersistentVector(const Alloc& alloc) : _alloc(alloc) {}
+
+    // This constructor creates vector from the given array
+    PersistentVector(const T* arr, size_t len, const Alloc& alloc = Alloc()) : _alloc(alloc)
+    {
+        for (size_t i = 0; i < len; i++)
+            push_back_mut(arr[i]);
+    }
+
+#ifdef USE_STL
+    PersistentVector(std::initializer_list<T> initlst, const Alloc& alloc = Alloc()) : _alloc(alloc)
+    {
+        for (auto x : initlst)
+            push_back_mut(x);
+    }
+#endif
+
+    // Copy constructor, O(1) snapshot sharing all nodes
+    PersistentVector(const PersistentVector& other) : _alloc(other._alloc)
+    {
+        _root = other._root;
+        _tail = other._tail;
+        _size = other._size;
+        _shift = other._shift;
+
+        retain(_root);
+        retain(_tail);
+    }
+
+    // Move constructor
+    PersistentVector(PersistentVector&& other) : _alloc(other._alloc)
+    {
+        _root = other._root;
+        _tail = other._tail;
+        _size = other._size;
+        _shift = other._shift;
+
+        other._root = nullptr;
+        other._tail = nullptr;
+        other._size = 0;
+        other._shift = bits;
+    }
+
+    ~PersistentVector()
+    {
+        release(_root, _shift);
+        release(_tail, 0);
+    }
+
+    // Copy assignment operator
+    PersistentVector& operator=(const PersistentVector& other)
+    {
+        if (&other != this)
+        {
+            retain(other._root);
+            retain(other._tail);
+            release(_root, _shift);
+            release(_tail, 0);
+
+            _root = other._root;
+            _tail = other._tail;
+            _size = other._size;
+            _shift = other._shift;
+            _alloc = other._alloc;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    PersistentVector& operator=(PersistentVector&& other)
+    {
+        if (&other != this)
+        {
+            release(_root, _shift);
+            release(_tail, 0);
+
+            _root = other._root;
+            _tail = other._tail;
+            _size = other._size;
+            _shift = other._shift;
+            _alloc = other._alloc;
+
+            other._root = nullptr;
+            other._tail = nullptr;
+            other._size = 0;
+            other._shift = bits;
+        }
+        return *this;
+    }
+
+    // Iterators
+    class Iterator
+    {
+        const PersistentVector* _vec = nullptr;
+        const T* _leaf = nullptr;
+        size_t _current = 0;
+
+    public:
+        Iterator() {}
+        Iterator(const PersistentVector* vec, size_t n) : _vec(vec), _current(n)
+        {
+            if (_current < _vec->_size)
+                _leaf = _vec->leaf_for(_current)->values;
+        }
+
+        // Prefix increment operator
+        Iterator& operator++()
+        {
+            // Look up the next leaf only when we cross its boundary
+            if ((++_current & mask) == 0 && _current < _vec->_size)
+                _leaf = _vec->leaf_for(_current)->values;
+            return *this;
+        }
+
+        // Postfix increment operator
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        const T& operator*() const { return _leaf[_current & mask]; }
+
+        bool operator==(const Iterator& other) const { return other._current == _current; }
+        bool operator!=(const Iterator& other) const { return other._current != _current; }
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, _size); }
+
+    // Capacity
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // Allocator
+    Alloc get_allocator() const { return _alloc; }
+
+    // Element access, O(log32 n)
+    const T& operator[](size_t n) const { return leaf_for(n)->values[n & mask]; }
+
+    const T& at(size_t n) const
+    {
+        assert(n < _size);
+        return leaf_for(n)->values[n & mask];
+    }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return _tail->values[(_size - 1) & mask]; }
+
+    // Modifiers, they return a new version and leave this one unchanged
+
+    PersistentVector push_back(const T& value) const
+    {
+        PersistentVector v(*this);
+        v.push_back_mut(value);
+        return v;
+    }
+
+    PersistentVector set(size_t n, const T& value) const
+    {
+        PersistentVector v(*this);
+        v.set_mut(n, value);
+        return v;
+    }
+
+    PersistentVector pop_back() const
+    {
+        PersistentVector v(*this);
+        v.pop_back_mut();
+        return v;
+    }
+
+    // Return a mutable vector sharing nodes with this one
+    TransientVector<T, Alloc> transient() const { return TransientVector<T, Alloc>(*this); }
+};
+
+// Mutable builder for PersistentVector. Nodes it owns alone are modified in
+// place, nodes shared with other versions are copied the first time they are
+// touched, so a batch of k updates copies each node at most once.
+template <class T, class Alloc = Allocator<T>>
+class TransientVector
+{
+    PersistentVector<T, Alloc> _vec;
+
+public:
+    TransientVector() {}
+    explicit TransientVector(const Alloc& alloc) : _vec(alloc) {}
+    explicit TransientVector(const PersistentVector<T, Alloc>& vec) : _vec(vec) {}
+
+    // Capacity
+    size_t size() const { return _vec.size(); }
+    bool empty() const { return _vec.empty(); }
+
+    // Element access
+    const T& operator[](size_t n) const { return _vec[n]; }
+
+    // Modifiers
+    void push_back(const T& value) { _vec.push_back_mut(value); }
+    void set(size_t n, const T& value) { _vec.set_mut(n, value); }
+    void pop_back() { _vec.pop_back_mut(); }
+
+    // Return the built vector, it shares nodes with this transient and further
+    // modifications of the transient copy them again.
+    PersistentVector<T, Alloc> persistent() const { return _vec; }
+};
+
+} // namespace stlite
+
+#endif
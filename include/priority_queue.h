@@ -0,0 +1,340 @@
+// The MIT License (MIT)
+//
+// STLite priority queue
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include "algorithms.h"
+#include "allocator.h"
+#include "vector.h"
+
+namespace stlite
+{
+
+// Operations of a d-ary heap stored in an array. The element at the root is
+// the largest one according to comp. moved(element, i) is called whenever an
+// element is stored at the index i, which lets the indexed queue track the
+// positions of its keys.
+template <unsigned D>
+struct DaryHeap
+{
+    static_assert(D >= 2, "The heap arity must be at least 2");
+
+    static size_t parent(size_t i) { return (i - 1) / D; }
+    static size_t first_child(size_t i) { return D * i + 1; }
+
+    // Move the element at i towards the root until its parent is not smaller
+    template <class T, class Compare, class Moved>
+    static void sift_up(T* data, size_t i, Compare& comp, Moved& moved)
+    {
+        T value = static_cast<T&&>(data[i]);
+
+        while (i > 0)
+        {
+            size_t p = parent(i);
+            if (!comp(data[p], value))
+                break;
+
+            data[i] = static_cast<T&&>(data[p]);
+            moved(data[i], i);
+            i = p;
+        }
+
+        data[i] = static_cast<T&&>(value);
+        moved(data[i], i);
+    }
+
+    // Move the element at i towards the leaves until no child is larger
+    template <class T, class Compare, class Moved>
+    static void sift_down(T* data, size_t n, size_t i, Compare& comp, Moved& moved)
+    {
+        T value = static_cast<T&&>(data[i]);
+
+        while (true)
+        {
+            size_t c = first_child(i);
+            if (c >= n)
+                break;
+
+            // Largest child
+            size_t last = c + D < n ? c + D : n;
+            size_t best = c;
+            for (size_t j = c + 1; j < last; j++)
+                if (comp(data[best], data[j]))
+                    best = j;
+
+            if (!comp(value, data[best]))
+                break;
+
+            data[i] = static_cast<T&&>(data[best]);
+            moved(data[i], i);
+            i = best;
+        }
+
+        data[i] = static_cast<T&&>(value);
+        moved(data[i], i);
+    }
+
+    // Build the heap bottom-up in O(n)
+    template <class T, class Compare, class Moved>
+    static void make(T* data, size_t n, Compare& comp, Moved& moved)
+    {
+        for (size_t i = 0; i < n; i++)
+            moved(data[i], i);
+
+        if (n < 2)
+            return;
+
+        for (size_t i = parent(n - 1) + 1; i-- > 0;)
+            sift_down(data, n, i, comp, moved);
+    }
+};
+
+struct HeapNotMoved
+{
+    template <class T>
+    void operator()(const T&, size_t) const
+    {
+    }
+};
+
+// Priority queue on a d-ary heap in a Vector. top() is the largest element
+// according to Compare, use Greater<T> for a min-queue. A wider heap is
+// shallower, so pop() touches fewer cache lines; 4 is a good default.
+template <class T, class Compare = Less<T>, unsigned Arity = 4>
+class PriorityQueue
+{
+    typedef DaryHeap<Arity> Heap;
+
+    Vector<T> _data;
+    Compare _comp;
+    HeapNotMoved _moved;
+
+    // Vector grows by a fixed number of elements, the queue doubles it so
+    // that pushes take amortized constant time
+    void grow()
+    {
+        if (_data.size() == _data.capacity() && _data.capacity() > 0)
+            _data.reserve(2 * _data.capacity());
+    }
+
+public:
+    PriorityQueue() {}
+
+    explicit PriorityQueue(const Compare& comp) : _comp(comp) {}
+
+    // Build the queue from a range in linear time
+    template <class InputIt>
+    PriorityQueue(InputIt first, InputIt last, const Compare& comp = Compare()) : _comp(comp)
+    {
+        for (; first != last; ++first)
+        {
+            grow();
+            _data.push_back(*first);
+        }
+        Heap::make(_data.data(), _data.size(), _comp, _moved);
+    }
+
+    // Capacity
+    bool empty() const { return _data.empty(); }
+    size_t size() const { return _data.size(); }
+
+    void reserve(size_t n) { _data.reserve(n); }
+
+    // Element access
+    const T& top() const { return _data.front(); }
+
+    // Modifiers
+    void push(const T& value)
+    {
+        grow();
+        _data.push_back(value);
+        Heap::sift_up(_data.data(), _data.size() - 1, _comp, _moved);
+    }
+
+    void push(T&& value)
+    {
+        grow();
+        _data.push_back(static_cast<T&&>(value));
+        Heap::sift_up(_data.data(), _data.size() - 1, _comp, _moved);
+    }
+
+    // Remove the top element
+    bool pop()
+    {
+        if (_data.empty())
+            return false;
+
+        T* data = _data.data();
+        size_t n = _data.size() - 1;
+        if (n > 0)
+        {
+            data[0] = static_cast<T&&>(data[n]);
+            Heap::sift_down(data, n, 0, _comp, _moved);
+        }
+        _data.pop_back();
+        return true;
+    }
+
+    void clear() { _data.clear(); }
+};
+
+// Priority queue of keys 0 ... max_keys - 1, each with a priority which can be
+// changed while the key is queued (decrease-key). A position table maps the
+// keys to their heap entries, so update() and erase() take O(log n).
+//
+//   IndexedPriorityQueue<int, Greater<int>> queue(nodes); // Smallest on top
+//   queue.push(node, distance);
+//   queue.update(node, shorter_distance);
+template <class T, class Compare = Less<T>, unsigned Arity = 4>
+class IndexedPriorityQueue
+{
+    typedef DaryHeap<Arity> Heap;
+
+    static constexpr size_t npos = -1;
+
+    struct Entry
+    {
+        T priority;
+        size_t key;
+    };
+
+    struct EntryCompare
+    {
+        Compare comp;
+
+        bool operator()(const Entry& a, const Entry& b) { return comp(a.priority, b.priority); }
+    };
+
+    struct Moved
+    {
+        size_t* pos;
+
+        void operator()(const Entry& e, size_t i) { pos[e.key] = i; }
+    };
+
+    Vector<Entry> _heap;
+    Vector<size_t> _pos; // Heap index of every key, npos if not queued
+    EntryCompare _comp;
+
+    Moved moved() { return Moved{ _pos.data() }; }
+
+public:
+    explicit IndexedPriorityQueue(size_t max_keys, const Compare& comp = Compare())
+        : _pos(max_keys, size_t(npos))
+    {
+        _comp.comp = comp;
+        _heap.reserve(max_keys);
+    }
+
+    // Capacity
+    bool empty() const { return _heap.empty(); }
+    size_t size() const { return _heap.size(); }
+    size_t max_keys() const { return _pos.size(); }
+
+    bool contains(size_t key) const { return _pos[key] != npos; }
+
+    // Element access
+    size_t top_key() const { return _heap.front().key; }
+    const T& top_priority() const { return _heap.front().priority; }
+
+    // Priority of a queued key
+    const T& priority(size_t key) const { return _heap.data()[_pos[key]].priority; }
+
+    // Modifiers
+
+    // Add a key which is not queued. Return false if it is queued already.
+    bool push(size_t key, const T& priority)
+    {
+        if (contains(key))
+            return false;
+
+        _heap.push_back(Entry{ priority, key });
+        Moved m = moved();
+        Heap::sift_up(_heap.data(), _heap.size() - 1, _comp, m);
+        return true;
+    }
+
+    // Change the priority of a queued key, in either direction
+    void update(size_t key, const T& priority)
+    {
+        Entry* data = _heap.data();
+        size_t i = _pos[key];
+        bool up = _comp.comp(data[i].priority, priority);
+        Moved m = moved();
+
+        data[i].priority = priority;
+        if (up)
+            Heap::sift_up(data, i, _comp, m);
+        else
+            Heap::sift_down(data, _heap.size(), i, _comp, m);
+    }
+
+    // Push the key or change its priority if it is queued already
+    void push_or_update(size_t key, const T& priority)
+    {
+        if (contains(key))
+            update(key, priority);
+        else
+            push(key, priority);
+    }
+
+    // Remove the top key
+    bool pop() { return !empty() && erase(top_key()); }
+
+    // Remove a key, return false if it is not queued
+    bool erase(size_t key)
+    {
+        if (!contains(key))
+            return false;
+
+        Entry* data = _heap.data();
+        size_t i = _pos[key];
+        size_t n = _heap.size() - 1;
+        Moved m = moved();
+
+        _pos[key] = npos;
+        if (i != n)
+        {
+            bool up = _comp(data[i], data[n]);
+            data[i] = static_cast<Entry&&>(data[n]);
+            if (up)
+                Heap::sift_up(data, i, _comp, m);
+            else
+                Heap::sift_down(data, n, i, _comp, m);
+        }
+        _heap.pop_back();
+        return true;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < _heap.size(); i++)
+            _pos[_heap.data()[i].key] = npos;
+        _heap.clear();
+    }
+};
+
+} // namespace stlite
+
+#endif
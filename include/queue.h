@@ -29,14 +29,28 @@
 namespace stlite
 {
 
-template <class T>
+// FIFO adaptor over CircularList, which allocates its nodes with Alloc
+template <class T, class Alloc = Allocator<T>>
 class Queue
 {
-    CircularList<T> _data;
+    CircularList<T, Alloc> _data;
+
+#ifdef STLITE_TRACE
+    size_t _high_water = 0;
+#endif
 
 public:
     Queue() {}
 
+    explicit Queue(const Alloc& alloc) : _data(alloc) {}
+
+    Queue(const Queue& other, const Alloc& alloc) : _data(other._data, alloc) {}
+
+    Queue(Queue&& other, const Alloc& alloc)
+        : _data(static_cast<CircularList<T, Alloc>&&>(other._data), alloc)
+    {
+    }
+
     //Queue(const Queue<T> &other);               // Copy constructor
     //Queue(Queue<T> &&other);                    // Move constructor
 
@@ -49,6 +63,9 @@ public:
     bool empty() const { return _data.empty(); }
     size_t size() const { return _data.size(); }
 
+    // Allocator
+    Alloc get_allocator() const { return _data.get_allocator(); }
+
     // Element access
     T& front() { return _data.front(); }
     T& back() { return _data.back(); }
@@ -57,7 +74,21 @@ public:
     const T& back() const { return _data.back(); }
 
     // Modifiers
-    void push(T value) { _data.push_back(value); }
+    void push(T value)
+    {
+        _data.push_back(value);
+
+#ifdef STLITE_TRACE
+        // Only the powers of two are recorded, so that a growing queue
+        // doesn't flood the trace
+        if (_data.size() > _high_water)
+        {
+            _high_water = _data.size();
+            if ((_high_water & (_high_water - 1)) == 0)
+                STLITE_TRACE_COUNTER("Queue::high_water", "size", _high_water);
+        }
+#endif
+    }
     void pop() { _data.pop_front(); }
 };
 
@@ -0,0 +1,969 @@
+// The MIT License (MIT)
+//
+// STLite radix tree
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef RADIX_TREE_H
+#define RADIX_TREE_H
+
+#include "allocator.h"
+#include "simd_algorithms.h"
+
+#include <string.h>
+
+#ifdef USE_STL
+#include <string>
+#endif
+
+namespace stlite
+{
+
+// Adaptive radix tree (Leis et al., "The Adaptive Radix Tree: ARTful Indexing
+// for Main-Memory Databases") mapping byte strings to values:
+//
+//   RadixTree<int> routes;
+//   routes.insert("/api/", 1);
+//   routes.insert("/api/users/", 2);
+//   routes.longest_prefix("/api/users/42"); // Points to 2
+//
+// Each inner node branches on one byte of the key and comes in four sizes,
+// for up to 4, 16, 48 and 256 children, so sparse nodes stay small and dense
+// ones are a direct array lookup. A node16 is searched with one SSE2
+// comparison of all its keys. Chains of nodes with a single child are
+// collapsed into a prefix stored in the node (up to max_prefix bytes, longer
+// prefixes are compared against a key below the node). A key which ends at an
+// inner node, a prefix of other keys, is kept in the node itself. Lookups
+// take time proportional to the key length, independently of the number of
+// keys, and the keys are visited in lexicographic byte order.
+//
+// The nodes are allocated through Alloc rebound to each node type, and the
+// keys of the leaves as bytes.
+template <class V, class Alloc = Allocator<V>>
+class RadixTree
+{
+    static constexpr unsigned max_prefix = 10;
+
+    enum NodeType : unsigned char { leaf_node, node4, node16, node48, node256 };
+
+    struct Node
+    {
+        NodeType type;
+        explicit Node(NodeType t) : type(t) {}
+    };
+
+    struct Leaf : Node
+    {
+        V value;
+        unsigned char* key;
+        size_t len;
+
+        Leaf(unsigned char* k, size_t n, const V& v) : Node(leaf_node), value(v), key(k), len(n) {}
+
+        bool matches(const unsigned char* k, size_t n) const
+        {
+            return len == n && memcmp(key, k, n) == 0;
+        }
+    };
+
+    struct Inner : Node
+    {
+        unsigned short count = 0;
+        unsigned prefix_len = 0;
+        unsigned char prefix[max_prefix];
+        Leaf* leaf = nullptr; // Key ending at this node
+
+        explicit Inner(NodeType t) : Node(t) {}
+    };
+
+    struct Node4 : Inner
+    {
+        unsigned char keys[4];
+        Node* children[4];
+        Node4() : Inner(node4) {}
+    };
+
+    struct Node16 : Inner
+    {
+        unsigned char keys[16];
+        Node* children[16];
+        Node16() : Inner(node16) {}
+    };
+
+    struct Node48 : Inner
+    {
+        unsigned char index[256]; // Child slot + 1, 0 for no child
+        Node* children[48];
+        Node48() : Inner(node48) { memset(index, 0, sizeof(index)); }
+    };
+
+    struct Node256 : Inner
+    {
+        Node* children[256];
+        Node256() : Inner(node256)
+        {
+            for (unsigned i = 0; i < 256; i++)
+                children[i] = nullptr;
+        }
+    };
+
+    // The keys are counted under the name of the tree by the allocators
+    // which name their allocations
+    typedef typename ContainerAllocator<typename Alloc::template rebind<unsigned char>::other,
+                                        RadixTree>::type KeyAlloc;
+
+    Node* _root = nullptr;
+    size_t _size = 0;
+    KeyAlloc _alloc;
+
+    template <class N, class... Args>
+    N* create(Args&&... args)
+    {
+        typename Alloc::template rebind<N>::other alloc(_alloc);
+        return alloc.construct(static_cast<Args&&>(args)...);
+    }
+
+    template <class N>
+    void release(N* n)
+    {
+        typename Alloc::template rebind<N>::other alloc(_alloc);
+        alloc.destroy(n);
+    }
+
+    Leaf* create_leaf(const unsigned char* key, size_t len, const V& value)
+    {
+        unsigned char* k = _alloc.allocate(len ? len : 1);
+        memcpy(k, key, len);
+        return create<Leaf>(k, len, value);
+    }
+
+    void destroy_leaf(Leaf* l)
+    {
+        if (!l)
+            return;
+        _alloc.deallocate(l->key, l->len ? l->len : 1);
+        release(l);
+    }
+
+    void steal(RadixTree& other)
+    {
+        _root = other._root;
+        _size = other._size;
+        other._root = nullptr;
+        other._size = 0;
+    }
+
+    static const unsigned char* bytes(const char* key)
+    {
+        return reinterpret_cast<const unsigned char*>(key);
+    }
+
+    static void copy_header(Inner* to, const Inner* from)
+    {
+        to->count = from->count;
+        to->prefix_len = from->prefix_len;
+        memcpy(to->prefix, from->prefix, max_prefix);
+        to->leaf = from->leaf;
+    }
+
+    static void set_prefix(Inner* n, const unsigned char* p, size_t len)
+    {
+        n->prefix_len = len;
+        memcpy(n->prefix, p, len < max_prefix ? len : max_prefix);
+    }
+
+    void destroy_inner(Inner* n)
+    {
+        switch (n->type)
+        {
+        case node4: release(static_cast<Node4*>(n)); break;
+        case node16: release(static_cast<Node16*>(n)); break;
+        case node48: release(static_cast<Node48*>(n)); break;
+        default: release(static_cast<Node256*>(n)); break;
+        }
+    }
+
+    void destroy(Node* n)
+    {
+        if (!n)
+            return;
+
+        if (n->type == leaf_node)
+        {
+            destroy_leaf(static_cast<Leaf*>(n));
+            return;
+        }
+
+        Inner* in = static_cast<Inner*>(n);
+        destroy_leaf(in->leaf);
+        for_each_child(in, [this](unsigned char, Node* child) { destroy(child); });
+        destroy_inner(in);
+    }
+
+    // Call f(byte, child) for the children in the order of the bytes
+    template <class F>
+    static void for_each_child(const Inner* n, F f)
+    {
+        switch (n->type)
+        {
+        case node4:
+        {
+            const Node4* p = static_cast<const Node4*>(n);
+            for (unsigned i = 0; i < p->count; i++)
+                f(p->keys[i], p->children[i]);
+            break;
+        }
+        case node16:
+        {
+            const Node16* p = static_cast<const Node16*>(n);
+            for (unsigned i = 0; i < p->count; i++)
+                f(p->keys[i], p->children[i]);
+            break;
+        }
+        case node48:
+        {
+            const Node48* p = static_cast<const Node48*>(n);
+            for (unsigned b = 0; b < 256; b++)
+                if (p->index[b])
+                    f((unsigned char) b, p->children[p->index[b] - 1]);
+            break;
+        }
+        default:
+        {
+            const Node256* p = static_cast<const Node256*>(n);
+            for (unsigned b = 0; b < 256; b++)
+                if (p->children[b])
+                    f((unsigned char) b, p->children[b]);
+            break;
+        }
+        }
+    }
+
+    // Slot of the child for byte b, or null
+    static Node** find_child(Inner* n, unsigned char b)
+    {
+        switch (n->type)
+        {
+        case node4:
+        {
+            Node4* p = static_cast<Node4*>(n);
+            for (unsigned i = 0; i < p->count; i++)
+                if (p->keys[i] == b)
+                    return &p->children[i];
+            return nullptr;
+        }
+        case node16:
+        {
+            Node16* p = static_cast<Node16*>(n);
+#ifdef STLITE_SIMD_X86
+            __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p->keys));
+            __m128i eq = _mm_cmpeq_epi8(keys, _mm_set1_epi8((char) b));
+            unsigned mask = _mm_movemask_epi8(eq) & ((1u << p->count) - 1);
+            return mask ? &p->children[__builtin_ctz(mask)] : nullptr;
+#else
+            for (unsigned i = 0; i < p->count; i++)
+                if (p->keys[i] == b)
+                    return &p->children[i];
+            return nullptr;
+#endif
+        }
+        case node48:
+        {
+            Node48* p = static_cast<Node48*>(n);
+            return p->index[b] ? &p->children[p->index[b] - 1] : nullptr;
+        }
+        default:
+        {
+            Node256* p = static_cast<Node256*>(n);
+            return p->children[b] ? &p->children[b] : nullptr;
+        }
+        }
+    }
+
+    // Insert child at byte b into a node with sorted keys and a free slot
+    template <class N>
+    static void insert_sorted(N* p, unsigned char b, Node* child)
+    {
+        unsigned i = p->count;
+        while (i > 0 && p->keys[i - 1] > b)
+        {
+            p->keys[i] = p->keys[i - 1];
+            p->children[i] = p->children[i - 1];
+            i--;
+        }
+        p->keys[i] = b;
+        p->children[i] = child;
+        p->count++;
+    }
+
+    // Add the child at byte b to the node in ref, growing it when it is full
+    void add_child(Node*& ref, unsigned char b, Node* child)
+    {
+        Inner* n = static_cast<Inner*>(ref);
+        switch (n->type)
+        {
+        case node4:
+        {
+            Node4* p = static_cast<Node4*>(n);
+            if (p->count < 4)
+            {
+                insert_sorted(p, b, child);
+                return;
+            }
+            Node16* q = create<Node16>();
+            copy_header(q, p);
+            memcpy(q->keys, p->keys, 4);
+            memcpy(q->children, p->children, 4 * sizeof(Node*));
+            insert_sorted(q, b, child);
+            ref = q;
+            release(p);
+            return;
+        }
+        case node16:
+        {
+            Node16* p = static_cast<Node16*>(n);
+            if (p->count < 16)
+            {
+                insert_sorted(p, b, child);
+                return;
+            }
+            Node48* q = create<Node48>();
+            copy_header(q, p);
+            for (unsigned i = 0; i < 16; i++)
+            {
+                q->children[i] = p->children[i];
+                q->index[p->keys[i]] = i + 1;
+            }
+            q->children[16] = child;
+            q->index[b] = 17;
+            q->count++;
+            ref = q;
+            release(p);
+            return;
+        }
+        case node48:
+        {
+            Node48* p = static_cast<Node48*>(n);
+            if (p->count < 48)
+            {
+                // Slots are kept dense, the erase moves the last one down
+                p->children[p->count] = child;
+                p->index[b] = p->count + 1;
+                p->count++;
+                return;
+            }
+            Node256* q = create<Node256>();
+            copy_header(q, p);
+            for (unsigned i = 0; i < 256; i++)
+                if (p->index[i])
+                    q->children[i] = p->children[p->index[i] - 1];
+            q->children[b] = child;
+            q->count++;
+            ref = q;
+            release(p);
+            return;
+        }
+        default:
+        {
+            Node256* p = static_cast<Node256*>(n);
+            p->children[b] = child;
+            p->count++;
+            return;
+        }
+        }
+    }
+
+    // Remove the child at byte b, the node is shrunk by collapse()
+    static void remove_child(Inner* n, unsigned char b)
+    {
+        switch (n->type)
+        {
+        case node4:
+        case node16:
+        {
+            unsigned char* keys = n->type == node4 ? static_cast<Node4*>(n)->keys
+                                                   : static_cast<Node16*>(n)->keys;
+            Node** children = n->type == node4 ? static_cast<Node4*>(n)->children
+                                               : static_cast<Node16*>(n)->children;
+            unsigned i = 0;
+            while (keys[i] != b)
+                i++;
+            for (; i + 1 < n->count; i++)
+            {
+                keys[i] = keys[i + 1];
+                children[i] = children[i + 1];
+            }
+            n->count--;
+            return;
+        }
+        case node48:
+        {
+            Node48* p = static_cast<Node48*>(n);
+            unsigned slot = p->index[b] - 1;
+            unsigned last = p->count - 1;
+            p->index[b] = 0;
+            if (slot != last)
+            {
+                for (unsigned i = 0; i < 256; i++)
+                    if (p->index[i] == last + 1)
+                    {
+                        p->index[i] = slot + 1;
+                        break;
+                    }
+                p->children[slot] = p->children[last];
+            }
+            p->count--;
+            return;
+        }
+        default:
+            static_cast<Node256*>(n)->children[b] = nullptr;
+            n->count--;
+            return;
+        }
+    }
+
+    // Leaf with the smallest key below n, it has the whole prefix of n
+    static const Leaf* minimum(const Node* n)
+    {
+        while (n->type != leaf_node)
+        {
+            const Inner* in = static_cast<const Inner*>(n);
+            if (in->leaf)
+                return in->leaf;
+
+            switch (in->type)
+            {
+            case node4: n = static_cast<const Node4*>(in)->children[0]; break;
+            case node16: n = static_cast<const Node16*>(in)->children[0]; break;
+            case node48:
+            {
+                const Node48* p = static_cast<const Node48*>(in);
+                unsigned b = 0;
+                while (!p->index[b])
+                    b++;
+                n = p->children[p->index[b] - 1];
+                break;
+            }
+            default:
+            {
+                const Node256* p = static_cast<const Node256*>(in);
+                unsigned b = 0;
+                while (!p->children[b])
+                    b++;
+                n = p->children[b];
+                break;
+            }
+            }
+        }
+        return static_cast<const Leaf*>(n);
+    }
+
+    // Number of bytes of the prefix of n equal to the key at depth. Unlike
+    // the lookup, which checks the whole key at the leaf, this compares
+    // prefixes longer than max_prefix with the key of a leaf below n.
+    static size_t prefix_match(const Inner* n, const unsigned char* key, size_t len, size_t depth)
+    {
+        size_t stored = n->prefix_len < max_prefix ? n->prefix_len : max_prefix;
+        size_t i = 0;
+        for (; i < stored; i++)
+            if (depth + i >= len || n->prefix[i] != key[depth + i])
+                return i;
+
+        if (n->prefix_len > max_prefix)
+        {
+            const Leaf* l = minimum(n);
+            for (; i < n->prefix_len; i++)
+                if (depth + i >= len || l->key[depth + i] != key[depth + i])
+                    return i;
+        }
+        return i;
+    }
+
+    bool insert_at(Node*& ref, const unsigned char* key, size_t len, size_t depth, const V& value)
+    {
+        if (!ref)
+        {
+            ref = create_leaf(key, len, value);
+            _size++;
+            return true;
+        }
+
+        if (ref->type == leaf_node)
+        {
+            Leaf* l = static_cast<Leaf*>(ref);
+            if (l->matches(key, len))
+                return false;
+
+            // Replace the leaf by a node branching where the keys differ
+            size_t common = 0;
+            while (depth + common < len && depth + common < l->len &&
+                   key[depth + common] == l->key[depth + common])
+                common++;
+
+            Node4* n = create<Node4>();
+            set_prefix(n, key + depth, common);
+            depth += common;
+
+            Leaf* added = create_leaf(key, len, value);
+            _size++;
+
+            Node* tmp = n;
+            if (l->len == depth)
+                n->leaf = l;
+            else
+                add_child(tmp, l->key[depth], l);
+            if (len == depth)
+                n->leaf = added;
+            else
+                add_child(tmp, key[depth], added);
+
+            ref = n;
+            return true;
+        }
+
+        Inner* in = static_cast<Inner*>(ref);
+        if (in->prefix_len)
+        {
+            size_t m = prefix_match(in, key, len, depth);
+            if (m < in->prefix_len)
+            {
+                // Split the prefix, the new node takes its first m bytes
+                Node4* n = create<Node4>();
+                set_prefix(n, key + depth, m);
+
+                const unsigned char* full = in->prefix;
+                if (in->prefix_len > max_prefix)
+                    full = minimum(in)->key + depth;
+                unsigned char b = full[m];
+
+                size_t rest = in->prefix_len - m - 1;
+                memmove(in->prefix, full + m + 1, rest < max_prefix ? rest : max_prefix);
+                in->prefix_len = rest;
+
+                Node* tmp = n;
+                add_child(tmp, b, in);
+
+                Leaf* added = create_leaf(key, len, value);
+                _size++;
+                if (len == depth + m)
+                    n->leaf = added;
+                else
+                    add_child(tmp, key[depth + m], added);
+
+                ref = n;
+                return true;
+            }
+            depth += in->prefix_len;
+        }
+
+        if (depth == len)
+        {
+            if (in->leaf)
+                return false;
+            in->leaf = create_leaf(key, len, value);
+            _size++;
+            return true;
+        }
+
+        Node** child = find_child(in, key[depth]);
+        if (child)
+            return insert_at(*child, key, len, depth + 1, value);
+
+        add_child(ref, key[depth], create_leaf(key, len, value));
+        _size++;
+        return true;
+    }
+
+    // Shrink the node in ref after a removal: a node left with a single
+    // entry is replaced by it, others move to a smaller node type when they
+    // get well below its size
+    void collapse(Node*& ref)
+    {
+        Inner* n = static_cast<Inner*>(ref);
+
+        if (n->count == 0)
+        {
+            ref = n->leaf;
+            destroy_inner(n);
+            return;
+        }
+
+        if (n->count == 1 && !n->leaf)
+        {
+            unsigned char b = 0;
+            Node* child = nullptr;
+            for_each_child(n, [&](unsigned char k, Node* c) { b = k; child = c; });
+
+            if (child->type != leaf_node)
+            {
+                // Concatenate the prefixes, only the first max_prefix bytes
+                // are stored
+                Inner* c = static_cast<Inner*>(child);
+                unsigned char p[max_prefix];
+                size_t len = n->prefix_len < max_prefix ? n->prefix_len : max_prefix;
+                memcpy(p, n->prefix, len);
+                if (len < max_prefix)
+                    p[len++] = b;
+                for (size_t i = 0; len < max_prefix && i < c->prefix_len; i++)
+                    p[len++] = c->prefix[i];
+
+                c->prefix_len += n->prefix_len + 1;
+                memcpy(c->prefix, p, len);
+            }
+
+            ref = child;
+            destroy_inner(n);
+            return;
+        }
+
+        if (n->type == node16 && n->count <= 3)
+        {
+            Node16* p = static_cast<Node16*>(n);
+            Node4* q = create<Node4>();
+            copy_header(q, p);
+            memcpy(q->keys, p->keys, p->count);
+            memcpy(q->children, p->children, p->count * sizeof(Node*));
+            ref = q;
+            release(p);
+        }
+        else if (n->type == node48 && n->count <= 12)
+        {
+            Node48* p = static_cast<Node48*>(n);
+            Node16* q = create<Node16>();
+            copy_header(q, p);
+            unsigned j = 0;
+            for (unsigned b = 0; b < 256; b++)
+                if (p->index[b])
+                {
+                    q->keys[j] = b;
+                    q->children[j++] = p->children[p->index[b] - 1];
+                }
+            ref = q;
+            release(p);
+        }
+        else if (n->type == node256 && n->count <= 36)
+        {
+            Node256* p = static_cast<Node256*>(n);
+            Node48* q = create<Node48>();
+            copy_header(q, p);
+            unsigned j = 0;
+            for (unsigned b = 0; b < 256; b++)
+                if (p->children[b])
+                {
+                    q->children[j] = p->children[b];
+                    q->index[b] = ++j;
+                }
+            ref = q;
+            release(p);
+        }
+    }
+
+    bool erase_at(Node*& ref, const unsigned char* key, size_t len, size_t depth)
+    {
+        if (!ref)
+            return false;
+
+        if (ref->type == leaf_node)
+        {
+            Leaf* l = static_cast<Leaf*>(ref);
+            if (!l->matches(key, len))
+                return false;
+            destroy_leaf(l);
+            ref = nullptr;
+            _size--;
+            return true;
+        }
+
+        Inner* in = static_cast<Inner*>(ref);
+        if (prefix_match(in, key, len, depth) != in->prefix_len)
+            return false;
+        depth += in->prefix_len;
+
+        if (depth == len)
+        {
+            if (!in->leaf)
+                return false;
+            destroy_leaf(in->leaf);
+            in->leaf = nullptr;
+            _size--;
+            collapse(ref);
+            return true;
+        }
+
+        Node** child = find_child(in, key[depth]);
+        if (!child || !erase_at(*child, key, len, depth + 1))
+            return false;
+
+        if (!*child)
+        {
+            remove_child(in, key[depth]);
+            collapse(ref);
+        }
+        return true;
+    }
+
+    template <class F>
+    static void visit(const Node* n, F& f)
+    {
+        if (n->type == leaf_node)
+        {
+            const Leaf* l = static_cast<const Leaf*>(n);
+            f(reinterpret_cast<const char*>(l->key), l->len, l->value);
+            return;
+        }
+
+        const Inner* in = static_cast<const Inner*>(n);
+        if (in->leaf)
+            visit(in->leaf, f);
+        for_each_child(in, [&](unsigned char, const Node* child) { visit(child, f); });
+    }
+
+    const Leaf* find_leaf(const unsigned char* key, size_t len) const
+    {
+        const Node* n = _root;
+        size_t depth = 0;
+
+        while (n)
+        {
+            if (n->type == leaf_node)
+            {
+                const Leaf* l = static_cast<const Leaf*>(n);
+                return l->matches(key, len) ? l : nullptr;
+            }
+
+            // Only the stored bytes of the prefix are compared, the whole
+            // key is checked at the leaf
+            const Inner* in = static_cast<const Inner*>(n);
+            if (in->prefix_len)
+            {
+                size_t stored = in->prefix_len < max_prefix ? in->prefix_len : max_prefix;
+                if (depth + in->prefix_len > len)
+                    return nullptr;
+                for (size_t i = 0; i < stored; i++)
+                    if (in->prefix[i] != key[depth + i])
+                        return nullptr;
+                depth += in->prefix_len;
+            }
+
+            if (depth == len)
+                return in->leaf && in->leaf->matches(key, len) ? in->leaf : nullptr;
+
+            Node** child = find_child(const_cast<Inner*>(in), key[depth]);
+            n = child ? *child : nullptr;
+            depth++;
+        }
+        return nullptr;
+    }
+
+public:
+    RadixTree() {}
+
+    explicit RadixTree(const Alloc& alloc) : _alloc(alloc) {}
+
+    RadixTree(const RadixTree& other) = delete;
+    RadixTree& operator=(const RadixTree& other) = delete;
+
+    // Move constructor
+    RadixTree(RadixTree&& other) : _alloc(other._alloc) { steal(other); }
+
+    // Move assignment operator, the keys are inserted one by one when the
+    // allocators are not equal
+    RadixTree& operator=(RadixTree&& other)
+    {
+        if (&other != this)
+        {
+            clear();
+
+            if (AllocatorTraits<KeyAlloc>::propagate_on_move_assignment)
+            {
+                _alloc = other._alloc;
+                steal(other);
+            }
+            else if (AllocatorTraits<KeyAlloc>::equal(_alloc, other._alloc))
+                steal(other);
+            else
+            {
+                other.for_each([this](const char* key, size_t len, const V& value) {
+                    insert(key, len, value);
+                });
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    ~RadixTree() { clear(); }
+
+    // Capacity
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
+    // Modifiers
+
+    // Insert the key with the value, returns false (and keeps the old value)
+    // if the key is already present
+    bool insert(const char* key, size_t len, const V& value)
+    {
+        return insert_at(_root, bytes(key), len, 0, value);
+    }
+
+    bool erase(const char* key, size_t len) { return erase_at(_root, bytes(key), len, 0); }
+
+    void clear()
+    {
+        destroy(_root);
+        _root = nullptr;
+        _size = 0;
+    }
+
+    // Lookup
+
+    // Value of the key, or null if it is not present
+    V* find(const char* key, size_t len)
+    {
+        const Leaf* l = find_leaf(bytes(key), len);
+        return l ? const_cast<V*>(&l->value) : nullptr;
+    }
+
+    const V* find(const char* key, size_t len) const
+    {
+        const Leaf* l = find_leaf(bytes(key), len);
+        return l ? &l->value : nullptr;
+    }
+
+    bool contains(const char* key, size_t len) const { return find_leaf(bytes(key), len) != nullptr; }
+
+    // Value of the longest key which is a prefix of the given key, or null if
+    // there is none. The length of that key is stored in match_len.
+    const V* longest_prefix(const char* k, size_t len, size_t* match_len = nullptr) const
+    {
+        const unsigned char* key = bytes(k);
+        const Leaf* best = nullptr;
+        const Node* n = _root;
+        size_t depth = 0;
+
+        while (n)
+        {
+            if (n->type == leaf_node)
+            {
+                const Leaf* l = static_cast<const Leaf*>(n);
+                if (l->len <= len && memcmp(l->key, key, l->len) == 0)
+                    best = l;
+                break;
+            }
+
+            const Inner* in = static_cast<const Inner*>(n);
+            if (prefix_match(in, key, len, depth) != in->prefix_len)
+                break;
+            depth += in->prefix_len;
+
+            // All the bytes on the path have been compared
+            if (in->leaf)
+                best = in->leaf;
+            if (depth == len)
+                break;
+
+            Node** child = find_child(const_cast<Inner*>(in), key[depth]);
+            n = child ? *child : nullptr;
+            depth++;
+        }
+
+        if (best && match_len)
+            *match_len = best->len;
+        return best ? &best->value : nullptr;
+    }
+
+    // Call f(key, len, value) for all the keys in lexicographic order
+    template <class F>
+    void for_each(F f) const
+    {
+        if (_root)
+            visit(_root, f);
+    }
+
+    // Call f(key, len, value) for the keys starting with prefix, in
+    // lexicographic order
+    template <class F>
+    void for_each_prefix(const char* p, size_t len, F f) const
+    {
+        const unsigned char* prefix = bytes(p);
+        const Node* n = _root;
+        size_t depth = 0;
+
+        while (n)
+        {
+            if (n->type == leaf_node)
+            {
+                const Leaf* l = static_cast<const Leaf*>(n);
+                if (l->len >= len && memcmp(l->key, prefix, len) == 0)
+                    visit(l, f);
+                return;
+            }
+
+            // The whole subtree matches once the prefix runs out
+            const Inner* in = static_cast<const Inner*>(n);
+            size_t m = prefix_match(in, prefix, len, depth);
+            if (depth + m == len)
+            {
+                visit(in, f);
+                return;
+            }
+            if (m < in->prefix_len)
+                return;
+            depth += in->prefix_len;
+
+            Node** child = find_child(const_cast<Inner*>(in), prefix[depth]);
+            n = child ? *child : nullptr;
+            depth++;
+        }
+    }
+
+#ifdef USE_STL
+    bool insert(const std::string& key, const V& value)
+    {
+        return insert(key.data(), key.size(), value);
+    }
+
+    bool erase(const std::string& key) { return erase(key.data(), key.size()); }
+
+    V* find(const std::string& key) { return find(key.data(), key.size()); }
+    const V* find(const std::string& key) const { return find(key.data(), key.size()); }
+
+    bool contains(const std::string& key) const { return contains(key.data(), key.size()); }
+
+    const V* longest_prefix(const std::string& key, size_t* match_len = nullptr) const
+    {
+        return longest_prefix(key.data(), key.size(), match_len);
+    }
+
+    template <class F>
+    void for_each_prefix(const std::string& prefix, F f) const
+    {
+        for_each_prefix(prefix.data(), prefix.size(), f);
+    }
+#endif
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,560 @@
+// The MIT License (MIT)
+//
+// STLite binary serialization
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include "array.h"
+#include "circular_list.h"
+#include "forward_list.h"
+#include "set.h"
+#include "vector.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace stlite
+{
+
+// Binary format of the containers of trivially copyable elements. A 32-byte
+// header is followed by the elements as they are in memory:
+//
+//   magic         4 bytes   "STLS"
+//   version       2 bytes
+//   header_size   2 bytes   32
+//   byte_order    4 bytes   0x01020304 in the byte order of the writer
+//   element_size  4 bytes   sizeof(T)
+//   count         8 bytes   Number of elements
+//   checksum      8 bytes   SerialChecksum of the elements
+//
+// The elements aren't converted, so a file can only be read on a machine
+// with the same byte order and the same layout of T; the header makes the
+// reader fail on a mismatch instead of returning garbage. The elements of
+// the lists are stored from the front, those of a set in order.
+//
+// Vector and Array are written with a single writev() and read with a
+// single read() into the container; SerialView maps a file and uses the
+// elements in place. The lists and sets are streamed through a buffer.
+// All the functions return false on an I/O error or an invalid file and
+// leave the container as it was.
+
+constexpr unsigned serial_magic = 0x534c5453; // "STLS" in little endian
+constexpr unsigned short serial_version = 1;
+constexpr unsigned serial_byte_order = 0x01020304;
+
+// Size of the buffer of the streamed containers
+constexpr unsigned serial_buffer_size = 1 << 16;
+
+struct SerialHeader
+{
+    unsigned magic;
+    unsigned short version;
+    unsigned short header_size;
+    unsigned byte_order;
+    unsigned element_size;
+    unsigned long long count;
+    unsigned long long checksum;
+};
+
+static_assert(sizeof(SerialHeader) == 32, "The header must be 32 bytes");
+
+// 64-bit checksum of a byte stream, four independent multiply-rotate lanes
+// over 32-byte blocks (the round function of xxHash64), so it runs at
+// several GB/s. The stream may be passed in pieces of any size.
+class SerialChecksum
+{
+    static constexpr unsigned long long p1 = 0x9e3779b185ebca87ULL;
+    static constexpr unsigned long long p2 = 0xc2b2ae3d27d4eb4fULL;
+
+    unsigned long long _lanes[4] = { p1 + p2, p2, 0, 0 - p1 };
+    unsigned char _tail[32];
+    unsigned _tail_size = 0;
+    unsigned long long _length = 0;
+
+    static unsigned long long rotl(unsigned long long x, unsigned r) { return x << r | x >> (64 - r); }
+
+    void block(const unsigned char* p)
+    {
+        for (unsigned i = 0; i < 4; i++)
+        {
+            unsigned long long w;
+            memcpy(&w, p + i * 8, 8);
+            _lanes[i] = rotl(_lanes[i] + w * p2, 31) * p1;
+        }
+    }
+
+public:
+    void update(const void* data, unsigned long n)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        _length += n;
+        if (n == 0)
+            return;
+
+        if (_tail_size)
+        {
+            unsigned k = 32 - _tail_size < n ? 32 - _tail_size : n;
+            memcpy(_tail + _tail_size, p, k);
+            _tail_size += k;
+            p += k;
+            n -= k;
+            if (_tail_size < 32)
+                return;
+            block(_tail);
+            _tail_size = 0;
+        }
+
+        for (; n >= 32; p += 32, n -= 32)
+            block(p);
+
+        memcpy(_tail, p, n);
+        _tail_size = n;
+    }
+
+    unsigned long long value() const
+    {
+        unsigned long long h = rotl(_lanes[0], 1) + rotl(_lanes[1], 7) + rotl(_lanes[2], 12) +
+                               rotl(_lanes[3], 18) + _length;
+        for (unsigned i = 0; i < _tail_size; i++)
+            h = rotl(h ^ (_tail[i] * p1), 11) * p2;
+
+        h ^= h >> 33;
+        h *= p2;
+        h ^= h >> 29;
+        return h;
+    }
+};
+
+inline unsigned long long serial_checksum(const void* data, unsigned long n)
+{
+    SerialChecksum c;
+    c.update(data, n);
+    return c.value();
+}
+
+inline SerialHeader serial_header(unsigned element_size, unsigned long long count,
+                                  unsigned long long checksum)
+{
+    SerialHeader h = { serial_magic, serial_version, sizeof(SerialHeader), serial_byte_order,
+                       element_size, count, checksum };
+    return h;
+}
+
+inline bool serial_valid(const SerialHeader& h, unsigned element_size)
+{
+    return h.magic == serial_magic && h.version == serial_version &&
+           h.header_size == sizeof(SerialHeader) && h.byte_order == serial_byte_order &&
+           h.element_size == element_size;
+}
+
+// Write all the buffers, writev() may write only a part of them
+inline bool serial_write(int fd, iovec* iov, int n)
+{
+    while (n > 0)
+    {
+        ssize_t written = writev(fd, iov, n);
+        if (written < 0)
+            return false;
+
+        while (n > 0 && (size_t) written >= iov->iov_len)
+        {
+            written -= iov->iov_len;
+            iov++;
+            n--;
+        }
+        if (n > 0)
+        {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+inline bool serial_write(int fd, const void* data, unsigned long n)
+{
+    iovec iov = { const_cast<void*>(data), n };
+    return serial_write(fd, &iov, 1);
+}
+
+// Read exactly n bytes, fails at the end of the file
+inline bool serial_read(int fd, void* data, unsigned long n)
+{
+    char* p = static_cast<char*>(data);
+    while (n > 0)
+    {
+        ssize_t r = read(fd, p, n);
+        if (r <= 0)
+            return false;
+        p += r;
+        n -= r;
+    }
+    return true;
+}
+
+// Read and check the header of a file of elements of the given size
+inline bool serial_read_header(int fd, unsigned element_size, SerialHeader& h)
+{
+    return serial_read(fd, &h, sizeof(h)) && serial_valid(h, element_size);
+}
+
+// Whether count elements of the given size fit in the rest of the file, so
+// a corrupt count is rejected before allocating the elements. Pipes and
+// sockets have no size, they fail at their end in serial_read()
+inline bool serial_fits(int fd, unsigned element_size, unsigned long long count)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return false;
+    if (!S_ISREG(st.st_mode))
+        return true;
+
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0 || offset > st.st_size)
+        return false;
+    return count <= (unsigned long long) (st.st_size - offset) / element_size;
+}
+
+// Write count elements at data
+template <class T>
+bool serialize(int fd, const T* data, unsigned long count)
+{
+    static_assert(__is_trivially_copyable(T), "Only trivially copyable elements can be serialized");
+
+    unsigned long bytes = count * sizeof(T);
+    SerialHeader h = serial_header(sizeof(T), count, serial_checksum(data, bytes));
+    iovec iov[2] = { { &h, sizeof(h) }, { const_cast<T*>(data), bytes } };
+    return serial_write(fd, iov, 2);
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const Vector<T, Alloc>& vec)
+{
+    return serialize(fd, vec.data(), vec.size());
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const Array<T, Alloc>& arr)
+{
+    return serialize(fd, arr.data(), arr.size());
+}
+
+// Read the elements of a contiguous container C constructed with C(count)
+template <class T, class C>
+bool deserialize_contiguous(int fd, C& c)
+{
+    static_assert(__is_trivially_copyable(T), "Only trivially copyable elements can be serialized");
+
+    SerialHeader h;
+    if (!serial_read_header(fd, sizeof(T), h) || h.count > (size_t) -1 ||
+        !serial_fits(fd, sizeof(T), h.count))
+        return false;
+
+    C tmp(h.count, c.get_allocator());
+    unsigned long bytes = h.count * sizeof(T);
+    if (!serial_read(fd, tmp.data(), bytes) || serial_checksum(tmp.data(), bytes) != h.checksum)
+        return false;
+
+    c = static_cast<C&&>(tmp);
+    return true;
+}
+
+template <class T, class Alloc>
+bool deserialize(int fd, Vector<T, Alloc>& vec)
+{
+    return deserialize_contiguous<T>(fd, vec);
+}
+
+template <class T, class Alloc>
+bool deserialize(int fd, Array<T, Alloc>& arr)
+{
+    return deserialize_contiguous<T>(fd, arr);
+}
+
+// Buffered writer of the streamed containers, the elements are passed in
+// two rounds: first to count() for the header, then to write()
+template <class T>
+class SerialStreamWriter
+{
+    static_assert(__is_trivially_copyable(T), "Only trivially copyable elements can be serialized");
+
+    static constexpr unsigned capacity = serial_buffer_size / sizeof(T) ? serial_buffer_size / sizeof(T) : 1;
+
+    int _fd;
+    unsigned long long _count = 0;
+    SerialChecksum _checksum;
+    Array<T> _buffer;
+    unsigned _size = 0;
+    bool _ok = true;
+
+    void flush()
+    {
+        if (_ok && _size)
+            _ok = serial_write(_fd, _buffer.data(), (unsigned long) _size * sizeof(T));
+        _size = 0;
+    }
+
+public:
+    explicit SerialStreamWriter(int fd) : _fd(fd), _buffer(capacity) {}
+
+    void count(const T& value)
+    {
+        _checksum.update(&value, sizeof(T));
+        _count++;
+    }
+
+    bool write_header()
+    {
+        SerialHeader h = serial_header(sizeof(T), _count, _checksum.value());
+        return _ok = serial_write(_fd, &h, sizeof(h));
+    }
+
+    void write(const T& value)
+    {
+        _buffer[_size++] = value;
+        if (_size == capacity)
+            flush();
+    }
+
+    bool finish()
+    {
+        flush();
+        return _ok;
+    }
+};
+
+// Buffered reader of the streamed containers, passes the elements to f
+template <class T, class F>
+bool deserialize_stream(int fd, F f)
+{
+    static_assert(__is_trivially_copyable(T), "Only trivially copyable elements can be serialized");
+
+    constexpr unsigned capacity = serial_buffer_size / sizeof(T) ? serial_buffer_size / sizeof(T) : 1;
+
+    SerialHeader h;
+    if (!serial_read_header(fd, sizeof(T), h))
+        return false;
+
+    Array<T> buffer(capacity);
+    SerialChecksum checksum;
+    for (unsigned long long left = h.count; left > 0;)
+    {
+        unsigned n = left < capacity ? left : capacity;
+        if (!serial_read(fd, buffer.data(), (unsigned long) n * sizeof(T)))
+            return false;
+        checksum.update(buffer.data(), (unsigned long) n * sizeof(T));
+        for (unsigned i = 0; i < n; i++)
+            f(buffer[i]);
+        left -= n;
+    }
+    return checksum.value() == h.checksum;
+}
+
+// Containers with for_each(), streamed
+template <class T, class C>
+bool serialize_stream(int fd, const C& c)
+{
+    SerialStreamWriter<T> w(fd);
+    c.for_each([&](const T& value) { w.count(value); });
+    if (!w.write_header())
+        return false;
+
+    c.for_each([&](const T& value) { w.write(value); });
+    return w.finish();
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const ForwardList<T, Alloc>& lst)
+{
+    return serialize_stream<T>(fd, lst);
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const CircularList<T, Alloc>& lst)
+{
+    return serialize_stream<T>(fd, lst);
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const Set<T, Alloc>& set)
+{
+    return serialize_stream<T>(fd, set);
+}
+
+template <class T, class Alloc>
+bool deserialize(int fd, ForwardList<T, Alloc>& lst)
+{
+    // Pushed to the front, so the list is reversed at the end
+    ForwardList<T, Alloc> tmp(lst.get_allocator());
+    if (!deserialize_stream<T>(fd, [&](const T& value) { tmp.push_front(value); }))
+        return false;
+
+    tmp.reverse();
+    lst = static_cast<ForwardList<T, Alloc>&&>(tmp);
+    return true;
+}
+
+template <class T, class Alloc>
+bool deserialize(int fd, CircularList<T, Alloc>& lst)
+{
+    CircularList<T, Alloc> tmp(lst.get_allocator());
+    if (!deserialize_stream<T>(fd, [&](const T& value) { tmp.push_back(value); }))
+        return false;
+
+    lst = static_cast<CircularList<T, Alloc>&&>(tmp);
+    return true;
+}
+
+template <class T, class Alloc>
+bool deserialize(int fd, Set<T, Alloc>& set)
+{
+    // The format is the one of an array. Inserting the sorted elements one
+    // by one would degenerate the tree into a list, so they are read into an
+    // array and built into a balanced tree.
+    Array<T> elements;
+    if (!deserialize_contiguous<T>(fd, elements))
+        return false;
+
+    Set<T, Alloc> tmp(elements.data(), elements.size(), set.get_allocator());
+    set = static_cast<Set<T, Alloc>&&>(tmp);
+    return true;
+}
+
+// Write the container to the file at path, which is replaced
+template <class C>
+bool save(const char* path, const C& c)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    bool ok = serialize(fd, c);
+    return close(fd) == 0 && ok;
+}
+
+// Read the container from the file at path
+template <class C>
+bool load(const char* path, C& c)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    bool ok = deserialize(fd, c);
+    close(fd);
+    return ok;
+}
+
+// Read-only view of the elements of a serialized file, mapped into memory
+// without reading or copying them. The header is checked when the file is
+// opened; the checksum only on request, because it reads all the elements.
+template <class T>
+class SerialView
+{
+    static_assert(__is_trivially_copyable(T), "Only trivially copyable elements can be serialized");
+    static_assert(alignof(T) <= sizeof(SerialHeader), "The elements follow the header");
+
+    void* _map = nullptr;
+    unsigned long _map_size = 0;
+    const T* _data = nullptr;
+    size_t _size = 0;
+
+public:
+    SerialView() {}
+
+    SerialView(const SerialView& other) = delete;
+    SerialView& operator=(const SerialView& other) = delete;
+
+    ~SerialView() { close(); }
+
+    bool open(const char* path, bool verify = false)
+    {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (unsigned long) st.st_size < sizeof(SerialHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+
+        _map = p;
+        _map_size = st.st_size;
+
+        const SerialHeader* h = static_cast<const SerialHeader*>(p);
+        const T* data = reinterpret_cast<const T*>(h + 1);
+        if (!serial_valid(*h, sizeof(T)) || h->count > (size_t) -1 ||
+            h->count * sizeof(T) != _map_size - sizeof(SerialHeader) ||
+            (verify && serial_checksum(data, h->count * sizeof(T)) != h->checksum))
+        {
+            close();
+            return false;
+        }
+
+        _data = data;
+        _size = h->count;
+        return true;
+    }
+
+    void close()
+    {
+        if (_map)
+            munmap(_map, _map_size);
+        _map = nullptr;
+        _map_size = 0;
+        _data = nullptr;
+        _size = 0;
+    }
+
+    bool is_open() const { return _map != nullptr; }
+
+    // Iterators
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+    // Capacity
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // Element access
+    const T& operator[](size_t n) const { return _data[n]; }
+    const T* data() const { return _data; }
+};
+
+} // namespace stlite
+
+#endif
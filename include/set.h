@@ -25,6 +25,8 @@
 #define SET_H
 
 #include "algorithms.h"
+#include "allocator.h"
+#include "trace.h"
 
 #include <algorithm>
 
@@ -43,28 +45,43 @@ struct Node
     Node(T v) : value(v) {}
 };
 
-template <class T>
+template <class T, class Alloc = Allocator<T>>
 class Set
 {
     Node<T> *_root = nullptr;
     unsigned _size = 0;
     unsigned _max_size = -1;
 
+    typedef typename Alloc::template rebind<Node<T>>::other NodeAlloc;
+    NodeAlloc _alloc;
+
     friend class SetIterator<T>;
 
-    void insert_element(Node<T>* &node, T value)
+    void insert_element(Node<T>* &node, T value, unsigned depth = 0)
     {
         if (!node)
         {
-            node = new Node<T>(value);
+            STLITE_TRACE_EVENT("Set::insert", "depth", depth, "size", _size);
+            node = _alloc.construct(value);
             _size++;
         }
         else
         {
             if (value < node->value)
-                insert_element(node->left, value);
+                insert_element(node->left, value, depth + 1);
             else
-                insert_element(node->right, value);
+                insert_element(node->right, value, depth + 1);
+        }
+    }
+
+    template <class F>
+    static void for_each_element(const Node<T> *node, F& f)
+    {
+        while (node)
+        {
+            for_each_element(node->left, f);
+            f(node->value);
+            node = node->right;
         }
     }
 
@@ -76,7 +93,35 @@ class Set
         remove_elements(node->left);
         remove_elements(node->right);
 
-        delete node;
+        _alloc.destroy(node);
+    }
+
+    // Copy of the subtree, the right spine is walked in a loop like in
+    // for_each_element()
+    Node<T> *copy_elements(const Node<T> *node)
+    {
+        Node<T> *root = nullptr;
+        Node<T> **link = &root;
+
+        while (node)
+        {
+            Node<T> *n = _alloc.construct(node->value);
+            n->left = copy_elements(node->left);
+            *link = n;
+            link = &n->right;
+            node = node->right;
+        }
+        return root;
+    }
+
+    // Take the elements of other, which must be releasable by our allocator
+    void steal(Set &other)
+    {
+        _root = other._root;
+        _size = other._size;
+
+        other._root = nullptr;
+        other._size = 0;
     }
 
     Node<T> *array_to_tree(T *arr, int lo, int hi)
@@ -84,7 +129,7 @@ class Set
         if (lo <= hi)
         {
             int middle = (lo + hi) / 2;
-            Node<T> *n = new Node<T>(arr[middle]);
+            Node<T> *n = _alloc.construct(arr[middle]);
             n->left = array_to_tree(arr, lo, middle-1);
             n->right = array_to_tree(arr, middle+1, hi);
             return n;
@@ -95,29 +140,48 @@ class Set
 public:
     Set() {}
 
-    // This constructor creates set from the given array
-    Set(const T *arr, unsigned len)
+    explicit Set(const Alloc &alloc) : _alloc(alloc) {}
+
+    // This constructor creates set from the given array. The elements are
+    // sorted into a temporary array, which is then built into a balanced
+    // tree.
+    Set(const T *arr, unsigned len, const Alloc &alloc = Alloc()) : _alloc(alloc)
     {
-        // TODO: Implement. Sort array and insert the elements.
-        T tmparr[len];
+        T *tmparr = new T[len];
         std::copy(arr, arr + len, tmparr);
-        quick_sort<T>(tmparr, len);
+        sort(tmparr, tmparr + len);
         _root = array_to_tree(tmparr, 0, len-1);
+        _size = len;
+        delete[] tmparr;
     }
 
     // Copy constructor
-    Set(const Set<T> &other) {}
+    Set(const Set &other)
+        : _alloc(AllocatorTraits<NodeAlloc>::select_on_copy_construction(other._alloc))
+    {
+        _root = copy_elements(other._root);
+        _size = other._size;
+    }
+
+    Set(const Set &other, const Alloc &alloc) : _alloc(alloc)
+    {
+        _root = copy_elements(other._root);
+        _size = other._size;
+    }
 
     // Move constructor
-    Set(Set<T> &&other)
+    Set(Set &&other) : _alloc(other._alloc) { steal(other); }
+
+    // The elements are copied when the allocators are not equal
+    Set(Set &&other, const Alloc &alloc) : _alloc(alloc)
     {
-        if (&other != this)
+        if (AllocatorTraits<NodeAlloc>::equal(_alloc, other._alloc))
+            steal(other);
+        else
         {
-            _root = other._root;
+            _root = copy_elements(other._root);
             _size = other._size;
-
-            other._root = nullptr;
-            other._size = 0;
+            other.clear();
         }
     }
 
@@ -125,31 +189,47 @@ public:
     ~Set() { clear(); }
 
     // Copy assignment operator
-    Set<T>& operator=(const Set<T> &other)
+    Set& operator=(const Set &other)
     {
-        // TODO: Implement
+        if (&other != this)
+        {
+            clear();
+            if (AllocatorTraits<NodeAlloc>::propagate_on_copy_assignment)
+                _alloc = other._alloc;
+            _root = copy_elements(other._root);
+            _size = other._size;
+        }
         return *this;
     }
 
     // Move assignment operator
-    Set<T>& operator=(Set<T> &&other)
+    Set& operator=(Set &&other)
     {
         if (&other != this)
         {
             clear();
-            _root = other._root;
-            _size = other._size;
 
-            other._root = nullptr;
-            other._size = 0;
+            if (AllocatorTraits<NodeAlloc>::propagate_on_move_assignment)
+            {
+                _alloc = other._alloc;
+                steal(other);
+            }
+            else if (AllocatorTraits<NodeAlloc>::equal(_alloc, other._alloc))
+                steal(other);
+            else
+            {
+                _root = copy_elements(other._root);
+                _size = other._size;
+                other.clear();
+            }
         }
         return *this;
     }
 
     // Capacity
-    bool empty() { return _root == nullptr; }
-    unsigned size() { return _size; }
-    unsigned max_size() { return _max_size; }
+    bool empty() const { return _root == nullptr; }
+    unsigned size() const { return _size; }
+    unsigned max_size() const { return _max_size; }
 
     // Modifiers
 
@@ -167,17 +247,43 @@ public:
         _size = 0;
     }
 
+    // The allocators are exchanged only if they propagate on swap,
+    // otherwise they must be equal
+    void swap(Set &other)
+    {
+        if (AllocatorTraits<NodeAlloc>::propagate_on_swap)
+            stlite::swap(_alloc, other._alloc);
+        stlite::swap(_root, other._root);
+        stlite::swap(_size, other._size);
+    }
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
     // Operations
     void find(T value) {}
 
     unsigned count(T value)
     {
-        if (!_root)
-            return 0;
+        Node<T> *node = _root;
+
+        while (node)
+        {
+            if (value < node->value)
+                node = node->left;
+            else if (node->value < value)
+                node = node->right;
+            else
+                return 1;
+        }
 
         return 0;
     }
 
+    // Call f(value) for the elements in order
+    template <class F>
+    void for_each(F f) const { for_each_element(_root, f); }
+
     SetIterator<T>* create_iterator()
     {
         return new SetIterator<T>(this);
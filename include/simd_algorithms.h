@@ -0,0 +1,644 @@
+// The MIT License (MIT)
+//
+// STLite SIMD algorithms
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef SIMD_ALGORITHMS_H
+#define SIMD_ALGORITHMS_H
+
+#include "iterator.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define STLITE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Functions using AVX2 are compiled for it regardless of the compiler flags
+// and are only called after the CPU has been checked to support it
+#define STLITE_AVX2 __attribute__((target("avx2")))
+
+namespace stlite
+{
+
+// Vectorized linear scans over contiguous ranges of int and float:
+//
+//   stlite::Vector<int> vec;
+//   ...
+//   auto it = stlite::simd::find(vec.begin(), vec.end(), 42);
+//   long long total = stlite::simd::sum(vec.begin(), vec.end());
+//
+// The instruction set is picked once at run time: AVX2 when the CPU supports
+// it, SSE2 on any other x86 CPU and plain loops everywhere else.
+//
+// The results are the same as those of the scalar loops with two exceptions:
+// the float sum is added up in a different order, so it can differ by
+// rounding, and min_element/max_element return an unspecified element if the
+// range contains NaN. Ranges must have less than 2^31 elements.
+namespace simd
+{
+
+static_assert(sizeof(int) == 4, "The int kernels assume 32-bit int");
+
+enum Level
+{
+    scalar,
+    sse2,
+    avx2
+};
+
+// The best level supported by the CPU
+inline Level detected_level()
+{
+#ifdef STLITE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return avx2;
+    return sse2;
+#else
+    return scalar;
+#endif
+}
+
+inline Level& active_level()
+{
+    static Level level = detected_level();
+    return level;
+}
+
+// The level used by the algorithms
+inline Level level() { return active_level(); }
+
+// Use a lower level than the detected one, e.g. to compare the kernels. The
+// level is never raised above what the CPU supports.
+inline void set_level(Level l)
+{
+    Level detected = detected_level();
+    active_level() = (l < detected) ? l : detected;
+}
+
+//====----------------------------------------------------------------------====
+// Scalar kernels
+//====----------------------------------------------------------------------====
+
+template <class T>
+const T* find_scalar(const T* first, const T* last, T value)
+{
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+template <class T>
+ptrdiff_t count_scalar(const T* first, const T* last, T value)
+{
+    ptrdiff_t n = 0;
+    for (; first != last; ++first)
+        if (*first == value)
+            n++;
+    return n;
+}
+
+// Return the first smallest (or largest if Max) element
+template <bool Max, class T>
+const T* minmax_scalar(const T* first, const T* last)
+{
+    if (first == last)
+        return last;
+
+    const T* best = first;
+    for (const T* p = first + 1; p != last; ++p)
+        if (Max ? *best < *p : *p < *best)
+            best = p;
+
+    return best;
+}
+
+template <class R, class T>
+R sum_scalar(const T* first, const T* last)
+{
+    R sum = 0;
+    for (; first != last; ++first)
+        sum += *first;
+    return sum;
+}
+
+#ifdef STLITE_SIMD_X86
+
+//====----------------------------------------------------------------------====
+// Vector operations
+//====----------------------------------------------------------------------====
+
+// The kernels are written in terms of these operations. V is a vector of
+// elements, M a vector of 32-bit lanes used for comparison masks, counts and
+// indices, and Sum the accumulator of sum().
+
+struct Sse2Base
+{
+    typedef __m128i M;
+    static const unsigned lanes = 4;
+
+    static M m_set1(int x) { return _mm_set1_epi32(x); }
+    static M m_iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static M m_or(M a, M b) { return _mm_or_si128(a, b); }
+    static M m_add(M a, M b) { return _mm_add_epi32(a, b); }
+    static M m_sub(M a, M b) { return _mm_sub_epi32(a, b); }
+    static M m_select(M m, M a, M b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static void m_store(int* p, M m) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), m); }
+
+    // One bit for every lane
+    static unsigned movemask(M m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+};
+
+struct Sse2Int : Sse2Base
+{
+    typedef int T;
+    typedef __m128i V;
+    typedef __m128i Sum; // Two 64-bit lanes
+    typedef long long SumResult;
+
+    static V load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static V set1(int x) { return _mm_set1_epi32(x); }
+    static void store(int* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static M eq(V a, V b) { return _mm_cmpeq_epi32(a, b); }
+    static M lt(V a, V b) { return _mm_cmplt_epi32(a, b); }
+    static V select(M m, V a, V b) { return m_select(m, a, b); }
+
+    static Sum sum_zero() { return _mm_setzero_si128(); }
+
+    static Sum sum_add(Sum acc, V x)
+    {
+        // Sign extend the lanes to 64 bits
+        __m128i sign = _mm_srai_epi32(x, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+        return _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+    }
+
+    static SumResult sum_reduce(Sum acc)
+    {
+        long long lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        return lanes[0] + lanes[1];
+    }
+};
+
+struct Sse2Float : Sse2Base
+{
+    typedef float T;
+    typedef __m128 V;
+    typedef __m128 Sum;
+    typedef float SumResult;
+
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static V set1(float x) { return _mm_set1_ps(x); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static M eq(V a, V b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+    static M lt(V a, V b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+
+    static V select(M m, V a, V b)
+    {
+        __m128 mask = _mm_castsi128_ps(m);
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static Sum sum_zero() { return _mm_setzero_ps(); }
+    static Sum sum_add(Sum acc, V x) { return _mm_add_ps(acc, x); }
+
+    static SumResult sum_reduce(Sum acc)
+    {
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct Avx2Base
+{
+    typedef __m256i M;
+    static const unsigned lanes = 8;
+
+    STLITE_AVX2 static M m_set1(int x) { return _mm256_set1_epi32(x); }
+    STLITE_AVX2 static M m_iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    STLITE_AVX2 static M m_or(M a, M b) { return _mm256_or_si256(a, b); }
+    STLITE_AVX2 static M m_add(M a, M b) { return _mm256_add_epi32(a, b); }
+    STLITE_AVX2 static M m_sub(M a, M b) { return _mm256_sub_epi32(a, b); }
+    STLITE_AVX2 static M m_select(M m, M a, M b) { return _mm256_blendv_epi8(b, a, m); }
+    STLITE_AVX2 static void m_store(int* p, M m) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), m); }
+
+    // One bit for every lane
+    STLITE_AVX2 static unsigned movemask(M m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+};
+
+struct Avx2Int : Avx2Base
+{
+    typedef int T;
+    typedef __m256i V;
+    typedef __m256i Sum; // Four 64-bit lanes
+    typedef long long SumResult;
+
+    STLITE_AVX2 static V load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    STLITE_AVX2 static V set1(int x) { return _mm256_set1_epi32(x); }
+    STLITE_AVX2 static void store(int* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    STLITE_AVX2 static M eq(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+    STLITE_AVX2 static M lt(V a, V b) { return _mm256_cmpgt_epi32(b, a); }
+    STLITE_AVX2 static V select(M m, V a, V b) { return _mm256_blendv_epi8(b, a, m); }
+
+    STLITE_AVX2 static Sum sum_zero() { return _mm256_setzero_si256(); }
+
+    STLITE_AVX2 static Sum sum_add(Sum acc, V x)
+    {
+        __m256i lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x));
+        __m256i hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1));
+        return _mm256_add_epi64(acc, _mm256_add_epi64(lo, hi));
+    }
+
+    STLITE_AVX2 static SumResult sum_reduce(Sum acc)
+    {
+        long long lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
+
+struct Avx2Float : Avx2Base
+{
+    typedef float T;
+    typedef __m256 V;
+    typedef __m256 Sum;
+    typedef float SumResult;
+
+    STLITE_AVX2 static V load(const float* p) { return _mm256_loadu_ps(p); }
+    STLITE_AVX2 static V set1(float x) { return _mm256_set1_ps(x); }
+    STLITE_AVX2 static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    STLITE_AVX2 static M eq(V a, V b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+    STLITE_AVX2 static M lt(V a, V b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    STLITE_AVX2 static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(m)); }
+
+    STLITE_AVX2 static Sum sum_zero() { return _mm256_setzero_ps(); }
+    STLITE_AVX2 static Sum sum_add(Sum acc, V x) { return _mm256_add_ps(acc, x); }
+
+    STLITE_AVX2 static SumResult sum_reduce(Sum acc)
+    {
+        float lanes[8];
+        _mm256_storeu_ps(lanes, acc);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+               ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+};
+
+//====----------------------------------------------------------------------====
+// Vector kernels
+//====----------------------------------------------------------------------====
+
+// The kernels are the same for every instruction set, only the target they
+// are compiled for differs. STLITE_SIMD_KERNELS(isa, target) defines
+// find_<isa>, count_<isa>, minmax_<isa> and sum_<isa> compiled for target:
+// SSE2 is the x86-64 baseline and needs no attribute.
+
+// Find the lowest index among the lanes holding the best value
+template <bool Max, class T>
+const T* minmax_reduce(const T* first, const T* vals, const int* idxs, unsigned lanes)
+{
+    T best = vals[0];
+    int best_idx = idxs[0];
+
+    for (unsigned i = 1; i < lanes; i++)
+    {
+        bool better = Max ? best < vals[i] : vals[i] < best;
+        if (better || (vals[i] == best && idxs[i] < best_idx))
+        {
+            best = vals[i];
+            best_idx = idxs[i];
+        }
+    }
+
+    return first + best_idx;
+}
+
+#define STLITE_SIMD_KERNELS(ISA, TARGET)                                                           \
+template <class Ops>                                                                               \
+TARGET const typename Ops::T* find_##ISA(const typename Ops::T* first,                             \
+                                        const typename Ops::T* last, typename Ops::T value)        \
+{                                                                                                  \
+    typedef typename Ops::M M;                                                                     \
+    const ptrdiff_t n = Ops::lanes;                                                                \
+    typename Ops::V v = Ops::set1(value);                                                          \
+                                                                                                   \
+    /* Four vectors per iteration with a single branch, the exact position                         \
+       is found by the loop below */                                                               \
+    while (last - first >= 4 * n)                                                                  \
+    {                                                                                              \
+        M m0 = Ops::eq(Ops::load(first), v);                                                       \
+        M m1 = Ops::eq(Ops::load(first + n), v);                                                   \
+        M m2 = Ops::eq(Ops::load(first + 2 * n), v);                                               \
+        M m3 = Ops::eq(Ops::load(first + 3 * n), v);                                               \
+        if (Ops::movemask(Ops::m_or(Ops::m_or(m0, m1), Ops::m_or(m2, m3))))                        \
+            break;                                                                                 \
+        first += 4 * n;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    while (last - first >= n)                                                                      \
+    {                                                                                              \
+        unsigned mask = Ops::movemask(Ops::eq(Ops::load(first), v));                               \
+        if (mask)                                                                                  \
+            return first + __builtin_ctz(mask);                                                    \
+        first += n;                                                                                \
+    }                                                                                              \
+                                                                                                   \
+    return find_scalar(first, last, value);                                                        \
+}                                                                                                  \
+                                                                                                   \
+template <class Ops>                                                                               \
+TARGET ptrdiff_t count_##ISA(const typename Ops::T* first, const typename Ops::T* last,            \
+                             typename Ops::T value)                                                \
+{                                                                                                  \
+    typedef typename Ops::M M;                                                                     \
+    const ptrdiff_t n = Ops::lanes;                                                                \
+    typename Ops::V v = Ops::set1(value);                                                          \
+                                                                                                   \
+    /* A matching lane of the mask is -1, subtracting it counts the match */                       \
+    M acc0 = Ops::m_set1(0);                                                                       \
+    M acc1 = Ops::m_set1(0);                                                                       \
+                                                                                                   \
+    while (last - first >= 2 * n)                                                                  \
+    {                                                                                              \
+        acc0 = Ops::m_sub(acc0, Ops::eq(Ops::load(first), v));                                     \
+        acc1 = Ops::m_sub(acc1, Ops::eq(Ops::load(first + n), v));                                 \
+        first += 2 * n;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    int lanes[Ops::lanes];                                                                         \
+    Ops::m_store(lanes, Ops::m_add(acc0, acc1));                                                   \
+                                                                                                   \
+    ptrdiff_t count = count_scalar(first, last, value);                                            \
+    for (unsigned i = 0; i < Ops::lanes; i++)                                                      \
+        count += lanes[i];                                                                         \
+                                                                                                   \
+    return count;                                                                                  \
+}                                                                                                  \
+                                                                                                   \
+template <bool Max, class Ops>                                                                     \
+TARGET const typename Ops::T* minmax_##ISA(const typename Ops::T* first,                           \
+                                          const typename Ops::T* last)                             \
+{                                                                                                  \
+    typedef typename Ops::T T;                                                                     \
+    typedef typename Ops::M M;                                                                     \
+    typedef typename Ops::V V;                                                                     \
+    const ptrdiff_t n = Ops::lanes;                                                                \
+                                                                                                   \
+    if (last - first < 2 * n)                                                                      \
+        return minmax_scalar<Max>(first, last);                                                    \
+                                                                                                   \
+    /* Every lane keeps its best value and the index of its first                                  \
+       occurrence. Two sets of lanes take alternate vectors, so the compare                        \
+       and blend chains of one don't wait for the other. */                                        \
+    V best0 = Ops::load(first);                                                                    \
+    V best1 = Ops::load(first + n);                                                                \
+    M idx0 = Ops::m_iota();                                                                        \
+    M idx1 = Ops::m_add(idx0, Ops::m_set1(n));                                                     \
+    M best_idx0 = idx0;                                                                            \
+    M best_idx1 = idx1;                                                                            \
+    const M step = Ops::m_set1(2 * n);                                                             \
+                                                                                                   \
+    const T* p = first + 2 * n;                                                                    \
+    for (; last - p >= 2 * n; p += 2 * n)                                                          \
+    {                                                                                              \
+        idx0 = Ops::m_add(idx0, step);                                                             \
+        idx1 = Ops::m_add(idx1, step);                                                             \
+        V x0 = Ops::load(p);                                                                       \
+        V x1 = Ops::load(p + n);                                                                   \
+        M better0 = Max ? Ops::lt(best0, x0) : Ops::lt(x0, best0);                                 \
+        M better1 = Max ? Ops::lt(best1, x1) : Ops::lt(x1, best1);                                 \
+        best0 = Ops::select(better0, x0, best0);                                                   \
+        best1 = Ops::select(better1, x1, best1);                                                   \
+        best_idx0 = Ops::m_select(better0, idx0, best_idx0);                                       \
+        best_idx1 = Ops::m_select(better1, idx1, best_idx1);                                       \
+    }                                                                                              \
+                                                                                                   \
+    T vals[2 * Ops::lanes];                                                                        \
+    int idxs[2 * Ops::lanes];                                                                      \
+    Ops::store(vals, best0);                                                                       \
+    Ops::store(vals + n, best1);                                                                   \
+    Ops::m_store(idxs, best_idx0);                                                                 \
+    Ops::m_store(idxs + n, best_idx1);                                                             \
+                                                                                                   \
+    const T* result = minmax_reduce<Max>(first, vals, idxs, 2 * Ops::lanes);                       \
+    for (; p != last; ++p)                                                                         \
+        if (Max ? *result < *p : *p < *result)                                                     \
+            result = p;                                                                            \
+                                                                                                   \
+    return result;                                                                                 \
+}                                                                                                  \
+                                                                                                   \
+template <class Ops>                                                                               \
+TARGET typename Ops::SumResult sum_##ISA(const typename Ops::T* first,                             \
+                                        const typename Ops::T* last)                               \
+{                                                                                                  \
+    typedef typename Ops::Sum Sum;                                                                 \
+    const ptrdiff_t n = Ops::lanes;                                                                \
+                                                                                                   \
+    /* Independent accumulators hide the latency of the additions */                               \
+    Sum acc0 = Ops::sum_zero();                                                                    \
+    Sum acc1 = Ops::sum_zero();                                                                    \
+    Sum acc2 = Ops::sum_zero();                                                                    \
+    Sum acc3 = Ops::sum_zero();                                                                    \
+                                                                                                   \
+    while (last - first >= 4 * n)                                                                  \
+    {                                                                                              \
+        acc0 = Ops::sum_add(acc0, Ops::load(first));                                               \
+        acc1 = Ops::sum_add(acc1, Ops::load(first + n));                                           \
+        acc2 = Ops::sum_add(acc2, Ops::load(first + 2 * n));                                       \
+        acc3 = Ops::sum_add(acc3, Ops::load(first + 3 * n));                                       \
+        first += 4 * n;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    while (last - first >= n)                                                                      \
+    {                                                                                              \
+        acc0 = Ops::sum_add(acc0, Ops::load(first));                                               \
+        first += n;                                                                                \
+    }                                                                                              \
+                                                                                                   \
+    typename Ops::SumResult sum = (Ops::sum_reduce(acc0) + Ops::sum_reduce(acc1)) +                \
+                                  (Ops::sum_reduce(acc2) + Ops::sum_reduce(acc3));                 \
+    return sum + sum_scalar<typename Ops::SumResult>(first, last);                                 \
+}
+
+STLITE_SIMD_KERNELS(sse2, )
+STLITE_SIMD_KERNELS(avx2, STLITE_AVX2)
+
+#undef STLITE_SIMD_KERNELS
+
+#endif // STLITE_SIMD_X86
+
+//====----------------------------------------------------------------------====
+// Dispatch
+//====----------------------------------------------------------------------====
+
+// Element types with kernels
+template <class T>
+struct Kernels;
+
+template <>
+struct Kernels<int>
+{
+    typedef long long SumResult;
+#ifdef STLITE_SIMD_X86
+    typedef Sse2Int Sse2;
+    typedef Avx2Int Avx2;
+#endif
+};
+
+template <>
+struct Kernels<float>
+{
+    typedef float SumResult;
+#ifdef STLITE_SIMD_X86
+    typedef Sse2Float Sse2;
+    typedef Avx2Float Avx2;
+#endif
+};
+
+template <class T>
+const T* find_kernel(const T* first, const T* last, T value)
+{
+#ifdef STLITE_SIMD_X86
+    switch (level())
+    {
+    case avx2:
+        return find_avx2<typename Kernels<T>::Avx2>(first, last, value);
+    case sse2:
+        return find_sse2<typename Kernels<T>::Sse2>(first, last, value);
+    default:
+        break;
+    }
+#endif
+    return find_scalar(first, last, value);
+}
+
+template <class T>
+ptrdiff_t count_kernel(const T* first, const T* last, T value)
+{
+#ifdef STLITE_SIMD_X86
+    switch (level())
+    {
+    case avx2:
+        return count_avx2<typename Kernels<T>::Avx2>(first, last, value);
+    case sse2:
+        return count_sse2<typename Kernels<T>::Sse2>(first, last, value);
+    default:
+        break;
+    }
+#endif
+    return count_scalar(first, last, value);
+}
+
+template <bool Max, class T>
+const T* minmax_kernel(const T* first, const T* last)
+{
+#ifdef STLITE_SIMD_X86
+    switch (level())
+    {
+    case avx2:
+        return minmax_avx2<Max, typename Kernels<T>::Avx2>(first, last);
+    case sse2:
+        return minmax_sse2<Max, typename Kernels<T>::Sse2>(first, last);
+    default:
+        break;
+    }
+#endif
+    return minmax_scalar<Max>(first, last);
+}
+
+template <class T>
+typename Kernels<T>::SumResult sum_kernel(const T* first, const T* last)
+{
+#ifdef STLITE_SIMD_X86
+    switch (level())
+    {
+    case avx2:
+        return sum_avx2<typename Kernels<T>::Avx2>(first, last);
+    case sse2:
+        return sum_sse2<typename Kernels<T>::Sse2>(first, last);
+    default:
+        break;
+    }
+#endif
+    return sum_scalar<typename Kernels<T>::SumResult>(first, last);
+}
+
+//====----------------------------------------------------------------------====
+// Algorithms
+//====----------------------------------------------------------------------====
+
+// The algorithms take contiguous iterators (raw pointers, Vector, Array,
+// StaticVector, ...) of int or float elements.
+
+// Return iterator to the first element equal to value or last
+template <class It>
+It find(It first, It last, typename IteratorTraits<It>::value_type value)
+{
+    typedef IteratorTraits<It> Traits;
+    const typename Traits::value_type* p = Traits::pointer(first);
+    return first + (find_kernel(p, Traits::pointer(last), value) - p);
+}
+
+// Return the number of elements equal to value
+template <class It>
+ptrdiff_t count(It first, It last, typename IteratorTraits<It>::value_type value)
+{
+    typedef IteratorTraits<It> Traits;
+    return count_kernel<typename Traits::value_type>(Traits::pointer(first),
+                                                     Traits::pointer(last), value);
+}
+
+// Return iterator to the first smallest element, last if the range is empty
+template <class It>
+It min_element(It first, It last)
+{
+    typedef IteratorTraits<It> Traits;
+    const typename Traits::value_type* p = Traits::pointer(first);
+    return first + (minmax_kernel<false>(p, Traits::pointer(last)) - p);
+}
+
+// Return iterator to the first largest element, last if the range is empty
+template <class It>
+It max_element(It first, It last)
+{
+    typedef IteratorTraits<It> Traits;
+    const typename Traits::value_type* p = Traits::pointer(first);
+    return first + (minmax_kernel<true>(p, Traits::pointer(last)) - p);
+}
+
+// Sum of the elements. Ints are added up in 64 bits, so the sum doesn't
+// overflow.
+template <class It>
+typename Kernels<typename IteratorTraits<It>::value_type>::SumResult sum(It first, It last)
+{
+    typedef IteratorTraits<It> Traits;
+    const typename Traits::value_type* p = Traits::pointer(first);
+    return sum_kernel(p, Traits::pointer(last));
+}
+
+} // namespace simd
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,364 @@
+// The MIT License (MIT)
+//
+// STLite skip list
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include "algorithms.h"
+#include "allocator.h"
+
+#include <new>
+
+namespace stlite
+{
+
+constexpr unsigned skip_list_max_level = 32;
+
+// Random node height for the skip lists, a node reaches the next level with
+// probability 1/4, which needs fewer pointers per node than 1/2 for about
+// the same search cost
+inline unsigned skip_list_level(unsigned long long& state)
+{
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    unsigned level = 1 + __builtin_ctzll(state | (1ULL << 62)) / 2;
+    return level < skip_list_max_level ? level : skip_list_max_level;
+}
+
+template <class T, class Compare, class Alloc>
+class SkipList;
+
+template <class T>
+struct SkipListNode
+{
+    T value;
+    unsigned level;
+    SkipListNode* next[1]; // level pointers, allocated with the node
+
+    // Size of a node with the given number of levels
+    static size_t bytes(unsigned level)
+    {
+        return sizeof(SkipListNode) + (level - 1) * sizeof(SkipListNode*);
+    }
+};
+
+template <class T>
+class SkipListIterator
+{
+    const SkipListNode<T>* _node = nullptr;
+
+public:
+    typedef T value_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    SkipListIterator() {}
+    explicit SkipListIterator(const SkipListNode<T>* node) : _node(node) {}
+
+    // Prefix increment operator
+    SkipListIterator& operator++()
+    {
+        _node = _node->next[0];
+        return *this;
+    }
+
+    // Postfix increment operator
+    SkipListIterator operator++(int)
+    {
+        SkipListIterator tmp = *this;
+        _node = _node->next[0];
+        return tmp;
+    }
+
+    const T& operator*() const { return _node->value; }
+    const T* operator->() const { return &_node->value; }
+
+    bool operator==(const SkipListIterator& other) const { return _node == other._node; }
+    bool operator!=(const SkipListIterator& other) const { return _node != other._node; }
+};
+
+// Ordered set on a skip list, with the interface of Set. The elements are
+// kept in a sorted linked list, and each node is also linked in a random
+// number of higher levels which skip over more and more nodes, so searches,
+// insertions and erasures take expected logarithmic time without any
+// rebalancing. Iteration visits the elements in order. The elements are
+// constant, changing them would break the order. The nodes, whose size
+// depends on their level, are allocated in NodeBytes units of Alloc.
+template <class T, class Compare = Less<T>, class Alloc = Allocator<T>>
+class SkipList
+{
+    typedef SkipListNode<T> Node;
+    typedef typename Alloc::template rebind<NodeBytes<Node>>::other NodeAlloc;
+
+    // Head pointers of all the levels, the list of a level ends with null
+    Node* _head[skip_list_max_level];
+    unsigned _level = 1; // Levels in use
+    unsigned _size = 0;
+    unsigned long long _random = 0x9e3779b97f4a7c15ULL;
+    Compare _comp;
+    NodeAlloc _alloc;
+
+    Node* create(const T& value, unsigned level)
+    {
+        Node* node = reinterpret_cast<Node*>(_alloc.allocate(NodeBytes<Node>::units(Node::bytes(level))));
+        new (&node->value) T(value);
+        node->level = level;
+        return node;
+    }
+
+    void destroy(Node* node)
+    {
+        unsigned level = node->level;
+        node->value.~T();
+        _alloc.deallocate(reinterpret_cast<NodeBytes<Node>*>(node), NodeBytes<Node>::units(Node::bytes(level)));
+    }
+
+    // Pointer at level i to the first node not less than value, and the
+    // pointers leading to it at all the levels in update
+    Node** lower_bound_link(const T& value, Node*** update)
+    {
+        Node** link = nullptr;
+        Node** next = _head;
+
+        for (unsigned i = _level; i-- > 0;)
+        {
+            link = &next[i];
+            while (*link && _comp((*link)->value, value))
+            {
+                next = (*link)->next;
+                link = &next[i];
+            }
+            if (update)
+                update[i] = link;
+        }
+        return link;
+    }
+
+    const Node* lower_bound_node(const T& value) const
+    {
+        const Node* const* next = _head;
+        const Node* node = nullptr;
+
+        for (unsigned i = _level; i-- > 0;)
+        {
+            node = next[i];
+            while (node && _comp(node->value, value))
+            {
+                next = node->next;
+                node = next[i];
+            }
+        }
+        return node;
+    }
+
+    void init()
+    {
+        for (unsigned i = 0; i < skip_list_max_level; i++)
+            _head[i] = nullptr;
+    }
+
+    void steal(SkipList& other)
+    {
+        for (unsigned i = 0; i < skip_list_max_level; i++)
+        {
+            _head[i] = other._head[i];
+            other._head[i] = nullptr;
+        }
+        _level = other._level;
+        _size = other._size;
+        other._level = 1;
+        other._size = 0;
+    }
+
+public:
+    typedef SkipListIterator<T> iterator;
+    typedef SkipListIterator<T> const_iterator;
+
+    SkipList() { init(); }
+
+    explicit SkipList(const Alloc& alloc) : _alloc(alloc) { init(); }
+
+    explicit SkipList(const Compare& comp, const Alloc& alloc = Alloc()) : _comp(comp), _alloc(alloc)
+    {
+        init();
+    }
+
+    // This constructor creates set from the given array
+    SkipList(const T* arr, unsigned len, const Alloc& alloc = Alloc()) : _alloc(alloc)
+    {
+        init();
+        for (unsigned i = 0; i < len; i++)
+            insert(arr[i]);
+    }
+
+    // Copy constructor
+    SkipList(const SkipList& other)
+        : _comp(other._comp), _alloc(AllocatorTraits<NodeAlloc>::select_on_copy_construction(other._alloc))
+    {
+        init();
+        for (const T& value : other)
+            insert(value);
+    }
+
+    // Move constructor
+    SkipList(SkipList&& other) : _comp(other._comp), _alloc(other._alloc)
+    {
+        init();
+        steal(other);
+    }
+
+    ~SkipList() { clear(); }
+
+    // Copy assignment operator
+    SkipList& operator=(const SkipList& other)
+    {
+        if (&other != this)
+        {
+            clear();
+            if (AllocatorTraits<NodeAlloc>::propagate_on_copy_assignment)
+                _alloc = other._alloc;
+            for (const T& value : other)
+                insert(value);
+        }
+        return *this;
+    }
+
+    // Move assignment operator, the elements are copied when the allocators
+    // are not equal
+    SkipList& operator=(SkipList&& other)
+    {
+        if (&other != this)
+        {
+            clear();
+
+            if (AllocatorTraits<NodeAlloc>::propagate_on_move_assignment)
+            {
+                _alloc = other._alloc;
+                steal(other);
+            }
+            else if (AllocatorTraits<NodeAlloc>::equal(_alloc, other._alloc))
+                steal(other);
+            else
+            {
+                for (const T& value : other)
+                    insert(value);
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    // Iterators
+    iterator begin() const { return iterator(_head[0]); }
+    iterator end() const { return iterator(); }
+
+    // Capacity
+    bool empty() const { return _size == 0; }
+    unsigned size() const { return _size; }
+    unsigned max_size() const { return -1; }
+
+    // Allocator
+    Alloc get_allocator() const { return Alloc(_alloc); }
+
+    // Modifiers
+
+    // Insert the value unless an equal one is present, returns whether it
+    // has been inserted
+    bool insert(const T& value)
+    {
+        Node** update[skip_list_max_level];
+        Node** link = lower_bound_link(value, update);
+
+        if (*link && !_comp(value, (*link)->value))
+            return false;
+
+        unsigned level = skip_list_level(_random);
+        for (; _level < level; _level++)
+            update[_level] = &_head[_level];
+
+        Node* node = create(value, level);
+        for (unsigned i = 0; i < level; i++)
+        {
+            node->next[i] = *update[i];
+            *update[i] = node;
+        }
+
+        _size++;
+        return true;
+    }
+
+    bool erase(const T& value)
+    {
+        Node** update[skip_list_max_level];
+        Node** link = lower_bound_link(value, update);
+        Node* node = *link;
+
+        if (!node || _comp(value, node->value))
+            return false;
+
+        for (unsigned i = 0; i < node->level; i++)
+            *update[i] = node->next[i];
+
+        while (_level > 1 && !_head[_level - 1])
+            _level--;
+
+        destroy(node);
+        _size--;
+        return true;
+    }
+
+    void clear()
+    {
+        Node* node = _head[0];
+        while (node)
+        {
+            Node* next = node->next[0];
+            destroy(node);
+            node = next;
+        }
+
+        init();
+        _level = 1;
+        _size = 0;
+    }
+
+    // Operations
+
+    iterator find(const T& value) const
+    {
+        const Node* node = lower_bound_node(value);
+        return node && !_comp(value, node->value) ? iterator(node) : end();
+    }
+
+    unsigned count(const T& value) const { return find(value) != end(); }
+
+    // First element not less than value
+    iterator lower_bound(const T& value) const { return iterator(lower_bound_node(value)); }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,346 @@
+// The MIT License (MIT)
+//
+// STLite structure-of-arrays vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef SOA_VECTOR_H
+#define SOA_VECTOR_H
+
+#include "algorithms.h"
+#include "allocator.h"
+#include "iterator.h"
+#include "span.h"
+#include "vector.h"
+
+namespace stlite
+{
+
+// Vector of records stored as a structure of arrays: every field has a
+// contiguous column of its own. A loop over one field reads only that column,
+// so it doesn't pull the other fields into the cache, and the columns can be
+// handed to the SIMD and parallel algorithms as plain contiguous ranges:
+//
+//   SoAVector<int, float> vec;               // Records of (id, price)
+//   vec.push_back(1, 2.5f);
+//   vec[0].get<1>() = 3.0f;                  // Row access through a proxy
+//   Span<float> prices = vec.column<1>();    // Whole column
+//
+// The columns are allocated with Allocator and grow together by
+// vector_block_size elements, like Vector.
+template <class... Fields>
+class SoAVector
+{
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+    static constexpr size_t columns = sizeof...(Fields);
+    typedef typename MakeIndexSequence<columns>::type Indices;
+
+    template <size_t I>
+    using Field = typename TypeAt<I, Fields...>::type;
+
+    void* _columns[columns] = {};
+    size_t _capacity = 0;
+    size_t _size = 0;
+
+    template <size_t I>
+    Field<I>* column_data() const
+    {
+        return static_cast<Field<I>*>(_columns[I]);
+    }
+
+    // Move column I to new storage of the given capacity
+    template <size_t I>
+    int reallocate_column(size_t capacity)
+    {
+        Allocator<Field<I>> allocator;
+        Field<I>* old = column_data<I>();
+        Field<I>* tmp = allocator.allocate(capacity);
+
+        move_range(old, old + _size, tmp);
+        allocator.deallocate(old, _capacity);
+        _columns[I] = tmp;
+        return 0;
+    }
+
+    template <size_t I>
+    int deallocate_column()
+    {
+        Allocator<Field<I>>().deallocate(column_data<I>(), _capacity);
+        _columns[I] = nullptr;
+        return 0;
+    }
+
+    template <size_t I>
+    int copy_column(const SoAVector& other)
+    {
+        Field<I>* src = other.template column_data<I>();
+        stlite::copy(src, src + other._size, column_data<I>());
+        return 0;
+    }
+
+    // The pack expansions below call the member template once per column
+
+    template <size_t... I>
+    void reallocate(size_t capacity, IndexSequence<I...>)
+    {
+        int expand[] = { reallocate_column<I>(capacity)... };
+        (void) expand;
+        _capacity = capacity;
+    }
+
+    template <size_t... I>
+    void deallocate(IndexSequence<I...>)
+    {
+        int expand[] = { deallocate_column<I>()... };
+        (void) expand;
+        _capacity = 0;
+    }
+
+    template <size_t... I>
+    void copy_columns(const SoAVector& other, IndexSequence<I...>)
+    {
+        int expand[] = { copy_column<I>(other)... };
+        (void) expand;
+    }
+
+    template <size_t... I>
+    void assign_row(size_t n, IndexSequence<I...>, const Fields&... values)
+    {
+        int expand[] = { (column_data<I>()[n] = values, 0)... };
+        (void) expand;
+    }
+
+    template <size_t... I>
+    void copy_row(size_t n, const SoAVector& other, size_t m, IndexSequence<I...>)
+    {
+        int expand[] = { (column_data<I>()[n] = other.template column_data<I>()[m], 0)... };
+        (void) expand;
+    }
+
+    void check_and_alloc_data()
+    {
+        if (_size >= _capacity)
+            reallocate(_capacity + vector_block_size, Indices());
+    }
+
+    void steal(SoAVector& other)
+    {
+        for (size_t i = 0; i < columns; i++)
+        {
+            _columns[i] = other._columns[i];
+            other._columns[i] = nullptr;
+        }
+        _capacity = other._capacity;
+        _size = other._size;
+
+        other._capacity = 0;
+        other._size = 0;
+    }
+
+public:
+    class ConstReference;
+
+    // Proxy of a row, the fields are accessed with get<I>(). Assigning a row
+    // to another one copies the fields.
+    class Reference
+    {
+        friend class SoAVector;
+        friend class ConstReference;
+
+        SoAVector* _vec;
+        size_t _index;
+
+        Reference(SoAVector* vec, size_t index) : _vec(vec), _index(index) {}
+
+    public:
+        Reference(const Reference& other) = default;
+
+        template <size_t I>
+        Field<I>& get() const
+        {
+            return _vec->template column_data<I>()[_index];
+        }
+
+        // Assign all the fields
+        void assign(const Fields&... values) const
+        {
+            _vec->assign_row(_index, Indices(), values...);
+        }
+
+        Reference& operator=(const Reference& other)
+        {
+            _vec->copy_row(_index, *other._vec, other._index, Indices());
+            return *this;
+        }
+
+        Reference& operator=(const ConstReference& other)
+        {
+            _vec->copy_row(_index, *other._vec, other._index, Indices());
+            return *this;
+        }
+    };
+
+    // Read-only proxy of a row
+    class ConstReference
+    {
+        friend class SoAVector;
+        friend class Reference;
+
+        const SoAVector* _vec;
+        size_t _index;
+
+        ConstReference(const SoAVector* vec, size_t index) : _vec(vec), _index(index) {}
+
+    public:
+        ConstReference(const Reference& other) : _vec(other._vec), _index(other._index) {}
+
+        template <size_t I>
+        const Field<I>& get() const
+        {
+            return _vec->template column_data<I>()[_index];
+        }
+    };
+
+    SoAVector() {}
+
+    // Fill constructor, the fields are default initialized
+    explicit SoAVector(size_t n)
+    {
+        reallocate(n, Indices());
+        _size = n;
+    }
+
+    // Copy constructor
+    SoAVector(const SoAVector& other)
+    {
+        reallocate(other._size, Indices());
+        copy_columns(other, Indices());
+        _size = other._size;
+    }
+
+    // Move constructor
+    SoAVector(SoAVector&& other) { steal(other); }
+
+    ~SoAVector() { deallocate(Indices()); }
+
+    // Copy assignment operator
+    SoAVector& operator=(const SoAVector& other)
+    {
+        if (&other != this)
+        {
+            deallocate(Indices());
+            _size = 0;
+
+            reallocate(other._size, Indices());
+            copy_columns(other, Indices());
+            _size = other._size;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    SoAVector& operator=(SoAVector&& other)
+    {
+        if (&other != this)
+        {
+            deallocate(Indices());
+            steal(other);
+        }
+        return *this;
+    }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    // Make room for at least n rows without reallocating
+    void reserve(size_t n)
+    {
+        if (n > _capacity)
+            reallocate(n, Indices());
+    }
+
+    // Row access
+    Reference operator[](size_t n) { return Reference(this, n); }
+    ConstReference operator[](size_t n) const { return ConstReference(this, n); }
+
+    Reference front() { return Reference(this, 0); }
+    Reference back() { return Reference(this, _size - 1); }
+
+    ConstReference front() const { return ConstReference(this, 0); }
+    ConstReference back() const { return ConstReference(this, _size - 1); }
+
+    // Column access
+    template <size_t I>
+    Field<I>* data()
+    {
+        return column_data<I>();
+    }
+
+    template <size_t I>
+    const Field<I>* data() const
+    {
+        return column_data<I>();
+    }
+
+    template <size_t I>
+    Span<Field<I>> column()
+    {
+        return Span<Field<I>>(column_data<I>(), _size);
+    }
+
+    template <size_t I>
+    Span<const Field<I>> column() const
+    {
+        return Span<const Field<I>>(column_data<I>(), _size);
+    }
+
+    // Modifiers
+
+    void push_back(const Fields&... values)
+    {
+        check_and_alloc_data();
+        assign_row(_size++, Indices(), values...);
+    }
+
+    // Append a copy of a row, which may belong to this vector
+    void push_back(ConstReference row)
+    {
+        // The row is read after the reallocation, through its vector
+        check_and_alloc_data();
+        copy_row(_size++, *row._vec, row._index, Indices());
+    }
+
+    bool pop_back()
+    {
+        if (_size == 0)
+            return false;
+        _size--;
+        return true;
+    }
+
+    void clear() { _size = 0; }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,72 @@
+// The MIT License (MIT)
+//
+// STLite span
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include "allocator.h"
+#include "iterator.h"
+
+namespace stlite
+{
+
+// Non-owning view of a contiguous range of elements. A Span doesn't manage
+// the storage it refers to, it is valid only as long as the storage is.
+// Span<const T> gives read-only access.
+template <class T>
+class Span
+{
+    T* _data = nullptr;
+    size_t _size = 0;
+
+public:
+    typedef ContiguousIterator<T> Iterator;
+
+    constexpr Span() {}
+    constexpr Span(T* data, size_t size) : _data(data), _size(size) {}
+
+    // Conversion from Span<T> to Span<const T>
+    template <class U>
+    constexpr Span(const Span<U>& other) : _data(other.data()), _size(other.size())
+    {
+    }
+
+    constexpr Iterator begin() const { return Iterator(_data); }
+    constexpr Iterator end() const { return Iterator(_data + _size); }
+
+    constexpr size_t size() const { return _size; }
+    constexpr bool empty() const { return _size == 0; }
+
+    constexpr T& operator[](size_t n) const { return _data[n]; }
+    constexpr T* data() const { return _data; }
+
+    // Part of the span starting at offset, count elements long
+    constexpr Span subspan(size_t offset, size_t count) const
+    {
+        return Span(_data + offset, count);
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -29,16 +29,29 @@
 namespace stlite
 {
 
-template <class T>
+// LIFO adaptor over Vector, which allocates the elements with Alloc
+template <class T, class Alloc = Allocator<T>>
 class Stack
 {
-    Vector<T> _data;
+    Vector<T, Alloc> _data;
 
 public:
     Stack() {}
 
-    Stack(const Stack& other) {}                 // Copy constructor
-    Stack(Stack&& other) {}                      // Move constructor
+    explicit Stack(const Alloc& alloc) : _data(alloc) {}
+
+    // Copy constructor
+    Stack(const Stack& other) : _data(other._data) {}
+
+    // Move constructor
+    Stack(Stack&& other) : _data(static_cast<Vector<T, Alloc>&&>(other._data)) {}
+
+    Stack(const Stack& other, const Alloc& alloc) : _data(other._data, alloc) {}
+
+    Stack(Stack&& other, const Alloc& alloc)
+        : _data(static_cast<Vector<T, Alloc>&&>(other._data), alloc)
+    {
+    }
 
     ~Stack() {}                                // Destructor
 
@@ -49,6 +62,9 @@ public:
     bool empty() const { return _data.empty(); }
     size_t size() const { return _data.size(); }
 
+    // Allocator
+    Alloc get_allocator() const { return _data.get_allocator(); }
+
     // Element access
     T& top() { return _data.back(); }
 
@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+//
+// STLite static array
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef STATIC_ARRAY_H
+#define STATIC_ARRAY_H
+
+#include "allocator.h"
+#include "iterator.h"
+
+#include <assert.h>
+
+namespace stlite
+{
+
+// Fixed-size array with inline storage. It never allocates, it is an aggregate
+// and all of its members are constexpr:
+//
+//   constexpr stlite::StaticArray<int, 3> arr = { 1, 2, 3 };
+//   static_assert(arr[1] == 2, "");
+template <class T, size_t N>
+struct StaticArray
+{
+    static_assert(N > 0, "StaticArray must have at least one element");
+
+    // Public only to keep the class an aggregate, use data() instead
+    T _data[N];
+
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
+
+    // Iterators
+    constexpr Iterator begin() { return Iterator(_data); }
+    constexpr Iterator end() { return Iterator(_data + N); }
+
+    constexpr ConstIterator begin() const { return ConstIterator(_data); }
+    constexpr ConstIterator end() const { return ConstIterator(_data + N); }
+
+    constexpr ConstIterator cbegin() const { return ConstIterator(_data); }
+    constexpr ConstIterator cend() const { return ConstIterator(_data + N); }
+
+    constexpr ReverseIterator rbegin() { return ReverseIterator(end()); }
+    constexpr ReverseIterator rend() { return ReverseIterator(begin()); }
+
+    constexpr ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    constexpr ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    constexpr ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    constexpr ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
+
+    // Capacity
+    constexpr size_t size() const { return N; }
+    constexpr size_t max_size() const { return N; }
+    constexpr bool empty() const { return false; }
+
+    // Element access
+    constexpr T& operator[](size_t n) { return _data[n]; }
+    constexpr const T& operator[](size_t n) const { return _data[n]; }
+
+    // The index is checked with assert()
+    constexpr T& at(size_t n)
+    {
+        assert(n < N);
+        return _data[n];
+    }
+
+    constexpr const T& at(size_t n) const
+    {
+        assert(n < N);
+        return _data[n];
+    }
+
+    constexpr T& front() { return _data[0]; }
+    constexpr T& back() { return _data[N - 1]; }
+
+    constexpr const T& front() const { return _data[0]; }
+    constexpr const T& back() const { return _data[N - 1]; }
+
+    constexpr T* data() { return _data; }
+    constexpr const T* data() const { return _data; }
+
+    // Modifiers
+    constexpr void fill(const T& value)
+    {
+        for (size_t i = 0; i < N; ++i)
+            _data[i] = value;
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,255 @@
+// The MIT License (MIT)
+//
+// STLite static vector
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef STATIC_VECTOR_H
+#define STATIC_VECTOR_H
+
+#include "allocator.h"
+#include "iterator.h"
+
+#include <assert.h>
+#include <new>
+
+#ifdef USE_STL
+#include <initializer_list>
+#endif
+
+namespace stlite
+{
+
+// Vector with inline storage for up to N elements, it never allocates.
+// Elements are constructed only when they are added, so T doesn't need to be
+// default constructible.
+template <class T, size_t N>
+class StaticVector
+{
+    alignas(T) unsigned char _storage[N * sizeof(T)];
+    size_t _size = 0;
+
+    T* ptr() { return reinterpret_cast<T*>(_storage); }
+    const T* ptr() const { return reinterpret_cast<const T*>(_storage); }
+
+    void destroy_from(size_t n)
+    {
+        T* d = ptr();
+        for (size_t i = n; i < _size; i++)
+            d[i].~T();
+        _size = n;
+    }
+
+public:
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
+
+    StaticVector() {}
+
+    // Fill constructor, at most N elements are created
+    explicit StaticVector(size_t n, const T& val = T())
+    {
+        for (size_t i = 0; i < n && i < N; i++)
+            new (ptr() + i) T(val);
+        _size = n < N ? n : N;
+    }
+
+    // This constructor creates vector from the given array, at most N
+    // elements are copied
+    StaticVector(const T* arr, size_t len)
+    {
+        for (size_t i = 0; i < len && i < N; i++)
+            new (ptr() + i) T(arr[i]);
+        _size = len < N ? len : N;
+    }
+
+#ifdef USE_STL
+    StaticVector(std::initializer_list<T> initlst)
+    {
+        for (auto x : initlst)
+            push_back(x);
+    }
+#endif
+
+    // Copy constructor
+    StaticVector(const StaticVector& other)
+    {
+        for (size_t i = 0; i < other._size; i++)
+            new (ptr() + i) T(other.ptr()[i]);
+        _size = other._size;
+    }
+
+    // Move constructor, moves the elements one by one
+    StaticVector(StaticVector&& other)
+    {
+        for (size_t i = 0; i < other._size; i++)
+            new (ptr() + i) T(static_cast<T &&>(other.ptr()[i]));
+        _size = other._size;
+        other.clear();
+    }
+
+    ~StaticVector() { clear(); }
+
+    // Copy assignment operator
+    StaticVector& operator=(const StaticVector& other)
+    {
+        if (&other != this)
+        {
+            clear();
+            for (size_t i = 0; i < other._size; i++)
+                new (ptr() + i) T(other.ptr()[i]);
+            _size = other._size;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    StaticVector& operator=(StaticVector&& other)
+    {
+        if (&other != this)
+        {
+            clear();
+            for (size_t i = 0; i < other._size; i++)
+                new (ptr() + i) T(static_cast<T &&>(other.ptr()[i]));
+            _size = other._size;
+            other.clear();
+        }
+        return *this;
+    }
+
+    // Iterators
+    Iterator begin() { return Iterator(ptr()); }
+    Iterator end() { return Iterator(ptr() + _size); }
+
+    ConstIterator begin() const { return ConstIterator(ptr()); }
+    ConstIterator end() const { return ConstIterator(ptr() + _size); }
+
+    ConstIterator cbegin() const { return ConstIterator(ptr()); }
+    ConstIterator cend() const { return ConstIterator(ptr() + _size); }
+
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
+
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+
+    ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
+
+    // Capacity
+    size_t size() const { return _size; }
+    size_t max_size() const { return N; }
+    size_t capacity() const { return N; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size == N; }
+
+    // Element access
+    T& operator[](size_t n) { return ptr()[n]; }
+    const T& operator[](size_t n) const { return ptr()[n]; }
+
+    // The index is checked with assert()
+    T& at(size_t n)
+    {
+        assert(n < _size);
+        return ptr()[n];
+    }
+
+    const T& at(size_t n) const
+    {
+        assert(n < _size);
+        return ptr()[n];
+    }
+
+    T& front() { return ptr()[0]; }
+    T& back() { return ptr()[_size - 1]; }
+
+    const T& front() const { return ptr()[0]; }
+    const T& back() const { return ptr()[_size - 1]; }
+
+    T* data() { return ptr(); }
+    const T* data() const { return ptr(); }
+
+    // Modifiers
+
+    // These return false and leave the vector unchanged when it is full
+    bool push_back(const T& value)
+    {
+        if (_size == N)
+            return false;
+
+        new (ptr() + _size) T(value);
+        _size++;
+        return true;
+    }
+
+    bool push_back(T&& value)
+    {
+        if (_size == N)
+            return false;
+
+        new (ptr() + _size) T(static_cast<T &&>(value));
+        _size++;
+        return true;
+    }
+
+    template <class... Args>
+    bool emplace_back(Args&&... args)
+    {
+        if (_size == N)
+            return false;
+
+        new (ptr() + _size) T(static_cast<Args &&>(args)...);
+        _size++;
+        return true;
+    }
+
+    void pop_back()
+    {
+        if (_size > 0)
+            destroy_from(_size - 1);
+    }
+
+    // Grow or shrink to n elements, new elements are copies of value. The
+    // size is limited to N.
+    void resize(size_t n, const T& value = T())
+    {
+        if (n > N)
+            n = N;
+
+        if (n < _size)
+        {
+            destroy_from(n);
+            return;
+        }
+
+        T* d = ptr();
+        for (size_t i = _size; i < n; i++)
+            new (d + i) T(value);
+        _size = n;
+    }
+
+    void clear() { destroy_from(0); }
+};
+
+} // namespace stlite
+
+#endif
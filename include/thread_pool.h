@@ -0,0 +1,222 @@
+// The MIT License (MIT)
+//
+// STLite thread pool
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace stlite
+{
+
+// Number of CPUs available to the process
+inline unsigned hardware_concurrency()
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? n : 1;
+}
+
+// Fixed set of worker threads running fork-join jobs. A job is a number of
+// tasks; the workers and the calling thread take the task indices from a
+// shared counter until there are none left, and run() returns once all of
+// them have finished. Only one job runs at a time. A job started from inside
+// a task runs serially in the calling thread.
+class ThreadPool
+{
+    struct Job
+    {
+        void (*run)(void* ctx, unsigned task);
+        void* ctx;
+        unsigned tasks;
+        unsigned next; // Next task index, taken atomically
+    };
+
+    pthread_t* _threads = nullptr;
+    unsigned _workers = 0;
+
+    pthread_mutex_t _run_mutex; // Held by the thread running a job
+
+    // Protect the members below
+    pthread_mutex_t _mutex;
+    pthread_cond_t _wake;  // A job has been posted or the pool is stopping
+    pthread_cond_t _idle;  // The last worker has left the job
+
+    Job* _job = nullptr;
+    unsigned long _generation = 0;
+    unsigned _active = 0; // Workers currently working on _job
+    bool _stop = false;
+
+    static bool& inside_task()
+    {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    template <class F>
+    static void call(void* ctx, unsigned task)
+    {
+        (*static_cast<F*>(ctx))(task);
+    }
+
+    static void work(Job* job)
+    {
+        unsigned task;
+        while ((task = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->tasks)
+            job->run(job->ctx, task);
+    }
+
+    static void* worker_main(void* arg)
+    {
+        ThreadPool* pool = static_cast<ThreadPool*>(arg);
+        unsigned long seen = 0;
+
+        inside_task() = true;
+
+        pthread_mutex_lock(&pool->_mutex);
+
+        while (true)
+        {
+            while (!pool->_stop && pool->_generation == seen)
+                pthread_cond_wait(&pool->_wake, &pool->_mutex);
+
+            if (pool->_stop)
+                break;
+
+            seen = pool->_generation;
+
+            // The job may have been finished by the others already
+            Job* job = pool->_job;
+            if (!job)
+                continue;
+
+            pool->_active++;
+            pthread_mutex_unlock(&pool->_mutex);
+
+            work(job);
+
+            pthread_mutex_lock(&pool->_mutex);
+            if (--pool->_active == 0)
+                pthread_cond_signal(&pool->_idle);
+        }
+
+        pthread_mutex_unlock(&pool->_mutex);
+        return nullptr;
+    }
+
+public:
+    // Start the given number of worker threads. With zero workers every job
+    // runs in the calling thread.
+    explicit ThreadPool(unsigned workers)
+    {
+        pthread_mutex_init(&_run_mutex, nullptr);
+        pthread_mutex_init(&_mutex, nullptr);
+        pthread_cond_init(&_wake, nullptr);
+        pthread_cond_init(&_idle, nullptr);
+
+        _threads = new pthread_t[workers ? workers : 1];
+        for (unsigned i = 0; i < workers; i++)
+        {
+            if (pthread_create(&_threads[i], nullptr, worker_main, this) != 0)
+                break;
+            _workers++;
+        }
+    }
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    ~ThreadPool()
+    {
+        pthread_mutex_lock(&_mutex);
+        _stop = true;
+        pthread_cond_broadcast(&_wake);
+        pthread_mutex_unlock(&_mutex);
+
+        for (unsigned i = 0; i < _workers; i++)
+            pthread_join(_threads[i], nullptr);
+
+        delete[] _threads;
+
+        pthread_cond_destroy(&_idle);
+        pthread_cond_destroy(&_wake);
+        pthread_mutex_destroy(&_mutex);
+        pthread_mutex_destroy(&_run_mutex);
+    }
+
+    // Pool shared by the parallel algorithms, one thread per CPU including
+    // the calling one
+    static ThreadPool& default_pool()
+    {
+        static ThreadPool pool(hardware_concurrency() - 1);
+        return pool;
+    }
+
+    // Number of threads taking part in a job, including the calling one
+    unsigned size() const { return _workers + 1; }
+
+    // Call f(i) for every i in [0, tasks) and wait for all the calls to
+    // finish. The calls run concurrently in no particular order.
+    template <class F>
+    void run(unsigned tasks, F& f)
+    {
+        if (_workers == 0 || tasks < 2 || inside_task())
+        {
+            for (unsigned i = 0; i < tasks; i++)
+                f(i);
+            return;
+        }
+
+        Job job;
+        job.run = &call<F>;
+        job.ctx = &f;
+        job.tasks = tasks;
+        job.next = 0;
+
+        pthread_mutex_lock(&_run_mutex);
+
+        pthread_mutex_lock(&_mutex);
+        _job = &job;
+        _generation++;
+        pthread_cond_broadcast(&_wake);
+        pthread_mutex_unlock(&_mutex);
+
+        inside_task() = true;
+        work(&job);
+        inside_task() = false;
+
+        // All tasks have been taken, wait for the workers still running one.
+        // The job lives on this stack, so no worker may pick it up later.
+        pthread_mutex_lock(&_mutex);
+        while (_active > 0)
+            pthread_cond_wait(&_idle, &_mutex);
+        _job = nullptr;
+        pthread_mutex_unlock(&_mutex);
+
+        pthread_mutex_unlock(&_run_mutex);
+    }
+};
+
+} // namespace stlite
+
+#endif
@@ -0,0 +1,205 @@
+// The MIT License (MIT)
+//
+// STLite event tracing
+// Copyright (c) 2017, 2018 Jozef Kolek <jkolek@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Tracing of the container hot paths. With STLITE_TRACE defined the
+// containers record events like reallocations and linear walks in a ring
+// buffer per thread, which Trace::write_chrome_json() exports in the Chrome
+// trace event format (chrome://tracing, Perfetto). Without it the trace
+// macros expand to nothing and their arguments are not evaluated.
+//
+//   STLITE_TRACE_EVENT("Vector::reallocate", "old_capacity", old, "new_capacity", n);
+//   STLITE_TRACE_COUNTER("Queue::high_water", "size", size);
+
+#ifdef STLITE_TRACE
+
+#include <stdio.h>
+#include <time.h>
+
+// Events kept per thread, older ones are overwritten
+#ifndef STLITE_TRACE_BUFFER_SIZE
+#define STLITE_TRACE_BUFFER_SIZE 4096
+#endif
+
+#define STLITE_TRACE_EVENT(...) ::stlite::Trace::record('i', __VA_ARGS__)
+#define STLITE_TRACE_COUNTER(...) ::stlite::Trace::record('C', __VA_ARGS__)
+
+namespace stlite
+{
+
+struct TraceEvent
+{
+    const char* name;
+    const char* arg_names[3]; // String literals, null if unused
+    unsigned long args[3];
+    unsigned long time;       // Nanoseconds
+    char phase;               // 'i' instant, 'C' counter
+};
+
+// Ring buffer of a thread. Only the owning thread writes the events, it
+// publishes them by advancing head.
+struct TraceBuffer
+{
+    TraceEvent events[STLITE_TRACE_BUFFER_SIZE];
+    unsigned long head = 0;  // Events written
+    unsigned long start = 0; // Events before it have been cleared
+    unsigned tid;
+    TraceBuffer* next;
+};
+
+class Trace
+{
+    // The buffers of all the threads. They are never freed, so the events of
+    // the threads which have exited can still be exported.
+    static TraceBuffer*& buffers()
+    {
+        static TraceBuffer* list = nullptr;
+        return list;
+    }
+
+    static TraceBuffer* create()
+    {
+        static unsigned threads = 0;
+
+        TraceBuffer* b = new TraceBuffer;
+        b->tid = __atomic_add_fetch(&threads, 1, __ATOMIC_RELAXED);
+        b->next = __atomic_load_n(&buffers(), __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&buffers(), &b->next, b, false, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED))
+        {
+        }
+        return b;
+    }
+
+    static TraceBuffer* local()
+    {
+        static thread_local TraceBuffer* buffer = create();
+        return buffer;
+    }
+
+    static unsigned long now()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+    }
+
+public:
+    static void record(char phase, const char* name, const char* arg0 = nullptr,
+                       unsigned long value0 = 0, const char* arg1 = nullptr,
+                       unsigned long value1 = 0, const char* arg2 = nullptr,
+                       unsigned long value2 = 0)
+    {
+        TraceBuffer* b = local();
+        unsigned long head = b->head;
+        TraceEvent& e = b->events[head % STLITE_TRACE_BUFFER_SIZE];
+
+        e.name = name;
+        e.arg_names[0] = arg0;
+        e.arg_names[1] = arg1;
+        e.arg_names[2] = arg2;
+        e.args[0] = value0;
+        e.args[1] = value1;
+        e.args[2] = value2;
+        e.time = now();
+        e.phase = phase;
+
+        __atomic_store_n(&b->head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    // Discard the recorded events of all the threads
+    static void clear()
+    {
+        for (TraceBuffer* b = __atomic_load_n(&buffers(), __ATOMIC_ACQUIRE); b; b = b->next)
+            __atomic_store_n(&b->start, __atomic_load_n(&b->head, __ATOMIC_ACQUIRE),
+                             __ATOMIC_RELAXED);
+    }
+
+    // Number of events which write_chrome_json() would export
+    static unsigned long size()
+    {
+        unsigned long n = 0;
+        for (TraceBuffer* b = __atomic_load_n(&buffers(), __ATOMIC_ACQUIRE); b; b = b->next)
+            n += recorded(b, nullptr);
+        return n;
+    }
+
+    // Write the recorded events of all the threads as a Chrome trace. The
+    // events are exact if no thread records events at the same time,
+    // otherwise the oldest ones may be overwritten while they are written.
+    static void write_chrome_json(FILE* out)
+    {
+        fprintf(out, "{\"traceEvents\": [");
+        bool first = true;
+
+        for (TraceBuffer* b = __atomic_load_n(&buffers(), __ATOMIC_ACQUIRE); b; b = b->next)
+        {
+            unsigned long begin;
+            unsigned long n = recorded(b, &begin);
+
+            for (unsigned long i = begin; i < begin + n; i++)
+            {
+                const TraceEvent& e = b->events[i % STLITE_TRACE_BUFFER_SIZE];
+                fprintf(out, "%s\n{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %lu.%03lu, "
+                             "\"pid\": 1, \"tid\": %u",
+                        first ? "" : ",", e.name, e.phase, e.time / 1000, e.time % 1000, b->tid);
+                if (e.phase == 'i')
+                    fprintf(out, ", \"s\": \"t\"");
+
+                fprintf(out, ", \"args\": {");
+                for (unsigned j = 0; j < 3 && e.arg_names[j]; j++)
+                    fprintf(out, "%s\"%s\": %lu", j ? ", " : "", e.arg_names[j], e.args[j]);
+                fprintf(out, "}}");
+                first = false;
+            }
+        }
+        fprintf(out, "\n]}\n");
+    }
+
+private:
+    // Number of events in the buffer, and the index of the oldest one
+    static unsigned long recorded(TraceBuffer* b, unsigned long* begin)
+    {
+        unsigned long head = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE);
+        unsigned long start = __atomic_load_n(&b->start, __ATOMIC_RELAXED);
+        if (head - start > STLITE_TRACE_BUFFER_SIZE)
+            start = head - STLITE_TRACE_BUFFER_SIZE;
+        if (begin)
+            *begin = start;
+        return head - start;
+    }
+};
+
+} // namespace stlite
+
+#else
+
+#define STLITE_TRACE_EVENT(...) ((void) 0)
+#define STLITE_TRACE_COUNTER(...) ((void) 0)
+
+#endif
+
+#endif
@@ -26,6 +26,8 @@
 
 #include "algorithms.h"
 #include "allocator.h"
+#include "trace.h"
+#include "iterator.h"
 
 #ifdef USE_STL
 #include <algorithm>
@@ -43,7 +45,10 @@ class Vector
     size_t _max_size = -1;
     size_t _capacity = 0;
     size_t _size = 0;
-    Alloc allocator;
+    // The allocator of the blocks, Alloc itself unless it counts them under
+    // the name of the container
+    typedef typename ContainerAllocator<Alloc, Vector>::type BlockAlloc;
+    BlockAlloc allocator;
 
     void allocate_data(size_t capacity)
     {
@@ -64,6 +69,9 @@ class Vector
             if (new_capacity > _max_size)
                 return;
 
+            STLITE_TRACE_EVENT("Vector::reallocate", "old_capacity", _capacity, "new_capacity",
+                               new_capacity, "bytes_copied", _size * sizeof(T));
+
             T* tmp = allocator.allocate(new_capacity);
             copy<T>(_data, _data + _size, tmp);
             allocator.deallocate(_data, _capacity);
@@ -72,76 +80,151 @@ class Vector
         }
     }
 
+    // Grow to at least n elements, at least by a block like push_back()
+    void grow(size_t n)
+    {
+        if (n > _capacity)
+            reserve(n > _capacity + vector_block_size ? n : _capacity + vector_block_size);
+    }
+
+    // Make room for n elements at index, moving the following elements up,
+    // and return the room. Reallocates at most once, to the final size.
+    T* open_gap(size_t index, size_t n)
+    {
+        if (_size + n > _capacity)
+        {
+            size_t new_capacity = _size + n;
+            if (new_capacity < _capacity + vector_block_size)
+                new_capacity = _capacity + vector_block_size;
+
+            STLITE_TRACE_EVENT("Vector::reallocate", "old_capacity", _capacity, "new_capacity",
+                               new_capacity, "bytes_copied", _size * sizeof(T));
+
+            T* tmp = allocator.allocate(new_capacity);
+            copy<T>(_data, _data + index, tmp);
+            copy<T>(_data + index, _data + _size, tmp + index + n);
+            allocator.deallocate(_data, _capacity);
+            _data = tmp;
+            _capacity = new_capacity;
+        }
+        else if (__is_trivially_copyable(T))
+            copy<T>(_data + index, _data + _size, _data + index + n);
+        else
+        {
+            for (size_t i = _size; i-- > index;)
+                _data[i + n] = static_cast<T&&>(_data[i]);
+        }
+
+        _size += n;
+        return _data + index;
+    }
+
+    // Take the memory of other, which must be releasable by our allocator
+    void steal(Vector& other)
+    {
+        _data = other._data;
+        _capacity = other._capacity;
+        _size = other._size;
+
+        other._data = nullptr;
+        other._capacity = 0;
+        other._size = 0;
+    }
+
+    // Move the elements of other into our own memory
+    void move_elements(Vector& other)
+    {
+        _size = other._size;
+        allocate_data(other._size);
+        for (size_t i = 0; i < _size; i++)
+            _data[i] = static_cast<T&&>(other._data[i]);
+        other._size = 0;
+    }
+
 public:
     Vector() {}
 
+    explicit Vector(const Alloc& alloc) : allocator(alloc) {}
+
     // Fill constructors
-    explicit Vector(size_t n)
+    explicit Vector(size_t n, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         _size = n;
         allocate_data(n);
     }
 
-    explicit Vector(size_t n, const T& val)
+    explicit Vector(size_t n, const T& val, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         _size = n;
         allocate_data(n);
-        for (unsigned i = 0; i < n; i++)
-            _data[i] = val;
+        stlite::fill(_data, _data + n, val);
     }
 
     // This constructor creates list from the given array
-    Vector(T* arr, size_t len)
+    Vector(const T* arr, size_t len, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         _size = len;
         allocate_data(len);
         copy<T>(arr, arr + _size, _data);
     }
 
+    // Range constructor, the size is computed up front and the vector
+    // allocated once
+    template <class InputIt, class = typename EnableIfIterator<InputIt>::type>
+    Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : allocator(alloc)
+    {
+        _size = stlite::distance(first, last);
+        allocate_data(_size);
+        stlite::copy(first, last, _data);
+    }
+
 #ifdef USE_STL
-    Vector(std::initializer_list<T> initlst)
+    Vector(std::initializer_list<T> initlst, const Alloc& alloc = Alloc()) : allocator(alloc)
     {
         _size = initlst.size();
         allocate_data(_size);
-
-        unsigned idx = 0;
-
-        for (auto x : initlst)
-            _data[idx++] = x;
+        stlite::copy(initlst.begin(), initlst.end(), _data);
     }
 #endif
 
     // Copy constructor
     Vector(const Vector& other)
+        : allocator(AllocatorTraits<BlockAlloc>::select_on_copy_construction(other.allocator))
     {
         _size = other._size;
         allocate_data(other._size);
         copy<T>(other._data, other._data + _size, _data);
     }
 
-    // Move constructor
-    Vector(Vector&& other)
+    Vector(const Vector& other, const Alloc& alloc) : allocator(alloc)
     {
-        if (&other != this)
-        {
-            _data = other._data;
-            _capacity = other._capacity;
-            _size = other._size;
+        _size = other._size;
+        allocate_data(other._size);
+        copy<T>(other._data, other._data + _size, _data);
+    }
 
-            other._data = nullptr;
-            other._capacity = 0;
-            other._size = 0;
-        }
+    // Move constructor
+    Vector(Vector&& other) : allocator(other.allocator) { steal(other); }
+
+    // The elements are moved one by one when the allocators are not equal
+    Vector(Vector&& other, const Alloc& alloc) : allocator(alloc)
+    {
+        if (AllocatorTraits<BlockAlloc>::equal(allocator, other.allocator))
+            steal(other);
+        else
+            move_elements(other);
     }
 
     ~Vector() { allocator.deallocate(_data, _capacity); }
 
     // Copy assignment operator
-    Vector<T>& operator=(const Vector& other)
+    Vector& operator=(const Vector& other)
     {
         if (&other != this)
         {
             allocator.deallocate(_data, _capacity);
+            if (AllocatorTraits<BlockAlloc>::propagate_on_copy_assignment)
+                allocator = other.allocator;
 
             _size = other._size;
             allocate_data(other._size);
@@ -152,83 +235,48 @@ public:
 
 
     // Move assignment operator
-    Vector<T>& operator=(Vector&& other)
+    Vector& operator=(Vector&& other)
     {
         if (&other != this)
         {
             allocator.deallocate(_data, _capacity);
 
-            _data = other._data;
-            _capacity = other._capacity;
-            _size = other._size;
-
-            other._data = nullptr;
-            other._capacity = 0;
-            other._size = 0;
+            if (AllocatorTraits<BlockAlloc>::propagate_on_move_assignment)
+            {
+                allocator = other.allocator;
+                steal(other);
+            }
+            else if (AllocatorTraits<BlockAlloc>::equal(allocator, other.allocator))
+                steal(other);
+            else
+                move_elements(other);
         }
         return *this;
     }
 
     // Iterators
-    class Iterator
-    {
-        T* _data = nullptr;
-        unsigned _current = -1;
-    public:
-        Iterator() {}
-        Iterator(T* data, unsigned n) : _data(data), _current(n) {}
-
-        // Prefix increment operator
-        Iterator& operator++()
-        {
-            _current++;
-            return *this;
-        }
+    typedef ContiguousIterator<T> Iterator;
+    typedef ContiguousIterator<const T> ConstIterator;
+    typedef stlite::ReverseIterator<Iterator> ReverseIterator;
+    typedef stlite::ReverseIterator<ConstIterator> ConstReverseIterator;
 
-        // Postfix increment operator
-        Iterator operator++(int)
-        {
-            Iterator tmp = *this;
-            _current++;
-            return tmp;
-        }
-    
-        // Prefix decrement operator
-        Iterator& operator--()
-        {
-            --_current;
-            return *this;
-        }
+    Iterator begin() { return Iterator(_data); }
+    Iterator end() { return Iterator(_data + _size); }
 
-        // Postfix decrement operator
-        Iterator operator--(int)
-        {
-            Iterator tmp = *this;
-            --_current;
-            return tmp;
-        }
+    ConstIterator begin() const { return ConstIterator(_data); }
+    ConstIterator end() const { return ConstIterator(_data + _size); }
 
-        T& operator*()
-        {
-            return _data[_current];
-        }
-
-        bool operator==(const Iterator& other)
-        {
-            return other._current == _current;
-        }
+    ConstIterator cbegin() const { return ConstIterator(_data); }
+    ConstIterator cend() const { return ConstIterator(_data + _size); }
 
-        bool operator!=(const Iterator& other)
-        {
-            return other._current != _current;
-        }
-    };
+    ReverseIterator rbegin() { return ReverseIterator(end()); }
+    ReverseIterator rend() { return ReverseIterator(begin()); }
 
-    Iterator begin() { return Iterator(_data, 0); }
-    Iterator end() { return Iterator(nullptr, _size); }
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
 
-    const Iterator cbegin() const { return Iterator(_data, 0); }
-    const Iterator cend() const { return Iterator(nullptr, _size); }
+    ConstReverseIterator crbegin() const { return ConstReverseIterator(cend()); }
+    ConstReverseIterator crend() const { return ConstReverseIterator(cbegin()); }
 
     // Capacity
     size_t size() const { return _size; }
@@ -236,6 +284,22 @@ public:
     size_t capacity() const { return _capacity; }
     bool empty() const { return _size == 0; }
 
+    // Make room for at least n elements without reallocating
+    void reserve(size_t n)
+    {
+        if (n <= _capacity)
+            return;
+
+        STLITE_TRACE_EVENT("Vector::reallocate", "old_capacity", _capacity, "new_capacity", n,
+                           "bytes_copied", _size * sizeof(T));
+
+        T* tmp = allocator.allocate(n);
+        copy<T>(_data, _data + _size, tmp);
+        allocator.deallocate(_data, _capacity);
+        _data = tmp;
+        _capacity = n;
+    }
+
     // Element access
     // http://www.cplusplus.com/reference/vector/vector/operator[]/
     // We must be able to assign values via []:
@@ -265,6 +329,7 @@ public:
     const T& back() const { return _data[_size-1]; }
 
     T* data() { return _data; }
+    const T* data() const { return _data; }
 
     // Modifiers
 
@@ -280,13 +345,94 @@ public:
         _data[_size++] = static_cast<T &&>(value);
     }
 
-    bool pop_back() { if (_size > 0) _size--; }
+    bool pop_back()
+    {
+        if (_size == 0)
+            return false;
+        _size--;
+        return true;
+    }
+
+    // Resize to n elements, the new elements are value-initialized or
+    // copies of val
+    void resize(size_t n) { resize(n, T()); }
+
+    void resize(size_t n, const T& val)
+    {
+        if (n > _size)
+        {
+            const T v = val; // val may be an element which moves
+            grow(n);
+            stlite::fill(_data + _size, _data + n, v);
+        }
+        _size = n;
+    }
+
+    // Replace the contents with n copies of val
+    void assign(size_t n, const T& val)
+    {
+        const T v = val;
+        if (n > _capacity)
+        {
+            allocator.deallocate(_data, _capacity);
+            allocate_data(n);
+        }
+        stlite::fill(_data, _data + n, v);
+        _size = n;
+    }
+
+    // Replace the contents with the range, which must not be in this vector
+    template <class InputIt>
+    typename EnableIfIterator<InputIt>::type assign(InputIt first, InputIt last)
+    {
+        size_t n = stlite::distance(first, last);
+        if (n > _capacity)
+        {
+            allocator.deallocate(_data, _capacity);
+            allocate_data(n);
+        }
+        stlite::copy(first, last, _data);
+        _size = n;
+    }
+
+    // Insert the range, which must not be in this vector, before pos and
+    // return the position of its first element. The vector is reallocated
+    // at most once.
+    template <class InputIt>
+    typename EnableIfIterator<InputIt, Iterator>::type insert(ConstIterator pos, InputIt first,
+                                                              InputIt last)
+    {
+        size_t index = pos.base() - _data;
+        size_t n = stlite::distance(first, last);
+        if (n)
+            stlite::copy(first, last, open_gap(index, n));
+        return Iterator(_data + index);
+    }
+
+    // Append the elements of a container or any other range with begin()
+    // and end()
+    template <class R>
+    void append_range(R&& range)
+    {
+        insert(cend(), range.begin(), range.end());
+    }
 
     void clear() { _size = 0; }
 
+    // The allocators are exchanged only if they propagate on swap,
+    // otherwise they must be equal
+    void swap(Vector& other)
+    {
+        if (AllocatorTraits<BlockAlloc>::propagate_on_swap)
+            stlite::swap(allocator, other.allocator);
+        stlite::swap(_data, other._data);
+        stlite::swap(_capacity, other._capacity);
+        stlite::swap(_size, other._size);
+    }
+
     // Allocator
     // http://www.cplusplus.com/reference/vector/vector/get_allocator/
-    // get_allocator()
+    Alloc get_allocator() const { return Alloc(allocator); }
 
     // Operations
     void reverse()
@@ -298,7 +444,7 @@ public:
         unsigned j = _size-1;
 
         while (i < j)
-            swap(_data[i++], _data[j--]);
+            stlite::swap(_data[i++], _data[j--]);
     }
 };
 
@@ -0,0 +1,250 @@
+#include "../include/algorithms.h"
+#include "../include/array.h"
+#include "../include/forward_list.h"
+#include "../include/vector.h"
+
+#include <string>
+#include <iostream>
+#include <assert.h>
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+struct Item
+{
+    int key;
+    int order;
+    std::string name; // Not trivially copyable
+
+    bool operator<(const Item& other) const { return key < other.key; }
+};
+
+static stlite::Vector<int> random_vector(unsigned n, int range)
+{
+    stlite::Vector<int> vec(n);
+    for (unsigned i = 0; i < n; i++)
+        vec[i] = rand() % range;
+    return vec;
+}
+
+void test_min_max()
+{
+    assert(stlite::min(3, 7) == 3);
+    assert(stlite::max(3, 7) == 7);
+    assert(stlite::min(std::string("b"), std::string("a")) == "a");
+}
+
+void test_copy_fill_find()
+{
+    stlite::Vector<int> vec(10);
+    stlite::fill(vec.begin(), vec.end(), 7);
+    assert(stlite::count(vec.begin(), vec.end(), 7) == 10);
+
+    int arr[10] = { 0 };
+    int* end = stlite::copy(vec.cbegin(), vec.cend(), arr);
+    assert(end == arr + 10);
+    assert(arr[0] == 7 && arr[9] == 7);
+
+    // Byte elements go through memset and memchr
+    stlite::Array<char> chars(16);
+    stlite::fill(chars.begin(), chars.end(), 'a');
+    chars[11] = 'b';
+    assert(stlite::find(chars.begin(), chars.end(), 'b') == chars.begin() + 11);
+    assert(stlite::find(chars.begin(), chars.end(), 'c') == chars.end());
+    assert(stlite::find(chars.begin(), chars.end(), 'a' + 256) == chars.end());
+
+    unsigned char bytes[4] = { 1, 255, 3, 4 };
+    assert(stlite::find(bytes, bytes + 4, 255) == bytes + 1);
+    assert(stlite::find(bytes, bytes + 4, -1) == bytes + 4);
+
+    // Non-contiguous ranges
+    stlite::ForwardList<int> lst;
+    lst.push_front(3);
+    lst.push_front(2);
+    lst.push_front(1);
+    assert(*stlite::find(lst.begin(), lst.end(), 2) == 2);
+    assert(stlite::find(lst.begin(), lst.end(), 5) == lst.end());
+    assert(stlite::accumulate(lst.begin(), lst.end(), 0) == 6);
+
+    std::string words[3] = { "a", "b", "c" };
+    std::string copies[3];
+    stlite::copy(words, words + 3, copies);
+    assert(copies[2] == "c");
+}
+
+void test_count_transform_accumulate()
+{
+    stlite::Vector<int> vec({ 1, 2, 3, 4, 5, 6 });
+
+    assert(stlite::count_if(vec.begin(), vec.end(), [](int x) { return x % 2 == 0; }) == 3);
+    assert(*stlite::find_if(vec.begin(), vec.end(), [](int x) { return x > 3; }) == 4);
+
+    stlite::Vector<int> squares(6);
+    stlite::transform(vec.begin(), vec.end(), squares.begin(), [](int x) { return x * x; });
+    assert(squares[5] == 36);
+
+    stlite::Vector<int> sums(6);
+    stlite::transform(vec.begin(), vec.end(), squares.begin(), sums.begin(),
+                      [](int a, int b) { return a + b; });
+    assert(sums[2] == 12);
+
+    assert(stlite::accumulate(vec.begin(), vec.end(), 0) == 21);
+    assert(stlite::accumulate(vec.begin(), vec.end(), 1, [](int a, int b) { return a * b; }) == 720);
+}
+
+void test_partition_unique()
+{
+    stlite::Vector<int> vec = random_vector(1000, 100);
+    stlite::Vector<int>::Iterator mid =
+        stlite::partition(vec.begin(), vec.end(), [](int x) { return x < 50; });
+
+    for (stlite::Vector<int>::Iterator it = vec.begin(); it != mid; ++it)
+        assert(*it < 50);
+    for (stlite::Vector<int>::Iterator it = mid; it != vec.end(); ++it)
+        assert(*it >= 50);
+
+    stlite::Vector<int> dup({ 1, 1, 2, 2, 2, 3, 1, 1 });
+    stlite::Vector<int>::Iterator end = stlite::unique(dup.begin(), dup.end());
+    assert(end - dup.begin() == 4);
+    assert(dup[0] == 1 && dup[1] == 2 && dup[2] == 3 && dup[3] == 1);
+}
+
+void test_merge()
+{
+    int a[4] = { 1, 3, 5, 7 };
+    int b[5] = { 2, 3, 4, 8, 9 };
+    int out[9];
+
+    stlite::merge(a, a + 4, b, b + 5, out);
+    for (unsigned i = 1; i < 9; i++)
+        assert(out[i - 1] <= out[i]);
+    assert(out[8] == 9);
+
+    // On equal keys the elements of the first range come first
+    Item x[2] = { { 1, 0, "x0" }, { 2, 1, "x1" } };
+    Item y[2] = { { 1, 2, "y0" }, { 2, 3, "y1" } };
+    Item merged[4];
+    stlite::merge(x, x + 2, y, y + 2, merged);
+    assert(merged[0].name == "x0" && merged[1].name == "y0");
+    assert(merged[2].name == "x1" && merged[3].name == "y1");
+}
+
+void test_nth_element_partial_sort()
+{
+    for (unsigned n : { 1u, 2u, 5u, 17u, 100u, 5000u })
+    {
+        stlite::Vector<int> vec = random_vector(n, 1000);
+        std::vector<int> ref(vec.begin(), vec.end());
+        std::sort(ref.begin(), ref.end());
+
+        unsigned k = n / 3;
+        stlite::nth_element(vec.begin(), vec.begin() + k, vec.end());
+        assert(vec[k] == ref[k]);
+        for (unsigned i = 0; i < k; i++)
+            assert(vec[i] <= vec[k]);
+        for (unsigned i = k; i < n; i++)
+            assert(vec[i] >= vec[k]);
+
+        stlite::partial_sort(vec.begin(), vec.begin() + k, vec.end());
+        for (unsigned i = 0; i < k; i++)
+            assert(vec[i] == ref[i]);
+    }
+
+    // Many equal elements
+    stlite::Vector<int> same(1000, 4);
+    stlite::nth_element(same.begin(), same.begin() + 500, same.end());
+    assert(same[500] == 4);
+
+    // Descending order with a comparator
+    stlite::Vector<int> vec = random_vector(200, 50);
+    stlite::partial_sort(vec.begin(), vec.begin() + 10, vec.end(),
+                         [](int a, int b) { return a > b; });
+    for (unsigned i = 1; i < 10; i++)
+        assert(vec[i - 1] >= vec[i]);
+}
+
+void test_sort_reduce_for_each()
+{
+    for (unsigned n : { 0u, 1u, 2u, 16u, 17u, 100u, 10000u })
+    {
+        stlite::Vector<int> vec = random_vector(n, 100);
+        std::vector<int> ref(vec.begin(), vec.end());
+        std::sort(ref.begin(), ref.end());
+
+        stlite::sort(vec.begin(), vec.end());
+        for (unsigned i = 0; i < n; i++)
+            assert(vec[i] == ref[i]);
+
+        // Sorted and reverse sorted input
+        stlite::sort(vec.begin(), vec.end());
+        stlite::sort(vec.begin(), vec.end(), [](int a, int b) { return a > b; });
+        for (unsigned i = 1; i < n; i++)
+            assert(vec[i - 1] >= vec[i]);
+    }
+
+    std::string words[4] = { "d", "b", "c", "a" };
+    stlite::sort(words, words + 4);
+    assert(stlite::reduce(words, words + 4, std::string()) == "abcd");
+
+    int arr[5] = { 1, 2, 3, 4, 5 };
+    assert(stlite::reduce(arr, arr + 5, 0) == 15);
+    assert(stlite::reduce(arr, arr + 5, 1, [](int a, int b) { return a * b; }) == 120);
+
+    int sum = 0;
+    stlite::for_each(arr, arr + 5, [&sum](int x) { sum += x; });
+    assert(sum == 15);
+    stlite::for_each(arr, arr + 5, [](int& x) { x *= 2; });
+    assert(arr[4] == 10);
+}
+
+void test_stable_sort()
+{
+    for (unsigned n : { 0u, 1u, 31u, 32u, 33u, 100u, 10000u })
+    {
+        stlite::Vector<int> vec = random_vector(n, 100000);
+        std::vector<int> ref(vec.begin(), vec.end());
+        std::sort(ref.begin(), ref.end());
+
+        stlite::stable_sort(vec.begin(), vec.end());
+        for (unsigned i = 0; i < n; i++)
+            assert(vec[i] == ref[i]);
+    }
+
+    // Elements with equal keys keep their order
+    const unsigned n = 3000;
+    std::vector<Item> items(n);
+    for (unsigned i = 0; i < n; i++)
+    {
+        items[i].key = rand() % 20;
+        items[i].order = i;
+        items[i].name = std::to_string(i);
+    }
+
+    stlite::stable_sort(items.begin(), items.end());
+    for (unsigned i = 1; i < n; i++)
+    {
+        assert(items[i - 1].key <= items[i].key);
+        if (items[i - 1].key == items[i].key)
+            assert(items[i - 1].order < items[i].order);
+        assert(items[i].name == std::to_string(items[i].order));
+    }
+
+    // Reverse order through a comparator
+    stlite::Array<int> arr({ 3, 1, 4, 1, 5, 9, 2, 6 });
+    stlite::stable_sort(arr.begin(), arr.end(), [](int a, int b) { return a > b; });
+    assert(arr[0] == 9 && arr[7] == 1);
+}
+
+int main()
+{
+    test_min_max();
+    test_copy_fill_find();
+    test_count_transform_accumulate();
+    test_partition_unique();
+    test_merge();
+    test_nth_element_partial_sort();
+    test_sort_reduce_for_each();
+    test_stable_sort();
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "../include/allocator.h"
+#include "../include/array.h"
+#include "../include/forward_list.h"
+#include "../include/vector.h"
+
+#include <assert.h>
+
+struct alignas(64) Line
+{
+    static int alive;
+    int value = 3;
+    Line() { alive++; }
+    Line(int v) : value(v) { alive++; }
+    Line(const Line& other) : value(other.value) { alive++; }
+    ~Line() { alive--; }
+};
+
+int Line::alive = 0;
+
+// Throws from the constructor once fail_after objects are alive
+struct alignas(64) Fragile
+{
+    static int alive;
+    static int fail_after;
+    Fragile()
+    {
+        if (alive == fail_after)
+            throw 1;
+        alive++;
+    }
+    Fragile(int) : Fragile() {}
+    ~Fragile() { alive--; }
+};
+
+int Fragile::alive = 0;
+int Fragile::fail_after = 0;
+
+static bool aligned(const void* p, unsigned long alignment)
+{
+    return reinterpret_cast<unsigned long>(p) % alignment == 0;
+}
+
+void test_alignment()
+{
+    static_assert(stlite::Allocator<int>::alignment == alignof(int), "");
+    static_assert(stlite::Allocator<int, 64>::alignment == 64, "");
+    static_assert(stlite::Allocator<Line>::alignment == 64, "");
+    static_assert(stlite::Allocator<Line, 16>::alignment == 64, "");
+
+    stlite::Allocator<float, stlite::cache_line_size> alloc;
+    for (unsigned n = 0; n < 100; n++)
+    {
+        float* p = alloc.allocate(n);
+        assert(p);
+        assert(aligned(p, 64));
+        alloc.deallocate(p, n);
+    }
+
+    stlite::Allocator<char, 4096> pages;
+    char* p = pages.allocate(10000);
+    assert(aligned(p, 4096));
+    pages.deallocate(p, 10000);
+
+    // Rebinding keeps the alignment
+    typedef stlite::Allocator<int, 128>::rebind<double>::other Rebound;
+    static_assert(Rebound::alignment == 128, "");
+}
+
+void test_over_aligned()
+{
+    stlite::Allocator<Line> alloc;
+
+    Line* p = alloc.allocate(10);
+    assert(aligned(p, 64));
+    assert(Line::alive == 10);
+    assert(p[9].value == 3);
+    alloc.deallocate(p, 10);
+    assert(Line::alive == 0);
+
+    Line* l = alloc.construct(42);
+    assert(aligned(l, 64));
+    assert(l->value == 42);
+    assert(Line::alive == 1);
+    alloc.destroy(l);
+    assert(Line::alive == 0);
+}
+
+void test_exceptions()
+{
+    stlite::Allocator<Fragile> alloc;
+
+    // The elements built before the throwing one are destroyed
+    Fragile::fail_after = 3;
+    bool thrown = false;
+    try
+    {
+        alloc.allocate(10);
+    }
+    catch (int)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(Fragile::alive == 0);
+
+    Fragile::fail_after = 0;
+    thrown = false;
+    try
+    {
+        alloc.construct(1);
+    }
+    catch (int)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(Fragile::alive == 0);
+}
+
+void test_containers()
+{
+    stlite::Vector<float, stlite::Allocator<float, 64>> vec;
+    for (int i = 0; i < 1000; i++)
+    {
+        vec.push_back(i);
+        assert(aligned(vec.data(), 64));
+    }
+    assert(vec[999] == 999);
+
+    stlite::Array<double, stlite::Allocator<double, 32>> arr(100);
+    assert(aligned(arr.data(), 32));
+
+    {
+        stlite::Vector<Line> lines;
+        for (int i = 0; i < 150; i++)
+            lines.push_back(Line(i));
+        assert(aligned(lines.data(), 64));
+        assert(lines[149].value == 149);
+    }
+    assert(Line::alive == 0);
+
+    // The nodes of the node containers are aligned too
+    {
+        stlite::ForwardList<Line> lst;
+        lst.push_front(Line(1));
+        lst.push_front(Line(2));
+        assert(aligned(&lst.front(), 64));
+        assert(lst.front().value == 2);
+    }
+    assert(Line::alive == 0);
+}
+
+int main()
+{
+    test_alignment();
+    test_over_aligned();
+    test_exceptions();
+    test_containers();
+
+    return 0;
+}
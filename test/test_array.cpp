@@ -194,5 +194,51 @@ int main()
     assert(arr10[2] == 66);
     assert(arr10.at(2) == 66);
 
+    // Random access iterator test
+    stlite::Array<int> arr11({ 5, 3, 9, 1, 7 });
+
+    stlite::Array<int>::Iterator ait = arr11.begin();
+    assert(ait[2] == 9);
+    assert(*(ait + 4) == 7);
+    assert(arr11.end() - arr11.begin() == 5);
+
+    std::sort(arr11.begin(), arr11.end());
+    assert(arr11[0] == 1);
+    assert(arr11[4] == 9);
+
+    const stlite::Array<int>& carr11 = arr11;
+    stlite::Array<int>::ConstIterator cit = carr11.begin();
+    assert(*cit == 1);
+    assert(cit == arr11.begin());
+
+    stlite::Array<int>::ConstReverseIterator rit = carr11.rbegin();
+    assert(*rit == 9);
+    ++rit;
+    assert(*rit == 7);
+    assert(carr11.rend() - carr11.rbegin() == 5);
+
+    // Range constructor, assign and resize
+    stlite::Array<int> arr12(arr11.begin() + 1, arr11.end());
+    assert(arr12.size() == 4);
+    assert(arr12[0] == 3 && arr12[3] == 9);
+
+    stlite::Array<int> arr13(3, 4);
+    assert(arr13.size() == 3 && arr13[2] == 4);
+
+    arr13.assign(arr11.begin(), arr11.end());
+    assert(arr13.size() == 5 && arr13[4] == 9);
+    arr13.assign(2, arr13[4]);
+    assert(arr13.size() == 2 && arr13[0] == 9 && arr13[1] == 9);
+
+    arr13.resize(4);
+    assert(arr13.size() == 4);
+    assert(arr13[1] == 9 && arr13[2] == 0 && arr13[3] == 0);
+    arr13.resize(1);
+    assert(arr13.size() == 1 && arr13[0] == 9);
+
+    std::string words[] = { "a", "b", "c" };
+    stlite::Array<std::string> arr14(words, words + 3);
+    assert(arr14.size() == 3 && arr14[2] == "c");
+
     return 0;
 }
@@ -0,0 +1,166 @@
+#include "../include/bit_vector.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <vector>
+
+void test_basic()
+{
+    stlite::BitVector bv;
+
+    assert(bv.empty() == true);
+    assert(bv.find_first() == 0);
+    assert(bv.none() == true);
+    assert(bv.all() == true);
+
+    for (unsigned i = 0; i < 200; i++)
+        bv.push_back(i % 3 == 0);
+
+    assert(bv.size() == 200);
+    assert(bv.capacity() >= 200);
+    assert(bv.count() == 67);
+    assert(bv[3] == true && bv[4] == false);
+    assert(bv.test(198) == true);
+
+    bv[4] = true;
+    assert(bv[4] == true);
+    bv[4] = bv[5];
+    assert(bv[4] == false);
+
+    bv.set(1);
+    bv.reset(0);
+    bv.flip(2);
+    assert(bv[0] == false && bv[1] == true && bv[2] == true);
+
+    assert(bv.pop_back() == true);
+    assert(bv.size() == 199);
+    assert(bv.count() == 68);
+
+    bv.clear();
+    assert(bv.empty() == true);
+    assert(bv.pop_back() == false);
+}
+
+void test_fill_resize()
+{
+    stlite::BitVector ones(130, true);
+    assert(ones.count() == 130);
+    assert(ones.all() == true);
+
+    // The bits past the size stay clear
+    ones.flip();
+    assert(ones.none() == true);
+    ones.flip();
+    ones.set();
+    assert(ones.count() == 130);
+
+    ones.resize(70);
+    assert(ones.count() == 70);
+    ones.resize(300);
+    assert(ones.count() == 70);
+    assert(ones[69] == true && ones[70] == false);
+
+    ones.resize(400, true);
+    assert(ones.count() == 170);
+    assert(ones[299] == false && ones[300] == true && ones[399] == true);
+
+    ones.reset();
+    assert(ones.none() == true);
+    assert(ones.size() == 400);
+}
+
+void test_find()
+{
+    stlite::BitVector bv(1000);
+    unsigned positions[] = { 0, 63, 64, 65, 127, 500, 999 };
+    for (unsigned p : positions)
+        bv.set(p);
+
+    unsigned n = 0;
+    for (size_t i = bv.find_first(); i != bv.size(); i = bv.find_next(i))
+        assert(i == positions[n++]);
+    assert(n == 7);
+
+    bv.reset(0);
+    assert(bv.find_first() == 63);
+    assert(bv.find_next(999) == 1000);
+}
+
+void test_bulk()
+{
+    const unsigned n = 1234;
+    stlite::BitVector a(n);
+    stlite::BitVector b(n);
+    std::vector<bool> ra(n);
+    std::vector<bool> rb(n);
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        ra[i] = rand() % 2;
+        rb[i] = rand() % 3 == 0;
+        a.set(i, ra[i]);
+        b.set(i, rb[i]);
+    }
+
+    stlite::BitVector c = a;
+    c &= b;
+    stlite::BitVector d = a;
+    d |= b;
+    stlite::BitVector e = a;
+    e ^= b;
+    stlite::BitVector f = a;
+    f.subtract(b);
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        assert(c[i] == (ra[i] && rb[i]));
+        assert(d[i] == (ra[i] || rb[i]));
+        assert(e[i] == (ra[i] != rb[i]));
+        assert(f[i] == (ra[i] && !rb[i]));
+    }
+
+    assert(c != a);
+    e ^= b;
+    assert(e == a);
+
+    stlite::BitVector moved(static_cast<stlite::BitVector&&>(e));
+    assert(moved == a);
+    assert(e.size() == 0);
+}
+
+void test_rank_select()
+{
+    for (unsigned n : { 0u, 1u, 64u, 511u, 512u, 513u, 5000u })
+    {
+        stlite::BitVector bv(n);
+        for (unsigned i = 0; i < n; i++)
+            bv.set(i, rand() % 4 == 0);
+
+        stlite::RankSelect rs(bv);
+        assert(rs.count() == bv.count());
+
+        size_t rank = 0;
+        for (unsigned i = 0; i < n; i++)
+        {
+            assert(rs.rank(i) == rank);
+            if (bv[i])
+            {
+                assert(rs.select(rank) == i);
+                rank++;
+            }
+        }
+        assert(rs.rank(n) == rank);
+        assert(rs.select(rank) == n);
+    }
+}
+
+int main()
+{
+    test_basic();
+    test_fill_resize();
+    test_find();
+    test_bulk();
+    test_rank_select();
+
+    return 0;
+}
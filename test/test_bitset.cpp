@@ -0,0 +1,101 @@
+#include "../include/bitset.h"
+#include "../include/bit_vector.h"
+
+#include <assert.h>
+
+void test_basic()
+{
+    stlite::Bitset<100> bs;
+
+    assert(bs.size() == 100);
+    assert(bs.none() == true);
+    assert(bs.find_first() == 100);
+
+    bs.set(0).set(64).set(99);
+    assert(bs.count() == 3);
+    assert(bs[64] == true && bs.test(65) == false);
+    assert(bs.find_first() == 0);
+    assert(bs.find_next(0) == 64);
+    assert(bs.find_next(64) == 99);
+    assert(bs.find_next(99) == 100);
+
+    bs[65] = true;
+    bs.reset(64);
+    bs.flip(1);
+    assert(bs.count() == 4);
+
+    // The bits past N stay clear
+    bs.flip();
+    assert(bs.count() == 96);
+    bs.set();
+    assert(bs.all() == true);
+    assert(bs.count() == 100);
+    bs.reset();
+    assert(bs.none() == true);
+}
+
+void test_operators()
+{
+    stlite::Bitset<8> a(0xF0);
+    stlite::Bitset<8> b(0x3C);
+
+    assert((a & b) == stlite::Bitset<8>(0x30));
+    assert((a | b) == stlite::Bitset<8>(0xFC));
+    assert((a ^ b) == stlite::Bitset<8>(0xCC));
+    assert(~a == stlite::Bitset<8>(0x0F));
+    assert(a != b);
+
+    // The value is cut to N bits
+    assert(stlite::Bitset<4>(0xFF).count() == 4);
+
+    stlite::Bitset<1000> big;
+    stlite::Bitset<1000> other;
+    for (unsigned i = 0; i < 1000; i += 3)
+        big.set(i);
+    for (unsigned i = 0; i < 1000; i += 2)
+        other.set(i);
+    assert((big & other).count() == 167);
+    assert((big | other).count() == 334 + 500 - 167);
+
+    stlite::Bitset<0> empty;
+    assert(empty.none() == true && empty.all() == true);
+}
+
+void test_rank_select()
+{
+    stlite::Bitset<700> bs;
+    for (unsigned i = 0; i < 700; i += 7)
+        bs.set(i);
+    bs.set(699);
+
+    stlite::RankSelect rs(bs.data(), bs.size());
+    assert(rs.count() == bs.count());
+
+    stlite::size_t ones = 0;
+    for (stlite::size_t i = 0; i <= bs.size(); i++)
+    {
+        assert(bs.rank(i) == ones);
+        assert(rs.rank(i) == ones);
+        if (i < bs.size() && bs.test(i))
+        {
+            assert(bs.select(ones) == i);
+            assert(rs.select(ones) == i);
+            ones++;
+        }
+    }
+    assert(bs.select(ones) == bs.size());
+    assert(rs.select(ones) == bs.size());
+
+    stlite::Bitset<0> empty;
+    assert(empty.rank(0) == 0);
+    assert(empty.select(0) == 0);
+}
+
+int main()
+{
+    test_basic();
+    test_operators();
+    test_rank_select();
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "../include/bloom_filter.h"
+
+#include <assert.h>
+#include <string>
+
+void test_basic()
+{
+    stlite::BloomFilter<int> filter(10000, 0.01);
+
+    assert(filter.inserted() == 0);
+    assert(filter.contains(5) == false);
+
+    for (int i = 0; i < 10000; i++)
+        filter.insert(i * 7);
+    assert(filter.inserted() == 10000);
+
+    // No false negatives
+    for (int i = 0; i < 10000; i++)
+        assert(filter.contains(i * 7) == true);
+
+    // The measured rate is close to the requested one
+    unsigned positives = 0;
+    for (int i = 0; i < 100000; i++)
+        positives += filter.contains(-1 - i);
+    assert(positives < 1500);
+    assert(filter.false_positive_rate() <= 0.01);
+
+    filter.clear();
+    assert(filter.contains(7) == false);
+}
+
+void test_sizing()
+{
+    // Lower rates need more memory
+    stlite::BloomFilter<int> loose(100000, 0.05);
+    stlite::BloomFilter<int> tight(100000, 0.001);
+    assert(loose.size_in_bytes() < tight.size_in_bytes());
+
+    assert(stlite::BloomFilter<int>::estimate_fpr(100000, tight.block_count()) <= 0.001);
+    assert(stlite::BloomFilter<int>::estimate_fpr(100000, tight.block_count() - 1) > 0.001);
+}
+
+void test_strings()
+{
+    stlite::BloomFilter<std::string> filter(100, 0.01);
+    filter.insert("apple");
+    filter.insert("banana");
+
+    assert(filter.contains("apple") == true);
+    assert(filter.contains("banana") == true);
+    assert(filter.contains(std::string("apple")) == true);
+}
+
+void test_merge_serialize()
+{
+    stlite::BloomFilter<int> a(1000, 0.01);
+    stlite::BloomFilter<int> b(1000, 0.01);
+    for (int i = 0; i < 500; i++)
+    {
+        a.insert(i);
+        b.insert(i + 500);
+    }
+
+    assert(a.merge(b) == true);
+    for (int i = 0; i < 1000; i++)
+        assert(a.contains(i) == true);
+    assert(a.inserted() == 1000);
+
+    stlite::BloomFilter<int> other(100000, 0.01);
+    assert(a.merge(other) == false);
+
+    unsigned char* buf = new unsigned char[a.serialized_size()];
+    a.serialize(buf);
+
+    stlite::BloomFilter<int> c;
+    assert(c.deserialize(buf, a.serialized_size()) == true);
+    assert(c.block_count() == a.block_count());
+    assert(c.inserted() == 1000);
+    for (int i = 0; i < 1000; i++)
+        assert(c.contains(i) == true);
+
+    // Truncated or damaged data is rejected
+    assert(c.deserialize(buf, a.serialized_size() - 1) == false);
+    buf[0] ^= 1;
+    assert(c.deserialize(buf, a.serialized_size()) == false);
+    assert(c.contains(999) == true);
+    delete[] buf;
+
+    stlite::BloomFilter<int> d(c);
+    stlite::BloomFilter<int> e(static_cast<stlite::BloomFilter<int>&&>(c));
+    assert(d.contains(10) == true && e.contains(10) == true);
+}
+
+int main()
+{
+    // Both the AVX2 and the scalar bit tests, they must give the same bits
+    for (int l = stlite::simd::detected_level(); l >= stlite::simd::scalar; l--)
+    {
+        stlite::simd::set_level(static_cast<stlite::simd::Level>(l));
+
+        test_basic();
+        test_sizing();
+        test_strings();
+        test_merge_serialize();
+    }
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "../include/chunked_reader.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct Record
+{
+    unsigned id;
+    unsigned short kind;
+    char tag[6];
+};
+
+static char path[] = "/tmp/test_chunked_reader.XXXXXX";
+
+static void write_file(const void* data, size_t n)
+{
+    FILE* f = fopen(path, "w");
+    assert(fwrite(data, 1, n, f) == n);
+    fclose(f);
+}
+
+void test_records()
+{
+    // Records straddle the 4096 byte chunks
+    constexpr unsigned n = 10000;
+    Record* records = new Record[n];
+    for (unsigned i = 0; i < n; i++)
+    {
+        records[i].id = i;
+        records[i].kind = i % 7;
+        memcpy(records[i].tag, "abcde", 6);
+    }
+    write_file(records, n * sizeof(Record));
+    delete[] records;
+
+    stlite::ChunkedReader reader;
+    assert(reader.open(path, 0, 4096));
+
+    Record r;
+    assert(reader.next(r));
+    assert(r.id == 0);
+
+    stlite::Vector<Record> batch;
+    unsigned expected = 1;
+    unsigned batches = 0;
+    while (reader.next_batch(batch, 1000))
+    {
+        for (unsigned i = 0; i < batch.size(); i++)
+        {
+            assert(batch[i].id == expected++);
+            assert(batch[i].kind == batch[i].id % 7);
+            assert(strcmp(batch[i].tag, "abcde") == 0);
+        }
+        batches++;
+    }
+    assert(expected == n);
+    assert(batches == 10);
+    assert(!reader.error());
+    assert(reader.done());
+
+    // Into a bounded queue, with any allocator
+    assert(reader.open(path, stlite::chunked_read_drop_cache, 4096));
+    stlite::Queue<Record, stlite::Allocator<Record, 64>> queue;
+    expected = 0;
+    while (reader.fill(queue, 100) > 0)
+    {
+        assert(queue.size() <= 100);
+        while (queue.size() > 50)
+        {
+            assert(queue.front().id == expected++);
+            queue.pop();
+        }
+    }
+    while (!queue.empty())
+    {
+        assert(queue.front().id == expected++);
+        queue.pop();
+    }
+    assert(expected == n);
+    assert(!reader.error());
+}
+
+void test_partial_record()
+{
+    char data[20] = {};
+    write_file(data, sizeof(data));
+
+    stlite::ChunkedReader reader;
+    assert(reader.open(path));
+    Record r;
+    assert(reader.next(r));
+    assert(!reader.next(r));
+    assert(reader.error());
+}
+
+void test_lines()
+{
+    // Lines of 0 to 199 characters, 'a' + number % 26
+    char* text = new char[300000];
+    size_t size = 0;
+    unsigned lines = 0;
+    for (unsigned len = 0; size < 250000; len = (len + 37) % 200)
+    {
+        memset(text + size, 'a' + lines % 26, len);
+        size += len;
+        text[size++] = '\n';
+        lines++;
+    }
+    // The last line has no newline
+    memcpy(text + size, "last", 4);
+    size += 4;
+    write_file(text, size);
+    delete[] text;
+
+    stlite::ChunkedReader reader;
+    assert(reader.open(path, 0, 4096));
+
+    stlite::Span<const char> line;
+    unsigned n = 0;
+    for (unsigned len = 0; n < lines; len = (len + 37) % 200, n++)
+    {
+        assert(reader.next_line(line));
+        assert(line.size() == len);
+        for (char c : line)
+            assert(c == (char) ('a' + n % 26));
+    }
+    assert(reader.next_line(line));
+    assert(line.size() == 4 && memcmp(line.data(), "last", 4) == 0);
+    assert(!reader.next_line(line));
+    assert(!reader.error());
+
+    // In batches, O_DIRECT falls back to buffered reads where unsupported
+    assert(reader.open(path, stlite::chunked_read_direct, 4096));
+    stlite::Vector<stlite::Span<const char>> batch;
+    n = 0;
+    unsigned len = 0;
+    while (reader.next_lines(batch, 64))
+    {
+        assert(batch.size() <= 64);
+        for (unsigned i = 0; i < batch.size(); i++, n++, len = (len + 37) % 200)
+            if (n < lines)
+                assert(batch[i].size() == len);
+    }
+    assert(n == lines + 1);
+    assert(!reader.error());
+}
+
+void test_long_line()
+{
+    char text[10000];
+    memset(text, 'x', sizeof(text));
+    write_file(text, sizeof(text));
+
+    // The line doesn't fit in a chunk
+    stlite::ChunkedReader reader;
+    assert(reader.open(path, 0, 4096));
+    stlite::Span<const char> line;
+    assert(!reader.next_line(line));
+    assert(reader.error());
+}
+
+void test_pipe()
+{
+    int fds[2];
+    assert(pipe(fds) == 0);
+    assert(write(fds[1], "one\ntwo\nthree\n", 14) == 14);
+    close(fds[1]);
+
+    stlite::ChunkedReader reader;
+    assert(reader.open(fds[0]));
+    stlite::Span<const char> line;
+    assert(reader.next_line(line) && line.size() == 3);
+    assert(reader.next_line(line) && line.size() == 3);
+    assert(reader.next_line(line) && line.size() == 5);
+    assert(!reader.next_line(line));
+    assert(!reader.error());
+    reader.close();
+    close(fds[0]);
+
+    assert(!reader.open("/nonexistent/file"));
+}
+
+int main()
+{
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    test_records();
+    test_partial_record();
+    test_lines();
+    test_long_line();
+    test_pipe();
+
+    unlink(path);
+    return 0;
+}
@@ -216,5 +216,75 @@ int main()
     for (stlite::CircularList<int>::Iterator it = ls11.begin(); it != ls11.end(); ++it)
         assert(*it == n++);
 
+    // Reverse test
+    ls11.reverse();
+
+    assert(ls11.size() == 5);
+    assert(ls11.front() == 14);
+    assert(ls11.back() == 10);
+
+    n = 14;
+    for (stlite::CircularList<int>::Iterator it = ls11.begin(); it != ls11.end(); ++it)
+        assert(*it == (int) n--);
+
+    // Splice test
+    stlite::CircularList<int> ls12(arr, arr_size);
+    ls12.splice(ls11);
+
+    assert(ls11.empty() == true);
+    assert(ls11.size() == 0);
+    assert(ls12.size() == 10);
+    assert(ls12.front() == 44);
+    assert(ls12.back() == 10);
+    assert(ls12.at(5) == 14);
+
+    stlite::CircularList<int> ls13;
+    ls13.push_back(1);
+    ls13.push_back(2);
+    ls12.splice(ls12.begin(), ls13);
+
+    assert(ls13.empty() == true);
+    assert(ls12.size() == 12);
+    assert(ls12.front() == 1);
+    assert(ls12.at(1) == 2);
+    assert(ls12.at(2) == 44);
+    assert(ls12.back() == 10);
+
+    // Sort test
+    ls12.sort();
+
+    assert(ls12.size() == 12);
+    assert(ls12.front() == 1);
+    assert(ls12.back() == 88);
+
+    int prev = -1;
+    for (stlite::CircularList<int>::Iterator it = ls12.begin(); it != ls12.end(); ++it)
+    {
+        assert(prev <= *it);
+        prev = *it;
+    }
+
+    // Merge test
+    int sorted1[4] = { 1, 3, 5, 7 };
+    int sorted2[5] = { 0, 2, 4, 6, 8 };
+    stlite::CircularList<int> ls14(sorted1, 4);
+    stlite::CircularList<int> ls15(sorted2, 5);
+    ls14.merge(ls15);
+
+    assert(ls15.empty() == true);
+    assert(ls14.size() == 9);
+    assert(ls14.front() == 0);
+    assert(ls14.back() == 8);
+
+    n = 0;
+    for (stlite::CircularList<int>::Iterator it = ls14.begin(); it != ls14.end(); ++it)
+        assert(*it == (int) n++);
+
+    // Merged list keeps working as a circular list
+    ls14.push_back(9);
+    ls14.pop_front();
+    assert(ls14.front() == 1);
+    assert(ls14.back() == 9);
+
     return 0;
 }
@@ -0,0 +1,170 @@
+#include "../include/concurrent_skip_list.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <set>
+
+constexpr unsigned threads = 8;
+constexpr int range = 2000;
+
+typedef stlite::ConcurrentSkipList<int> List;
+
+void test_basic()
+{
+    List list;
+
+    assert(list.empty() == true);
+    assert(list.insert(3) == true);
+    assert(list.insert(1) == true);
+    assert(list.insert(2) == true);
+    assert(list.insert(2) == false);
+    assert(list.size() == 3);
+    assert(list.contains(2) == true);
+    assert(list.count(4) == 0);
+
+    assert(list.erase(2) == true);
+    assert(list.erase(2) == false);
+    assert(list.contains(2) == false);
+
+    int expected[] = { 1, 3 };
+    int i = 0;
+    list.for_each([&](int x) { assert(x == expected[i++]); });
+    assert(i == 2);
+}
+
+struct Args
+{
+    List* list;
+    unsigned id;
+    long inserted;
+    long erased;
+};
+
+// Each thread inserts and erases random values of a small range, so the
+// threads keep running into each other
+void* churn(void* p)
+{
+    Args* args = static_cast<Args*>(p);
+    unsigned long long state = args->id + 1;
+
+    for (int i = 0; i < 100000; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int x = (state >> 33) % range;
+        if ((state >> 20) & 1)
+            args->inserted += args->list->insert(x);
+        else
+            args->erased += args->list->erase(x);
+        args->list->contains(x + 1);
+    }
+    return nullptr;
+}
+
+// Each thread inserts its own values, all of them must be there afterwards
+void* fill(void* p)
+{
+    Args* args = static_cast<Args*>(p);
+    for (int i = 0; i < 20000; i++)
+        assert(args->list->insert(i * threads + args->id) == true);
+    return nullptr;
+}
+
+void run(List& list, void* (*f)(void*), Args* args)
+{
+    pthread_t t[threads];
+    for (unsigned i = 0; i < threads; i++)
+    {
+        args[i].list = &list;
+        args[i].id = i;
+        args[i].inserted = 0;
+        args[i].erased = 0;
+        pthread_create(&t[i], nullptr, f, &args[i]);
+    }
+    for (unsigned i = 0; i < threads; i++)
+        pthread_join(t[i], nullptr);
+}
+
+void test_threads()
+{
+    Args args[threads];
+
+    {
+        List list;
+        run(list, churn, args);
+
+        // Successful inserts minus successful erases is what is left
+        long left = 0;
+        for (unsigned i = 0; i < threads; i++)
+            left += args[i].inserted - args[i].erased;
+        assert(left == (long) list.size());
+
+        long n = 0;
+        int prev = -1;
+        list.for_each([&](int x) {
+            assert(x > prev && x < range);
+            prev = x;
+            n++;
+        });
+        assert(n == left);
+    }
+
+    {
+        List list;
+        run(list, fill, args);
+        assert(list.size() == threads * 20000);
+
+        int expected = 0;
+        list.for_each([&](int x) { assert(x == expected++); });
+        for (unsigned i = 0; i < threads * 20000; i++)
+            assert(list.contains(i) == true);
+    }
+}
+
+// Nodes retired in a critical section aren't deleted before it ends
+struct Tracked
+{
+    static int live;
+    Tracked() { live++; }
+    ~Tracked() { live--; }
+};
+
+int Tracked::live = 0;
+
+void test_epoch()
+{
+    stlite::EpochDomain domain;
+    Tracked* held = new Tracked;
+
+    domain.enter();
+    unsigned long start = domain.epoch();
+    {
+        stlite::EpochDomain::Guard guard(domain);
+        domain.retire(held);
+        for (int i = 0; i < 1000; i++)
+            domain.retire(new Tracked);
+    }
+
+    // This thread is still in the critical section, so the epoch can't move
+    // by more than one
+    assert(domain.epoch() <= start + 1);
+    assert(Tracked::live == 1001);
+    domain.exit();
+
+    {
+        stlite::EpochDomain::Guard guard(domain);
+        for (int i = 0; i < 1000; i++)
+            domain.retire(new Tracked);
+    }
+    assert(domain.epoch() > start + 1);
+    assert(Tracked::live < 2001);
+}
+
+int main()
+{
+    test_basic();
+    test_threads();
+    test_epoch();
+    assert(Tracked::live == 0);
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "../include/cow_array.h"
+#include "../include/cow_vector.h"
+
+#include <assert.h>
+#include <thread>
+#include <vector>
+
+static long sum(const stlite::CowVector<int>& vec)
+{
+    long s = 0;
+    for (unsigned i = 0; i < vec.size(); i++)
+        s += vec[i];
+    return s;
+}
+
+void test_vector()
+{
+    stlite::CowVector<int> vec;
+
+    assert(vec.empty() == true);
+    assert(vec.size() == 0);
+
+    for (int i = 0; i < 250; i++)
+        vec.push_back(i);
+
+    assert(vec.size() == 250);
+    assert(vec.capacity() == stlite::vector_block_size * 3);
+    assert(vec.use_count() == 1);
+
+    // Copies share the buffer
+    stlite::CowVector<int> copy1(vec);
+    stlite::CowVector<int> copy2;
+    copy2 = vec;
+
+    assert(vec.use_count() == 3);
+    assert(copy1.cbegin() == vec.cbegin());
+    assert(sum(copy1) == 249 * 250 / 2);
+
+    // Const access doesn't detach
+    const stlite::CowVector<int>& cref = copy1;
+    assert(cref[10] == 10);
+    assert(cref.front() == 0);
+    assert(cref.back() == 249);
+    assert(vec.use_count() == 3);
+
+    // Write detaches only the written vector
+    copy1[10] = -10;
+    assert(copy1.use_count() == 1);
+    assert(vec.use_count() == 2);
+    assert(copy1[10] == -10);
+
+    // Reading through a non-const vector detaches it as well
+    const stlite::CowVector<int>& cvec = vec;
+    assert(cvec[10] == 10);
+    assert(copy2.cbegin() == vec.cbegin());
+    assert(vec[10] == 10);
+    assert(vec.use_count() == 1);
+    assert(copy2.use_count() == 1);
+
+    // push_back detaches too
+    stlite::CowVector<int> copy3(copy2);
+    copy3.push_back(1000);
+    assert(copy3.size() == 251);
+    assert(copy2.size() == 250);
+    assert(copy3.back() == 1000);
+
+    // pop_back and clear don't touch the shared elements
+    stlite::CowVector<int> copy4(copy2);
+    copy4.pop_back();
+    copy4.clear();
+    assert(copy4.use_count() == copy2.use_count());
+    assert(copy2.size() == 250);
+    copy4.push_back(7);
+    assert(copy4[0] == 7);
+    assert(copy2[0] == 0);
+
+    stlite::CowVector<int> rev({ 1, 2, 3 });
+    stlite::CowVector<int> rev_copy(rev);
+    rev.reverse();
+    assert(rev[0] == 3);
+    assert(rev_copy[0] == 1);
+
+    int n = 0;
+    for (stlite::CowVector<int>::ConstIterator it = rev_copy.cbegin(); it != rev_copy.cend(); ++it)
+        assert(*it == ++n);
+    for (stlite::CowVector<int>::ConstReverseIterator it = rev_copy.crbegin();
+         it != rev_copy.crend(); ++it)
+        assert(*it == n--);
+    assert(n == 0);
+}
+
+void test_array()
+{
+    stlite::CowArray<int> arr(5, 3);
+
+    assert(arr.size() == 5);
+    assert(arr[4] == 3);
+
+    stlite::CowArray<int> copy(arr);
+    assert(arr.use_count() == 2);
+
+    copy.fill(7);
+    assert(arr.use_count() == 1);
+    assert(copy[0] == 7);
+    assert(arr[0] == 3);
+
+    stlite::CowArray<int> copy2(arr);
+    copy2.at(2) = 11;
+    assert(copy2[2] == 11);
+    assert(arr[2] == 3);
+
+    int values[3] = { 4, 5, 6 };
+    stlite::CowArray<int> arr2(values, 3);
+    stlite::CowArray<int> moved(std::move(arr2));
+    assert(arr2.size() == 0);
+    assert(moved.front() == 4);
+    assert(moved.back() == 6);
+}
+
+// Many threads copy, read and modify vectors sharing one buffer
+void test_threads()
+{
+    constexpr unsigned num_threads = 8;
+    constexpr unsigned iterations = 2000;
+    constexpr int size = 1000;
+
+    stlite::CowVector<int> base;
+    for (int i = 0; i < size; i++)
+        base.push_back(i);
+
+    const long expected = (long) (size - 1) * size / 2;
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; t++)
+    {
+        threads.push_back(std::thread([&base, expected, t] {
+            const stlite::CowVector<int>& shared = base;
+            for (unsigned i = 0; i < iterations; i++)
+            {
+                stlite::CowVector<int> copy(shared);
+                assert(sum(copy) == expected);
+
+                if (i % 3 == t % 3)
+                {
+                    copy[i % size] = -1;
+                    assert(copy.use_count() == 1);
+                    assert(sum(copy) == expected - (i % size) - 1);
+                }
+            }
+        }));
+    }
+
+    for (auto& th : threads)
+        th.join();
+
+    assert(base.use_count() == 1);
+    assert(sum(base) == expected);
+}
+
+int main()
+{
+    test_vector();
+    test_array();
+    test_threads();
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "../include/cuckoo_filter.h"
+
+#include <assert.h>
+#include <string>
+
+void test_basic()
+{
+    stlite::CuckooFilter<int> filter(10000, 0.01);
+
+    assert(filter.empty() == true);
+    assert(filter.fingerprint_bits() == 10);
+    assert(filter.contains(5) == false);
+
+    for (int i = 0; i < 10000; i++)
+        assert(filter.insert(i * 3) == true);
+    assert(filter.size() == 10000);
+
+    for (int i = 0; i < 10000; i++)
+        assert(filter.contains(i * 3) == true);
+
+    unsigned positives = 0;
+    for (int i = 0; i < 100000; i++)
+        positives += filter.contains(-1 - i);
+    assert(positives < 1500);
+
+    // Erasing half of the keys keeps the other half
+    for (int i = 0; i < 10000; i += 2)
+        assert(filter.erase(i * 3) == true);
+    assert(filter.size() == 5000);
+    for (int i = 1; i < 10000; i += 2)
+        assert(filter.contains(i * 3) == true);
+
+    filter.clear();
+    assert(filter.empty() == true);
+    assert(filter.contains(3) == false);
+}
+
+void test_full()
+{
+    stlite::CuckooFilter<int> filter(100, 0.001);
+    unsigned capacity = filter.capacity();
+
+    int n = 0;
+    while (filter.insert(n))
+        n++;
+
+    // Filled almost completely before the first failure
+    assert(filter.size() > capacity * 9 / 10);
+    assert(filter.size() <= capacity + 1);
+    for (int i = 0; i < n; i++)
+        assert(filter.contains(i) == true);
+
+    // Erasing makes room again
+    assert(filter.erase(0) == true);
+    assert(filter.insert(-5) == true);
+    for (int i = 1; i < n; i++)
+        assert(filter.contains(i) == true);
+}
+
+void test_duplicates()
+{
+    stlite::CuckooFilter<std::string> filter(100, 0.01);
+
+    filter.insert("a");
+    filter.insert("a");
+    assert(filter.erase("a") == true);
+    assert(filter.contains("a") == true);
+    assert(filter.erase("a") == true);
+    assert(filter.contains("a") == false);
+}
+
+void test_merge_serialize()
+{
+    stlite::CuckooFilter<int> a(1000, 0.01);
+    stlite::CuckooFilter<int> b(1000, 0.01);
+    for (int i = 0; i < 400; i++)
+    {
+        a.insert(i);
+        b.insert(i + 400);
+    }
+
+    assert(a.merge(b) == true);
+    assert(a.size() == 800);
+    for (int i = 0; i < 800; i++)
+        assert(a.contains(i) == true);
+
+    stlite::CuckooFilter<int> other(1000, 0.0001);
+    assert(a.merge(other) == false);
+
+    unsigned char* buf = new unsigned char[a.serialized_size()];
+    a.serialize(buf);
+
+    stlite::CuckooFilter<int> c;
+    assert(c.deserialize(buf, a.serialized_size()) == true);
+    assert(c.size() == 800);
+    assert(c.fingerprint_bits() == a.fingerprint_bits());
+    for (int i = 0; i < 800; i++)
+        assert(c.contains(i) == true);
+    assert(c.erase(10) == true);
+    assert(c.size() == 799);
+
+    assert(c.deserialize(buf, 10) == false);
+    buf[0] ^= 1;
+    assert(c.deserialize(buf, a.serialized_size()) == false);
+    delete[] buf;
+
+    stlite::CuckooFilter<int> d(a);
+    a.clear();
+    assert(d.contains(799) == true);
+    a = d;
+    assert(a.contains(799) == true);
+}
+
+int main()
+{
+    test_basic();
+    test_full();
+    test_duplicates();
+    test_merge_serialize();
+
+    return 0;
+}
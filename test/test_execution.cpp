@@ -0,0 +1,169 @@
+#include "../include/execution.h"
+#include "../include/array.h"
+#include "../include/vector.h"
+
+#include <string>
+#include <iostream>
+#include <assert.h>
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+// Large enough to be split into tasks, and not a multiple of the chunk size
+static const unsigned large = 300007;
+
+static stlite::Vector<int> random_vector(unsigned n, int range)
+{
+    stlite::Vector<int> vec(n);
+    for (unsigned i = 0; i < n; i++)
+        vec[i] = rand() % range;
+    return vec;
+}
+
+// Map x -> a * x + b modulo 2^32
+struct Affine
+{
+    unsigned a;
+    unsigned b;
+};
+
+// Apply f, then g
+static Affine compose(const Affine& f, const Affine& g)
+{
+    return { g.a * f.a, g.a * f.b + g.b };
+}
+
+template <class Policy>
+void test_fill_copy_transform(const Policy& policy, unsigned n)
+{
+    stlite::Vector<int> vec(n, 1);
+    if (n > 0)
+    {
+        stlite::fill(policy, vec.begin() + 1, vec.end(), 7);
+        assert(vec[0] == 1);
+    }
+    for (unsigned i = 1; i < n; i++)
+        assert(vec[i] == 7);
+
+    stlite::Vector<int> src = random_vector(n, 1000);
+    stlite::Vector<int> dst(n);
+    assert(stlite::copy(policy, src.cbegin(), src.cend(), dst.begin()) == dst.end());
+    for (unsigned i = 0; i < n; i++)
+        assert(dst[i] == src[i]);
+
+    stlite::Array<long> squares(n);
+    assert(stlite::transform(policy, src.begin(), src.end(), squares.begin(),
+                             [](int x) { return (long) x * x; }) == squares.end());
+    for (unsigned i = 0; i < n; i++)
+        assert(squares[i] == (long) src[i] * src[i]);
+}
+
+template <class Policy>
+void test_reduce_for_each(const Policy& policy, unsigned n)
+{
+    stlite::Vector<int> vec = random_vector(n, 1000);
+
+    long long sum = 0;
+    for (unsigned i = 0; i < n; i++)
+        sum += vec[i];
+    assert(stlite::reduce(policy, vec.begin(), vec.end(), 0LL) == sum);
+    assert(stlite::reduce(policy, vec.begin(), vec.end(), 5LL,
+                          [](long long a, long long b) { return a + b; }) == sum + 5);
+
+    // The operation doesn't need to be commutative, the chunks are combined
+    // in order
+    stlite::Vector<Affine> maps(n);
+    Affine ref = { 1, 0 };
+    for (unsigned i = 0; i < n; i++)
+    {
+        maps[i] = { 2u * (rand() % 100) + 1, (unsigned) rand() };
+        ref = compose(ref, maps[i]);
+    }
+    Affine res = stlite::reduce(policy, maps.begin(), maps.end(), Affine{ 1, 0 }, compose);
+    assert(res.a == ref.a && res.b == ref.b);
+
+    stlite::for_each(policy, vec.begin(), vec.end(), [](int& x) { x += 1; });
+    assert(stlite::reduce(policy, vec.begin(), vec.end(), 0LL) == sum + n);
+}
+
+template <class Policy>
+void test_sort(const Policy& policy, unsigned n)
+{
+    stlite::Vector<int> vec = random_vector(n, 100000);
+    std::vector<int> ref(vec.begin(), vec.end());
+    std::sort(ref.begin(), ref.end());
+
+    stlite::sort(policy, vec.begin(), vec.end());
+    for (unsigned i = 0; i < n; i++)
+        assert(vec[i] == ref[i]);
+
+    stlite::sort(policy, vec.begin(), vec.end(), [](int a, int b) { return a > b; });
+    for (unsigned i = 1; i < n; i++)
+        assert(vec[i - 1] >= vec[i]);
+
+    // Many equal elements
+    stlite::Vector<int> few = random_vector(n, 3);
+    stlite::sort(policy, few.begin(), few.end());
+    for (unsigned i = 1; i < n; i++)
+        assert(few[i - 1] <= few[i]);
+}
+
+template <class Policy>
+void test_policy(const Policy& policy)
+{
+    for (unsigned n : { 0u, 1u, 1000u, large })
+    {
+        test_fill_copy_transform(policy, n);
+        test_reduce_for_each(policy, n);
+        test_sort(policy, n);
+    }
+}
+
+void test_nested()
+{
+    // A parallel algorithm called from a task runs serially in that task
+    stlite::ThreadPool pool(3);
+    stlite::ParallelPolicy policy(pool);
+
+    stlite::Vector<int> rows(large);
+    stlite::for_each(policy, rows.begin(), rows.end(), [&](int& x) {
+        int small[4] = { 1, 2, 3, 4 };
+        x = stlite::reduce(policy, small, small + 4, 0);
+    });
+    assert(stlite::reduce(policy, rows.begin(), rows.end(), 0LL) == 10LL * large);
+}
+
+void test_pool()
+{
+    stlite::ThreadPool pool(3);
+    assert(pool.size() == 4);
+
+    // Every task runs exactly once
+    unsigned counts[100] = { 0 };
+    auto task = [&](unsigned i) { __atomic_fetch_add(&counts[i], 1, __ATOMIC_RELAXED); };
+    for (unsigned round = 0; round < 50; round++)
+        pool.run(100, task);
+    for (unsigned i = 0; i < 100; i++)
+        assert(counts[i] == 50);
+
+    assert(stlite::hardware_concurrency() >= 1);
+    assert(stlite::ThreadPool::default_pool().size() == stlite::hardware_concurrency());
+}
+
+int main()
+{
+    test_policy(stlite::seq);
+    test_policy(stlite::par);
+
+    // Explicit pools, also with more threads than CPUs
+    stlite::ThreadPool serial(0);
+    test_policy(stlite::ParallelPolicy(serial));
+
+    stlite::ThreadPool pool(3);
+    test_policy(stlite::ParallelPolicy(pool));
+
+    test_nested();
+    test_pool();
+
+    return 0;
+}
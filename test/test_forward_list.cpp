@@ -146,6 +146,103 @@ void test_iterator()
     }
 }
 
+void test_reverse()
+{
+    stlite::ForwardList<int> ls;
+    for (int i = 9; i >= 0; --i)
+        ls.push_front(i);
+
+    ls.reverse();
+
+    int i = 9;
+    for (stlite::ForwardList<int>::Iterator iter = ls.begin(); iter != ls.end(); ++iter)
+        assert(*iter == i--);
+    assert(i == -1);
+}
+
+void test_splice()
+{
+    stlite::ForwardList<int> ls1;
+    stlite::ForwardList<int> ls2;
+    for (int i = 4; i >= 0; --i)
+        ls1.push_front(i);
+    for (int i = 9; i >= 5; --i)
+        ls2.push_front(i);
+
+    // Insert 5..9 after 4
+    stlite::ForwardList<int>::Iterator pos = ls1.begin();
+    for (int i = 0; i < 4; i++)
+        ++pos;
+    ls1.splice_after(pos, ls2);
+
+    assert(ls2.empty() == true);
+
+    int i = 0;
+    for (stlite::ForwardList<int>::Iterator iter = ls1.begin(); iter != ls1.end(); ++iter)
+        assert(*iter == i++);
+    assert(i == 10);
+
+    ls2.push_front(-1);
+    ls2.push_front(-2);
+    ls1.splice_front(ls2);
+
+    assert(ls2.empty() == true);
+    assert(ls1.front() == -2);
+}
+
+// Ordered by key only, seq records the original position
+struct KeySeq
+{
+    int key = 0;
+    int seq = 0;
+
+    KeySeq() = default;
+    KeySeq(int k, int s) : key(k), seq(s) {}
+
+    bool operator<(const KeySeq& other) const { return key < other.key; }
+};
+
+void test_merge_sort()
+{
+    stlite::ForwardList<int> ls1;
+    stlite::ForwardList<int> ls2;
+    int values[10] = { 7, 3, 9, 1, 5, 8, 2, 0, 6, 4 };
+
+    for (int i = 0; i < 5; i++)
+        ls1.push_front(values[i]);
+    for (int i = 5; i < 10; i++)
+        ls2.push_front(values[i]);
+
+    ls1.sort();
+    ls2.sort();
+
+    assert(ls1.front() == 1);
+    assert(ls2.front() == 0);
+
+    ls1.merge(ls2);
+
+    assert(ls2.empty() == true);
+
+    int i = 0;
+    for (stlite::ForwardList<int>::Iterator iter = ls1.begin(); iter != ls1.end(); ++iter)
+        assert(*iter == i++);
+    assert(i == 10);
+
+    // Sort is stable
+    stlite::ForwardList<KeySeq> ls3;
+    for (int i = 19; i >= 0; i--)
+        ls3.push_front(KeySeq(i % 3, i));
+    ls3.sort();
+
+    KeySeq prev(-1, -1);
+    for (stlite::ForwardList<KeySeq>::Iterator iter = ls3.begin(); iter != ls3.end(); ++iter)
+    {
+        assert(prev.key < (*iter).key ||
+               (prev.key == (*iter).key && prev.seq < (*iter).seq));
+        prev = *iter;
+    }
+}
+
 int main()
 {
     test_push_front();
@@ -153,6 +250,9 @@ int main()
     test_remove();
     test_emplace_front();
     test_iterator();
+    test_reverse();
+    test_splice();
+    test_merge_sort();
 
     // assert(ls.size() == 5);
     // assert(ls.front() == 0);
@@ -0,0 +1,97 @@
+#include "../include/huge_page_allocator.h"
+#include "../include/vector.h"
+
+#include <assert.h>
+
+struct Counted
+{
+    static int alive;
+    int value = 7;
+    Counted() { alive++; }
+    ~Counted() { alive--; }
+};
+
+int Counted::alive = 0;
+
+template <class Alloc>
+void test_large()
+{
+    Alloc alloc;
+    constexpr unsigned n = 3 << 20; // 12 MB of ints
+
+    int* p = alloc.allocate(n);
+    assert(p);
+    assert(reinterpret_cast<unsigned long>(p) % stlite::huge_page_size == 0);
+
+    // Zeroed
+    assert(p[0] == 0 && p[n - 1] == 0);
+    for (unsigned i = 0; i < n; i += 1024)
+        p[i] = i;
+    for (unsigned i = 0; i < n; i += 1024)
+        assert(p[i] == (int) i);
+
+    alloc.deallocate(p, n);
+}
+
+void test_small()
+{
+    stlite::HugePageAllocator<int> alloc;
+
+    // Below the threshold the blocks come from the default allocator
+    int* p = alloc.allocate(100);
+    assert(p);
+    p[99] = 1;
+    alloc.deallocate(p, 100);
+
+    int* q = alloc.construct(5);
+    assert(*q == 5);
+    alloc.destroy(q);
+}
+
+void test_constructors()
+{
+    stlite::HugePageAllocator<Counted> alloc;
+    constexpr unsigned n = 1 << 20;
+
+    Counted* p = alloc.allocate(n);
+    assert(Counted::alive == (int) n);
+    assert(p[n - 1].value == 7);
+    alloc.deallocate(p, n);
+    assert(Counted::alive == 0);
+}
+
+void test_vector()
+{
+    stlite::Vector<long, stlite::HugePageAllocator<long>> vec(1 << 20);
+    for (unsigned i = 0; i < vec.size(); i++)
+        vec[i] = i;
+
+    long sum = 0;
+    for (long x : vec)
+        sum += x;
+    assert(sum == (long) (1 << 20) * ((1 << 20) - 1) / 2);
+
+    // Growing moves from the small to the large blocks
+    stlite::Vector<long, stlite::HugePageAllocator<long>> grown;
+    grown.reserve(100);
+    grown.push_back(1);
+    grown.reserve(1 << 18);
+    assert(grown.capacity() == 1 << 18);
+    assert(grown[0] == 1);
+}
+
+int main()
+{
+    test_large<stlite::HugePageAllocator<int>>();
+
+    // The NUMA policies and MAP_HUGETLB fall back where unsupported
+    test_large<stlite::HugePageAllocator<int, stlite::huge_page_hugetlb>>();
+    test_large<stlite::HugePageAllocator<int, stlite::huge_page_interleave>>();
+    test_large<stlite::HugePageAllocator<int, 0, 0>>();
+
+    test_small();
+    test_constructors();
+    test_vector();
+
+    return 0;
+}
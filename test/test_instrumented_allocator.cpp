@@ -0,0 +1,198 @@
+#include "../include/array.h"
+#include "../include/circular_list.h"
+#include "../include/concurrent_skip_list.h"
+#include "../include/forward_list.h"
+#include "../include/instrumented_allocator.h"
+#include "../include/persistent_vector.h"
+#include "../include/radix_tree.h"
+#include "../include/set.h"
+#include "../include/skip_list.h"
+#include "../include/vector.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+struct OrderBook
+{
+};
+
+static stlite::AllocationCounters stats(const char* name)
+{
+    stlite::AllocationCounters c;
+    bool found = stlite::AllocationStats::snapshot(name, c);
+    assert(found);
+    return c;
+}
+
+void test_vector()
+{
+    {
+        stlite::Vector<int, stlite::InstrumentedAllocator<int>> vec;
+        for (int i = 0; i < 250; i++)
+            vec.push_back(i);
+    }
+
+    // Counted under the name of the container, not of the element type
+    stlite::AllocationCounters c = stats("Vector<int, InstrumentedAllocator<int> >");
+
+    // The vector grows by vector_block_size elements, the old block is
+    // released after the elements have been copied to the new one
+    assert(c.allocations == 3);
+    assert(c.deallocations == 3);
+    assert(c.bytes_live == 0);
+    assert(c.peak_bytes == (200 + 300) * sizeof(int));
+    assert(c.bytes_total == (100 + 200 + 300) * sizeof(int));
+
+    // 400, 800 and 1200 bytes
+    assert(c.histogram[9] == 1);
+    assert(c.histogram[10] == 1);
+    assert(c.histogram[11] == 1);
+
+    {
+        stlite::Array<int, stlite::InstrumentedAllocator<int>> arr(10);
+    }
+
+    // The array has its own category
+    c = stats("Array<int, InstrumentedAllocator<int> >");
+    assert(c.allocations == 1);
+    assert(c.bytes_total == 10 * sizeof(int));
+    assert(c.bytes_live == 0);
+
+    c = stats("Vector<int, InstrumentedAllocator<int> >");
+    assert(c.allocations == 3);
+}
+
+void test_node_containers()
+{
+    typedef stlite::InstrumentedAllocator<int, OrderBook> Alloc;
+
+    stlite::ForwardList<int, Alloc> flst;
+    stlite::CircularList<int, Alloc> clst;
+    stlite::Set<int, Alloc> set;
+
+    for (int i = 0; i < 10; i++)
+    {
+        flst.push_front(i);
+        clst.push_back(i);
+        set.insert(i);
+    }
+
+    stlite::AllocationCounters c = stats("OrderBook");
+    assert(c.allocations == 30);
+    assert(c.deallocations == 0);
+    assert(c.bytes_live > 0);
+
+    flst.clear();
+    clst.clear();
+    set.clear();
+
+    c = stats("OrderBook");
+    assert(c.deallocations == 30);
+    assert(c.bytes_live == 0);
+    assert(c.peak_bytes == c.bytes_total);
+
+    // Without a tag each container counts under its node type
+    stlite::ForwardList<int, stlite::InstrumentedAllocator<int>> untagged;
+    untagged.push_front(1);
+    untagged.push_front(2);
+
+    stlite::AllocationCounters all[stlite::allocation_stats_max_categories];
+    unsigned n = stlite::AllocationStats::snapshot(all, stlite::allocation_stats_max_categories);
+    bool found = false;
+    for (unsigned i = 0; i < n; i++)
+        if (strstr(all[i].name, "ForwardList") && strstr(all[i].name, "Element"))
+        {
+            assert(all[i].allocations == 2);
+            assert(all[i].bytes_live == all[i].bytes_total);
+            found = true;
+        }
+    assert(found);
+}
+
+// The containers with variable-sized or shared nodes allocate all of them
+// through the allocator
+void test_other_containers()
+{
+    {
+        stlite::SkipList<int, stlite::Less<int>, stlite::InstrumentedAllocator<int>> list;
+        stlite::ConcurrentSkipList<int, stlite::Less<int>, stlite::InstrumentedAllocator<int>> clist;
+        stlite::RadixTree<int, stlite::InstrumentedAllocator<int>> tree;
+        stlite::PersistentVector<int, stlite::InstrumentedAllocator<int>> vec;
+
+        char key[8];
+        for (int i = 0; i < 100; i++)
+        {
+            list.insert(i);
+            clist.insert(i);
+            snprintf(key, sizeof(key), "k%d", i);
+            tree.insert(key, strlen(key), i);
+            vec = vec.push_back(i);
+        }
+        for (int i = 0; i < 50; i++)
+        {
+            list.erase(i);
+            clist.erase(i);
+            snprintf(key, sizeof(key), "k%d", i);
+            tree.erase(key, strlen(key));
+        }
+    }
+
+    // The keys of the radix tree are counted under its name
+    const char* names[] = {
+        "NodeBytes<SkipListNode<int> >",
+        "NodeBytes<ConcurrentSkipList<int, Less<int>, InstrumentedAllocator<int> >::Node>",
+        "RadixTree<int, InstrumentedAllocator<int> >",
+        "RadixTree<int, InstrumentedAllocator<int> >::Leaf",
+        "RadixTree<int, InstrumentedAllocator<int> >::Node4",
+        "RadixTree<int, InstrumentedAllocator<int> >::Node16",
+        "PersistentVector<int, InstrumentedAllocator<int> >::Leaf",
+        "PersistentVector<int, InstrumentedAllocator<int> >::Branch",
+    };
+    for (const char* name : names)
+    {
+        stlite::AllocationCounters c = stats(name);
+        assert(c.allocations > 0);
+        assert(c.allocations == c.deallocations);
+        assert(c.bytes_live == 0);
+    }
+}
+
+void test_reset_and_dump()
+{
+    stlite::ForwardList<int, stlite::InstrumentedAllocator<int, OrderBook>> lst;
+    lst.push_front(1);
+
+    stlite::AllocationStats::reset();
+
+    // The live bytes survive the reset
+    stlite::AllocationCounters c = stats("OrderBook");
+    assert(c.allocations == 0);
+    assert(c.bytes_total == 0);
+    assert(c.bytes_live > 0);
+    assert(c.peak_bytes == c.bytes_live);
+
+    lst.pop_front();
+    c = stats("OrderBook");
+    assert(c.deallocations == 1);
+    assert(c.bytes_live == 0);
+
+    char buffer[4096];
+    FILE* f = fmemopen(buffer, sizeof(buffer), "w");
+    stlite::AllocationStats::dump_json(f);
+    fclose(f);
+
+    assert(strncmp(buffer, "{\"categories\": [", 16) == 0);
+    assert(strstr(buffer, "{\"name\": \"OrderBook\", \"allocations\": 0, \"deallocations\": 1"));
+    assert(strstr(buffer, "{\"name\": \"Vector<int"));
+}
+
+int main()
+{
+    test_vector();
+    test_node_containers();
+    test_other_containers();
+    test_reset_and_dump();
+
+    return 0;
+}
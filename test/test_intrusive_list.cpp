@@ -0,0 +1,138 @@
+#include "../include/intrusive_list.h"
+
+#include <assert.h>
+#include <utility>
+
+struct Item
+{
+    int value = 0;
+    stlite::ForwardListHook fwd_hook;
+    stlite::ListHook hook;
+
+    Item() = default;
+    Item(int v) : value(v) {}
+};
+
+typedef stlite::IntrusiveForwardList<Item, &Item::fwd_hook> FwdList;
+typedef stlite::IntrusiveCircularList<Item, &Item::hook> CircList;
+
+void test_forward_list()
+{
+    Item items[5] = { 0, 1, 2, 3, 4 };
+    FwdList lst;
+
+    assert(lst.empty() == true);
+    assert(lst.size() == 0);
+
+    for (int i = 4; i >= 0; i--)
+        lst.push_front(items[i]);
+
+    assert(lst.size() == 5);
+    assert(&lst.front() == &items[0]);
+
+    int n = 0;
+    for (FwdList::Iterator it = lst.begin(); it != lst.end(); ++it)
+        assert(it->value == n++);
+
+    // Remove element in the middle
+    assert(lst.remove(items[2]) == true);
+    assert(lst.remove(items[2]) == false);
+    assert(lst.size() == 4);
+    assert(items[2].fwd_hook.next == nullptr);
+
+    // Insert it back after the second element
+    FwdList::Iterator it = lst.begin();
+    ++it;
+    lst.insert_after(it, items[2]);
+
+    n = 0;
+    for (it = lst.begin(); it != lst.end(); ++it)
+        assert((*it).value == n++);
+
+    lst.erase_after(lst.before_begin());
+    assert(lst.front().value == 1);
+    assert(lst.size() == 4);
+
+    lst.pop_front();
+    assert(lst.front().value == 2);
+
+    // Moving the list moves the links, not the objects
+    FwdList lst2(std::move(lst));
+    assert(lst.empty() == true);
+    assert(lst2.size() == 3);
+    assert(&lst2.front() == &items[2]);
+
+    lst2.clear();
+    assert(lst2.empty() == true);
+    assert(items[3].fwd_hook.next == nullptr);
+}
+
+void test_circular_list()
+{
+    Item items[5] = { 0, 1, 2, 3, 4 };
+    CircList lst;
+
+    assert(lst.empty() == true);
+    assert(lst.size() == 0);
+
+    lst.push_back(items[1]);
+    lst.push_back(items[2]);
+    lst.push_back(items[4]);
+    lst.push_front(items[0]);
+
+    assert(lst.size() == 4);
+    assert(lst.front().value == 0);
+    assert(lst.back().value == 4);
+
+    // Insert before items[4]
+    lst.insert(lst.iterator_to(items[4]), items[3]);
+
+    int n = 0;
+    for (CircList::Iterator it = lst.begin(); it != lst.end(); ++it)
+        assert(it->value == n++);
+
+    CircList::Iterator it = lst.end();
+    do
+    {
+        --it;
+        --n;
+        assert(it->value == n);
+    } while (it != lst.begin());
+
+    // Unlink by reference in O(1)
+    lst.erase(items[2]);
+    assert(items[2].hook.is_linked() == false);
+    assert(lst.size() == 4);
+
+    it = lst.erase(lst.iterator_to(items[1]));
+    assert(it->value == 3);
+    assert(lst.size() == 3);
+
+    lst.pop_front();
+    lst.pop_back();
+    assert(lst.size() == 1);
+    assert(lst.front().value == 3);
+    assert(lst.back().value == 3);
+
+    CircList lst2(std::move(lst));
+    assert(lst.empty() == true);
+    assert(lst2.size() == 1);
+    lst2.push_back(items[4]);
+    assert(lst2.back().value == 4);
+
+    lst2.clear();
+    assert(lst2.empty() == true);
+    assert(items[3].hook.is_linked() == false);
+    assert(items[4].hook.is_linked() == false);
+
+    assert(lst2.pop_front() == false);
+    assert(lst2.pop_back() == false);
+}
+
+int main()
+{
+    test_forward_list();
+    test_circular_list();
+
+    return 0;
+}
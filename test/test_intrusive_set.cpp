@@ -0,0 +1,109 @@
+#include "../include/intrusive_set.h"
+
+#include <assert.h>
+
+struct Item
+{
+    int value = 0;
+    stlite::SetHook hook;
+
+    Item() = default;
+    Item(int v) : value(v) {}
+
+    bool operator<(const Item& other) const { return value < other.value; }
+};
+
+typedef stlite::IntrusiveSet<Item, &Item::hook> ItemSet;
+
+static int check_tree(stlite::SetHook* n)
+{
+    if (!n)
+        return 0;
+
+    if (n->left)
+        assert(n->left->parent == n);
+    if (n->right)
+        assert(n->right->parent == n);
+
+    int hl = check_tree(n->left);
+    int hr = check_tree(n->right);
+
+    assert(hl - hr <= 1 && hr - hl <= 1);
+    assert(n->height == 1 + (hl > hr ? hl : hr));
+
+    return n->height;
+}
+
+int main()
+{
+    constexpr unsigned num = 1000;
+    static Item items[num];
+    ItemSet set;
+
+    assert(set.empty() == true);
+    assert(set.size() == 0);
+
+    // Insert in a scrambled order
+    for (unsigned i = 0; i < num; i++)
+    {
+        items[i].value = (i * 7919) % num;
+        assert(set.insert(items[i]) == true);
+    }
+
+    assert(set.size() == num);
+
+    // Find the root via any element
+    stlite::SetHook* root = &items[0].hook;
+    while (root->parent)
+        root = root->parent;
+
+    // AVL tree height with 1000 elements is at most 1.44 * log2(1000)
+    assert(check_tree(root) <= 14);
+
+    // Duplicates are rejected
+    Item dup(5);
+    assert(set.insert(dup) == false);
+    assert(dup.hook.is_linked() == false);
+
+    int n = 0;
+    for (ItemSet::Iterator it = set.begin(); it != set.end(); ++it)
+        assert(it->value == n++);
+    assert(n == num);
+
+    Item key(123);
+    assert(set.find(key) != nullptr);
+    assert(set.find(key)->value == 123);
+    assert(set.count(key) == 1);
+
+    // Erase every other element by reference
+    for (unsigned i = 0; i < num; i++)
+        if (items[i].value % 2 == 0)
+            set.erase(items[i]);
+
+    assert(set.size() == num / 2);
+    assert(set.count(key) == 1);
+    key.value = 124;
+    assert(set.count(key) == 0);
+
+    root = nullptr;
+    for (unsigned i = 0; i < num; i++)
+        if (items[i].hook.is_linked())
+            root = &items[i].hook;
+    while (root->parent)
+        root = root->parent;
+    check_tree(root);
+
+    n = 1;
+    for (ItemSet::Iterator it = set.begin(); it != set.end(); ++it)
+    {
+        assert(it->value == n);
+        n += 2;
+    }
+
+    set.clear();
+    assert(set.empty() == true);
+    assert(set.size() == 0);
+    assert(items[1].hook.is_linked() == false);
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../include/mapped_vector.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Record
+{
+    unsigned id;
+    float value;
+};
+
+static char path[] = "/tmp/test_mapped_vector.XXXXXX";
+
+static long file_size()
+{
+    struct stat st;
+    assert(stat(path, &st) == 0);
+    return st.st_size;
+}
+
+void test_create()
+{
+    stlite::MappedVector<Record> vec;
+    assert(!vec.is_open());
+    assert(vec.create(path));
+    assert(vec.is_open());
+    assert(vec.writable());
+    assert(vec.empty());
+
+    for (unsigned i = 0; i < 10000; i++)
+        assert(vec.push_back(Record{ i, i * 0.5f }));
+
+    assert(vec.size() == 10000);
+    assert(vec.capacity() >= 10000);
+    assert(vec[1234].id == 1234);
+    assert(vec.back().value == 9999 * 0.5f);
+
+    // The file grows in advance and is truncated on close
+    assert(file_size() >= (long) (vec.capacity() * sizeof(Record)));
+    assert(vec.sync());
+    assert(vec.close());
+    assert(file_size() == 10000 * sizeof(Record));
+}
+
+void test_open_read_only()
+{
+    stlite::MappedVector<Record> vec;
+    assert(vec.open(path));
+    assert(!vec.writable());
+    assert(vec.size() == 10000);
+
+    unsigned i = 0;
+    for (const Record& r : vec)
+    {
+        assert(r.id == i);
+        assert(r.value == i * 0.5f);
+        i++;
+    }
+    assert(i == 10000);
+
+    // Read-only vectors can't be modified
+    assert(!vec.push_back(Record{ 0, 0 }));
+    assert(!vec.resize(5));
+    assert(!vec.pop_back());
+    assert(!vec.clear());
+    assert(vec.size() == 10000);
+
+    // Moving transfers the mapping
+    stlite::MappedVector<Record> other(static_cast<stlite::MappedVector<Record>&&>(vec));
+    assert(!vec.is_open());
+    assert(other.size() == 10000);
+    assert(other.front().id == 0);
+}
+
+void test_open_writable()
+{
+    stlite::MappedVector<Record> vec;
+    assert(vec.open(path, true));
+
+    vec[0].value = 42;
+    assert(vec.pop_back());
+    assert(vec.resize(20000));
+    assert(vec[9999].id == 0 && vec[19999].id == 0);
+    assert(vec.resize(100));
+    assert(vec.close());
+    assert(file_size() == 100 * sizeof(Record));
+
+    assert(vec.open(path));
+    assert(vec.size() == 100);
+    assert(vec[0].value == 42);
+    assert(vec[99].id == 99);
+}
+
+void test_errors()
+{
+    stlite::MappedVector<Record> vec;
+    assert(!vec.open("/nonexistent/file"));
+    assert(!vec.is_open());
+
+    // The size of the file must be a multiple of the element size
+    FILE* f = fopen(path, "w");
+    fputs("abc", f);
+    fclose(f);
+    assert(!vec.open(path));
+
+    // An empty file is an empty vector
+    assert(vec.create(path));
+    assert(vec.close());
+    assert(vec.open(path));
+    assert(vec.empty());
+    assert(vec.begin() == vec.end());
+}
+
+int main()
+{
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    test_create();
+    test_open_read_only();
+    test_open_writable();
+    test_errors();
+
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,418 @@
+#include "../include/memory_resource.h"
+#include "../include/array.h"
+#include "../include/circular_list.h"
+#include "../include/cow_vector.h"
+#include "../include/forward_list.h"
+#include "../include/queue.h"
+#include "../include/set.h"
+#include "../include/stack.h"
+#include "../include/vector.h"
+
+#include <assert.h>
+
+// Upstream resource counting what is outstanding
+class CountingResource : public stlite::MemoryResource
+{
+public:
+    long blocks = 0;
+    long bytes = 0;
+
+protected:
+    void* do_allocate(unsigned long n, stlite::size_t align) override
+    {
+        blocks++;
+        bytes += n;
+        return stlite::new_delete_resource()->allocate(n, align);
+    }
+
+    void do_deallocate(void* p, unsigned long n, stlite::size_t align) override
+    {
+        blocks--;
+        bytes -= n;
+        stlite::new_delete_resource()->deallocate(p, n, align);
+    }
+};
+
+// Stateful allocator which goes along with the elements on assignment and
+// swap, allocators with different ids can't release each other's memory
+template <class T>
+struct TaggedAllocator
+{
+    static constexpr bool propagate_on_copy_assignment = true;
+    static constexpr bool propagate_on_move_assignment = true;
+    static constexpr bool propagate_on_swap = true;
+
+    int id = 0;
+
+    template <class U>
+    struct rebind
+    {
+        typedef TaggedAllocator<U> other;
+    };
+
+    TaggedAllocator() {}
+    TaggedAllocator(int i) : id(i) {}
+
+    template <class U>
+    TaggedAllocator(const TaggedAllocator<U>& other) : id(other.id)
+    {
+    }
+
+    T* allocate(stlite::size_t n) { return new T[n]; }
+    void deallocate(T* p, stlite::size_t) { delete[] p; }
+
+    template <class... Args>
+    T* construct(Args&&... args)
+    {
+        return new T(static_cast<Args&&>(args)...);
+    }
+
+    void destroy(T* p) { delete p; }
+
+    bool operator==(const TaggedAllocator& other) const { return id == other.id; }
+};
+
+typedef stlite::PolymorphicAllocator<int> IntAllocator;
+
+static bool aligned(const void* p, unsigned long alignment)
+{
+    return reinterpret_cast<unsigned long>(p) % alignment == 0;
+}
+
+void test_traits()
+{
+    typedef stlite::AllocatorTraits<stlite::Allocator<int>> Default;
+    static_assert(!Default::propagate_on_copy_assignment, "");
+    static_assert(!Default::propagate_on_move_assignment, "");
+    static_assert(!Default::propagate_on_swap, "");
+    assert(Default::equal(stlite::Allocator<int>(), stlite::Allocator<int>()));
+
+    typedef stlite::AllocatorTraits<TaggedAllocator<int>> Tagged;
+    static_assert(Tagged::propagate_on_copy_assignment, "");
+    static_assert(Tagged::propagate_on_move_assignment, "");
+    static_assert(Tagged::propagate_on_swap, "");
+    assert(Tagged::equal(TaggedAllocator<int>(1), TaggedAllocator<int>(1)));
+    assert(!Tagged::equal(TaggedAllocator<int>(1), TaggedAllocator<int>(2)));
+
+    // A copy of a container gets the default resource
+    stlite::MonotonicBufferResource arena;
+    IntAllocator alloc(&arena);
+    typedef stlite::AllocatorTraits<IntAllocator> Polymorphic;
+    static_assert(!Polymorphic::propagate_on_copy_assignment, "");
+    assert(Polymorphic::select_on_copy_construction(alloc).resource() == stlite::get_default_resource());
+    assert(!Polymorphic::equal(alloc, IntAllocator()));
+    assert(Polymorphic::equal(alloc, IntAllocator(&arena)));
+}
+
+void test_monotonic()
+{
+    CountingResource upstream;
+    {
+        char buffer[256];
+        stlite::MonotonicBufferResource arena(buffer, sizeof(buffer), &upstream);
+
+        // Carved from the buffer first
+        char* a = static_cast<char*>(arena.allocate(10, 1));
+        char* b = static_cast<char*>(arena.allocate(8, 8));
+        assert(a == buffer);
+        assert(b >= a + 10 && b < buffer + sizeof(buffer));
+        assert(aligned(b, 8));
+        assert(upstream.blocks == 0);
+
+        // Then from chunks of upstream, each twice as large
+        void* c = arena.allocate(1000, 64);
+        assert(aligned(c, 64));
+        assert(upstream.blocks == 1);
+        for (int i = 0; i < 100; i++)
+            assert(arena.allocate(100, 16));
+        assert(upstream.blocks > 1 && upstream.blocks < 6);
+
+        // Deallocation does nothing, release() returns the chunks
+        arena.deallocate(c, 1000, 64);
+        assert(upstream.blocks > 1);
+        arena.release();
+        assert(upstream.blocks == 0);
+        assert(arena.allocate(10, 1) == buffer);
+
+        arena.allocate(100000);
+        assert(upstream.blocks == 1);
+    }
+    assert(upstream.blocks == 0);
+    assert(upstream.bytes == 0);
+}
+
+void test_pool()
+{
+    CountingResource upstream;
+    {
+        stlite::PoolResource pool(&upstream, 1024);
+        assert(pool.largest_block() == 1024);
+
+        // Freed blocks are reused without going to upstream
+        void* a = pool.allocate(24);
+        assert(upstream.blocks == 1);
+        pool.deallocate(a, 24);
+        assert(pool.allocate(20) == a);
+
+        for (unsigned size = 1; size <= 1024; size *= 2)
+        {
+            void* p = pool.allocate(size, size < 64 ? size : 64);
+            assert(aligned(p, size < 64 ? size : 64));
+            pool.deallocate(p, size, size < 64 ? size : 64);
+        }
+
+        // Many blocks of one size take few chunks
+        void* blocks[1000];
+        long before = upstream.blocks;
+        for (int i = 0; i < 1000; i++)
+            blocks[i] = pool.allocate(40);
+        assert(upstream.blocks - before < 8);
+        for (int i = 0; i < 1000; i++)
+            pool.deallocate(blocks[i], 40);
+
+        // Larger blocks go to upstream directly
+        before = upstream.blocks;
+        void* big = pool.allocate(5000);
+        assert(upstream.blocks == before + 1);
+        pool.deallocate(big, 5000);
+        assert(upstream.blocks == before);
+
+        pool.release();
+        assert(upstream.blocks == 0);
+    }
+    assert(upstream.bytes == 0);
+}
+
+void test_default_resource()
+{
+    assert(stlite::get_default_resource() == stlite::new_delete_resource());
+
+    stlite::MonotonicBufferResource arena;
+    assert(stlite::set_default_resource(&arena) == stlite::new_delete_resource());
+    assert(IntAllocator().resource() == &arena);
+
+    assert(stlite::set_default_resource(nullptr) == &arena);
+    assert(stlite::get_default_resource() == stlite::new_delete_resource());
+}
+
+void test_containers()
+{
+    CountingResource upstream;
+    {
+        stlite::PoolResource pool(&upstream);
+        stlite::MonotonicBufferResource arena(&upstream);
+
+        stlite::Vector<int, IntAllocator> vec(&pool);
+        for (int i = 0; i < 500; i++)
+            vec.push_back(i);
+        assert(vec.get_allocator().resource() == &pool);
+        assert(upstream.blocks > 0);
+
+        stlite::Set<int, IntAllocator> set(&arena);
+        stlite::ForwardList<int, IntAllocator> flst(&arena);
+        stlite::CircularList<int, IntAllocator> clst(&arena);
+        for (int i = 0; i < 100; i++)
+        {
+            set.insert((i * 37) % 100);
+            flst.push_front(i);
+            clst.push_back(i);
+        }
+        assert(set.get_allocator().resource() == &arena);
+        assert(flst.get_allocator().resource() == &arena);
+        assert(clst.get_allocator().resource() == &arena);
+
+        // Copies use the default resource, or the given one
+        stlite::Set<int, IntAllocator> set_copy(set);
+        assert(set_copy.get_allocator().resource() == stlite::new_delete_resource());
+        assert(set_copy.size() == 100);
+        assert(set_copy.count(42) == 1);
+
+        stlite::ForwardList<int, IntAllocator> flst_copy(flst, &pool);
+        assert(flst_copy.get_allocator().resource() == &pool);
+        assert(flst_copy.front() == 99);
+
+        // Moves keep the resource
+        stlite::Vector<int, IntAllocator> moved(static_cast<stlite::Vector<int, IntAllocator>&&>(vec));
+        assert(moved.get_allocator().resource() == &pool);
+        assert(moved.size() == 500);
+        assert(vec.size() == 0);
+
+        // Assignment keeps the resource of the target, elements are moved
+        // into its memory when the resources differ
+        stlite::Vector<int, IntAllocator> other(&arena);
+        other = static_cast<stlite::Vector<int, IntAllocator>&&>(moved);
+        assert(other.get_allocator().resource() == &arena);
+        assert(other.size() == 500);
+        assert(other[499] == 499);
+
+        stlite::CircularList<int, IntAllocator> clst2(&pool);
+        clst2 = clst;
+        assert(clst2.get_allocator().resource() == &pool);
+        assert(clst2.size() == 100);
+        assert(clst2.front() == 0);
+
+        stlite::Array<int, IntAllocator> arr(10, 7, &pool);
+        stlite::Array<int, IntAllocator> arr2(&arena);
+        arr2 = arr;
+        assert(arr2.get_allocator().resource() == &arena);
+        assert(arr2[9] == 7);
+
+        // A shared buffer is released by the resource it came from
+        stlite::CowVector<int, IntAllocator> cow(&pool);
+        cow.push_back(1);
+        stlite::CowVector<int, IntAllocator> cow_copy(cow);
+        assert(cow_copy.use_count() == 2);
+        cow = stlite::CowVector<int, IntAllocator>(&arena);
+        assert(cow_copy.use_count() == 1);
+        assert(cow_copy[0] == 1);
+    }
+    assert(upstream.blocks == 0);
+}
+
+// The adaptors pass their allocator to the container they wrap
+void test_adaptors()
+{
+    CountingResource upstream;
+    {
+        stlite::PoolResource pool(&upstream);
+        stlite::MonotonicBufferResource arena(&upstream);
+
+        stlite::Stack<int, IntAllocator> stack(&pool);
+        stlite::Queue<int, IntAllocator> queue(&pool);
+        for (int i = 0; i < 100; i++)
+        {
+            stack.push(i);
+            queue.push(i);
+        }
+        assert(stack.get_allocator().resource() == &pool);
+        assert(queue.get_allocator().resource() == &pool);
+
+        stlite::Stack<int, IntAllocator> stack_copy(stack, &arena);
+        assert(stack_copy.get_allocator().resource() == &arena);
+        assert(stack_copy.size() == 100 && stack_copy.top() == 99);
+
+        stlite::Queue<int, IntAllocator> queue_copy(queue, &arena);
+        assert(queue_copy.get_allocator().resource() == &arena);
+        assert(queue_copy.size() == 100 && queue_copy.front() == 0);
+
+        // The elements are moved into the memory of the other resource
+        stlite::Stack<int, IntAllocator> stack_moved(static_cast<stlite::Stack<int, IntAllocator>&&>(stack),
+                                                     &arena);
+        assert(stack_moved.get_allocator().resource() == &arena);
+        assert(stack_moved.size() == 100 && stack_moved.top() == 99);
+
+        stlite::Queue<int, IntAllocator> queue_moved(static_cast<stlite::Queue<int, IntAllocator>&&>(queue),
+                                                     &arena);
+        assert(queue_moved.get_allocator().resource() == &arena);
+        assert(queue_moved.size() == 100 && queue_moved.back() == 99);
+
+        stack_moved.pop();
+        queue_moved.pop();
+        assert(stack_moved.top() == 98);
+        assert(queue_moved.front() == 1);
+    }
+    assert(upstream.blocks == 0);
+}
+
+// Nodes are not relinked between lists whose resources differ, the lists
+// must stay valid after the resource of the source is gone
+void test_splice()
+{
+    stlite::PoolResource target;
+    stlite::CircularList<int, IntAllocator> clst(&target);
+    stlite::ForwardList<int, IntAllocator> flst(&target);
+    clst.push_back(1);
+    flst.push_front(1);
+
+    {
+        stlite::PoolResource source;
+        stlite::CircularList<int, IntAllocator> c1(&source), c2(&source), c3(&source);
+        stlite::ForwardList<int, IntAllocator> f1(&source), f2(&source), f3(&source);
+        c1.push_back(2);
+        c2.push_back(0);
+        c3.push_back(3);
+        f1.push_front(0);
+        f2.push_front(3);
+        f3.push_front(2);
+
+        clst.splice(c1);
+        clst.splice(clst.begin(), c2);
+        clst.merge(c3);
+        flst.splice_front(f1);
+        flst.splice_after(flst.begin(), f2);
+        flst.merge(f3);
+
+        assert(c1.empty() && c2.empty() && c3.empty());
+        assert(f1.empty() && f2.empty() && f3.empty());
+        source.release();
+    }
+
+    assert(clst.size() == 4);
+    int expected = 0;
+    clst.for_each([&](int v) { assert(v == expected++); });
+    assert(clst.front() == 0);
+
+    // 0 3 1 merged with 2
+    int fexpected[] = { 0, 2, 3, 1 };
+    int i = 0;
+    flst.for_each([&](int v) { assert(v == fexpected[i++]); });
+    assert(i == 4);
+}
+
+void test_propagation()
+{
+    typedef TaggedAllocator<int> Tagged;
+
+    stlite::Vector<int, Tagged> a(Tagged(1));
+    stlite::Vector<int, Tagged> b(Tagged(2));
+    a.push_back(1);
+    b = a;
+    assert(b.get_allocator().id == 1);
+    assert(b[0] == 1);
+
+    stlite::Vector<int, Tagged> c(Tagged(3));
+    c = static_cast<stlite::Vector<int, Tagged>&&>(b);
+    assert(c.get_allocator().id == 1);
+
+    stlite::Vector<int, Tagged> d(Tagged(4));
+    d.swap(c);
+    assert(d.get_allocator().id == 1);
+    assert(c.get_allocator().id == 4);
+    assert(d[0] == 1);
+
+    stlite::Set<int, Tagged> s1(Tagged(5));
+    stlite::Set<int, Tagged> s2(Tagged(6));
+    s1.insert(3);
+    s2 = s1;
+    assert(s2.get_allocator().id == 5);
+    assert(s2.count(3) == 1);
+    s2.swap(s1);
+    assert(s1.get_allocator().id == 5);
+
+    stlite::ForwardList<int, Tagged> f1(Tagged(7));
+    stlite::ForwardList<int, Tagged> f2(Tagged(8));
+    f1.push_front(1);
+    f2 = static_cast<stlite::ForwardList<int, Tagged>&&>(f1);
+    assert(f2.get_allocator().id == 7);
+    assert(f1.empty());
+    assert(f2.front() == 1);
+
+    // Unequal allocators without propagation on the move constructor
+    stlite::ForwardList<int, Tagged> f3(static_cast<stlite::ForwardList<int, Tagged>&&>(f2), Tagged(9));
+    assert(f3.get_allocator().id == 9);
+    assert(f3.front() == 1);
+    assert(f2.empty());
+}
+
+int main()
+{
+    test_traits();
+    test_monotonic();
+    test_pool();
+    test_default_resource();
+    test_containers();
+    test_splice();
+    test_adaptors();
+    test_propagation();
+    return 0;
+}
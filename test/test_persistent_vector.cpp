@@ -0,0 +1,148 @@
+#include "../include/persistent_vector.h"
+
+#include <assert.h>
+
+typedef stlite::PersistentVector<unsigned> PVec;
+
+void test_push_back()
+{
+    PVec empty;
+
+    assert(empty.empty() == true);
+    assert(empty.size() == 0);
+
+    PVec v1 = empty.push_back(1);
+    PVec v2 = v1.push_back(2);
+
+    // Older versions are not modified
+    assert(empty.size() == 0);
+    assert(v1.size() == 1);
+    assert(v1[0] == 1);
+    assert(v2.size() == 2);
+    assert(v2.front() == 1);
+    assert(v2.back() == 2);
+
+    // Enough elements for a trie with three levels of branches
+    constexpr unsigned num = 40000;
+    PVec v;
+    for (unsigned i = 0; i < num; i++)
+    {
+        v = v.push_back(i);
+        assert(v.back() == i);
+    }
+
+    assert(v.size() == num);
+    for (unsigned i = 0; i < num; i++)
+        assert(v[i] == i);
+
+    unsigned n = 0;
+    for (PVec::Iterator it = v.begin(); it != v.end(); ++it)
+        assert(*it == n++);
+    assert(n == num);
+}
+
+void test_set()
+{
+    constexpr unsigned num = 5000;
+    PVec v;
+    for (unsigned i = 0; i < num; i++)
+        v = v.push_back(i);
+
+    // Snapshot is O(1) and shares all nodes
+    PVec snapshot(v);
+
+    PVec v2 = v.set(0, 100).set(1234, 101).set(num - 1, 102);
+
+    assert(v2[0] == 100);
+    assert(v2[1234] == 101);
+    assert(v2[num - 1] == 102);
+    assert(v2[1] == 1);
+    assert(v2[1235] == 1235);
+
+    for (unsigned i = 0; i < num; i++)
+    {
+        assert(v[i] == i);
+        assert(snapshot[i] == i);
+    }
+}
+
+void test_pop_back()
+{
+    constexpr unsigned num = 35000;
+    PVec v;
+    for (unsigned i = 0; i < num; i++)
+        v = v.push_back(i);
+
+    PVec full(v);
+
+    while (!v.empty())
+    {
+        v = v.pop_back();
+        if (!v.empty())
+            assert(v.back() == v.size() - 1);
+    }
+
+    assert(v.size() == 0);
+    assert(full.size() == num);
+    assert(full[num - 1] == num - 1);
+
+    // Shrunk vector can grow again
+    PVec w = full;
+    for (unsigned i = 0; i < 2000; i++)
+        w = w.pop_back();
+    for (unsigned i = 0; i < 3000; i++)
+        w = w.push_back(i);
+
+    assert(w.size() == num + 1000);
+    assert(w[num - 2001] == num - 2001);
+    assert(w[num - 2000] == 0);
+    assert(w.back() == 2999);
+    assert(full[num - 2000] == num - 2000);
+}
+
+void test_transient()
+{
+    PVec base;
+    for (unsigned i = 0; i < 100; i++)
+        base = base.push_back(i);
+
+    stlite::TransientVector<unsigned> t = base.transient();
+    for (unsigned i = 100; i < 10000; i++)
+        t.push_back(i);
+    t.set(5, 555);
+    t.pop_back();
+
+    PVec built = t.persistent();
+
+    assert(built.size() == 9999);
+    assert(built[5] == 555);
+    assert(built[9998] == 9998);
+
+    // The base vector is not modified
+    assert(base.size() == 100);
+    assert(base[5] == 5);
+
+    // Modifying the transient later doesn't change the built vector
+    t.set(6, 666);
+    assert(t[6] == 666);
+    assert(built[6] == 6);
+}
+
+int main()
+{
+    test_push_back();
+    test_set();
+    test_pop_back();
+    test_transient();
+
+    unsigned arr[5] = { 44, 55, 66, 77, 88 };
+    PVec v(arr, 5);
+    assert(v.size() == 5);
+    assert(v.at(2) == 66);
+
+    PVec v2({ 1, 2, 3 });
+    assert(v2.size() == 3);
+    assert(v2.back() == 3);
+
+    return 0;
+}
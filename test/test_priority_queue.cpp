@@ -0,0 +1,123 @@
+#include "../include/priority_queue.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+template <unsigned Arity>
+void test_arity()
+{
+    stlite::PriorityQueue<int, stlite::Less<int>, Arity> queue;
+
+    assert(queue.empty() == true);
+    assert(queue.pop() == false);
+
+    std::vector<int> ref;
+    for (int i = 0; i < 1000; i++)
+    {
+        int x = rand() % 500;
+        queue.push(x);
+        ref.push_back(x);
+    }
+    assert(queue.size() == 1000);
+
+    // Largest first
+    std::sort(ref.begin(), ref.end());
+    for (int i = 999; i >= 0; i--)
+    {
+        assert(queue.top() == ref[i]);
+        assert(queue.pop() == true);
+    }
+    assert(queue.empty() == true);
+}
+
+void test_heapify()
+{
+    int arr[] = { 5, 1, 9, 3, 7, 2, 8 };
+    stlite::PriorityQueue<int, stlite::Greater<int>> queue(arr, arr + 7);
+
+    // Smallest first with Greater
+    int expected[] = { 1, 2, 3, 5, 7, 8, 9 };
+    for (int x : expected)
+    {
+        assert(queue.top() == x);
+        queue.pop();
+    }
+
+    stlite::Vector<std::string> words({ "pear", "apple", "fig" });
+    stlite::PriorityQueue<std::string, stlite::Less<std::string>, 2> strings(words.begin(), words.end());
+    strings.reserve(10);
+    strings.push("zucchini");
+    assert(strings.top() == "zucchini");
+    strings.pop();
+    assert(strings.top() == "pear");
+    strings.clear();
+    assert(strings.empty() == true);
+}
+
+void test_indexed()
+{
+    const unsigned n = 500;
+    stlite::IndexedPriorityQueue<int, stlite::Greater<int>> queue(n);
+    std::vector<int> prio(n);
+
+    assert(queue.max_keys() == n);
+    for (unsigned k = 0; k < n; k++)
+    {
+        prio[k] = rand() % 1000;
+        assert(queue.push(k, prio[k]) == true);
+    }
+    assert(queue.push(3, 0) == false);
+    assert(queue.size() == n);
+
+    // Change the priorities in both directions and erase some keys
+    for (unsigned k = 0; k < n; k += 3)
+    {
+        prio[k] = rand() % 1000;
+        queue.update(k, prio[k]);
+        assert(queue.priority(k) == prio[k]);
+    }
+    for (unsigned k = 1; k < n; k += 7)
+    {
+        assert(queue.erase(k) == true);
+        prio[k] = -1;
+    }
+    assert(queue.contains(1) == false);
+    assert(queue.erase(1) == false);
+
+    // Keys come out in the order of their priorities
+    int last = -1;
+    unsigned popped = 0;
+    while (!queue.empty())
+    {
+        unsigned k = queue.top_key();
+        assert(queue.top_priority() == prio[k]);
+        assert(prio[k] >= last);
+        last = prio[k];
+        assert(queue.pop() == true);
+        assert(queue.contains(k) == false);
+        popped++;
+    }
+    assert(popped == n - (n + 5) / 7);
+
+    queue.push_or_update(7, 10);
+    queue.push_or_update(7, 5);
+    queue.push_or_update(8, 6);
+    assert(queue.top_key() == 7 && queue.top_priority() == 5);
+    queue.clear();
+    assert(queue.empty() == true && queue.contains(7) == false);
+}
+
+int main()
+{
+    test_arity<2>();
+    test_arity<3>();
+    test_arity<4>();
+    test_arity<8>();
+    test_heapify();
+    test_indexed();
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "../include/radix_tree.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef stlite::RadixTree<int> Tree;
+
+std::vector<std::string> keys_of(const Tree& tree)
+{
+    std::vector<std::string> keys;
+    tree.for_each([&](const char* key, size_t len, const int&) { keys.push_back(std::string(key, len)); });
+    return keys;
+}
+
+void test_basic()
+{
+    Tree tree;
+
+    assert(tree.empty() == true);
+    assert(tree.size() == 0);
+    assert(tree.find("a") == nullptr);
+
+    assert(tree.insert("apple", 1) == true);
+    assert(tree.insert("apply", 2) == true);
+    assert(tree.insert("app", 3) == true);
+    assert(tree.insert("", 4) == true);
+    assert(tree.insert("banana", 5) == true);
+    assert(tree.insert("apple", 6) == false);
+
+    assert(tree.size() == 5);
+    assert(*tree.find("apple") == 1);
+    assert(*tree.find("app") == 3);
+    assert(*tree.find("") == 4);
+    assert(tree.find("ap") == nullptr);
+    assert(tree.find("apples") == nullptr);
+    assert(tree.contains("banana") == true);
+    assert(tree.contains("band") == false);
+
+    *tree.find("apply") = 20;
+    assert(*tree.find("apply") == 20);
+
+    // Keys with zero bytes
+    assert(tree.insert(std::string("a\0b", 3), 7) == true);
+    assert(*tree.find(std::string("a\0b", 3)) == 7);
+    assert(tree.find("a") == nullptr);
+
+    std::vector<std::string> expected = { "", std::string("a\0b", 3), "app", "apple", "apply", "banana" };
+    assert(keys_of(tree) == expected);
+
+    assert(tree.erase("app") == true);
+    assert(tree.erase("app") == false);
+    assert(tree.erase("zzz") == false);
+    assert(tree.find("app") == nullptr);
+    assert(*tree.find("apple") == 1);
+    assert(tree.size() == 5);
+
+    tree.clear();
+    assert(tree.empty() == true);
+    assert(tree.find("apple") == nullptr);
+}
+
+void test_prefixes()
+{
+    Tree routes;
+    routes.insert("/", 0);
+    routes.insert("/api/", 1);
+    routes.insert("/api/users/", 2);
+    routes.insert("/api/users/admin", 3);
+    routes.insert("/static/", 4);
+
+    stlite::size_t len = 0;
+    assert(*routes.longest_prefix("/api/users/42", &len) == 2);
+    assert(len == 11);
+    assert(*routes.longest_prefix("/api/users/admin/x") == 3);
+    assert(*routes.longest_prefix("/api/user") == 1);
+    assert(*routes.longest_prefix("/index.html", &len) == 0 && len == 1);
+    assert(*routes.longest_prefix("/static/") == 4);
+    assert(routes.longest_prefix("api") == nullptr);
+
+    std::vector<std::string> found;
+    routes.for_each_prefix("/api/u", [&](const char* key, size_t n, const int&) {
+        found.push_back(std::string(key, n));
+    });
+    std::vector<std::string> expected = { "/api/users/", "/api/users/admin" };
+    assert(found == expected);
+
+    found.clear();
+    routes.for_each_prefix("", [&](const char* key, size_t n, const int&) {
+        found.push_back(std::string(key, n));
+    });
+    assert(found.size() == 5);
+
+    found.clear();
+    routes.for_each_prefix("/x", [&](const char* key, size_t n, const int&) {
+        found.push_back(std::string(key, n));
+    });
+    assert(found.empty());
+
+    // Prefixes longer than the ones stored in the nodes
+    Tree tree;
+    std::string base(40, 'x');
+    tree.insert(base + "a", 1);
+    tree.insert(base + "b", 2);
+    tree.insert(base.substr(0, 25), 3);
+    assert(*tree.longest_prefix(base + "bc") == 2);
+    assert(*tree.longest_prefix(base) == 3);
+    assert(tree.longest_prefix(base.substr(0, 24)) == nullptr);
+    assert(tree.find(base.substr(0, 30) + "y" + base.substr(31) + "a") == nullptr);
+    assert(tree.insert(base.substr(0, 30) + "y", 4) == true);
+    assert(*tree.find(base + "a") == 1 && *tree.find(base.substr(0, 30) + "y") == 4);
+
+    int count = 0;
+    tree.for_each_prefix(base.substr(0, 28), [&](const char*, size_t, const int&) { count++; });
+    assert(count == 3);
+}
+
+// Random keys against std::map, with enough keys per byte to use all the
+// node types, and erasing everything to shrink them again
+void test_random()
+{
+    Tree tree;
+    std::map<std::string, int> reference;
+
+    srand(1);
+    for (int i = 0; i < 20000; i++)
+    {
+        std::string key;
+        int n = rand() % 6;
+        for (int j = 0; j < n; j++)
+            key += (char) (j == 0 ? rand() % 256 : 'a' + rand() % 20);
+
+        bool inserted = reference.insert(std::make_pair(key, i)).second;
+        assert(tree.insert(key, i) == inserted);
+    }
+    assert(tree.size() == reference.size());
+
+    std::vector<std::string> expected;
+    for (auto& kv : reference)
+    {
+        expected.push_back(kv.first);
+        assert(*tree.find(kv.first) == kv.second);
+    }
+
+    // Unsigned byte order, like std::string comparison
+    assert(keys_of(tree) == expected);
+
+    int i = 0;
+    for (auto it = reference.begin(); it != reference.end(); i++)
+    {
+        if (i % 3 == 0)
+        {
+            it++;
+            continue;
+        }
+        assert(tree.erase(it->first) == true);
+        it = reference.erase(it);
+    }
+    assert(tree.size() == reference.size());
+    for (auto& kv : reference)
+        assert(*tree.find(kv.first) == kv.second);
+
+    for (auto& kv : reference)
+        assert(tree.erase(kv.first) == true);
+    assert(tree.empty() == true);
+    assert(keys_of(tree).empty());
+
+    tree.insert("again", 1);
+    assert(*tree.find("again") == 1);
+}
+
+void test_move()
+{
+    Tree tree;
+    tree.insert("one", 1);
+    tree.insert("two", 2);
+
+    Tree moved(static_cast<Tree&&>(tree));
+    assert(tree.size() == 0);
+    assert(moved.size() == 2 && *moved.find("two") == 2);
+
+    tree = static_cast<Tree&&>(moved);
+    assert(tree.size() == 2 && *tree.find("one") == 1);
+    assert(moved.empty() == true);
+}
+
+int main()
+{
+    test_basic();
+    test_prefixes();
+    test_random();
+    test_move();
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include "../include/memory_resource.h"
+#include "../include/serialization.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct Point
+{
+    int x;
+    int y;
+    double weight;
+};
+
+static char path[] = "/tmp/test_serialization.XXXXXX";
+
+void test_checksum()
+{
+    char data[1000];
+    for (unsigned i = 0; i < sizeof(data); i++)
+        data[i] = i * 7;
+
+    // The checksum doesn't depend on how the stream is split
+    unsigned long long whole = stlite::serial_checksum(data, sizeof(data));
+    stlite::SerialChecksum c;
+    c.update(data, 5);
+    c.update(data + 5, 100);
+    c.update(data + 105, 0);
+    c.update(data + 105, sizeof(data) - 105);
+    assert(c.value() == whole);
+
+    data[500] ^= 1;
+    assert(stlite::serial_checksum(data, sizeof(data)) != whole);
+    assert(stlite::serial_checksum(data, 0) != stlite::serial_checksum(data, 1));
+}
+
+void test_vector()
+{
+    stlite::Vector<Point> vec;
+    for (int i = 0; i < 1000; i++)
+        vec.push_back(Point{ i, -i, i * 0.25 });
+
+    assert(stlite::save(path, vec));
+
+    stlite::Vector<Point> loaded;
+    assert(stlite::load(path, loaded));
+    assert(loaded.size() == 1000);
+    for (int i = 0; i < 1000; i++)
+        assert(loaded[i].x == i && loaded[i].y == -i && loaded[i].weight == i * 0.25);
+
+    // The same format is readable as an array and as a view
+    stlite::Array<Point> arr;
+    assert(stlite::load(path, arr));
+    assert(arr.size() == 1000);
+    assert(arr[999].x == 999);
+
+    stlite::SerialView<Point> view;
+    assert(view.open(path, true));
+    assert(view.size() == 1000);
+    assert(view[10].y == -10);
+    int sum = 0;
+    for (const Point& p : view)
+        sum += p.x;
+    assert(sum == 999 * 1000 / 2);
+    view.close();
+    assert(!view.is_open());
+
+    // Empty containers
+    stlite::Vector<Point> empty;
+    assert(stlite::save(path, empty));
+    assert(stlite::load(path, loaded));
+    assert(loaded.empty());
+    assert(view.open(path));
+    assert(view.empty());
+}
+
+void test_invalid()
+{
+    stlite::Vector<int> vec;
+    for (int i = 0; i < 100; i++)
+        vec.push_back(i);
+    assert(stlite::save(path, vec));
+
+    // Wrong element size
+    stlite::Vector<long> longs;
+    assert(!stlite::load(path, longs));
+    stlite::SerialView<short> shorts;
+    assert(!shorts.open(path));
+
+    // Corrupted element, detected by the checksum
+    int fd = open(path, O_WRONLY);
+    assert(pwrite(fd, "x", 1, sizeof(stlite::SerialHeader) + 40) == 1);
+    close(fd);
+
+    stlite::Vector<int> loaded;
+    loaded.push_back(7);
+    assert(!stlite::load(path, loaded));
+    assert(loaded.size() == 1 && loaded[0] == 7);
+
+    stlite::SerialView<int> view;
+    assert(view.open(path));
+    assert(!view.open(path, true));
+
+    // Count larger than the file, rejected before allocating the elements
+    stlite::SerialHeader h;
+    fd = open(path, O_RDWR);
+    assert(pread(fd, &h, sizeof(h), 0) == sizeof(h));
+    h.count = 1000000000;
+    assert(pwrite(fd, &h, sizeof(h), 0) == sizeof(h));
+    close(fd);
+    assert(!stlite::load(path, loaded));
+    assert(loaded.size() == 1 && loaded[0] == 7);
+    assert(!view.open(path));
+
+    // Truncated file
+    assert(truncate(path, sizeof(stlite::SerialHeader) + 10) == 0);
+    assert(!stlite::load(path, loaded));
+    assert(!view.open(path));
+
+    assert(!stlite::load("/nonexistent/file", loaded));
+}
+
+void test_lists_and_set()
+{
+    stlite::ForwardList<int> flst;
+    stlite::CircularList<int> clst;
+    stlite::Set<int> set;
+
+    // More elements than the stream buffer holds
+    for (int i = 0; i < 50000; i++)
+    {
+        flst.push_front(i);
+        clst.push_back(i);
+        set.insert((i * 7919) % 50000);
+    }
+
+    assert(stlite::save(path, flst));
+    stlite::ForwardList<int> flst2;
+    assert(stlite::load(path, flst2));
+    int expected = 49999;
+    flst2.for_each([&](int v) { assert(v == expected--); });
+    assert(expected == -1);
+
+    assert(stlite::save(path, clst));
+    stlite::CircularList<int> clst2;
+    assert(stlite::load(path, clst2));
+    assert(clst2.size() == 50000);
+    expected = 0;
+    clst2.for_each([&](int v) { assert(v == expected++); });
+
+    // The set is stored in order
+    assert(stlite::save(path, set));
+    stlite::SerialView<int> view;
+    assert(view.open(path, true));
+    assert(view.size() == 50000);
+    for (int i = 0; i < 50000; i++)
+        assert(view[i] == i);
+    view.close();
+
+    stlite::Set<int> set2;
+    assert(stlite::load(path, set2));
+    assert(set2.size() == 50000);
+    assert(set2.count(0) == 1 && set2.count(49999) == 1 && set2.count(50000) == 0);
+    expected = 0;
+    set2.for_each([&](int v) { assert(v == expected++); });
+
+    // A list file can be loaded into a vector
+    stlite::Vector<int> vec;
+    assert(stlite::load(path, vec));
+    assert(vec.size() == 50000 && vec[123] == 123);
+}
+
+// Resource counting its allocations
+class CountingResource : public stlite::MemoryResource
+{
+public:
+    long blocks = 0;
+
+protected:
+    void* do_allocate(unsigned long n, stlite::size_t align) override
+    {
+        blocks++;
+        return stlite::new_delete_resource()->allocate(n, align);
+    }
+
+    void do_deallocate(void* p, unsigned long n, stlite::size_t align) override
+    {
+        stlite::new_delete_resource()->deallocate(p, n, align);
+    }
+};
+
+void test_allocator()
+{
+    stlite::Vector<int> values;
+    for (int i = 0; i < 1000; i++)
+        values.push_back(i);
+    assert(stlite::save(path, values));
+
+    // The containers are loaded with their own allocator, nothing comes from
+    // the default resource
+    CountingResource own;
+    CountingResource fallback;
+    stlite::MemoryResource* previous = stlite::set_default_resource(&fallback);
+    {
+        stlite::PolymorphicAllocator<int> alloc(&own);
+        stlite::Vector<int, stlite::PolymorphicAllocator<int>> vec(alloc);
+        stlite::ForwardList<int, stlite::PolymorphicAllocator<int>> flst(alloc);
+        stlite::CircularList<int, stlite::PolymorphicAllocator<int>> clst(alloc);
+        stlite::Set<int, stlite::PolymorphicAllocator<int>> set(alloc);
+
+        assert(stlite::load(path, vec) && vec.size() == 1000);
+        assert(stlite::load(path, flst) && flst.front() == 0);
+        assert(stlite::load(path, clst) && clst.size() == 1000);
+        assert(stlite::load(path, set) && set.size() == 1000);
+    }
+    stlite::set_default_resource(previous);
+    assert(own.blocks > 0);
+    assert(fallback.blocks == 0);
+}
+
+int main()
+{
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    test_checksum();
+    test_vector();
+    test_invalid();
+    test_lists_and_set();
+    test_allocator();
+
+    unlink(path);
+    return 0;
+}
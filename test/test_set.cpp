@@ -22,6 +22,10 @@ int main()
     assert(set.empty() == false);
     assert(set.size() == 7);
 
+    assert(set.count(3) == 1);
+    assert(set.count(-1) == 1);
+    assert(set.count(6) == 0);
+
     set.clear();
 
     assert(set.empty() == true);
@@ -31,5 +35,26 @@ int main()
     int arr1[arr1_size] = { 7, 1, 3, 2, 5, 4, 6 };
     stlite::Set<int> set2(arr1, arr1_size);
 
+    assert(set2.size() == 7);
+    assert(set2.count(5) == 1);
+
+    int expected = 1;
+    set2.for_each([&](int v) { assert(v == expected++); });
+    assert(expected == 8);
+
+    // Copies are deep
+    stlite::Set<int> set3(set2);
+    set2.clear();
+    assert(set3.size() == 7);
+    assert(set3.count(7) == 1);
+
+    set = set3;
+    set3.insert(8);
+    assert(set.size() == 7);
+    assert(set.count(8) == 0);
+    expected = 1;
+    set.for_each([&](int v) { assert(v == expected++); });
+    assert(expected == 8);
+
     return 0;
 }
@@ -0,0 +1,117 @@
+#include "../include/simd_algorithms.h"
+#include "../include/array.h"
+#include "../include/vector.h"
+
+#include <string>
+#include <iostream>
+#include <assert.h>
+#include <algorithm>
+#include <stdlib.h>
+
+namespace simd = stlite::simd;
+
+// Sizes around the vector widths and the unrolled loop lengths
+static const unsigned sizes[] = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000 };
+
+template <class T>
+void check_range(const T* first, const T* last)
+{
+    ptrdiff_t n = last - first;
+
+    for (ptrdiff_t i = 0; i < n; i += 1 + n / 50)
+    {
+        T value = first[i];
+        assert(simd::find(first, last, value) == std::find(first, last, value));
+        assert(simd::count(first, last, value) == std::count(first, last, value));
+    }
+    assert(simd::find(first, last, T(-12345)) == last);
+    assert(simd::count(first, last, T(-12345)) == 0);
+
+    assert(simd::min_element(first, last) == std::min_element(first, last));
+    assert(simd::max_element(first, last) == std::max_element(first, last));
+}
+
+void test_int()
+{
+    for (unsigned n : sizes)
+    {
+        // Small value range, so there are many duplicates of the minimum and
+        // maximum and the first one must be returned
+        stlite::Vector<int> vec(n + 3);
+        for (unsigned i = 0; i < n + 3; i++)
+            vec[i] = rand() % 16 - 8;
+
+        // Unaligned starts
+        for (unsigned offset = 0; offset < 3; offset++)
+            check_range(vec.data() + offset, vec.data() + offset + n);
+
+        long long sum = 0;
+        for (unsigned i = 0; i < n; i++)
+            sum += vec[i];
+        assert(simd::sum(vec.begin(), vec.begin() + n) == sum);
+    }
+
+    // The sum doesn't overflow
+    stlite::Vector<int> big(1000, 2000000000);
+    assert(simd::sum(big.begin(), big.end()) == 2000000000000LL);
+
+    big[999] = -2147483647 - 1;
+    assert(simd::min_element(big.begin(), big.end()) == big.begin() + 999);
+    assert(simd::max_element(big.begin(), big.end()) == big.begin());
+}
+
+void test_float()
+{
+    for (unsigned n : sizes)
+    {
+        stlite::Array<float> arr(n + 3);
+        for (unsigned i = 0; i < n + 3; i++)
+            arr[i] = (rand() % 64) * 0.25f;
+
+        for (unsigned offset = 0; offset < 3; offset++)
+            check_range(arr.data() + offset, arr.data() + offset + n);
+
+        // Small integers are exact in float, so the order of the additions
+        // doesn't matter
+        float sum = 0;
+        for (unsigned i = 0; i < n; i++)
+            sum += arr[i];
+        assert(simd::sum(arr.begin(), arr.begin() + n) == sum);
+    }
+
+    // NaN is never equal
+    stlite::Array<float> nan(20, 1.0f);
+    nan[5] = __builtin_nanf("");
+    assert(simd::find(nan.begin(), nan.end(), __builtin_nanf("")) == nan.end());
+    assert(simd::count(nan.begin(), nan.end(), 1.0f) == 19);
+}
+
+void test_containers()
+{
+    stlite::Vector<int> vec({ 4, 8, 15, 16, 23, 42 });
+    const stlite::Vector<int>& cvec = vec;
+
+    assert(simd::find(vec.begin(), vec.end(), 23) == vec.begin() + 4);
+    assert(simd::find(cvec.begin(), cvec.end(), 5) == cvec.end());
+    assert(*simd::max_element(cvec.begin(), cvec.end()) == 42);
+    assert(simd::sum(cvec.cbegin(), cvec.cend()) == 108);
+}
+
+int main()
+{
+    for (int l = simd::scalar; l <= simd::detected_level(); l++)
+    {
+        simd::set_level(static_cast<simd::Level>(l));
+        assert(simd::level() == l);
+
+        test_int();
+        test_float();
+        test_containers();
+    }
+
+    // The level can't be raised above the detected one
+    simd::set_level(simd::avx2);
+    assert(simd::level() == simd::detected_level());
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "../include/skip_list.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <set>
+#include <string>
+
+void test_basic()
+{
+    stlite::SkipList<int> list;
+
+    assert(list.empty() == true);
+    assert(list.size() == 0);
+    assert(list.begin() == list.end());
+
+    assert(list.insert(5) == true);
+    assert(list.insert(1) == true);
+    assert(list.insert(3) == true);
+    assert(list.insert(3) == false);
+
+    assert(list.empty() == false);
+    assert(list.size() == 3);
+    assert(list.count(3) == 1);
+    assert(list.count(4) == 0);
+    assert(*list.find(5) == 5);
+    assert(list.find(2) == list.end());
+    assert(*list.lower_bound(2) == 3);
+    assert(list.lower_bound(6) == list.end());
+
+    int expected[] = { 1, 3, 5 };
+    int i = 0;
+    for (int x : list)
+        assert(x == expected[i++]);
+    assert(i == 3);
+
+    assert(list.erase(3) == true);
+    assert(list.erase(3) == false);
+    assert(list.size() == 2);
+    assert(list.count(3) == 0);
+
+    list.clear();
+    assert(list.empty() == true);
+    assert(list.begin() == list.end());
+
+    int arr[] = { 7, 1, 3, 2, 5, 4, 6, 3 };
+    stlite::SkipList<int> list2(arr, 8);
+    assert(list2.size() == 7);
+    assert(*list2.begin() == 1);
+}
+
+void test_random()
+{
+    stlite::SkipList<int> list;
+    std::set<int> reference;
+
+    srand(1);
+    for (int i = 0; i < 50000; i++)
+    {
+        int x = rand() % 10000;
+        if (rand() % 3)
+            assert(list.insert(x) == reference.insert(x).second);
+        else
+            assert(list.erase(x) == (reference.erase(x) == 1));
+    }
+
+    assert(list.size() == reference.size());
+    auto it = reference.begin();
+    for (int x : list)
+        assert(x == *it++);
+    assert(it == reference.end());
+}
+
+void test_copy_move()
+{
+    stlite::SkipList<std::string, stlite::Greater<std::string>> list;
+    list.insert("b");
+    list.insert("a");
+    list.insert("c");
+
+    // Ordered by the comparison
+    assert(*list.begin() == "c");
+
+    stlite::SkipList<std::string, stlite::Greater<std::string>> copy(list);
+    copy.erase("c");
+    assert(list.size() == 3 && copy.size() == 2);
+    assert(*copy.begin() == "b");
+
+    stlite::SkipList<std::string, stlite::Greater<std::string>> moved(
+        static_cast<stlite::SkipList<std::string, stlite::Greater<std::string>>&&>(copy));
+    assert(copy.empty() == true && moved.size() == 2);
+
+    copy = list;
+    assert(copy.size() == 3 && copy.count("a") == 1);
+
+    moved = static_cast<stlite::SkipList<std::string, stlite::Greater<std::string>>&&>(copy);
+    assert(moved.size() == 3 && copy.empty() == true);
+    copy.insert("z");
+    assert(copy.size() == 1);
+}
+
+int main()
+{
+    test_basic();
+    test_random();
+    test_copy_move();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "../include/soa_vector.h"
+#include "../include/simd_algorithms.h"
+
+#include <assert.h>
+#include <string>
+
+typedef stlite::SoAVector<int, float, std::string> Records;
+
+void test_basic()
+{
+    Records vec;
+
+    assert(vec.empty() == true);
+    assert(vec.size() == 0);
+    assert(vec.capacity() == 0);
+
+    for (int i = 0; i < 250; i++)
+        vec.push_back(i, i * 0.5f, std::to_string(i));
+
+    // Grows like Vector
+    assert(vec.size() == 250);
+    assert(vec.capacity() == 300);
+
+    assert(vec[10].get<0>() == 10);
+    assert(vec[10].get<1>() == 5.0f);
+    assert(vec[10].get<2>() == "10");
+    assert(vec.front().get<2>() == "0");
+    assert(vec.back().get<0>() == 249);
+
+    vec[3].get<2>() = "three";
+    vec[4].assign(-4, -2.0f, "four");
+    assert(vec[3].get<2>() == "three");
+    assert(vec[4].get<0>() == -4 && vec[4].get<2>() == "four");
+
+    // Row assignment copies the fields
+    vec[5] = vec[4];
+    assert(vec[5].get<0>() == -4 && vec[5].get<1>() == -2.0f);
+    assert(vec[4].get<2>() == "four");
+
+    assert(vec.pop_back() == true);
+    assert(vec.size() == 249);
+
+    vec.clear();
+    assert(vec.empty() == true);
+    assert(vec.pop_back() == false);
+}
+
+void test_columns()
+{
+    stlite::SoAVector<int, float> vec;
+    vec.reserve(1000);
+    assert(vec.capacity() == 1000);
+
+    for (int i = 0; i < 1000; i++)
+        vec.push_back(i, 1.0f);
+    assert(vec.capacity() == 1000);
+
+    stlite::Span<int> ids = vec.column<0>();
+    assert(ids.size() == 1000);
+    assert(ids.data() == vec.data<0>());
+    assert(ids[999] == 999);
+
+    // Columns are plain contiguous ranges
+    assert(stlite::simd::sum(ids.begin(), ids.end()) == 999 * 1000 / 2);
+    stlite::fill(ids.begin(), ids.begin() + 10, 7);
+    assert(vec[9].get<0>() == 7 && vec[10].get<0>() == 10);
+
+    const stlite::SoAVector<int, float>& cvec = vec;
+    stlite::Span<const float> prices = cvec.column<1>();
+    assert(stlite::accumulate(prices.begin(), prices.end(), 0.0f) == 1000.0f);
+    assert(cvec[500].get<0>() == 500);
+
+    stlite::Span<const int> part = cvec.column<0>().subspan(100, 5);
+    assert(part.size() == 5 && part[0] == 100);
+
+    // Reserving less than the capacity does nothing
+    vec.reserve(10);
+    assert(vec.capacity() == 1000);
+    assert(vec.size() == 1000);
+}
+
+void test_copy_move()
+{
+    Records vec;
+    for (int i = 0; i < 150; i++)
+        vec.push_back(i, 0.0f, std::to_string(i));
+
+    Records copy(vec);
+    assert(copy.size() == 150);
+    copy[0].get<2>() = "changed";
+    assert(vec[0].get<2>() == "0");
+    assert(copy[149].get<2>() == "149");
+
+    Records moved(static_cast<Records&&>(copy));
+    assert(moved.size() == 150);
+    assert(copy.size() == 0);
+    assert(moved[0].get<2>() == "changed");
+
+    copy = vec;
+    assert(copy.size() == 150 && copy[100].get<0>() == 100);
+
+    moved = static_cast<Records&&>(copy);
+    assert(moved[0].get<2>() == "0");
+
+    // Appending a row of the same vector while it grows
+    Records small;
+    small.push_back(1, 1.0f, "one");
+    for (int i = 0; i < 200; i++)
+        small.push_back(small[0]);
+    assert(small.size() == 201);
+    assert(small[200].get<2>() == "one");
+
+    Records sized(20);
+    assert(sized.size() == 20);
+    assert(sized[19].get<2>().empty());
+}
+
+int main()
+{
+    test_basic();
+    test_columns();
+    test_copy_move();
+
+    return 0;
+}
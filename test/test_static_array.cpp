@@ -0,0 +1,80 @@
+#include "../include/static_array.h"
+
+#include <assert.h>
+
+constexpr stlite::StaticArray<int, 5> make_squares()
+{
+    stlite::StaticArray<int, 5> arr = {};
+    for (unsigned i = 0; i < arr.size(); i++)
+        arr[i] = i * i;
+    return arr;
+}
+
+constexpr int sum(const stlite::StaticArray<int, 5>& arr)
+{
+    int s = 0;
+    for (stlite::StaticArray<int, 5>::ConstIterator it = arr.begin(); it != arr.end(); ++it)
+        s += *it;
+    return s;
+}
+
+constexpr int last_odd(const stlite::StaticArray<int, 5>& arr)
+{
+    for (stlite::StaticArray<int, 5>::ConstReverseIterator it = arr.crbegin();
+         it != arr.crend(); ++it)
+        if (*it % 2)
+            return *it;
+    return 0;
+}
+
+int main()
+{
+    // Compile time use
+    constexpr stlite::StaticArray<int, 3> carr = { 1, 2, 3 };
+    static_assert(carr.size() == 3, "");
+    static_assert(carr[1] == 2, "");
+    static_assert(carr.front() == 1, "");
+    static_assert(carr.back() == 3, "");
+    static_assert(carr.at(2) == 3, "");
+    static_assert(carr.empty() == false, "");
+
+    constexpr stlite::StaticArray<int, 5> squares = make_squares();
+    static_assert(squares[4] == 16, "");
+    static_assert(sum(squares) == 30, "");
+    static_assert(last_odd(squares) == 9, "");
+
+    // Run time use
+    stlite::StaticArray<int, 5> arr = { -1, 0, 1, 2, 3 };
+
+    assert(arr.size() == 5);
+    assert(arr.max_size() == 5);
+    assert(arr.front() == -1);
+    assert(arr.back() == 3);
+    assert(arr[2] == 1);
+    assert(arr.data()[4] == 3);
+
+    arr[0] = 33;
+    arr.at(1) = 44;
+    assert(arr[0] == 33);
+    assert(arr[1] == 44);
+
+    int i = 0;
+    for (stlite::StaticArray<int, 5>::Iterator it = arr.begin(); it != arr.end(); ++it)
+        *it = i++;
+    for (i = 0; i < 5; i++)
+        assert(arr[i] == i);
+    for (stlite::StaticArray<int, 5>::ReverseIterator it = arr.rbegin(); it != arr.rend(); ++it)
+        assert(*it == --i);
+
+    // Copy is a plain aggregate copy
+    stlite::StaticArray<int, 5> arr2 = arr;
+    arr2.fill(7);
+    assert(arr2[0] == 7);
+    assert(arr2[4] == 7);
+    assert(arr[4] == 4);
+
+    // Storage is inline
+    static_assert(sizeof(stlite::StaticArray<int, 5>) == 5 * sizeof(int), "");
+
+    return 0;
+}
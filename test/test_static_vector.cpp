@@ -0,0 +1,117 @@
+#include "../include/static_vector.h"
+
+#include <assert.h>
+#include <string>
+
+// Counts live objects, it has no default constructor
+struct Counted
+{
+    static int live;
+    int value;
+
+    Counted(int v) : value(v) { live++; }
+    Counted(const Counted& other) : value(other.value) { live++; }
+    ~Counted() { live--; }
+};
+
+int Counted::live = 0;
+
+void test_basic()
+{
+    stlite::StaticVector<int, 8> vec;
+
+    assert(vec.empty() == true);
+    assert(vec.size() == 0);
+    assert(vec.capacity() == 8);
+
+    for (int i = 0; i < 8; i++)
+        assert(vec.push_back(i) == true);
+
+    assert(vec.full() == true);
+    assert(vec.push_back(100) == false);
+    assert(vec.size() == 8);
+    assert(vec.front() == 0);
+    assert(vec.back() == 7);
+    assert(vec[3] == 3);
+    assert(vec.at(5) == 5);
+
+    vec.pop_back();
+    assert(vec.size() == 7);
+    assert(vec.back() == 6);
+
+    int n = 0;
+    for (stlite::StaticVector<int, 8>::Iterator it = vec.begin(); it != vec.end(); ++it)
+        assert(*it == n++);
+    assert(n == 7);
+    for (stlite::StaticVector<int, 8>::ConstReverseIterator it = vec.crbegin();
+         it != vec.crend(); ++it)
+        assert(*it == --n);
+    assert(n == 0);
+
+    vec.clear();
+    assert(vec.empty() == true);
+
+    int arr[5] = { 44, 55, 66, 77, 88 };
+    stlite::StaticVector<int, 4> vec2(arr, 5);
+    assert(vec2.size() == 4);
+    assert(vec2.back() == 77);
+
+    stlite::StaticVector<int, 4> vec3(3, 9);
+    assert(vec3.size() == 3);
+    assert(vec3[2] == 9);
+
+    stlite::StaticVector<int, 4> vec4({ 1, 2, 3 });
+    assert(vec4.size() == 3);
+    assert(vec4.data()[1] == 2);
+
+    vec4.resize(10, 5);
+    assert(vec4.size() == 4);
+    assert(vec4[3] == 5);
+    vec4.resize(1);
+    assert(vec4.size() == 1);
+    assert(vec4.back() == 1);
+}
+
+void test_lifetime()
+{
+    {
+        stlite::StaticVector<Counted, 4> vec;
+        assert(Counted::live == 0);
+
+        vec.push_back(Counted(1));
+        vec.emplace_back(2);
+        vec.emplace_back(3);
+        assert(Counted::live == 3);
+
+        stlite::StaticVector<Counted, 4> copy(vec);
+        assert(Counted::live == 6);
+        assert(copy[2].value == 3);
+
+        copy.pop_back();
+        assert(Counted::live == 5);
+
+        vec = copy;
+        assert(Counted::live == 4);
+        assert(vec.size() == 2);
+
+        stlite::StaticVector<Counted, 4> moved(std::move(vec));
+        assert(vec.empty() == true);
+        assert(moved.back().value == 2);
+        assert(Counted::live == 4);
+    }
+
+    assert(Counted::live == 0);
+
+    stlite::StaticVector<std::string, 2> strs;
+    strs.push_back("abc");
+    strs.emplace_back(3, 'x');
+    assert(strs[1] == "xxx");
+}
+
+int main()
+{
+    test_basic();
+    test_lifetime();
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "../include/circular_list.h"
+#include "../include/queue.h"
+#include "../include/set.h"
+#include "../include/trace.h"
+#include "../include/vector.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+static char buffer[1 << 20];
+
+static const char* export_trace()
+{
+    FILE* f = fmemopen(buffer, sizeof(buffer), "w");
+    stlite::Trace::write_chrome_json(f);
+    fclose(f);
+    return buffer;
+}
+
+static unsigned occurrences(const char* s, const char* what)
+{
+    unsigned n = 0;
+    for (const char* p = strstr(s, what); p; p = strstr(p + 1, what))
+        n++;
+    return n;
+}
+
+void test_vector()
+{
+    stlite::Trace::clear();
+
+    stlite::Vector<int> vec;
+    for (int i = 0; i < 250; i++)
+        vec.push_back(i);
+
+    assert(stlite::Trace::size() == 2);
+
+    const char* json = export_trace();
+    assert(strncmp(json, "{\"traceEvents\": [", 17) == 0);
+    assert(occurrences(json, "\"name\": \"Vector::reallocate\", \"ph\": \"i\"") == 2);
+    assert(strstr(json, "\"args\": {\"old_capacity\": 100, \"new_capacity\": 200, \"bytes_copied\": 400}"));
+    assert(strstr(json, "\"args\": {\"old_capacity\": 200, \"new_capacity\": 300, \"bytes_copied\": 800}"));
+
+    vec.reserve(1000);
+    assert(stlite::Trace::size() == 3);
+}
+
+void test_set()
+{
+    stlite::Trace::clear();
+
+    // Sorted input degenerates the tree into a list
+    stlite::Set<int> set;
+    for (int i = 0; i < 5; i++)
+        set.insert(i);
+
+    const char* json = export_trace();
+    assert(occurrences(json, "Set::insert") == 5);
+    assert(strstr(json, "\"args\": {\"depth\": 4, \"size\": 4}"));
+}
+
+void test_lists()
+{
+    stlite::Trace::clear();
+
+    stlite::CircularList<int> lst;
+    for (int i = 0; i < 10; i++)
+        lst.push_back(i);
+    lst.pop_back();
+    lst.at(5);
+
+    const char* json = export_trace();
+    assert(strstr(json, "\"name\": \"CircularList::pop_back\", \"ph\": \"i\""));
+    assert(strstr(json, "\"args\": {\"size\": 10}"));
+    assert(strstr(json, "\"args\": {\"steps\": 5, \"size\": 9}"));
+
+    stlite::Trace::clear();
+
+    stlite::Queue<int> q;
+    for (int i = 0; i < 10; i++)
+        q.push(i);
+    while (!q.empty())
+        q.pop();
+    for (int i = 0; i < 10; i++)
+        q.push(i);
+
+    // High water marks 1, 2, 4 and 8
+    json = export_trace();
+    assert(occurrences(json, "\"name\": \"Queue::high_water\", \"ph\": \"C\"") == 4);
+    assert(strstr(json, "\"args\": {\"size\": 8}"));
+}
+
+void test_ring_buffer()
+{
+    stlite::Trace::clear();
+
+    for (unsigned i = 0; i < STLITE_TRACE_BUFFER_SIZE + 10; i++)
+        STLITE_TRACE_EVENT("test", "i", i);
+
+    // The oldest events are overwritten
+    assert(stlite::Trace::size() == STLITE_TRACE_BUFFER_SIZE);
+    const char* json = export_trace();
+    assert(!strstr(json, "\"args\": {\"i\": 9}"));
+    assert(strstr(json, "\"args\": {\"i\": 10}"));
+}
+
+void test_threads()
+{
+    stlite::Trace::clear();
+
+    std::thread t([] {
+        for (unsigned i = 0; i < 100; i++)
+            STLITE_TRACE_EVENT("worker", "i", i);
+    });
+    t.join();
+
+    STLITE_TRACE_EVENT("main");
+
+    // The events of the exited thread are kept, in its own track
+    assert(stlite::Trace::size() == 101);
+    const char* json = export_trace();
+    assert(occurrences(json, "\"name\": \"worker\"") == 100);
+    assert(strstr(json, "\"name\": \"main\", \"ph\": \"i\", \"ts\": "));
+    assert(strstr(json, "\"tid\": 2"));
+}
+
+int main()
+{
+    test_vector();
+    test_set();
+    test_lists();
+    test_ring_buffer();
+    test_threads();
+
+    return 0;
+}
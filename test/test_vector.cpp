@@ -4,6 +4,8 @@
 #include <iostream>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 
 int main()
 {
@@ -185,5 +187,128 @@ int main()
     assert(vec10[1] == 102);
     assert(vec10[2] == 103);
 
+    // Random access iterator test
+    stlite::Vector<int> vec11({ 5, 3, 9, 1, 7 });
+
+    it = vec11.begin();
+    assert(it[2] == 9);
+    assert(*(it + 4) == 7);
+    it += 3;
+    assert(*it == 1);
+    it -= 2;
+    assert(*it == 3);
+    assert(vec11.end() - vec11.begin() == 5);
+    assert(vec11.begin() < vec11.end());
+    assert(vec11.begin() + 5 == vec11.end());
+
+    std::sort(vec11.begin(), vec11.end());
+    assert(vec11[0] == 1);
+    assert(vec11[4] == 9);
+    assert(std::distance(vec11.begin(), vec11.end()) == 5);
+
+    // Const iterator test
+    const stlite::Vector<int>& cvec11 = vec11;
+    stlite::Vector<int>::ConstIterator cit = cvec11.begin();
+    assert(*cit == 1);
+    assert(cit == vec11.begin());
+    cit = vec11.end();
+    assert(cit == cvec11.end());
+
+    int sum = 0;
+    for (int x : cvec11)
+        sum += x;
+    assert(sum == 25);
+
+    // Reverse iterator test
+    int expected = 9;
+    for (stlite::Vector<int>::ReverseIterator rit = vec11.rbegin(); rit != vec11.rend(); ++rit)
+    {
+        assert(*rit == expected);
+        expected -= 2;
+    }
+    assert(vec11.crbegin()[1] == 7);
+    assert(vec11.crend() - vec11.crbegin() == 5);
+
+    // Reserve and pop_back test
+    vec11.reserve(1000);
+    assert(vec11.capacity() == 1000);
+    assert(vec11.size() == 5);
+    assert(vec11[4] == 9);
+    vec11.reserve(10);
+    assert(vec11.capacity() == 1000);
+
+    assert(vec11.pop_back() == true);
+    assert(vec11.size() == 4);
+    vec11.clear();
+    assert(vec11.pop_back() == false);
+
+    // Range constructors, the size is computed before allocating
+    std::vector<int> svec12 = { 1, 2, 3, 4, 5 };
+    stlite::Vector<int> vec12(svec12.begin(), svec12.end());
+    assert(vec12.size() == 5);
+    assert(vec12.capacity() == 5);
+    assert(vec12[4] == 5);
+
+    std::vector<std::string> svec13 = { "aaa", "bbb", "ccc" };
+    stlite::Vector<std::string> vec13(svec13.begin(), svec13.end());
+    assert(vec13.size() == 3);
+    assert(vec13[1] == "bbb");
+
+    // A count and a value are not a range
+    stlite::Vector<int> vec14(3, 7);
+    assert(vec14.size() == 3);
+    assert(vec14[2] == 7);
+
+    // Resize
+    vec14.resize(5);
+    assert(vec14.size() == 5);
+    assert(vec14[2] == 7 && vec14[3] == 0 && vec14[4] == 0);
+    vec14.resize(250, 9);
+    assert(vec14.size() == 250);
+    assert(vec14[249] == 9);
+    vec14.resize(2);
+    assert(vec14.size() == 2);
+    vec14.resize(4, vec14[0]);
+    assert(vec14[3] == 7);
+
+    // Assign
+    vec14.assign(4, -1);
+    assert(vec14.size() == 4 && vec14[3] == -1);
+    vec14.assign(vec12.begin(), vec12.end());
+    assert(vec14.size() == 5 && vec14[0] == 1 && vec14[4] == 5);
+
+    // Range insert, in the middle with and without reallocation
+    stlite::Vector<int> vec15;
+    vec15.reserve(20);
+    vec15.push_back(0);
+    vec15.push_back(9);
+    stlite::Vector<int>::Iterator it15 = vec15.insert(vec15.cbegin() + 1, vec12.begin(), vec12.end());
+    assert(it15 == vec15.begin() + 1);
+    assert(vec15.size() == 7);
+    assert(vec15.capacity() == 20);
+    for (int i = 0; i < 6; i++)
+        assert(vec15[i] == i);
+    assert(vec15[6] == 9);
+
+    int arr15[200];
+    for (int i = 0; i < 200; i++)
+        arr15[i] = 100 + i;
+    vec15.insert(vec15.cbegin(), arr15, arr15 + 200);
+    assert(vec15.size() == 207);
+    assert(vec15[0] == 100 && vec15[199] == 299 && vec15[200] == 0 && vec15[206] == 9);
+
+    stlite::Vector<std::string> vec16(svec13.begin(), svec13.end());
+    vec16.reserve(10);
+    vec16.insert(vec16.cbegin(), svec13.begin(), svec13.begin() + 2);
+    assert(vec16.size() == 5);
+    assert(vec16[0] == "aaa" && vec16[1] == "bbb" && vec16[2] == "aaa" && vec16[4] == "ccc");
+
+    // Append a range
+    stlite::Vector<int> vec17;
+    vec17.append_range(svec12);
+    vec17.append_range(vec12);
+    assert(vec17.size() == 10);
+    assert(vec17[5] == 1 && vec17[9] == 5);
+
     return 0;
 }